@@ -0,0 +1,167 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Harness/BenchmarkHarness.h"
+#include "Corpus/ScriptCorpus.h"
+#include "Lexer/Lexer.h"
+#include "Parser/Parser.h"
+#include "Optimizer/Optimizer.h"
+#include "Optimizer/Utility/ASTHelper.h"
+
+/**
+ * @file CPulseBenchmark.cpp
+ * @brief Benchmarks the lexer, parser and evaluator on a generated corpus of CPulse scripts.
+ *
+ * Micro benchmarks measure one phase on small scripts; macro benchmarks run the full pipeline
+ * of the driver on larger scripts. Results are printed and optionally written as JSON.
+ *
+ * Usage: cpulse_bench [--repetitions N] [--scale N] [--filter TEXT] [--json results.json] [--write-corpus DIR]
+ */
+
+namespace {
+    struct BenchmarkOptions {
+        size_t repetitions = 10;
+        size_t scale = 50;
+        std::string filter;
+        std::string jsonPath;
+        std::string corpusDirectory;
+    };
+
+    // Keeps the optimiser from discarding the measured work
+    volatile size_t sink = 0;
+
+    bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--repetitions" && i + 1 < argc) {
+                options.repetitions = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--scale" && i + 1 < argc) {
+                options.scale = std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--filter" && i + 1 < argc) {
+                options.filter = argv[++i];
+            }
+            else if (arg == "--json" && i + 1 < argc) {
+                options.jsonPath = argv[++i];
+            }
+            else if (arg == "--write-corpus" && i + 1 < argc) {
+                options.corpusDirectory = argv[++i];
+            }
+            else {
+                std::cerr << "Unknown argument: " << arg << std::endl;
+                std::cerr << "Usage: cpulse_bench [--repetitions N] [--scale N] [--filter TEXT] [--json results.json] [--write-corpus DIR]" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<BlockNode> parseProgram(const std::vector<Token>& tokens, CodeGenerator& codeGen) {
+        Parser parser(tokens, codeGen);
+        return parser.parseProgram();
+    }
+
+    // Registers lexer, parser and evaluator micro benchmarks for one script
+    void addMicroBenchmarks(BenchmarkHarness& harness, const ScriptCorpus::Script& script) {
+        auto source = std::make_shared<std::string>(script.source);
+        auto tokens = std::make_shared<std::vector<Token>>(Lexer(*source).tokenize());
+
+        harness.add("lexer/" + script.name, BenchmarkHarness::Kind::Micro, [source] {
+            Lexer lexer(*source);
+            sink = sink + lexer.tokenize().size();
+        });
+
+        harness.add("parser/" + script.name, BenchmarkHarness::Kind::Micro, [tokens] {
+            CodeGenerator codeGen;
+            sink = sink + parseProgram(*tokens, codeGen)->getStatements().size();
+        });
+
+        // Execution consumes function bodies, so every run gets a fresh copy of the optimised program
+        CodeGenerator parseGenerator;
+        std::shared_ptr<BlockNode> program = parseProgram(*tokens, parseGenerator);
+        Optimizer(OptimizerOptions()).optimize(*program);
+        auto copy = std::make_shared<std::unique_ptr<BlockNode>>();
+        auto codeGen = std::make_shared<std::unique_ptr<CodeGenerator>>();
+
+        harness.add("evaluator/" + script.name, BenchmarkHarness::Kind::Micro, [copy, codeGen] {
+            (*codeGen)->execute(copy->get());
+            sink = sink + (*codeGen)->getOutput().getContents().size();
+        }, [program, copy, codeGen] {
+            *copy = ASTHelper::cloneBlock(program.get());
+            *codeGen = std::make_unique<CodeGenerator>();
+            (*codeGen)->getOutput().useMemory();
+        });
+    }
+
+    // Registers a benchmark running a script through the same pipeline as the driver
+    void addMacroBenchmark(BenchmarkHarness& harness, const ScriptCorpus::Script& script) {
+        auto source = std::make_shared<std::string>(script.source);
+        harness.add("pipeline/" + script.name, BenchmarkHarness::Kind::Macro, [source] {
+            CodeGenerator codeGen;
+            codeGen.getOutput().useMemory();
+            std::vector<Token> tokens = Lexer(*source).tokenize();
+            Parser parser(tokens, codeGen);
+            parser.parse();
+            sink = sink + codeGen.getOutput().getContents().size();
+        });
+    }
+
+    bool writeCorpus(const std::string& directory, const std::vector<ScriptCorpus::Script>& scripts) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        for (const auto& script : scripts) {
+            std::ofstream file(std::filesystem::path(directory) / (script.name + ".txt"));
+            if (!(file << script.source)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<ScriptCorpus::Script> smallScripts = ScriptCorpus::generate(1);
+    std::vector<ScriptCorpus::Script> largeScripts = ScriptCorpus::generate(options.scale);
+
+    if (!options.corpusDirectory.empty()) {
+        if (!writeCorpus(options.corpusDirectory, largeScripts)) {
+            std::cerr << "Failed to write corpus to " << options.corpusDirectory << std::endl;
+            return 1;
+        }
+        std::cout << "Corpus written to " << options.corpusDirectory << std::endl;
+        return 0;
+    }
+
+    BenchmarkHarness harness(options.repetitions, 20.0);
+    for (const auto& script : smallScripts) {
+        addMicroBenchmarks(harness, script);
+    }
+    for (const auto& script : largeScripts) {
+        addMacroBenchmark(harness, script);
+    }
+
+    std::vector<BenchmarkHarness::Result> results;
+    try {
+        results = harness.run(options.filter);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+    if (!options.jsonPath.empty() && !BenchmarkHarness::writeJson(options.jsonPath, results)) {
+        std::cerr << "Failed to write results to " << options.jsonPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
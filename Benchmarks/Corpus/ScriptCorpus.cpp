@@ -0,0 +1,85 @@
+#include "ScriptCorpus.h"
+#include <algorithm>
+#include <cmath>
+
+std::vector<ScriptCorpus::Script> ScriptCorpus::generate(size_t scale) {
+    scale = std::max<size_t>(scale, 1);
+    return {
+        { "arithmetic", arithmeticLoop(200 * scale) },
+        { "lists", listOperations(100 * scale) },
+        { "strings", stringConcatenation(100 * scale) },
+        // Each step of n doubles the work, so recursion grows with the logarithm of the scale
+        { "recursion", recursiveFunctions(10 + static_cast<size_t>(std::log2(static_cast<double>(scale)))) },
+        { "expressions", deepExpressions(32, 10 * scale) },
+    };
+}
+
+std::string ScriptCorpus::arithmeticLoop(size_t iterations) {
+    return "i = 0\n"
+        "acc = 0\n"
+        "while (i < " + std::to_string(iterations) + ") {\n"
+        "    acc = acc + i * 3\n"
+        "    acc = acc - i % 7\n"
+        "    i = i + 1\n"
+        "}\n"
+        "print(acc)\n";
+}
+
+std::string ScriptCorpus::listOperations(size_t size) {
+    std::string count = std::to_string(size);
+    return "values = list:int()\n"
+        "i = 0\n"
+        "while (i < " + count + ") {\n"
+        "    values.append(i * 2)\n"
+        "    i = i + 1\n"
+        "}\n"
+        "total = 0\n"
+        "i = 0\n"
+        "while (i < " + count + ") {\n"
+        "    total = total + values[i]\n"
+        "    i = i + 1\n"
+        "}\n"
+        "while (values.length() > 0) {\n"
+        "    total = total - values.pop(values.length() - 1)\n"
+        "}\n"
+        "print(total)\n";
+}
+
+std::string ScriptCorpus::stringConcatenation(size_t rows) {
+    return "report = \"\"\n"
+        "i = 0\n"
+        "while (i < " + std::to_string(rows) + ") {\n"
+        "    report = report + \"row,\" + i + \",\" + (i * 2) + \";\"\n"
+        "    i = i + 1\n"
+        "}\n"
+        "print(string(i))\n";
+}
+
+std::string ScriptCorpus::recursiveFunctions(size_t n) {
+    return "func:int fib(n:int) {\n"
+        "    if (n < 2) {\n"
+        "        return n\n"
+        "    }\n"
+        "    return fib(n - 1) + fib(n - 2)\n"
+        "}\n"
+        "print(fib(" + std::to_string(n) + "))\n";
+}
+
+std::string ScriptCorpus::deepExpressions(size_t depth, size_t iterations) {
+    // Builds ((((i + 1) - 2) * 1) + 4 ...) so every level is a separate binary node
+    std::string expression = "i";
+    for (size_t level = 0; level < depth; ++level) {
+        static const char* const operators[] = { " + ", " - ", " * " };
+        const char* op = operators[level % 3];
+        std::string operand = level % 3 == 2 ? "1" : std::to_string(level % 5 + 1);
+        expression = "(" + expression + op + operand + ")";
+    }
+
+    return "i = 0\n"
+        "while (i < " + std::to_string(iterations) + ") {\n"
+        "    y = " + expression + "\n"
+        "    z = " + expression + " < " + expression + "\n"
+        "    i = i + 1\n"
+        "}\n"
+        "print(y)\n";
+}
@@ -0,0 +1,68 @@
+#ifndef SCRIPTCORPUS_H
+#define SCRIPTCORPUS_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct ScriptCorpus
+ * @brief Generates CPulse scripts representing typical workloads for benchmarking.
+ *
+ * Every script prints a result so that its work cannot be skipped and its output can be
+ * checked when the corpus is written to disk and run with CPulse.
+ */
+struct ScriptCorpus {
+    /**
+     * @struct Script
+     * @brief A generated script.
+     */
+    struct Script {
+        std::string name; ///< Short workload name used in benchmark names.
+        std::string source; ///< The CPulse source.
+    };
+
+    /**
+     * @brief Generates one script per workload.
+     * @param scale Multiplier for loop counts and sizes; 1 produces small scripts suited to micro benchmarks.
+     * @return The generated scripts.
+     */
+    static std::vector<Script> generate(size_t scale);
+
+    /**
+     * @brief Generates a loop of integer arithmetic.
+     * @param iterations Number of loop iterations.
+     * @return The script source.
+     */
+    static std::string arithmeticLoop(size_t iterations);
+
+    /**
+     * @brief Generates a script that builds a list, indexes every element and pops it empty.
+     * @param size Number of list elements.
+     * @return The script source.
+     */
+    static std::string listOperations(size_t size);
+
+    /**
+     * @brief Generates a loop that builds a report by string concatenation.
+     * @param rows Number of rows appended.
+     * @return The script source.
+     */
+    static std::string stringConcatenation(size_t rows);
+
+    /**
+     * @brief Generates recursive function calls.
+     * @param n The Fibonacci number computed recursively.
+     * @return The script source.
+     */
+    static std::string recursiveFunctions(size_t n);
+
+    /**
+     * @brief Generates assignments of deeply nested expressions evaluated in a loop.
+     * @param depth Nesting depth of each expression.
+     * @param iterations Number of loop iterations.
+     * @return The script source.
+     */
+    static std::string deepExpressions(size_t depth, size_t iterations);
+};
+
+#endif // SCRIPTCORPUS_H
@@ -0,0 +1,121 @@
+#include "BenchmarkHarness.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+BenchmarkHarness::BenchmarkHarness(size_t repetitions, double minRepetitionMilliseconds)
+    : repetitions(std::max<size_t>(repetitions, 1)), minRepetitionMilliseconds(minRepetitionMilliseconds) {}
+
+void BenchmarkHarness::add(const std::string& name, Kind kind, std::function<void()> operation, std::function<void()> setup) {
+    benchmarks.push_back(Benchmark{ name, kind, std::move(operation), std::move(setup) });
+}
+
+double BenchmarkHarness::measure(const Benchmark& benchmark, size_t iterations) {
+    using Clock = std::chrono::steady_clock;
+
+    if (!benchmark.setup) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            benchmark.operation();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    // With setup every operation is timed on its own so the preparation is excluded
+    double elapsed = 0.0;
+    for (size_t i = 0; i < iterations; ++i) {
+        benchmark.setup();
+        auto start = Clock::now();
+        benchmark.operation();
+        elapsed += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+    return elapsed;
+}
+
+BenchmarkHarness::Result BenchmarkHarness::measureBenchmark(const Benchmark& benchmark) const {
+    // Warm up caches and allocators, and calibrate the batch size of micro benchmarks
+    size_t iterations = 1;
+    double elapsed = measure(benchmark, iterations);
+    if (benchmark.kind == Kind::Micro) {
+        double target = minRepetitionMilliseconds * 1e6;
+        while (elapsed < target && iterations < (size_t(1) << 30)) {
+            double perOperation = std::max(elapsed / iterations, 1.0);
+            iterations = std::max(iterations * 2, static_cast<size_t>(target / perOperation * 1.2));
+            elapsed = measure(benchmark, iterations);
+        }
+    }
+
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (size_t i = 0; i < repetitions; ++i) {
+        samples.push_back(measure(benchmark, iterations) / iterations);
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.kind = benchmark.kind;
+    result.repetitions = repetitions;
+    result.iterations = iterations;
+
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    result.mean = sum / samples.size();
+
+    double squares = 0.0;
+    for (double sample : samples) {
+        squares += (sample - result.mean) * (sample - result.mean);
+    }
+    result.stddev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0.0;
+
+    std::sort(samples.begin(), samples.end());
+    size_t middle = samples.size() / 2;
+    result.median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+    result.min = samples.front();
+    result.max = samples.back();
+    return result;
+}
+
+std::vector<BenchmarkHarness::Result> BenchmarkHarness::run(const std::string& filter) {
+    std::vector<Result> results;
+    std::cout << std::left << std::setw(32) << "Benchmark" << std::right << std::setw(16) << "Median ns/op"
+        << std::setw(16) << "Mean ns/op" << std::setw(12) << "Stddev %" << std::setw(12) << "Iterations" << std::endl;
+
+    for (const auto& benchmark : benchmarks) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        Result result = measureBenchmark(benchmark);
+        double relative = result.mean > 0.0 ? result.stddev / result.mean * 100.0 : 0.0;
+        std::cout << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(16) << result.median << std::setw(16) << result.mean << std::setw(12) << relative
+            << std::setw(12) << result.iterations << std::endl;
+        results.push_back(result);
+    }
+    return results;
+}
+
+bool BenchmarkHarness::writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        // Benchmark names are generated by the suite and never need escaping
+        file << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": \"" << result.name << "\", \"kind\": \"" << (result.kind == Kind::Micro ? "micro" : "macro")
+            << "\", \"repetitions\": " << result.repetitions << ", \"iterations\": " << result.iterations
+            << ", \"mean\": " << result.mean << ", \"median\": " << result.median << ", \"min\": " << result.min
+            << ", \"max\": " << result.max << ", \"stddev\": " << result.stddev << "}";
+    }
+    file << "\n  ]\n}\n";
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,106 @@
+#ifndef BENCHMARKHARNESS_H
+#define BENCHMARKHARNESS_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @class BenchmarkHarness
+ * @brief Runs registered benchmarks with repeated measurements and reports time per operation.
+ *
+ * Micro benchmarks are calibrated so that each repetition runs the operation often enough to
+ * last at least the minimum repetition time. Macro benchmarks run the operation once per
+ * repetition. An optional setup function runs before every operation outside the timed region.
+ */
+class BenchmarkHarness {
+public:
+    /**
+     * @enum Kind
+     * @brief How a benchmark is repeated.
+     */
+    enum class Kind {
+        Micro, ///< Short operation, run in calibrated batches.
+        Macro  ///< Long operation, run once per repetition.
+    };
+
+    /**
+     * @struct Result
+     * @brief The statistics of one benchmark, in nanoseconds per operation.
+     */
+    struct Result {
+        std::string name; ///< The benchmark name.
+        Kind kind; ///< How the benchmark was repeated.
+        size_t repetitions = 0; ///< Number of measured repetitions.
+        size_t iterations = 0; ///< Operations per repetition.
+        double mean = 0.0; ///< Mean time per operation.
+        double median = 0.0; ///< Median time per operation.
+        double min = 0.0; ///< Fastest repetition.
+        double max = 0.0; ///< Slowest repetition.
+        double stddev = 0.0; ///< Sample standard deviation across repetitions.
+    };
+
+    /**
+     * @brief Constructs a harness.
+     * @param repetitions Number of measured repetitions per benchmark.
+     * @param minRepetitionMilliseconds Minimum duration of a micro benchmark repetition.
+     */
+    BenchmarkHarness(size_t repetitions, double minRepetitionMilliseconds);
+
+    /**
+     * @brief Registers a benchmark.
+     * @param name The benchmark name, such as "lexer/arithmetic".
+     * @param kind How the benchmark is repeated.
+     * @param operation The measured operation.
+     * @param setup Optional untimed preparation run before every operation.
+     */
+    void add(const std::string& name, Kind kind, std::function<void()> operation, std::function<void()> setup = nullptr);
+
+    /**
+     * @brief Runs every benchmark whose name contains the filter, printing each result as it completes.
+     * @param filter Substring a benchmark name must contain; empty runs all benchmarks.
+     * @return The results in registration order.
+     */
+    std::vector<Result> run(const std::string& filter);
+
+    /**
+     * @brief Writes results as JSON so runs on different commits can be compared.
+     * @param path The file to write.
+     * @param results The results to write.
+     * @return True if the file could be written, false otherwise.
+     */
+    static bool writeJson(const std::string& path, const std::vector<Result>& results);
+
+private:
+    /**
+     * @struct Benchmark
+     * @brief A registered benchmark.
+     */
+    struct Benchmark {
+        std::string name; ///< The benchmark name.
+        Kind kind; ///< How the benchmark is repeated.
+        std::function<void()> operation; ///< The measured operation.
+        std::function<void()> setup; ///< Untimed preparation, or empty.
+    };
+
+    size_t repetitions; ///< Number of measured repetitions per benchmark.
+    double minRepetitionMilliseconds; ///< Minimum duration of a micro benchmark repetition.
+    std::vector<Benchmark> benchmarks; ///< Registered benchmarks.
+
+    /**
+     * @brief Runs a benchmark's operation a number of times.
+     * @param benchmark The benchmark to run.
+     * @param iterations Number of operations.
+     * @return The time spent in the operations in nanoseconds, excluding setup.
+     */
+    static double measure(const Benchmark& benchmark, size_t iterations);
+
+    /**
+     * @brief Measures one benchmark.
+     * @param benchmark The benchmark to measure.
+     * @return Its statistics.
+     */
+    Result measureBenchmark(const Benchmark& benchmark) const;
+};
+
+#endif // BENCHMARKHARNESS_H
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Value/NumberConversion.h"
+
+/**
+ * @file NumberConversionBenchmark.cpp
+ * @brief Compares std::to_string/std::stod against NumberConversion for the conversions the interpreter performs.
+ */
+
+namespace {
+    constexpr size_t iterations = 2000000;
+
+    // Keeps the optimiser from discarding the measured work
+    volatile size_t sink = 0;
+
+    template <typename Function>
+    void measure(const std::string& name, Function&& function) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            function(i);
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << elapsed / iterations << " ns/op" << std::endl;
+    }
+}
+
+int main() {
+    std::vector<double> doubles;
+    std::vector<std::string> doubleTexts;
+    std::vector<std::string> intTexts;
+    for (size_t i = 0; i < 1024; ++i) {
+        doubles.push_back(static_cast<double>(i) * 1.37 - 500.25);
+        doubleTexts.push_back(NumberConversion::toString(doubles.back()));
+        intTexts.push_back(NumberConversion::toString(static_cast<int>(i * 7919)));
+    }
+
+    measure("int -> string (std::to_string)", [](size_t i) { sink = sink + std::to_string(static_cast<int>(i)).size(); });
+    measure("int -> string (NumberConversion)", [](size_t i) { sink = sink + NumberConversion::toString(static_cast<int>(i)).size(); });
+
+    measure("double -> string (std::to_string)", [&](size_t i) { sink = sink + std::to_string(doubles[i & 1023]).size(); });
+    measure("double -> string (NumberConversion)", [&](size_t i) { sink = sink + NumberConversion::toString(doubles[i & 1023]).size(); });
+
+    measure("string -> int (std::stoi)", [&](size_t i) { sink = sink + static_cast<size_t>(std::stoi(intTexts[i & 1023])); });
+    measure("string -> int (NumberConversion)", [&](size_t i) {
+        int value = 0;
+        NumberConversion::parseInt(intTexts[i & 1023], value);
+        sink = sink + static_cast<size_t>(value);
+    });
+
+    measure("string -> double (std::stod)", [&](size_t i) { sink = sink + static_cast<size_t>(static_cast<long long>(std::stod(doubleTexts[i & 1023]))); });
+    measure("string -> double (NumberConversion)", [&](size_t i) {
+        double value = 0;
+        NumberConversion::parseDouble(doubleTexts[i & 1023], value);
+        sink = sink + static_cast<size_t>(static_cast<long long>(value));
+    });
+
+    return 0;
+}
@@ -2,48 +2,317 @@
 
 namespace fs = std::filesystem;
 
-void CPulse::processFile(const std::string& filePath, const std::string& title) {
-    if (!title.empty()) {
-		std::cout << "Processing " << title << "..." << std::endl;
-	}
+// Reads the entire contents of a file, returning false if it cannot be opened
+static bool readFile(const std::string& filePath, std::string& content) {
     std::ifstream file(filePath);
     if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << filePath << std::endl;
-        return;
+        return false;
     }
-
-
-    // Read the entire contents of the file into a string
     std::ostringstream sstr;
     sstr << file.rdbuf();
-    std::string content = sstr.str();
+    content = sstr.str();
+    return true;
+}
 
+std::string CPulse::run(const std::string& filePath, const std::string& title, const std::string& content, CodeGenerator& codeGen) {
+    std::unique_ptr<TraceRecorder> recorder;
+    if (!options.tracePath.empty()) {
+        recorder = std::make_unique<TraceRecorder>(title + " (" + filePath + ")", traceOrigin);
+        codeGen.setTracer(recorder.get());
+    }
+
+    std::string error;
     try {
+        TraceRecorder::Scope fileTrace(recorder.get(), filePath, "file");
         Lexer lexer(content);  // Initialize the lexer with the entire content
-        std::vector<Token> tokens = lexer.tokenize(); // Tokenize the entire content
+        std::vector<Token> tokens;
+        {
+            TraceRecorder::Scope trace(recorder.get(), "Lexer", "phase");
+            tokens = lexer.tokenize(); // Tokenize the entire content
+        }
 
-        CodeGenerator codeGen;
+        codeGen.setOptimizerOptions(options.optimizer);
+        codeGen.setJITOptions(options.jit);
+        if (options.emitCpp) {
+            codeGen.setEmitPath(fs::path(filePath).replace_extension(".cpp").string());
+        }
+        if (options.profile) {
+            codeGen.enableProfiler();
+        }
+        if (options.stats) {
+            codeGen.enableStats();
+        }
+        if (options.inlineCaches) {
+            codeGen.enableInlineCacheReport();
+        }
         Parser parser(tokens, codeGen);  // Initialize the parser with the tokens
         parser.parse();  // Parse the tokens
-
-
     }
     catch (const std::runtime_error& e) {
-        std::cerr << e.what() << std::endl;
+        error = e.what();
+    }
+    // Output produced before an error is written ahead of the message
+    codeGen.getOutput().flush();
+
+    if (recorder) {
+        codeGen.setTracer(nullptr);
+        std::lock_guard<std::mutex> lock(traceMutex);
+        traces.push_back(std::move(*recorder));
+    }
+    return error;
+}
+
+void CPulse::processFile(const std::string& filePath, const std::string& title) {
+    if (!title.empty()) {
+		std::cout << "Processing " << title << "..." << std::endl;
+	}
+    std::string content;
+    if (!readFile(filePath, content)) {
+        std::cerr << "Failed to open file: " << filePath << std::endl;
+        return;
     }
 
-    file.close();
+    CodeGenerator codeGen;
+    std::string error = run(filePath, title, content, codeGen);
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
+    }
+    else if (!codeGen.getEmitPath().empty()) {
+        std::cout << "C++ written to " << codeGen.getEmitPath() << std::endl;
+    }
+    if (options.profile) {
+        std::cout << profileReport(filePath, codeGen);
+    }
+    if (const RuntimeStats* stats = codeGen.getStats()) {
+        std::cout << stats->report();
+    }
+    if (const InlineCacheReport* inlineCaches = codeGen.getInlineCacheReport()) {
+        std::cout << inlineCaches->report();
+    }
+    if (options.jit.report && codeGen.getJIT()) {
+        std::cout << codeGen.getJIT()->report();
+    }
+    std::cout << codeGen.getOptimizerReport();
 
     // print a ascii line
     std::cout << std::string(80, '-') << std::endl;
 }
 
-int main() {
+FileReport CPulse::captureFile(const std::string& filePath, const std::string& title) {
+    auto start = std::chrono::steady_clock::now();
+    FileReport report;
+    report.title = title;
+    report.path = filePath;
+    if (!title.empty()) {
+        report.output = "Processing " + title + "...\n";
+    }
+
+    std::string content;
+    report.opened = readFile(filePath, content);
+    if (!report.opened) {
+        report.errors = "Failed to open file: " + filePath + "\n";
+    }
+    else {
+        CodeGenerator codeGen;
+        codeGen.getOutput().useMemory();
+        std::string error = run(filePath, title, content, codeGen);
+        report.output += codeGen.getOutput().getContents();
+        if (!error.empty()) {
+            report.errors = error + "\n";
+        }
+        else if (!codeGen.getEmitPath().empty()) {
+            report.output += "C++ written to " + codeGen.getEmitPath() + "\n";
+        }
+        if (options.profile) {
+            report.output += profileReport(filePath, codeGen);
+        }
+        if (const RuntimeStats* stats = codeGen.getStats()) {
+            report.output += stats->report();
+        }
+        if (const InlineCacheReport* inlineCaches = codeGen.getInlineCacheReport()) {
+            report.output += inlineCaches->report();
+        }
+        if (options.jit.report && codeGen.getJIT()) {
+            report.output += codeGen.getJIT()->report();
+        }
+        report.output += codeGen.getOptimizerReport();
+    }
+
+    report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+void CPulse::emitReport(const FileReport& report) {
+    std::cout << report.output << std::flush;
+    std::cerr << report.errors << std::flush;
+    if (report.opened) {
+        std::cout << std::string(80, '-') << std::endl;
+    }
+}
+
+std::string CPulse::profileReport(const std::string& filePath, const CodeGenerator& codeGen) {
+    const Profiler* profiler = codeGen.getProfiler();
+    if (!profiler) {
+        return std::string();
+    }
+
+    std::string report = profiler->report();
+    std::string stacksPath = fs::path(filePath).replace_extension(".folded").string();
+    if (profiler->writeCollapsedStacks(stacksPath)) {
+        report += "Collapsed stacks written to " + stacksPath + "\n";
+    }
+    else {
+        report += "Failed to write collapsed stacks to " + stacksPath + "\n";
+    }
+    return report;
+}
+
+void CPulse::processFiles(const std::vector<std::string>& filePaths) {
+    if (options.jobs == 1) {
+        for (size_t i = 0; i < filePaths.size(); ++i) {
+            processFile(filePaths[i], "Test " + std::to_string(i + 1));
+        }
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<FileReport> reports(filePaths.size());
+    std::vector<bool> finished(filePaths.size(), false);
+    std::mutex mutex;
+    std::condition_variable reportFinished;
+    size_t jobCount;
+
+    {
+        ThreadPool pool(options.jobs);
+        jobCount = pool.size();
+        for (size_t i = 0; i < filePaths.size(); ++i) {
+            pool.submit([this, i, &filePaths, &reports, &finished, &mutex, &reportFinished] {
+                // Each file gets its own lexer, parser and code generator, so nothing is shared between tasks
+                FileReport report = captureFile(filePaths[i], "Test " + std::to_string(i + 1));
+                std::lock_guard<std::mutex> lock(mutex);
+                reports[i] = std::move(report);
+                finished[i] = true;
+                reportFinished.notify_all();
+            });
+        }
+
+        // Emit the reports in file order as soon as each one and all before it are done
+        for (size_t i = 0; i < filePaths.size(); ++i) {
+            std::unique_lock<std::mutex> lock(mutex);
+            reportFinished.wait(lock, [&finished, i] { return finished[i]; });
+            lock.unlock();
+            emitReport(reports[i]);
+        }
+    }
+
+    double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Summary (" << filePaths.size() << " files, " << jobCount << " jobs)" << std::endl;
+    for (const auto& report : reports) {
+        std::cout << "  " << report.title << " (" << report.path << "): " << std::fixed << std::setprecision(3)
+            << report.milliseconds << " ms" << std::endl;
+    }
+    std::cout << "  Total wall time: " << total << " ms" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+bool CPulse::writeTrace() {
+    if (options.tracePath.empty()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(traceMutex);
+    return TraceRecorder::writeJson(options.tracePath, traces);
+}
+
+// Parse the command line into the driver options, returning false on invalid arguments
+static bool parseArguments(int argc, char* argv[], CPulseOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--no-inline") {
+            options.optimizer.inlineFunctions = false;
+        }
+        else if (arg == "--no-specialize") {
+            options.optimizer.specializeTypes = false;
+        }
+        else if (arg == "--no-fuse") {
+            options.optimizer.fuseStatements = false;
+        }
+        else if (arg == "--no-dce") {
+            options.optimizer.eliminateDeadCode = false;
+        }
+        else if (arg == "--no-ssa") {
+            options.optimizer.optimizeSSA = false;
+        }
+        else if (arg == "--no-licm") {
+            options.optimizer.hoistInvariants = false;
+        }
+        else if (arg == "--inline-threshold" && i + 1 < argc) {
+            options.optimizer.inlineThreshold = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--no-jit") {
+            options.jit.enabled = false;
+        }
+        else if (arg == "--jit-threshold" && i + 1 < argc) {
+            options.jit.threshold = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--jit-loop-threshold" && i + 1 < argc) {
+            options.jit.loopThreshold = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--jobs" && i + 1 < argc) {
+            options.jobs = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--kernel-threads" && i + 1 < argc) {
+            options.kernels.threads = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--parallel-threshold" && i + 1 < argc) {
+            options.kernels.parallelThreshold = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--profile") {
+            options.profile = true;
+        }
+        else if (arg == "--stats") {
+            options.stats = true;
+        }
+        else if (arg == "--dump-inline-caches") {
+            options.inlineCaches = true;
+        }
+        else if (arg == "--dump-dce") {
+            options.optimizer.reportDeadCode = true;
+        }
+        else if (arg == "--dump-ir") {
+            options.optimizer.dumpIR = true;
+        }
+        else if (arg == "--dump-licm") {
+            options.optimizer.reportHoisting = true;
+        }
+        else if (arg == "--dump-jit") {
+            options.jit.report = true;
+        }
+        else if (arg == "--emit-cpp") {
+            options.emitCpp = true;
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            std::cerr << "Usage: CPulse [--no-inline] [--inline-threshold N] [--no-specialize] [--no-fuse] [--no-licm] [--no-dce] [--no-ssa] [--no-jit] [--jit-threshold N] [--jit-loop-threshold N] [--jobs N] [--kernel-threads N] [--parallel-threshold N] [--profile] [--stats] [--dump-inline-caches] [--dump-licm] [--dump-dce] [--dump-ir] [--dump-jit] [--emit-cpp] [--trace out.json]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
 
-    CPulse cpulse;
+int main(int argc, char* argv[]) {
+
+    CPulseOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+    ListKernels::setOptions(options.kernels);
+
+    CPulse cpulse(options);
     std::string base_path = "Files/";
     std::string extension = ".txt";
-    int test_number = 1;
     // check if the directory exists
     if (!fs::exists(base_path)) {
 		std::cerr << "Directory does not exist: " << base_path << std::endl;
@@ -51,12 +320,17 @@ int main() {
 	}
 
    // run all tests in the Files directory with the .txt extension
+    std::vector<std::string> files;
     for (const auto& entry : fs::directory_iterator(base_path)) {
         if (entry.path().extension() == extension) {
-			cpulse.processFile(entry.path().string(), "Test " + std::to_string(test_number));
-			test_number++;
+			files.push_back(entry.path().string());
 		}
 	}
+    cpulse.processFiles(files);
+    if (!cpulse.writeTrace()) {
+        std::cerr << "Failed to write trace: " << options.tracePath << std::endl;
+        return 1;
+    }
 
     return 0;
 }
@@ -5,12 +5,112 @@
 #include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <iomanip>
+#include <sstream>
 #include <Parser/Parser.h>
 #include "classes/Lexer/Lexer.h"
 #include "TokenType.h"
+#include "Structs/Optimizer/OptimizerOptions.h"
+#include "Structs/JIT/JITOptions.h"
+#include "CodeGenerator/JIT/JITRuntime.h"
+#include "Concurrency/ThreadPool.h"
+#include "TypedVector/ListKernels.h"
+
+/**
+ * @struct CPulseOptions
+ * @brief Holds the command line settings of the CPulse driver.
+ */
+struct CPulseOptions {
+    OptimizerOptions optimizer; ///< Options forwarded to the optimiser of every processed file.
+    JITOptions jit; ///< Options of the native code generator of every processed file.
+    size_t jobs = 1; ///< Number of files processed concurrently; 0 uses every hardware thread.
+    ListKernels::Options kernels; ///< Settings of the parallel list kernels shared by all files.
+    bool profile = false; ///< Whether each file is profiled and reported after it runs.
+    bool stats = false; ///< Whether the runtime counters of each file are reported after it runs.
+    bool inlineCaches = false; ///< Whether the inline caches of each file's binary operations are reported after it runs.
+    bool emitCpp = false; ///< Whether each file is translated to a C++ file next to it instead of being run.
+    std::string tracePath; ///< File the Chrome trace of all processed files is written to; empty disables tracing.
+};
+
+/**
+ * @struct FileReport
+ * @brief Holds the captured results of processing one file.
+ */
+struct FileReport {
+    std::string title; ///< The title the file is reported under.
+    std::string path; ///< The path of the processed file.
+    std::string output; ///< Everything the file wrote to standard output, in order.
+    std::string errors; ///< Everything the file wrote to standard error.
+    bool opened = false; ///< Whether the file could be read.
+    double milliseconds = 0.0; ///< Wall time spent processing the file.
+};
 
 class CPulse {
 public:
+    explicit CPulse(const CPulseOptions& options = CPulseOptions()) : options(options), traceOrigin(TraceRecorder::Clock::now()) {}
+
     // Process a file containing arithmetic expressions
     void processFile(const std::string& filePath, const std::string& title);
+
+    /**
+     * @brief Processes a file in its own interpreter, capturing everything it writes.
+     *
+     * Nothing is written to the console, so several files can be captured concurrently.
+     *
+     * @param filePath The path of the file to process.
+     * @param title The title the file is reported under.
+     * @return The captured output, errors and wall time.
+     */
+    FileReport captureFile(const std::string& filePath, const std::string& title);
+
+    /**
+     * @brief Processes all files, concurrently when more than one job is configured.
+     *
+     * With several jobs each file runs on a thread pool in an isolated interpreter. Captured
+     * output is written in the order of the files, followed by a summary of per-file wall times.
+     *
+     * @param filePaths The paths of the files to process.
+     */
+    void processFiles(const std::vector<std::string>& filePaths);
+
+    /**
+     * @brief Writes the trace of all files processed so far to the configured trace path.
+     * @return True if tracing is disabled or the trace was written, false otherwise.
+     */
+    bool writeTrace();
+
+private:
+    CPulseOptions options;
+    TraceRecorder::Clock::time_point traceOrigin; ///< The time trace timestamps are measured from.
+    std::vector<TraceRecorder> traces; ///< Trace events of each processed file, in completion order.
+    std::mutex traceMutex; ///< Guards traces while files run concurrently.
+
+    /**
+     * @brief Lexes, parses and executes a program with the given code generator.
+     * @param filePath The path of the program, used to name its trace.
+     * @param title The title of the program, used to name its trace.
+     * @param content The source of the program.
+     * @param codeGen The code generator executing the program.
+     * @return The error message if processing failed, otherwise an empty string.
+     */
+    std::string run(const std::string& filePath, const std::string& title, const std::string& content, CodeGenerator& codeGen);
+
+    /**
+     * @brief Writes a captured report to the console.
+     * @param report The report to write.
+     */
+    static void emitReport(const FileReport& report);
+
+    /**
+     * @brief Builds the profile report of a file and writes its collapsed stacks next to it.
+     * @param filePath The path of the profiled file; the stacks are written with the extension ".folded".
+     * @param codeGen The code generator that executed the file with profiling enabled.
+     * @return The text report.
+     */
+    static std::string profileReport(const std::string& filePath, const CodeGenerator& codeGen);
 };
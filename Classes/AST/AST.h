@@ -4,6 +4,10 @@
 #include <string>
 #include <vector>
 #include "Structs/Token/Token.h"
+#include "Structs/Cache/InlineCache.h"
+#include "ListMethod.h"
+#include "MapMethod.h"
+#include "TypedBinaryOp.h"
 
 /**
  * @class ASTNode
@@ -54,13 +58,49 @@ public:
         : ExprNode(token), left(std::move(left)), op(std::move(op)), right(std::move(right)) {}
 
     const std::unique_ptr<ExprNode>& getLeft() const { return left; }
+    std::unique_ptr<ExprNode>& getLeft() { return left; }
     const std::string& getOp() const { return op; }
     const std::unique_ptr<ExprNode>& getRight() const { return right; }
+    std::unique_ptr<ExprNode>& getRight() { return right; }
+
+    /**
+     * @brief Get the inline cache of this operation site, which is updated as the program runs.
+     * @return The inline cache.
+     */
+    InlineCache& getCache() const { return cache; }
 
 private:
     std::unique_ptr<ExprNode> right;
     const std::string op;
     std::unique_ptr<ExprNode> left;
+    mutable InlineCache cache;
+};
+
+/**
+ * @class TypedBinaryExprNode
+ * @brief Represents a binary operation whose operand types were proven by type inference.
+ *
+ * The node keeps the operator and operands of the BinaryExprNode it replaces, so passes that
+ * match binary expressions still recognise it, but it is evaluated without dispatching on the
+ * operand types.
+ */
+class TypedBinaryExprNode : public BinaryExprNode {
+public:
+    /**
+     * @brief Constructor for TypedBinaryExprNode.
+     * @param token The token associated with this binary expression node.
+     * @param left The left operand of the binary operation.
+     * @param op The operator of the binary operation.
+     * @param right The right operand of the binary operation.
+     * @param typedOp The specialised operation for the proven operand types.
+     */
+    TypedBinaryExprNode(const Token& token, std::unique_ptr<ExprNode> left, const std::string op, std::unique_ptr<ExprNode> right, TypedBinaryOp typedOp)
+        : BinaryExprNode(token, std::move(left), op, std::move(right)), typedOp(typedOp) {}
+
+    TypedBinaryOp getTypedOp() const { return typedOp; }
+
+private:
+    const TypedBinaryOp typedOp;
 };
 
 /**
@@ -79,6 +119,7 @@ public:
         : ExprNode(token), operand(std::move(operand)), op(op) {}
 
     const std::unique_ptr<ExprNode>& getOperand() const { return operand; }
+    std::unique_ptr<ExprNode>& getOperand() { return operand; }
     const std::string& getOp() const { return op; }
 
 private:
@@ -181,6 +222,48 @@ private:
     const std::string name;
 };
 
+/**
+ * @class VariableCompareNode
+ * @brief Represents a comparison of a variable with another variable or an int literal, such as `i < n`, fused by the optimiser.
+ *
+ * The node keeps the operands of the comparison it replaces. When both sides hold ints they are
+ * compared where they are stored, and any other types are compared like a BinaryExprNode.
+ */
+class VariableCompareNode : public BinaryExprNode {
+public:
+    /**
+     * @brief Constructor for VariableCompareNode.
+     * @param token The token associated with the comparison.
+     * @param left The variable on the left of the comparison.
+     * @param op The comparison operator.
+     * @param right The variable or int literal on the right of the comparison.
+     * @param intOp The int comparison for the operator, one of the INT_ comparisons of TypedBinaryOp.
+     */
+    VariableCompareNode(const Token& token, std::unique_ptr<VariableNode> left, const std::string op, std::unique_ptr<ExprNode> right, TypedBinaryOp intOp)
+        : BinaryExprNode(token, nullptr, op, nullptr), leftName(left->getName()), intOp(intOp) {
+        if (auto rightVariable = dynamic_cast<const VariableNode*>(right.get())) {
+            rightName = rightVariable->getName();
+        }
+        else {
+            constant = static_cast<const IntegerNode*>(right.get())->getValue();
+        }
+        getLeft() = std::move(left);
+        getRight() = std::move(right);
+    }
+
+    const std::string& getLeftName() const { return leftName; }
+    const std::string& getRightName() const { return rightName; }
+    bool hasConstant() const { return rightName.empty(); }
+    int getConstant() const { return constant; }
+    TypedBinaryOp getIntOp() const { return intOp; }
+
+private:
+    std::string leftName;
+    std::string rightName; ///< The variable on the right, or empty if the right side is the constant.
+    int constant = 0;
+    const TypedBinaryOp intOp;
+};
+
 /**
  * @class AssignNode
  * @brief Represents an assignment (e.g., "x = 1").
@@ -198,12 +281,59 @@ public:
 
     const std::string getName() const { return name; }
     const std::unique_ptr<ExprNode>& getValue() const { return value; }
+    std::unique_ptr<ExprNode>& getValue() { return value; }
 
 private:
     const std::string name;
     std::unique_ptr<ExprNode> value;
 };
 
+/**
+ * @class IncrementNode
+ * @brief Represents an assignment of the form `i = i + k` or `i = i - k` with an int literal k, fused by the optimiser.
+ *
+ * The node keeps the value expression of the assignment it replaces. An int variable is updated
+ * where it is stored, and a variable of any other type is assigned like an AssignNode.
+ */
+class IncrementNode : public AssignNode {
+public:
+    /**
+     * @brief Constructor for IncrementNode.
+     * @param token The token associated with this assignment.
+     * @param name The name of the variable being incremented.
+     * @param value The value expression of the original assignment.
+     * @param delta The amount added to the variable, negative for a subtraction.
+     */
+    IncrementNode(const Token& token, const std::string name, std::unique_ptr<ExprNode> value, int delta)
+        : AssignNode(token, name, std::move(value)), delta(delta) {}
+
+    int getDelta() const { return delta; }
+
+private:
+    const int delta;
+};
+
+/**
+ * @class UpdateAssignNode
+ * @brief Represents an assignment of the form `x = x op <expr>` with an arithmetic operator, fused by the optimiser.
+ *
+ * The value expression is the BinaryExprNode of the original assignment. The variable is read
+ * and written where it is stored instead of being copied out and assigned back.
+ */
+class UpdateAssignNode : public AssignNode {
+public:
+    /**
+     * @brief Constructor for UpdateAssignNode.
+     * @param token The token associated with this assignment.
+     * @param name The name of the variable being updated.
+     * @param operation The operation, whose left operand is the variable itself.
+     */
+    UpdateAssignNode(const Token& token, const std::string name, std::unique_ptr<BinaryExprNode> operation)
+        : AssignNode(token, name, std::move(operation)) {}
+
+    const BinaryExprNode* getOperation() const { return static_cast<const BinaryExprNode*>(getValue().get()); }
+};
+
 /**
  * @class PrintNode
  * @brief Represents a print statement node.
@@ -219,6 +349,7 @@ public:
         : ExprNode(token), expression(std::move(expression)) {}
 
     const std::unique_ptr<ExprNode>& getExpression() const { return expression; }
+    std::unique_ptr<ExprNode>& getExpression() { return expression; }
 
 private:
     std::unique_ptr<ExprNode> expression; ///< The expression to print
@@ -239,11 +370,25 @@ public:
         : ExprNode(token), expression(std::move(expression)) {}
 
     const std::unique_ptr<ExprNode>& getExpression() const { return expression; }
+    std::unique_ptr<ExprNode>& getExpression() { return expression; }
 
 private:
     std::unique_ptr<ExprNode> expression; ///< The expression for the input statement
 };
 
+/**
+ * @class FlushNode
+ * @brief Represents a flush statement node, which writes buffered output to its target.
+ */
+class FlushNode : public ExprNode {
+public:
+    /**
+     * @brief Constructor for FlushNode.
+     * @param token The token associated with this flush statement.
+     */
+    explicit FlushNode(const Token& token) : ExprNode(token) {}
+};
+
 /**
  * @class BlockNode
  * @brief Represents a block of statements.
@@ -267,6 +412,7 @@ public:
     BlockNode& operator=(BlockNode&&) = default;
 
     const std::vector<std::unique_ptr<ExprNode>>& getStatements() const { return statements; }
+    std::vector<std::unique_ptr<ExprNode>>& getStatements() { return statements; }
 
 private:
     std::vector<std::unique_ptr<ExprNode>> statements;
@@ -289,6 +435,7 @@ public:
 
     const std::string& getName() const { return name; }
     const std::vector<std::unique_ptr<ExprNode>>& getArgs() const { return args; }
+    std::vector<std::unique_ptr<ExprNode>>& getArgs() { return args; }
 
 private:
     const std::string name;
@@ -312,8 +459,11 @@ public:
         : ExprNode(token), condition(std::move(condition)), thenBlock(std::move(thenBlock)), elseBlock(std::move(elseBlock)) {}
 
     const std::unique_ptr<ExprNode>& getCondition() const { return condition; }
+    std::unique_ptr<ExprNode>& getCondition() { return condition; }
     const std::unique_ptr<BlockNode>& getThenBlock() const { return thenBlock; }
+    std::unique_ptr<BlockNode>& getThenBlock() { return thenBlock; }
     const std::unique_ptr<BlockNode>& getElseBlock() const { return elseBlock; }
+    std::unique_ptr<BlockNode>& getElseBlock() { return elseBlock; }
 
 private:
     std::unique_ptr<ExprNode> condition;
@@ -337,11 +487,55 @@ public:
         : ExprNode(token), condition(std::move(condition)), block(std::move(block)) {}
 
     const std::unique_ptr<ExprNode>& getCondition() const { return condition; }
+    std::unique_ptr<ExprNode>& getCondition() { return condition; }
     const std::unique_ptr<BlockNode>& getBlock() const { return block; }
+    std::unique_ptr<BlockNode>& getBlock() { return block; }
+
+    /**
+     * @brief Counts an iteration the interpreter finished without leaving the loop.
+     * @return The number of back edges counted so far, including this one.
+     */
+    size_t countBackEdge() const { return ++backEdges; }
+    size_t getBackEdges() const { return backEdges; }
 
 private:
     std::unique_ptr<ExprNode> condition;
     std::unique_ptr<BlockNode> block;
+    mutable size_t backEdges = 0; ///< Iterations the interpreter has run, which decide when the loop is compiled.
+};
+
+/**
+ * @class HoistedWhileNode
+ * @brief Represents a while loop whose loop-invariant expressions have been moved in front of it.
+ *
+ * The hoisted assignments store each invariant expression in a slot before the loop starts, and
+ * the loop reads the slots instead of computing the expressions on every iteration. The
+ * expressions are pure, but one may fail on a path the loop never takes, so if any of them fails
+ * the fallback, an unmodified copy of the loop, runs instead.
+ */
+class HoistedWhileNode : public ExprNode {
+public:
+    /**
+     * @brief Constructor for HoistedWhileNode.
+     * @param token The token of the original while loop.
+     * @param hoisted Assignments storing the invariant expressions in their slots.
+     * @param loop The loop reading the slots.
+     * @param fallback The loop as it was before the expressions were hoisted.
+     */
+    HoistedWhileNode(const Token& token, std::vector<std::unique_ptr<AssignNode>> hoisted, std::unique_ptr<ExprNode> loop, std::unique_ptr<ExprNode> fallback)
+        : ExprNode(token), hoisted(std::move(hoisted)), loop(std::move(loop)), fallback(std::move(fallback)) {}
+
+    const std::vector<std::unique_ptr<AssignNode>>& getHoisted() const { return hoisted; }
+    std::vector<std::unique_ptr<AssignNode>>& getHoisted() { return hoisted; }
+    const std::unique_ptr<ExprNode>& getLoop() const { return loop; }
+    std::unique_ptr<ExprNode>& getLoop() { return loop; }
+    const std::unique_ptr<ExprNode>& getFallback() const { return fallback; }
+    std::unique_ptr<ExprNode>& getFallback() { return fallback; }
+
+private:
+    std::vector<std::unique_ptr<AssignNode>> hoisted;
+    std::unique_ptr<ExprNode> loop;
+    std::unique_ptr<ExprNode> fallback;
 };
 
 /**
@@ -384,12 +578,29 @@ public:
 
     const std::string& getListName() const { return listName; }
     const std::unique_ptr<ExprNode>& getValue() const { return value; }
+    std::unique_ptr<ExprNode>& getValue() { return value; }
 
 private:
     const std::string listName;
     std::unique_ptr<ExprNode> value;
 };
 
+/**
+ * @class ListAppendInPlaceNode
+ * @brief Represents an append to a list that moves the value into the list stored in the variable, fused by the optimiser.
+ */
+class ListAppendInPlaceNode : public ListAppendNode {
+public:
+    /**
+     * @brief Constructor for ListAppendInPlaceNode.
+     * @param token The token associated with this list append operation.
+     * @param listName The name of the list.
+     * @param value The value to append to the list.
+     */
+    ListAppendInPlaceNode(const Token& token, const std::string& listName, std::unique_ptr<ExprNode> value)
+        : ListAppendNode(token, listName, std::move(value)) {}
+};
+
 /**
  * @class ListIndexNode
  * @brief Represents an indexing operation on a list.
@@ -407,12 +618,41 @@ public:
 
     const std::string& getListName() const { return listName; }
     const std::unique_ptr<ExprNode>& getIndex() const { return index; }
+    std::unique_ptr<ExprNode>& getIndex() { return index; }
 
 private:
     const std::string listName;
     std::unique_ptr<ExprNode> index;
 };
 
+/**
+ * @class ListSliceNode
+ * @brief Represents taking a slice `list[begin:end]` of a list, which shares the list's storage.
+ */
+class ListSliceNode : public ExprNode {
+public:
+    /**
+     * @brief Constructor for ListSliceNode.
+     * @param token The token associated with this slice operation.
+     * @param listName The name of the list.
+     * @param begin The index of the first element, or nullptr to start at the first element.
+     * @param end The index after the last element, or nullptr to end at the last element.
+     */
+    ListSliceNode(const Token& token, const std::string& listName, std::unique_ptr<ExprNode> begin, std::unique_ptr<ExprNode> end)
+        : ExprNode(token), listName(listName), begin(std::move(begin)), end(std::move(end)) {}
+
+    const std::string& getListName() const { return listName; }
+    const std::unique_ptr<ExprNode>& getBegin() const { return begin; }
+    std::unique_ptr<ExprNode>& getBegin() { return begin; }
+    const std::unique_ptr<ExprNode>& getEnd() const { return end; }
+    std::unique_ptr<ExprNode>& getEnd() { return end; }
+
+private:
+    const std::string listName;
+    std::unique_ptr<ExprNode> begin;
+    std::unique_ptr<ExprNode> end;
+};
+
 /**
  * @class ListLengthNode
  * @brief Represents an operation to get the length of a list.
@@ -450,12 +690,40 @@ public:
 
     const std::string& getListName() const { return listName; }
     const std::unique_ptr<ExprNode>& getIndex() const { return index; }
+    std::unique_ptr<ExprNode>& getIndex() { return index; }
 
 private:
     const std::string listName;
     std::unique_ptr<ExprNode> index;
 };
 
+/**
+ * @class ListMethodNode
+ * @brief Represents a call of a built-in list method such as sum, sort or contains.
+ */
+class ListMethodNode : public ExprNode {
+public:
+    /**
+     * @brief Constructor for ListMethodNode.
+     * @param token The token associated with this method call.
+     * @param listName The name of the list.
+     * @param method The method to call.
+     * @param argument The argument of the method, or nullptr for methods without one.
+     */
+    ListMethodNode(const Token& token, const std::string& listName, ListMethod method, std::unique_ptr<ExprNode> argument)
+        : ExprNode(token), listName(listName), method(method), argument(std::move(argument)) {}
+
+    const std::string& getListName() const { return listName; }
+    ListMethod getMethod() const { return method; }
+    const std::unique_ptr<ExprNode>& getArgument() const { return argument; }
+    std::unique_ptr<ExprNode>& getArgument() { return argument; }
+
+private:
+    const std::string listName;
+    const ListMethod method;
+    std::unique_ptr<ExprNode> argument;
+};
+
 /**
  * @class ListReplaceNode
  * @brief Represents an operation to replace an element in a list at a specified index with a new value.
@@ -474,7 +742,9 @@ public:
 
     const std::string& getListName() const { return listName; }
     const std::unique_ptr<ExprNode>& getIndex() const { return index; }
+    std::unique_ptr<ExprNode>& getIndex() { return index; }
     const std::unique_ptr<ExprNode>& getValue() const { return value; }
+    std::unique_ptr<ExprNode>& getValue() { return value; }
 
 private:
     const std::string listName;
@@ -482,6 +752,63 @@ private:
     std::unique_ptr<ExprNode> value;
 };
 
+/**
+ * @class MapInitNode
+ * @brief Represents the initialization of a map with specified key and value types.
+ */
+class MapInitNode : public ExprNode {
+public:
+    /**
+     * @brief Constructor for MapInitNode.
+     * @param token The token associated with this map initialization.
+     * @param name The name of the map.
+     * @param keyType The type of the keys in the map.
+     * @param valueType The type of the values in the map.
+     */
+    MapInitNode(const Token& token, const std::string& name, const std::string& keyType, const std::string& valueType)
+        : ExprNode(token), name(name), keyType(keyType), valueType(valueType) {}
+
+    const std::string& getName() const { return name; }
+    const std::string& getKeyType() const { return keyType; }
+    const std::string& getValueType() const { return valueType; }
+
+private:
+    const std::string name;
+    const std::string keyType;
+    const std::string valueType;
+};
+
+/**
+ * @class MapMethodNode
+ * @brief Represents a call of a built-in map method such as get, set or remove.
+ */
+class MapMethodNode : public ExprNode {
+public:
+    /**
+     * @brief Constructor for MapMethodNode.
+     * @param token The token associated with this method call.
+     * @param mapName The name of the map.
+     * @param method The method to call.
+     * @param key The key argument, or nullptr for methods without one.
+     * @param value The value argument of set, or nullptr for other methods.
+     */
+    MapMethodNode(const Token& token, const std::string& mapName, MapMethod method, std::unique_ptr<ExprNode> key, std::unique_ptr<ExprNode> value)
+        : ExprNode(token), mapName(mapName), method(method), key(std::move(key)), value(std::move(value)) {}
+
+    const std::string& getMapName() const { return mapName; }
+    MapMethod getMethod() const { return method; }
+    const std::unique_ptr<ExprNode>& getKey() const { return key; }
+    std::unique_ptr<ExprNode>& getKey() { return key; }
+    const std::unique_ptr<ExprNode>& getValue() const { return value; }
+    std::unique_ptr<ExprNode>& getValue() { return value; }
+
+private:
+    const std::string mapName;
+    const MapMethod method;
+    std::unique_ptr<ExprNode> key;
+    std::unique_ptr<ExprNode> value;
+};
+
 /**
  * @class TypeCastNode
  * @brief Represents a type cast operation (e.g., converting one type to another).
@@ -499,6 +826,7 @@ public:
 
     const std::string& getType() const { return type; }
     const std::unique_ptr<ExprNode>& getValue() const { return value; }
+    std::unique_ptr<ExprNode>& getValue() { return value; }
 
 private:
     const std::string type;
@@ -533,7 +861,8 @@ public:
     const std::string& getName() const { return name; }
     const std::string& getReturnType() const { return returnType; }
     const std::vector<std::pair<std::string, std::string>>& getParameters() const { return parameters; }
-    const std::unique_ptr<BlockNode>& getBody() const { return body; } // Return by reference for modification
+    const std::unique_ptr<BlockNode>& getBody() const { return body; }
+    std::unique_ptr<BlockNode>& getBody() { return body; } // Return by reference for modification
 
 private:
     std::string name;
@@ -557,7 +886,49 @@ public:
         : ExprNode(token), value(std::move(value)) {}
 
     const std::unique_ptr<ExprNode>& getValue() const { return value; }
+    std::unique_ptr<ExprNode>& getValue() { return value; }
 
 private:
     std::unique_ptr<ExprNode> value;
 };
+
+/**
+ * @class InlinedCallNode
+ * @brief Represents a call to a small function whose body has been expanded at the call site.
+ *
+ * Arguments that cannot be substituted directly are bound to caller-local slots by the
+ * binding assignments, which run in order before the expanded return expression.
+ */
+class InlinedCallNode : public ExprNode {
+public:
+    /**
+     * @brief Constructor for InlinedCallNode.
+     * @param token The token of the original function call.
+     * @param name The name of the inlined function.
+     * @param bindings Assignments binding arguments to caller-local slots.
+     * @param body The return expression of the function with parameters renamed.
+     * @param returnToken The token of the inlined return statement, used for error reporting.
+     * @param returnType The declared return type of the function.
+     * @param checkReturnType Whether the result type still has to be checked at runtime.
+     */
+    InlinedCallNode(const Token& token, const std::string& name, std::vector<std::unique_ptr<AssignNode>> bindings, std::unique_ptr<ExprNode> body,
+        const Token& returnToken, const std::string& returnType, bool checkReturnType)
+        : ExprNode(token), name(name), bindings(std::move(bindings)), body(std::move(body)), returnToken(returnToken), returnType(returnType), checkReturnType(checkReturnType) {}
+
+    const std::string& getName() const { return name; }
+    const std::vector<std::unique_ptr<AssignNode>>& getBindings() const { return bindings; }
+    std::vector<std::unique_ptr<AssignNode>>& getBindings() { return bindings; }
+    const std::unique_ptr<ExprNode>& getBody() const { return body; }
+    std::unique_ptr<ExprNode>& getBody() { return body; }
+    const Token& getReturnToken() const { return returnToken; }
+    const std::string& getReturnType() const { return returnType; }
+    bool needsReturnTypeCheck() const { return checkReturnType; }
+
+private:
+    const std::string name;
+    std::vector<std::unique_ptr<AssignNode>> bindings;
+    std::unique_ptr<ExprNode> body;
+    const Token returnToken;
+    const std::string returnType;
+    const bool checkReturnType;
+};
@@ -1,6 +1,53 @@
 #include "CodeGenerator/CodeGenerator.h"
 #include "Evaluator/Handler/FunctionHandler.h"
 #include "Value/ValueHelper.h"
+#include "Evaluator/Evaluator.h"
+#include "Utility/AllocationCounter.h"
+#include "JIT/JITRuntime.h"
+#include "Transpiler/CppTranspiler.h"
+#include <fstream>
+
+namespace {
+    // Adds the allocations made during an execution to the statistics, including when it fails
+    class AllocationScope {
+    public:
+        explicit AllocationScope(RuntimeStats* stats)
+            : stats(stats), allocations(AllocationCounter::allocations()), bytes(AllocationCounter::bytes()) {}
+
+        ~AllocationScope() {
+            if (stats) {
+                stats->allocations += AllocationCounter::allocations() - allocations;
+                stats->bytesAllocated += AllocationCounter::bytes() - bytes;
+            }
+        }
+
+    private:
+        RuntimeStats* stats;
+        uint64_t allocations;
+        uint64_t bytes;
+    };
+
+    // Collects the inline caches of the program and the functions it defined once an execution ends, including when it fails
+    class InlineCacheScope {
+    public:
+        InlineCacheScope(InlineCacheReport* report, const ExprNode* root, const std::unique_ptr<FunctionHandler>& functionHandler)
+            : report(report), root(root), functionHandler(functionHandler) {}
+
+        ~InlineCacheScope() {
+            if (report) {
+                report->collect(root);
+                for (const auto& function : functionHandler->getFunctions()) {
+                    report->collect(function.second->getBody().get());
+                }
+            }
+        }
+
+    private:
+        InlineCacheReport* report;
+        const ExprNode* root;
+        const std::unique_ptr<FunctionHandler>& functionHandler;
+    };
+}
 
 CodeGenerator::CodeGenerator() {
     functionHandler = std::make_unique<FunctionHandler>();
@@ -11,29 +58,85 @@ CodeGenerator::~CodeGenerator() {
 }
 
 void CodeGenerator::execute(const ExprNode* node) {
+    if (!emitPath.empty()) {
+        emit(node);
+        return;
+    }
     functionHandler = std::make_unique<FunctionHandler>();
-    if (auto blockNode = dynamic_cast<const BlockNode*>(node)) {
-        executeBlock(blockNode);
+    jit.reset();
+    // Native code does not count nodes, record samples or trace events, or fill inline caches, so those keep interpreting
+    if (jitOptions.enabled && JITRuntime::isSupported() && !profiler && !tracer && !stats && !inlineCaches) {
+        jit = std::make_unique<JITRuntime>(jitOptions, functionHandler->getFunctions());
+    }
+    AllocationScope allocationScope(stats.get());
+    InlineCacheScope inlineCacheScope(inlineCaches.get(), node, functionHandler);
+    Result<void> result;
+    if (profiler) {
+        // Attribute top-level code to a root frame so it appears in the report and the collapsed stacks
+        Profiler::FunctionScope scope(*profiler, "<main>");
+        result = executeBlockOrNode(node);
     }
     else {
-        evaluate(node, *this);
+        result = executeBlockOrNode(node);
+    }
+    // The runtime returns its errors, which leave the interpreter as exceptions like the front end's
+    if (!result.ok()) {
+        throw std::runtime_error(result.getError().message);
+    }
+}
+
+void CodeGenerator::emit(const ExprNode* node) {
+    auto program = dynamic_cast<const BlockNode*>(node);
+    if (!program) {
+        throw std::runtime_error("Emit Error: The program is not a block");
+    }
+    CppTranspiler transpiler;
+    std::string source = transpiler.transpile(program);
+    std::ofstream file(emitPath, std::ios::binary);
+    if (!file || !(file << source) || !file.flush()) {
+        throw std::runtime_error("Emit Error: Failed to write " + emitPath);
+    }
+}
+
+const RuntimeStats* CodeGenerator::getStats() {
+    if (stats) {
+        for (const auto& count : nodeCounts) {
+            stats->nodesByKind[nodeKindName(count.first)] += count.second;
+        }
+        nodeCounts.clear();
+    }
+    return stats.get();
+}
+
+Result<void> CodeGenerator::executeBlockOrNode(const ExprNode* node) {
+    if (auto blockNode = dynamic_cast<const BlockNode*>(node)) {
+        return executeBlock(blockNode);
+    }
+    Result<Value> value = evaluate(node, *this);
+    if (!value.ok()) {
+        return value.takeError();
     }
+    return {};
 }
 
-void CodeGenerator::executeBlock(const BlockNode* blockNode) {
+Result<void> CodeGenerator::executeBlock(const BlockNode* blockNode) {
     for (const auto& statement : blockNode->getStatements()) {
-        evaluate(statement.get(), *this);
+        Result<Value> value = evaluate(statement.get(), *this);
+        if (!value.ok()) {
+            return value.takeError();
+        }
     }
+    return {};
 }
 
-Value CodeGenerator::performBinaryOperation(const BinaryExprNode* binNode, const Value& left, const Value& right) {
+Result<Value> CodeGenerator::performBinaryOperation(const BinaryExprNode* binNode, const Value& left, const Value& right) {
     return OperationDispatcher::dispatchOperation(binNode, left, right);
 }
 
-Value CodeGenerator::performUnaryOperation(const Token& token, const std::string& op, const Value& operand) {
+Result<Value> CodeGenerator::performUnaryOperation(const Token& token, const std::string& op, const Value& operand) {
     return UnaryOperations::performUnaryOperation(token, op, operand);
 }
 
 void CodeGenerator::printValue(const Value& value) {
-    PrintOperations::printValue(value);
+    PrintOperations::printValue(value, output);
 }
\ No newline at end of file
@@ -6,13 +6,22 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <typeindex>
 #include <Value/Value.h>
 #include <AST/AST.h>
 #include "Operation/OperationDispatcher/OperationDispatcher.h"
 #include "Operation/UnaryOperations/UnaryOperations.h"
 #include "Utility/PrintOperations.h"
+#include "Utility/Profiler.h"
+#include "Utility/AllocationCounter.h"
+#include "Utility/InlineCacheReport.h"
+#include "Utility/TraceRecorder.h"
+#include "Structs/Optimizer/OptimizerOptions.h"
+#include "Structs/Stats/RuntimeStats.h"
+#include "Structs/JIT/JITOptions.h"
 
 class FunctionHandler;
+class JITRuntime;
 
 /**
  * @class CodeGenerator
@@ -23,6 +32,7 @@ public:
     /**
      * @brief Executes the AST and outputs the result.
      * @param root The root node of the AST.
+     * @throws std::runtime_error If the program fails, with the message of the error it failed with.
      */
     void execute(const ExprNode* root);
 
@@ -36,62 +46,209 @@ public:
      */
     ~CodeGenerator();
 
+    /**
+     * @brief Sets the options used to optimise programs before they are executed.
+     * @param options The optimiser options.
+     */
+    void setOptimizerOptions(const OptimizerOptions& options) { optimizerOptions = options; }
+
+    /**
+     * @brief Gets the options used to optimise programs before they are executed.
+     * @return A constant reference to the optimiser options.
+     */
+    const OptimizerOptions& getOptimizerOptions() const { return optimizerOptions; }
+
+    /**
+     * @brief Stores the diagnostics the optimiser produced for the program.
+     * @param report The report, empty if no pass was asked to report.
+     */
+    void setOptimizerReport(std::string report) { optimizerReport = std::move(report); }
+
+    /**
+     * @brief Gets the diagnostics the optimiser produced for the program.
+     * @return The report, empty if no pass was asked to report.
+     */
+    const std::string& getOptimizerReport() const { return optimizerReport; }
+
+    /**
+     * @brief Gets the buffer that program output is written to.
+     * @return A reference to the output buffer, which can be redirected to a file or memory.
+     */
+    OutputBuffer& getOutput() { return output; }
+
+    /**
+     * @brief Enables profiling of lines and functions for subsequent executions.
+     */
+    void enableProfiler() {
+        profiler = std::make_unique<Profiler>();
+        AllocationCounter::enable();
+    }
+
+    /**
+     * @brief Gets the profiler recording the executed program.
+     * @return A pointer to the profiler, or nullptr if profiling is disabled.
+     */
+    Profiler* getProfiler() const { return profiler.get(); }
+
+    /**
+     * @brief Sets the recorder that receives trace events for phases and function calls.
+     * @param recorder The recorder, which must outlive the execution, or nullptr to disable tracing.
+     */
+    void setTracer(TraceRecorder* recorder) { tracer = recorder; }
+
+    /**
+     * @brief Gets the recorder that receives trace events.
+     * @return A pointer to the recorder, or nullptr if tracing is disabled.
+     */
+    TraceRecorder* getTracer() const { return tracer; }
+
+    /**
+     * @brief Enables the runtime statistics counters for subsequent executions.
+     */
+    void enableStats() {
+        stats = std::make_unique<RuntimeStats>();
+        AllocationCounter::enable();
+    }
+
+    /**
+     * @brief Gets the runtime statistics gathered so far.
+     * @return A pointer to the statistics, or nullptr if statistics are disabled.
+     */
+    const RuntimeStats* getStats();
+
+    /**
+     * @brief Enables collecting the inline caches of binary operations after each execution.
+     */
+    void enableInlineCacheReport() { inlineCaches = std::make_unique<InlineCacheReport>(); }
+
+    /**
+     * @brief Gets the inline caches collected so far.
+     * @return A pointer to the collected caches, or nullptr if collecting is disabled.
+     */
+    const InlineCacheReport* getInlineCacheReport() const { return inlineCaches.get(); }
+
+    /**
+     * @brief Sets the options of the native code generator for subsequent executions.
+     * @param options The native code generator options.
+     */
+    void setJITOptions(const JITOptions& options) { jitOptions = options; }
+
+    /**
+     * @brief Gets the native code generator of the last execution.
+     * @return A pointer to the runtime, or nullptr if the last execution was interpreted only.
+     */
+    const JITRuntime* getJIT() const { return jit.get(); }
+
+    /**
+     * @brief Makes subsequent executions translate the program to C++ instead of running it.
+     * @param path The file the C++ translation unit is written to, or empty to run programs again.
+     */
+    void setEmitPath(const std::string& path) { emitPath = path; }
+
+    /**
+     * @brief Gets the file programs are translated to instead of being run.
+     * @return The path, or empty if programs are run.
+     */
+    const std::string& getEmitPath() const { return emitPath; }
+
 private:
     std::unordered_map<std::string, Value> variables;
     std::unique_ptr<FunctionHandler> functionHandler;
+    OptimizerOptions optimizerOptions;
+    std::string optimizerReport;
+    OutputBuffer output;
+    std::unique_ptr<Profiler> profiler;
+    TraceRecorder* tracer = nullptr;
+    std::unique_ptr<RuntimeStats> stats;
+    std::unique_ptr<InlineCacheReport> inlineCaches;
+    JITOptions jitOptions;
+    std::unique_ptr<JITRuntime> jit; ///< Compiles hot functions and loops, or null if the execution is interpreted only.
+    std::string emitPath; ///< File the program is translated to instead of being run, or empty.
+    std::unordered_map<std::type_index, uint64_t> nodeCounts; ///< Node counts by type, folded into stats on request.
 
     /**
      * @brief Executes a block of statements.
      * @param blockNode The block node containing the statements.
+     * @return The error of the first statement that fails, if any.
+     */
+    Result<void> executeBlock(const BlockNode* blockNode);
+
+    /**
+     * @brief Translates a program to C++ and writes it to the emit path.
+     * @param node The root node of the program.
+     * @throws std::runtime_error If the program cannot be translated or the file cannot be written.
+     */
+    void emit(const ExprNode* node);
+
+    /**
+     * @brief Executes a node, running its statements directly if it is a block.
+     * @param node The node to execute.
+     * @return The error of the first statement that fails, if any.
      */
-    void executeBlock(const BlockNode* blockNode);
+    Result<void> executeBlockOrNode(const ExprNode* node);
 
     /**
      * @brief Performs a binary operation based on the given binary expression node.
      * @param binNode Pointer to the binary expression node.
      * @param left The left operand value.
      * @param right The right operand value.
-     * @return The result of the binary operation.
+     * @return The result of the binary operation, or the error it failed with.
      */
-    Value performBinaryOperation(const BinaryExprNode* binNode, const Value& left, const Value& right);
+    Result<Value> performBinaryOperation(const BinaryExprNode* binNode, const Value& left, const Value& right);
 
     /**
      * @brief Performs a unary operation based on the given token and operand.
      * @param token The token representing the unary operator.
      * @param op The unary operator as a string.
      * @param operand The operand value.
-     * @return The result of the unary operation.
+     * @return The result of the unary operation, or the error it failed with.
      */
-    Value performUnaryOperation(const Token& token, const std::string& op, const Value& operand);
+    Result<Value> performUnaryOperation(const Token& token, const std::string& op, const Value& operand);
 
     /**
-     * @brief Prints the given value to the standard output.
+     * @brief Prints the given value to the output buffer.
      * @param value The value to be printed.
      */
     void printValue(const Value& value);
 
     // Grant access to private members
-    friend Value evaluate(const ExprNode* node, CodeGenerator& generator);
-    friend Value evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode);
-    friend Value evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode);
-    friend Value evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode);
-    friend Value evaluateListAppendNode(CodeGenerator& generator, const ListAppendNode* listAppendNode);
-    friend Value evaluateListPopNode(CodeGenerator& generator, const ListPopNode* listPopNode);
-    friend Value evaluateListLengthNode(CodeGenerator& generator, const ListLengthNode* listLengthNode);
-    friend Value evaluateListIndexNode(CodeGenerator& generator, const ListIndexNode* listIndexNode);
-    friend Value evaluateListReplaceNode(CodeGenerator& generator, const ListReplaceNode* listReplaceNode);
-    friend Value evaluateBinaryExprNode(CodeGenerator& generator, const BinaryExprNode* binNode);
-    friend Value evaluateUnaryExprNode(CodeGenerator& generator, const UnaryExprNode* unNode);
-    friend Value evaluatePrintNode(CodeGenerator& generator, const PrintNode* prNode);
-    friend Value evaluateInputNode(CodeGenerator& generator, const InputNode* inNode);
-    friend Value evaluateIfNode(CodeGenerator& generator, const IfNode* ifNode);
-    friend Value evaluateWhileNode(CodeGenerator& generator, const WhileNode* whileNode);
-    friend Value evaluateBlockNode(CodeGenerator& generator, const BlockNode* blockNode);
-    friend Value evaluateTypeCastNode(CodeGenerator& generator, const TypeCastNode* typeCastNode);
-    friend Value evaluateFunctionCallNode(CodeGenerator& generator, const FunctionCallNode* functionCallNode);
-    friend Value evaluateFunctionDefNode(CodeGenerator& generator, const FunctionDefNode* functionDefNode);
-    friend Value evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode);
-    friend Value getListValue(CodeGenerator& generator, const std::string& name, const Token& token);
+    friend Result<Value> evaluate(const ExprNode* node, CodeGenerator& generator);
+    friend Result<Value> evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode);
+    friend Result<Value> evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode);
+    friend Value* findAppendTarget(CodeGenerator& generator, const AssignNode* assignNode);
+    friend Result<Value> appendToString(CodeGenerator& generator, const AssignNode* assignNode, Value& target);
+    friend Result<Value> evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode);
+    friend Result<Value> evaluateListAppendNode(CodeGenerator& generator, const ListAppendNode* listAppendNode);
+    friend Result<Value> evaluateListPopNode(CodeGenerator& generator, const ListPopNode* listPopNode);
+    friend Result<Value> evaluateListLengthNode(CodeGenerator& generator, const ListLengthNode* listLengthNode);
+    friend Result<Value> evaluateListIndexNode(CodeGenerator& generator, const ListIndexNode* listIndexNode);
+    friend Result<Value> evaluateListReplaceNode(CodeGenerator& generator, const ListReplaceNode* listReplaceNode);
+    friend Result<Value> evaluateListSliceNode(CodeGenerator& generator, const ListSliceNode* listSliceNode);
+    friend Result<Value> evaluateListMethodNode(CodeGenerator& generator, const ListMethodNode* listMethodNode);
+    friend Result<Value> evaluateMapInitNode(CodeGenerator& generator, const MapInitNode* mapNode);
+    friend Result<Value> evaluateMapMethodNode(CodeGenerator& generator, const MapMethodNode* mapMethodNode);
+    friend Result<Value> evaluateBinaryExprNode(CodeGenerator& generator, const BinaryExprNode* binNode);
+    friend Result<Value> evaluateTypedBinaryExprNode(CodeGenerator& generator, const TypedBinaryExprNode* typedNode);
+    friend Result<Value> evaluateUnaryExprNode(CodeGenerator& generator, const UnaryExprNode* unNode);
+    friend Result<Value> evaluatePrintNode(CodeGenerator& generator, const PrintNode* prNode);
+    friend Result<Value> evaluateInputNode(CodeGenerator& generator, const InputNode* inNode);
+    friend Result<Value> evaluateFlushNode(CodeGenerator& generator, const FlushNode* flushNode);
+    friend Result<Value> evaluateIfNode(CodeGenerator& generator, const IfNode* ifNode);
+    friend Result<Value> evaluateWhileNode(CodeGenerator& generator, const WhileNode* whileNode);
+    friend Result<Value> evaluateHoistedWhileNode(CodeGenerator& generator, const HoistedWhileNode* hoistedNode);
+    friend Result<Value> evaluateBlockNode(CodeGenerator& generator, const BlockNode* blockNode);
+    friend Result<Value> evaluateTypeCastNode(CodeGenerator& generator, const TypeCastNode* typeCastNode);
+    friend Result<Value> evaluateFunctionCallNode(CodeGenerator& generator, const FunctionCallNode* functionCallNode);
+    friend Result<Value> evaluateFunctionDefNode(CodeGenerator& generator, const FunctionDefNode* functionDefNode);
+    friend Result<Value> evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode);
+    friend Result<Value> getListValue(CodeGenerator& generator, const std::string& name, const Token& token);
+    friend Value* findVariableSlot(CodeGenerator& generator, const std::string& name);
+    friend Value* findAssignmentSlot(CodeGenerator& generator, const std::string& name);
+    friend Result<Value> evaluateIncrementNode(CodeGenerator& generator, const IncrementNode* incrementNode);
+    friend Result<Value> evaluateUpdateAssignNode(CodeGenerator& generator, const UpdateAssignNode* updateNode);
+    friend Result<Value> evaluateVariableCompareNode(CodeGenerator& generator, const VariableCompareNode* compareNode);
+    friend Result<Value> evaluateListAppendInPlaceNode(CodeGenerator& generator, const ListAppendInPlaceNode* appendNode);
 
     friend class FunctionNodeEvaluator;
+    friend class FunctionHandler;
 };
@@ -1,10 +1,24 @@
 #include "ControlFlowEvaluator.h"
+#include "CodeGenerator/Evaluator/Handler/FunctionHandler.h"
+#include "CodeGenerator/JIT/JITRuntime.h"
 
-Value evaluateIfNode(CodeGenerator& generator, const IfNode* ifNode) {
-    Value condition = evaluate(ifNode->getCondition().get(), generator);
+// Evaluates the condition of an if or while statement, which must be a bool
+static Result<bool> evaluateCondition(CodeGenerator& generator, const ExprNode* condition) {
+    Result<Value> value = evaluate(condition, generator);
+    if (!value.ok()) {
+        return value.takeError();
+    }
+    return ValueHelper::asBool(*value);
+}
+
+Result<Value> evaluateIfNode(CodeGenerator& generator, const IfNode* ifNode) {
+    Result<bool> condition = evaluateCondition(generator, ifNode->getCondition().get());
+    if (!condition.ok()) {
+        return condition.takeError();
+    }
     auto thenBlock = ifNode->getThenBlock().get();
     auto elseBlock = ifNode->getElseBlock().get();
-    if (ValueHelper::asBool(condition)) {
+    if (*condition) {
         return evaluate(thenBlock, generator);
     }
     else if (elseBlock) {
@@ -13,25 +27,81 @@ Value evaluateIfNode(CodeGenerator& generator, const IfNode* ifNode) {
     return std::monostate();
 }
 
-Value evaluateWhileNode(CodeGenerator& generator, const WhileNode* whileNode) {
-    while (ValueHelper::asBool(evaluate(whileNode->getCondition().get(), generator))) {
+Result<Value> evaluateWhileNode(CodeGenerator& generator, const WhileNode* whileNode) {
+    // Hot loops of the program body run natively when they can be compiled for the current types of their globals
+    JITRuntime* jit = generator.functionHandler->currentFunctionContext.empty() ? generator.jit.get() : nullptr;
+    if (jit && jit->isHot(whileNode)) {
+        Result<bool> ran = jit->runLoop(whileNode, generator.variables);
+        if (!ran.ok()) {
+            return ran.takeError();
+        }
+        if (*ran) {
+            return std::monostate();
+        }
+    }
+    const ExprNode* conditionNode = whileNode->getCondition().get();
+    while (true) {
+        Result<bool> condition = evaluateCondition(generator, conditionNode);
+        if (!condition.ok()) {
+            return condition.takeError();
+        }
+        if (!*condition) {
+            break;
+        }
         for (const auto& statement : whileNode->getBlock()->getStatements()) {
-            evaluate(statement.get(), generator);
-            auto condition = evaluate(whileNode->getCondition().get(), generator);
-            bool isTrue = ValueHelper::asBool(condition);
-            if (!ValueHelper::asBool(evaluate(whileNode->getCondition().get(), generator))) {
+            Result<Value> value = evaluate(statement.get(), generator);
+            if (!value.ok()) {
+                return value;
+            }
+            // The condition is evaluated twice after each statement, which programs can observe through calls
+            Result<bool> checked = evaluateCondition(generator, conditionNode);
+            if (!checked.ok()) {
+                return checked.takeError();
+            }
+            condition = evaluateCondition(generator, conditionNode);
+            if (!condition.ok()) {
+                return condition.takeError();
+            }
+            if (!*condition) {
                 break;
             }
         }
-        if (!ValueHelper::asBool(evaluate(whileNode->getCondition().get(), generator))) {
+        condition = evaluateCondition(generator, conditionNode);
+        if (!condition.ok()) {
+            return condition.takeError();
+        }
+        if (!*condition) {
             break;
         }
+        // A loop that becomes hot while it runs continues natively, from the condition test that starts the next iteration
+        if (jit && jit->countBackEdge(whileNode)) {
+            Result<bool> ran = jit->runLoop(whileNode, generator.variables, true);
+            if (!ran.ok()) {
+                return ran.takeError();
+            }
+            if (*ran) {
+                return std::monostate();
+            }
+        }
     }
     return std::monostate();
 }
 
-Value evaluateBlockNode(CodeGenerator& generator, const BlockNode* blockNode)
+Result<Value> evaluateHoistedWhileNode(CodeGenerator& generator, const HoistedWhileNode* hoistedNode) {
+    for (const auto& assignment : hoistedNode->getHoisted()) {
+        Result<Value> value = evaluate(assignment.get(), generator);
+        if (!value.ok()) {
+            return evaluate(hoistedNode->getFallback().get(), generator);
+        }
+    }
+    return evaluate(hoistedNode->getLoop().get(), generator);
+}
+
+Result<Value> evaluateBlockNode(CodeGenerator& generator, const BlockNode* blockNode)
 {
-    generator.executeBlock(blockNode);
+    Result<void> result = generator.executeBlock(blockNode);
+    if (!result.ok()) {
+        return result.takeError();
+    }
     return std::monostate();
 }
@@ -7,22 +7,35 @@
  * @brief Evaluates an if-node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param ifNode The if-node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateIfNode(CodeGenerator& generator, const IfNode* ifNode);
+Result<Value> evaluateIfNode(CodeGenerator& generator, const IfNode* ifNode);
 
 /**
  * @brief Evaluates a while-node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param whileNode The while-node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateWhileNode(CodeGenerator& generator, const WhileNode* whileNode);
+Result<Value> evaluateWhileNode(CodeGenerator& generator, const WhileNode* whileNode);
+
+/**
+ * @brief Evaluates a while loop whose invariant expressions were hoisted in front of it.
+ *
+ * The hoisted expressions are evaluated first. They are pure, so evaluating them early can only
+ * be observed through an error, and if one fails the unmodified copy of the loop runs instead.
+ * It reports the error only if the loop actually reaches the expression.
+ *
+ * @param generator The code generator used for evaluating the node.
+ * @param hoistedNode The hoisted loop to evaluate.
+ * @return The result of the evaluation, or the error it failed with.
+ */
+Result<Value> evaluateHoistedWhileNode(CodeGenerator& generator, const HoistedWhileNode* hoistedNode);
 
 /**
  * @brief Evaluates a block-node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param blockNode The block-node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateBlockNode(CodeGenerator& generator, const BlockNode* blockNode);
+Result<Value> evaluateBlockNode(CodeGenerator& generator, const BlockNode* blockNode);
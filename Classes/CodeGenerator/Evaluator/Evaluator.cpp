@@ -1,13 +1,51 @@
 #include "CodeGenerator/Evaluator/Evaluator.h"
-#include <stdexcept>
+#include <unordered_map>
 #include "CodeGenerator/Evaluator/Function/FunctionNodeEvaluator.h"
 #include "CodeGenerator/Evaluator/Function/ReturnNodeEvaluator.h"
+#include "CodeGenerator/Evaluator/Function/InlinedCallNodeEvaluator.h"
 
-Value evaluate(const ExprNode* node, CodeGenerator& generator) {
+// Dispatches a node to the evaluator for its type
+static Result<Value> evaluateNode(const ExprNode* node, CodeGenerator& generator);
+
+Result<Value> evaluate(const ExprNode* node, CodeGenerator& generator) {
     if (!node) {
         return std::monostate();
     }
 
+    if (generator.stats) {
+        ++generator.nodeCounts[typeid(*node)];
+    }
+
+    // A single branch keeps the cost negligible when profiling is disabled
+    if (generator.profiler) {
+        Profiler::LineScope scope(*generator.profiler, node->getToken().line);
+        return evaluateNode(node, generator);
+    }
+    return evaluateNode(node, generator);
+}
+
+static Result<Value> evaluateNode(const ExprNode* node, CodeGenerator& generator) {
+    // Binary operations are the most frequent nodes in hot loops, so they are matched by their exact type first
+    const std::type_info& type = typeid(*node);
+    if (type == typeid(TypedBinaryExprNode)) {
+        return evaluateTypedBinaryExprNode(generator, static_cast<const TypedBinaryExprNode*>(node));
+    }
+    if (type == typeid(BinaryExprNode)) {
+        return evaluateBinaryExprNode(generator, static_cast<const BinaryExprNode*>(node));
+    }
+    // Fused statements and conditions are the other nodes that dominate hot loops
+    if (type == typeid(VariableCompareNode)) {
+        return evaluateVariableCompareNode(generator, static_cast<const VariableCompareNode*>(node));
+    }
+    if (type == typeid(IncrementNode)) {
+        return evaluateIncrementNode(generator, static_cast<const IncrementNode*>(node));
+    }
+    if (type == typeid(UpdateAssignNode)) {
+        return evaluateUpdateAssignNode(generator, static_cast<const UpdateAssignNode*>(node));
+    }
+    if (type == typeid(ListAppendInPlaceNode)) {
+        return evaluateListAppendInPlaceNode(generator, static_cast<const ListAppendInPlaceNode*>(node));
+    }
     if (auto strNode = dynamic_cast<const StringNode*>(node)) {
         return evaluateStringNode(strNode);
     }
@@ -38,9 +76,21 @@ Value evaluate(const ExprNode* node, CodeGenerator& generator) {
     else if (auto listIndexNode = dynamic_cast<const ListIndexNode*>(node)) {
         return evaluateListIndexNode(generator, listIndexNode);
     }
+    else if (auto listSliceNode = dynamic_cast<const ListSliceNode*>(node)) {
+        return evaluateListSliceNode(generator, listSliceNode);
+    }
     else if (auto listReplaceNode = dynamic_cast<const ListReplaceNode*>(node)) {
         return evaluateListReplaceNode(generator, listReplaceNode);
     }
+    else if (auto listMethodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        return evaluateListMethodNode(generator, listMethodNode);
+    }
+    else if (auto mapNode = dynamic_cast<const MapInitNode*>(node)) {
+        return evaluateMapInitNode(generator, mapNode);
+    }
+    else if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        return evaluateMapMethodNode(generator, mapMethodNode);
+    }
     else if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
         return evaluateAssignNode(generator, assignNode);
     }
@@ -56,6 +106,9 @@ Value evaluate(const ExprNode* node, CodeGenerator& generator) {
     else if (auto inNode = dynamic_cast<const InputNode*>(node)) {
         return evaluateInputNode(generator, inNode);
     }
+    else if (auto flushNode = dynamic_cast<const FlushNode*>(node)) {
+        return evaluateFlushNode(generator, flushNode);
+    }
     else if (auto ifNode = dynamic_cast<const IfNode*>(node)) {
         return evaluateIfNode(generator, ifNode);
     }
@@ -79,6 +132,54 @@ Value evaluate(const ExprNode* node, CodeGenerator& generator) {
     else if (auto returnNode = dynamic_cast<const ReturnNode*>(node)) {
 		return evaluateReturnNode(generator, returnNode);
 	}
+    else if (auto inlinedCallNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        return evaluateInlinedCallNode(generator, inlinedCallNode);
+    }
+    else if (auto hoistedWhileNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+        return evaluateHoistedWhileNode(generator, hoistedWhileNode);
+    }
+
+    return RuntimeError{ "Syntax Error: Unsupported node type at line " + std::to_string(node->getToken().line) };
+}
 
-    throw std::runtime_error("Syntax Error: Unsupported node type at line " + std::to_string(node->getToken().line));
-}
\ No newline at end of file
+const char* nodeKindName(const std::type_index& type) {
+    static const std::unordered_map<std::type_index, const char*> names = {
+        { typeid(StringNode), "StringNode" },
+        { typeid(DoubleNode), "DoubleNode" },
+        { typeid(BooleanNode), "BooleanNode" },
+        { typeid(IntegerNode), "IntegerNode" },
+        { typeid(VariableNode), "VariableNode" },
+        { typeid(ListInitNode), "ListInitNode" },
+        { typeid(ListAppendNode), "ListAppendNode" },
+        { typeid(ListAppendInPlaceNode), "ListAppendInPlaceNode" },
+        { typeid(ListPopNode), "ListPopNode" },
+        { typeid(ListLengthNode), "ListLengthNode" },
+        { typeid(ListIndexNode), "ListIndexNode" },
+        { typeid(ListReplaceNode), "ListReplaceNode" },
+        { typeid(ListSliceNode), "ListSliceNode" },
+        { typeid(ListMethodNode), "ListMethodNode" },
+        { typeid(MapInitNode), "MapInitNode" },
+        { typeid(MapMethodNode), "MapMethodNode" },
+        { typeid(AssignNode), "AssignNode" },
+        { typeid(IncrementNode), "IncrementNode" },
+        { typeid(UpdateAssignNode), "UpdateAssignNode" },
+        { typeid(BinaryExprNode), "BinaryExprNode" },
+        { typeid(TypedBinaryExprNode), "TypedBinaryExprNode" },
+        { typeid(VariableCompareNode), "VariableCompareNode" },
+        { typeid(UnaryExprNode), "UnaryExprNode" },
+        { typeid(PrintNode), "PrintNode" },
+        { typeid(InputNode), "InputNode" },
+        { typeid(FlushNode), "FlushNode" },
+        { typeid(IfNode), "IfNode" },
+        { typeid(WhileNode), "WhileNode" },
+        { typeid(HoistedWhileNode), "HoistedWhileNode" },
+        { typeid(BlockNode), "BlockNode" },
+        { typeid(TypeCastNode), "TypeCastNode" },
+        { typeid(FunctionDefNode), "FunctionDefNode" },
+        { typeid(FunctionCallNode), "FunctionCallNode" },
+        { typeid(ReturnNode), "ReturnNode" },
+        { typeid(InlinedCallNode), "InlinedCallNode" },
+    };
+    auto it = names.find(type);
+    return it != names.end() ? it->second : "Unknown";
+}
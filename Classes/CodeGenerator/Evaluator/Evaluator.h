@@ -1,4 +1,5 @@
 #pragma once
+#include <typeindex>
 #include "CodeGenerator/CodeGenerator.h"
 #include "CodeGenerator/Evaluator/Primitive/PrimitiveNodeEvaluator.h"
 
@@ -10,9 +11,18 @@
  * statements, type casts, function definitions, and function calls. It delegates the evaluation
  * to specific functions based on the type of node.
  *
+ * A failure is returned rather than thrown.
+ *
  * @param node Pointer to the expression node to be evaluated.
  * @param generator Reference to the CodeGenerator.
- * @return The evaluated value of the expression node.
- * @throws std::runtime_error if the node type is unsupported or if there is a syntax error.
+ * @return The evaluated value of the expression node, or the error if the node type is unsupported,
+ * there is a syntax error or the evaluation fails.
+ */
+Result<Value> evaluate(const ExprNode* node, CodeGenerator& generator);
+
+/**
+ * @brief Gets the class name of an AST node type for reports.
+ * @param type The dynamic type of the node.
+ * @return The class name, or "Unknown" for types the evaluator does not dispatch.
  */
-Value evaluate(const ExprNode* node, CodeGenerator& generator);
\ No newline at end of file
+const char* nodeKindName(const std::type_index& type);
\ No newline at end of file
@@ -1,44 +1,109 @@
 #include "ExpressionNodeEvaluator.h"
 
-Value evaluateBinaryExprNode(CodeGenerator& generator, const BinaryExprNode* binNode) {
-    Value left = evaluate(binNode->getLeft().get(), generator);
-    Value right = evaluate(binNode->getRight().get(), generator);
-    return generator.performBinaryOperation(binNode, left, right);
+Result<Value> evaluateBinaryExprNode(CodeGenerator& generator, const BinaryExprNode* binNode) {
+    Result<Value> leftResult = evaluate(binNode->getLeft().get(), generator);
+    if (!leftResult.ok()) {
+        return leftResult;
+    }
+    Result<Value> rightResult = evaluate(binNode->getRight().get(), generator);
+    if (!rightResult.ok()) {
+        return rightResult;
+    }
+    Value& left = *leftResult;
+    Value& right = *rightResult;
+
+    // Operands of the types this site saw last go straight to the cached kernel
+    InlineCache& cache = binNode->getCache();
+    if (cache.state == InlineCache::State::MONOMORPHIC && left.index() == cache.leftType && right.index() == cache.rightType) {
+        cache.hits++;
+        return cache.kernel(binNode->getToken(), left, right);
+    }
+    return OperationDispatcher::dispatchMiss(binNode, left, right);
+}
+
+Result<Value> evaluateTypedBinaryExprNode(CodeGenerator& generator, const TypedBinaryExprNode* typedNode) {
+    Result<Value> leftResult = evaluate(typedNode->getLeft().get(), generator);
+    if (!leftResult.ok()) {
+        return leftResult;
+    }
+    Result<Value> rightResult = evaluate(typedNode->getRight().get(), generator);
+    if (!rightResult.ok()) {
+        return rightResult;
+    }
+    Value& left = *leftResult;
+    Value& right = *rightResult;
+    const Token& token = typedNode->getToken();
+
+    switch (typedNode->getTypedOp()) {
+        case TypedBinaryOp::INT_ADD: return ArithmeticOperations::intAdd(token, left, right);
+        case TypedBinaryOp::INT_SUB: return ArithmeticOperations::intSubtract(token, left, right);
+        case TypedBinaryOp::INT_MUL: return ArithmeticOperations::intMultiply(token, left, right);
+        case TypedBinaryOp::INT_DIV: return ArithmeticOperations::intDivide(token, left, right);
+        case TypedBinaryOp::INT_MOD: return ArithmeticOperations::intModulo(token, left, right);
+        case TypedBinaryOp::DOUBLE_ADD: return ArithmeticOperations::numberAdd(token, left, right);
+        case TypedBinaryOp::DOUBLE_SUB: return ArithmeticOperations::numberSubtract(token, left, right);
+        case TypedBinaryOp::DOUBLE_MUL: return ArithmeticOperations::numberMultiply(token, left, right);
+        case TypedBinaryOp::DOUBLE_DIV: return ArithmeticOperations::numberDivide(token, left, right);
+        case TypedBinaryOp::DOUBLE_MOD: return ArithmeticOperations::numberModulo(token, left, right);
+        case TypedBinaryOp::INT_EQUAL: return ComparisonOperations::intEqual(token, left, right);
+        case TypedBinaryOp::INT_NOT_EQUAL: return ComparisonOperations::intNotEqual(token, left, right);
+        case TypedBinaryOp::INT_LESS: return ComparisonOperations::intLess(token, left, right);
+        case TypedBinaryOp::INT_LESS_EQUAL: return ComparisonOperations::intLessEqual(token, left, right);
+        case TypedBinaryOp::INT_GREATER: return ComparisonOperations::intGreater(token, left, right);
+        case TypedBinaryOp::INT_GREATER_EQUAL: return ComparisonOperations::intGreaterEqual(token, left, right);
+        case TypedBinaryOp::DOUBLE_EQUAL: return ComparisonOperations::numberEqual(token, left, right);
+        case TypedBinaryOp::DOUBLE_NOT_EQUAL: return ComparisonOperations::numberNotEqual(token, left, right);
+        case TypedBinaryOp::DOUBLE_LESS: return ComparisonOperations::numberLess(token, left, right);
+        case TypedBinaryOp::DOUBLE_LESS_EQUAL: return ComparisonOperations::numberLessEqual(token, left, right);
+        case TypedBinaryOp::DOUBLE_GREATER: return ComparisonOperations::numberGreater(token, left, right);
+        case TypedBinaryOp::DOUBLE_GREATER_EQUAL: return ComparisonOperations::numberGreaterEqual(token, left, right);
+        case TypedBinaryOp::STRING_CONCAT: return StringOperations::concatenate(token, left, right);
+        case TypedBinaryOp::STRING_EQUAL: return ComparisonOperations::stringEqual(token, left, right);
+        case TypedBinaryOp::STRING_NOT_EQUAL: return ComparisonOperations::stringNotEqual(token, left, right);
+        case TypedBinaryOp::BOOL_EQUAL: return ComparisonOperations::boolEqual(token, left, right);
+        case TypedBinaryOp::BOOL_NOT_EQUAL: return ComparisonOperations::boolNotEqual(token, left, right);
+        case TypedBinaryOp::BOOL_AND: return LogicalOperations::boolAnd(token, left, right);
+        case TypedBinaryOp::BOOL_OR: return LogicalOperations::boolOr(token, left, right);
+    }
+    return generator.performBinaryOperation(typedNode, left, right);
 }
 
-Value evaluateUnaryExprNode(CodeGenerator& generator, const UnaryExprNode* unNode) {
-    Value operand = evaluate(unNode->getOperand().get(), generator);
-    return generator.performUnaryOperation(unNode->getToken(), unNode->getOp(), operand);
+Result<Value> evaluateUnaryExprNode(CodeGenerator& generator, const UnaryExprNode* unNode) {
+    Result<Value> operand = evaluate(unNode->getOperand().get(), generator);
+    if (!operand.ok()) {
+        return operand;
+    }
+    return generator.performUnaryOperation(unNode->getToken(), unNode->getOp(), *operand);
 }
 
-Value evaluateTypeCastNode(CodeGenerator& generator, const TypeCastNode* typeCastNode) {
-    Value value = evaluate(typeCastNode->getValue().get(), generator);
-    std::string valType = ValueHelper::type(value);
+Result<Value> evaluateTypeCastNode(CodeGenerator& generator, const TypeCastNode* typeCastNode) {
+    Result<Value> evaluated = evaluate(typeCastNode->getValue().get(), generator);
+    if (!evaluated.ok()) {
+        return evaluated;
+    }
+    const Value& value = *evaluated;
     std::string type = typeCastNode->getType();
-    std::string line = std::to_string(typeCastNode->getToken().line);
-    try {
-        if (type == "int") {
-            if (valType == "string") {
-                return ValueHelper::asInt(value);
-            }
-        }
-        else if (type == "double") {
-            return ValueHelper::asDouble(value);
-        }
-        else if (type == "bool") {
-            return ValueHelper::asBool(value);
-        }
-        else if (type == "string") {
-            return ValueHelper::asString(value);
-        }
-        else {
-            throw;
-        }
-    }
-    catch (const std::runtime_error& e) {
-		throw std::runtime_error("Type Cast Error: " + std::string(e.what()) + " at line " + line);
-	}
-    catch (const std::exception& e) {
-		throw std::runtime_error("Type Cast Error: Invalid type cast with exception " + std::string(e.what()) + " at line " + line);
-	}
+    Result<Value> result = std::monostate();
+    if (type == "int" && ValueHelper::isString(value)) {
+        result = ValueHelper::asInt(value);
+    }
+    else if (type == "double") {
+        result = ValueHelper::asDouble(value);
+    }
+    else if (type == "bool") {
+        result = ValueHelper::asBool(value);
+    }
+    else if (type == "string") {
+        result = ValueHelper::asString(value);
+    }
+    else {
+        // Only strings are converted to int
+        const Token& token = typeCastNode->getToken();
+        return RuntimeError{ "Type Cast Error: Cannot cast " + ValueHelper::type(value) + " to " + type + " at line " + std::to_string(token.line) };
+    }
+    if (!result.ok()) {
+        const Token& token = typeCastNode->getToken();
+        return RuntimeError{ "Type Cast Error: " + result.getError().message + " at line " + std::to_string(token.line) };
+    }
+    return result;
 }
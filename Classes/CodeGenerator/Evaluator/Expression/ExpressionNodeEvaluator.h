@@ -8,38 +8,46 @@
  * @brief Evaluates a binary expression node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param binNode The binary expression node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateBinaryExprNode(CodeGenerator& generator, const BinaryExprNode* binNode);
+Result<Value> evaluateBinaryExprNode(CodeGenerator& generator, const BinaryExprNode* binNode);
+
+/**
+ * @brief Evaluates a binary expression node whose operand types were proven by type inference.
+ * @param generator The code generator used for evaluating the node.
+ * @param typedNode The specialised binary expression node to evaluate.
+ * @return The result of the evaluation, which is the same as for the generic node, or the error it failed with.
+ */
+Result<Value> evaluateTypedBinaryExprNode(CodeGenerator& generator, const TypedBinaryExprNode* typedNode);
 
 /**
  * @brief Evaluates a unary expression node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param unNode The unary expression node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateUnaryExprNode(CodeGenerator& generator, const UnaryExprNode* unNode);
+Result<Value> evaluateUnaryExprNode(CodeGenerator& generator, const UnaryExprNode* unNode);
 
 /**
  * @brief Evaluates a type cast node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param typeCastNode The type cast node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateTypeCastNode(CodeGenerator& generator, const TypeCastNode* typeCastNode);
+Result<Value> evaluateTypeCastNode(CodeGenerator& generator, const TypeCastNode* typeCastNode);
 
 /**
  * @brief Evaluates a function call node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param functionCallNode The function call node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateFunctionCallNode(CodeGenerator* generator, const FunctionCallNode* functionCallNode);
+Result<Value> evaluateFunctionCallNode(CodeGenerator* generator, const FunctionCallNode* functionCallNode);
 
 /**
  * @brief Evaluates a function definition node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param functionNode The function definition node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or the error it failed with.
  */
-Value evaluateFunctionDefNode(CodeGenerator* generator, const FunctionDefNode* functionNode);
+Result<Value> evaluateFunctionDefNode(CodeGenerator* generator, const FunctionDefNode* functionNode);
@@ -2,8 +2,9 @@
 #include "CodeGenerator/CodeGenerator.h"
 #include "Function/Function.h"
 #include "CodeGenerator/Evaluator/Handler/FunctionHandler.h"
+#include "CodeGenerator/JIT/JITRuntime.h"
 
-Value FunctionNodeEvaluator::evaluateFunctionDefNode(CodeGenerator* generator, const FunctionDefNode* functionDefNode) {
+Result<Value> FunctionNodeEvaluator::evaluateFunctionDefNode(CodeGenerator* generator, const FunctionDefNode* functionDefNode) {
     std::vector<Parameter> params;
     for (const auto& param : functionDefNode->getParameters()) {
         params.emplace_back(param.first, param.second);
@@ -16,10 +17,14 @@ Value FunctionNodeEvaluator::evaluateFunctionDefNode(CodeGenerator* generator, c
         std::make_unique<BlockNode>(std::move(*functionDefNode->getBody())) // Move BlockNode
     );
 
+    // Native code may call the previous definition directly, so it is all dropped
+    if (generator->jit && generator->functionHandler->getFunctions().count(functionDefNode->getName())) {
+        generator->jit->invalidate();
+    }
     generator->functionHandler->addFunction(functionDefNode->getName(), std::move(function));
     return std::monostate();
 }
 
-Value FunctionNodeEvaluator::evaluateFunctionCallNode(CodeGenerator* generator, const FunctionCallNode* functionCallNode) {
+Result<Value> FunctionNodeEvaluator::evaluateFunctionCallNode(CodeGenerator* generator, const FunctionCallNode* functionCallNode) {
     return generator->functionHandler->callFunction(functionCallNode, *generator);
 }
@@ -2,6 +2,7 @@
 #define FUNCTION_NODE_EVALUATOR_H
 
 #include "Value/Value.h"
+#include "Result/Result.h"
 
 class ExprNode;
 class CodeGenerator;
@@ -18,17 +19,17 @@ public:
      * @brief Evaluates a function call node in the AST.
      * @param generator The code generator used for evaluating the node.
      * @param functionCallNode The function call node to evaluate.
-     * @return The result of the evaluation.
+     * @return The result of the evaluation, or the error it failed with.
      */
-    Value evaluateFunctionCallNode(CodeGenerator* generator, const FunctionCallNode* functionCallNode);
+    Result<Value> evaluateFunctionCallNode(CodeGenerator* generator, const FunctionCallNode* functionCallNode);
 
     /**
      * @brief Evaluates a function definition node in the AST.
      * @param generator The code generator used for evaluating the node.
      * @param functionNode The function definition node to evaluate.
-     * @return The result of the evaluation.
+     * @return The result of the evaluation, or the error it failed with.
      */
-    Value evaluateFunctionDefNode(CodeGenerator* generator, const FunctionDefNode* functionNode);
+    Result<Value> evaluateFunctionDefNode(CodeGenerator* generator, const FunctionDefNode* functionNode);
 };
 
 #endif // FUNCTION_NODE_EVALUATOR_H
@@ -0,0 +1,23 @@
+#include "InlinedCallNodeEvaluator.h"
+#include "Value/ValueHelper.h"
+
+Result<Value> evaluateInlinedCallNode(CodeGenerator& generator, const InlinedCallNode* inlinedCallNode) {
+    for (const auto& binding : inlinedCallNode->getBindings()) {
+        Result<Value> bound = evaluate(binding.get(), generator);
+        if (!bound.ok()) {
+            return bound;
+        }
+    }
+
+    Result<Value> result = evaluate(inlinedCallNode->getBody().get(), generator);
+    if (!result.ok()) {
+        return result;
+    }
+
+    if (inlinedCallNode->needsReturnTypeCheck() && !ValueHelper::hasType(*result, inlinedCallNode->getReturnType())) {
+        const Token& token = inlinedCallNode->getReturnToken();
+        return RuntimeError{ "Type Error: Return type mismatch in function at line " + std::to_string(token.line) };
+    }
+
+    return result;
+}
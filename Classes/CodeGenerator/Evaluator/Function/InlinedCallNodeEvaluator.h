@@ -0,0 +1,21 @@
+#ifndef INLINEDCALLNODEEVALUATOR_H
+#define INLINEDCALLNODEEVALUATOR_H
+
+#include "CodeGenerator/Evaluator/Evaluator.h"
+#include "AST/AST.h"
+#include "Value/Value.h"
+
+/**
+ * @brief Evaluates an inlined function call in the AST.
+ * @param generator The code generator used for evaluating the node.
+ * @param inlinedCallNode The inlined call node to evaluate.
+ * @return The value of the inlined return expression, or an error if evaluating it fails or the
+ * result does not match the declared return type.
+ *
+ * This function binds the arguments that were not substituted to their caller-local slots,
+ * evaluates the expanded return expression and, where the result type could not be proven
+ * by the optimiser, checks it against the declared return type of the function.
+ */
+Result<Value> evaluateInlinedCallNode(CodeGenerator& generator, const InlinedCallNode* inlinedCallNode);
+
+#endif // INLINEDCALLNODEEVALUATOR_H
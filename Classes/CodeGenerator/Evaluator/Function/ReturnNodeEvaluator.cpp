@@ -5,18 +5,18 @@
 #include "Function/Function.h"
 #include "CodeGenerator/Evaluator/Handler/FunctionHandler.h"
 
-Value evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode) {
+Result<Value> evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode) {
 
     Token token = returnNode->getToken();
 
     std::string line = std::to_string(token.line);
     if (!returnNode->getValue()) {
-        throw std::runtime_error("Runtime Error: Return statement missing value at line " + line);
+        return RuntimeError{ "Runtime Error: Return statement missing value at line " + line };
     }
 
     // check if function context is empty
     if (generator.functionHandler->currentFunctionContext.empty()) {
-		throw std::runtime_error("Runtime Error: Return statement outside of function at line " + line);
+		return RuntimeError{ "Runtime Error: Return statement outside of function at line " + line };
 	}
 
     // Get the current function context
@@ -31,14 +31,18 @@ Value evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode)
     context.returnFlag = true;
 
     if (*context.returnType == "void") {
-		throw std::runtime_error("Runtime Error: Return statement with value in void function at line " + line);
+		return RuntimeError{ "Runtime Error: Return statement with value in void function at line " + line };
 	}
 
     // check if return type matches function return type
-    Value returnValue = evaluate(returnNode->getValue().get(), generator);
+    Result<Value> evaluated = evaluate(returnNode->getValue().get(), generator);
+    if (!evaluated.ok()) {
+        return evaluated;
+    }
+    const Value& returnValue = *evaluated;
 
-    if (*context.returnType != ValueHelper::type(returnValue)) {
-        throw std::runtime_error("Type Error: Return type mismatch in function at line " + line);
+    if (!ValueHelper::hasType(returnValue, *context.returnType)) {
+        return RuntimeError{ "Type Error: Return type mismatch in function at line " + line };
     }
 
     // save the return value to the function context
@@ -46,5 +50,5 @@ Value evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode)
     context.returnValue = returnValue;
 
 
-    return returnValue;
+    return evaluated;
 }
\ No newline at end of file
@@ -9,15 +9,13 @@
  * @brief Evaluates a return node in the AST.
  * @param generator The code generator used for evaluating the node.
  * @param returnNode The return node to evaluate.
- * @return The result of the evaluation.
+ * @return The result of the evaluation, or an error related to the return statement, such as a
+ * missing value, a return statement outside of a function or a type mismatch.
  *
  * This function checks if the return statement is valid within the context of a function,
  * ensures that the return type matches the expected function return type, sets the return
  * flag, and stores the return value in the function context.
- *
- * @throws std::runtime_error If there is any error related to the return statement, such as
- * missing value, return statement outside of a function, multiple return statements, or type mismatch.
  */
-Value evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode);
+Result<Value> evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode);
 
 #endif // RETURNNODEEVALUATOR_H
@@ -0,0 +1,141 @@
+#include "FusedNodeEvaluator.h"
+#include "CodeGenerator/Evaluator/Handler/FunctionHandler.h"
+#include "CodeGenerator/Evaluator/Variable/VariableNodeEvaluator.h"
+#include "CodeGenerator/Evaluator/Expression/ExpressionNodeEvaluator.h"
+#include "TypedVector/TypedVector.h"
+
+Value* findVariableSlot(CodeGenerator& generator, const std::string& name) {
+    if (!generator.functionHandler->currentFunctionContext.empty()) {
+        auto& context = generator.functionHandler->currentFunctionContext.top().variables;
+        auto it = context.find(name);
+        if (it != context.end()) {
+            return &it->second;
+        }
+    }
+    auto it = generator.variables.find(name);
+    return it != generator.variables.end() ? &it->second : nullptr;
+}
+
+Value* findAssignmentSlot(CodeGenerator& generator, const std::string& name) {
+    std::unordered_map<std::string, Value>& scope = generator.functionHandler->currentFunctionContext.empty()
+        ? generator.variables
+        : generator.functionHandler->currentFunctionContext.top().variables;
+    auto it = scope.find(name);
+    return it != scope.end() ? &it->second : nullptr;
+}
+
+Result<Value> evaluateIncrementNode(CodeGenerator& generator, const IncrementNode* incrementNode) {
+    Value* target = findAssignmentSlot(generator, incrementNode->getName());
+    if (target && std::holds_alternative<int>(*target)) {
+        // Computed in double like the generic path, so results out of the int range behave the same
+        int& value = std::get<int>(*target);
+        value = static_cast<int>(static_cast<double>(value) + incrementNode->getDelta());
+        return std::monostate();
+    }
+    return evaluateAssignNode(generator, incrementNode);
+}
+
+Result<Value> evaluateUpdateAssignNode(CodeGenerator& generator, const UpdateAssignNode* updateNode) {
+    // A variable that is undefined or only readable from the global scope takes the generic path,
+    // which reports the error or writes a new local
+    Value* target = findAssignmentSlot(generator, updateNode->getName());
+    if (!target) {
+        return evaluateAssignNode(generator, updateNode);
+    }
+
+    const BinaryExprNode* operation = updateNode->getOperation();
+    Result<Value> rightResult = evaluate(operation->getRight().get(), generator);
+    if (!rightResult.ok()) {
+        return rightResult;
+    }
+    Value& right = *rightResult;
+    // Evaluating the operand cannot remove the variable, and references into a scope stay valid while it grows
+    Value& current = *target;
+
+    if (std::holds_alternative<int>(current) && std::holds_alternative<int>(right)) {
+        int& value = std::get<int>(current);
+        double operand = std::get<int>(right);
+        switch (operation->getOp()[0]) {
+            case '+':
+                value = static_cast<int>(value + operand);
+                return std::monostate();
+            case '-':
+                value = static_cast<int>(value - operand);
+                return std::monostate();
+            case '*':
+                value = static_cast<int>(value * operand);
+                return std::monostate();
+        }
+    }
+
+    InlineCache& cache = operation->getCache();
+    Result<Value> result = std::monostate();
+    if (cache.state == InlineCache::State::MONOMORPHIC && current.index() == cache.leftType && right.index() == cache.rightType) {
+        cache.hits++;
+        result = cache.kernel(operation->getToken(), current, right);
+    }
+    else {
+        result = OperationDispatcher::dispatchMiss(operation, current, right);
+    }
+    if (!result.ok()) {
+        return result;
+    }
+    current = std::move(*result);
+    return std::monostate();
+}
+
+Result<Value> evaluateVariableCompareNode(CodeGenerator& generator, const VariableCompareNode* compareNode) {
+    const Value* left = findVariableSlot(generator, compareNode->getLeftName());
+    const Value* right = compareNode->hasConstant() ? nullptr : findVariableSlot(generator, compareNode->getRightName());
+    if (left && std::holds_alternative<int>(*left) && (compareNode->hasConstant() || (right && std::holds_alternative<int>(*right)))) {
+        int a = std::get<int>(*left);
+        int b = compareNode->hasConstant() ? compareNode->getConstant() : std::get<int>(*right);
+        switch (compareNode->getIntOp()) {
+            case TypedBinaryOp::INT_EQUAL: return a == b;
+            case TypedBinaryOp::INT_NOT_EQUAL: return a != b;
+            case TypedBinaryOp::INT_LESS: return a < b;
+            case TypedBinaryOp::INT_LESS_EQUAL: return a <= b;
+            case TypedBinaryOp::INT_GREATER: return a > b;
+            case TypedBinaryOp::INT_GREATER_EQUAL: return a >= b;
+            default: break;
+        }
+    }
+    return evaluateBinaryExprNode(generator, compareNode);
+}
+
+Result<Value> evaluateListAppendInPlaceNode(CodeGenerator& generator, const ListAppendInPlaceNode* appendNode) {
+    const std::string& name = appendNode->getListName();
+    Result<Value> evaluated = evaluate(appendNode->getValue().get(), generator);
+    if (!evaluated.ok()) {
+        return evaluated;
+    }
+    Value& value = *evaluated;
+
+    Value* list = findVariableSlot(generator, name);
+    if (!list) {
+        if (generator.stats) {
+            generator.stats->lookupMisses++;
+        }
+        return RuntimeError{ "List Error: Undefined list " + name + " at line " + std::to_string(appendNode->getToken().line) };
+    }
+    if (!ValueHelper::isVector(*list)) {
+        return RuntimeError{ "List Append Error: Variable " + name + " is not a list at line " + std::to_string(appendNode->getToken().line) };
+    }
+    TypedVector& vec = *std::get<std::shared_ptr<TypedVector>>(*list);
+    if (!vec.accepts(value)) {
+        return RuntimeError{ "List Append Error: Type mismatch in list " + name + " at line " + std::to_string(appendNode->getToken().line) };
+    }
+
+    if (generator.stats) {
+        size_t capacity = vec.capacity();
+        generator.stats->countCopy(value);
+        vec.push_back(std::move(value));
+        generator.stats->vectorGrowths++;
+        if (vec.capacity() != capacity) {
+            generator.stats->vectorReallocations++;
+        }
+        return std::monostate();
+    }
+    vec.push_back(std::move(value));
+    return std::monostate();
+}
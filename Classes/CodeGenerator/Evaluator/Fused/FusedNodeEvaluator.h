@@ -0,0 +1,58 @@
+#pragma once
+
+#include <CodeGenerator/CodeGenerator.h>
+#include <Value/ValueHelper.h>
+#include <AST/AST.h>
+
+/**
+ * @brief Finds where a variable is stored for reading, in the current function's scope or else the global scope.
+ * @param generator The code generator used for evaluation.
+ * @param name The name of the variable.
+ * @return A pointer to the stored value, or nullptr if the variable is undefined.
+ */
+Value* findVariableSlot(CodeGenerator& generator, const std::string& name);
+
+/**
+ * @brief Finds where an assignment to a variable writes, which inside a function is always its own scope.
+ * @param generator The code generator used for evaluation.
+ * @param name The name of the variable.
+ * @return A pointer to the stored value, or nullptr if the variable is not yet defined in that scope.
+ */
+Value* findAssignmentSlot(CodeGenerator& generator, const std::string& name);
+
+/**
+ * @brief Evaluates `i = i + k` by adding to the stored int, and any other variable like an assignment.
+ * @param generator The code generator used for evaluation.
+ * @param incrementNode The fused increment.
+ * @return An empty value, as the assignment is a statement.
+ */
+Result<Value> evaluateIncrementNode(CodeGenerator& generator, const IncrementNode* incrementNode);
+
+/**
+ * @brief Evaluates `x = x op <expr>` by applying the operation to the stored value and storing the result in its place.
+ *
+ * The expression is evaluated first, as the generic path reads the variable without side effects.
+ * Int +, - and * update the stored int directly, and other types use the inline cache of the operation.
+ *
+ * @param generator The code generator used for evaluation.
+ * @param updateNode The fused update.
+ * @return An empty value, as the assignment is a statement, or an error if the operation is not
+ * supported for the types of its operands.
+ */
+Result<Value> evaluateUpdateAssignNode(CodeGenerator& generator, const UpdateAssignNode* updateNode);
+
+/**
+ * @brief Evaluates a comparison of a variable with a variable or int literal, comparing ints where they are stored.
+ * @param generator The code generator used for evaluation.
+ * @param compareNode The fused comparison.
+ * @return The result of the comparison, or an error if a variable is undefined or the comparison is not supported.
+ */
+Result<Value> evaluateVariableCompareNode(CodeGenerator& generator, const VariableCompareNode* compareNode);
+
+/**
+ * @brief Evaluates an append by moving the value into the list stored in the variable.
+ * @param generator The code generator used for evaluation.
+ * @param appendNode The fused append.
+ * @return An empty value, or an error if the list is undefined, is not a list, or has another element type.
+ */
+Result<Value> evaluateListAppendInPlaceNode(CodeGenerator& generator, const ListAppendInPlaceNode* appendNode);
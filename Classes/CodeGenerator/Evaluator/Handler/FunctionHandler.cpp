@@ -1,16 +1,18 @@
 #include "FunctionHandler.h"
-#include <stdexcept>
+#include <algorithm>
 #include <CodeGenerator/Evaluator/Evaluator.h>
+#include <Value/ValueHelper.h>
+#include <CodeGenerator/JIT/JITRuntime.h>
 
 
 void FunctionHandler::addFunction(const std::string& name, std::unique_ptr<Function> function) {
     functions[name] = std::move(function);
 }
 
-Value FunctionHandler::callFunction(const FunctionCallNode* functionCallNode, CodeGenerator& generator) {
+Result<Value> FunctionHandler::callFunction(const FunctionCallNode* functionCallNode, CodeGenerator& generator) {
     auto it = functions.find(functionCallNode->getName());
     if (it == functions.end()) {
-        throw std::runtime_error("Runtime Error: Undefined function " + functionCallNode->getName());
+        return RuntimeError{ "Runtime Error: Undefined function " + functionCallNode->getName() };
     }
 
     Function* function = it->second.get();
@@ -18,21 +20,80 @@ Value FunctionHandler::callFunction(const FunctionCallNode* functionCallNode, Co
     const auto& args = functionCallNode->getArgs();
 
     if (params.size() != args.size()) {
-        throw std::runtime_error("Runtime Error: Argument count mismatch in function call " + functionCallNode->getName());
+        return RuntimeError{ "Runtime Error: Argument count mismatch in function call " + functionCallNode->getName() };
+    }
+
+    // Compiled functions take their arguments evaluated up front and fall back to the interpreter if native code cannot take them
+    if (generator.jit) {
+        if (const NativeUnit* unit = generator.jit->prepare(*function)) {
+            std::vector<Value> arguments;
+            arguments.reserve(args.size());
+            for (const auto& arg : args) {
+                Result<Value> argument = evaluate(arg.get(), generator);
+                if (!argument.ok()) {
+                    return argument;
+                }
+                arguments.push_back(std::move(*argument));
+            }
+            Value result;
+            Result<bool> called = generator.jit->call(*function, *unit, arguments, result);
+            if (!called.ok()) {
+                return called.takeError();
+            }
+            if (*called) {
+                return result;
+            }
+            FunctionContext context;
+            for (size_t i = 0; i < params.size(); ++i) {
+                context.variables[params[i].name] = std::move(arguments[i]);
+            }
+            return execute(function, std::move(context), generator);
+        }
     }
 
     // Create a new function context and push it onto the stack
     FunctionContext context;
     for (size_t i = 0; i < params.size(); ++i) {
-        context.variables[params[i].name] = evaluate(args[i].get(), generator);
+        Result<Value> evaluated = evaluate(args[i].get(), generator);
+        if (!evaluated.ok()) {
+            return evaluated;
+        }
+        Value& argument = *evaluated;
+        if (params[i].type.compare(0, 5, "list:") == 0) {
+            if (!ValueHelper::hasType(argument, params[i].type)) {
+                return RuntimeError{ "Type Error: Argument " + params[i].name + " of function " + functionCallNode->getName() +
+                    " must be a " + params[i].type + " at line " + std::to_string(functionCallNode->getToken().line) };
+            }
+            // Lists are passed by value: the parameter shares the caller's elements until either side changes them
+            const auto& list = std::get<std::shared_ptr<TypedVector>>(argument);
+            argument = list->slice(0, list->size());
+        }
+        context.variables[params[i].name] = std::move(argument);
     }
+    return execute(function, std::move(context), generator);
+}
+
+Result<Value> FunctionHandler::execute(const Function* function, FunctionContext context, CodeGenerator& generator) {
     context.returnType = &function->getReturnType();
     context.functionName = &function->getName();
-    currentFunctionContext.push(context);
+    currentFunctionContext.push(std::move(context));
+
+    if (RuntimeStats* stats = generator.stats.get()) {
+        stats->functionCalls++;
+        stats->maxCallDepth = std::max(stats->maxCallDepth, currentFunctionContext.size());
+    }
 
 
     // Execute the function body
-    evaluate(function->getBody().get(), generator);
+    TraceRecorder::Scope trace(generator.getTracer(), function->getName(), "function");
+    Result<Value> body = std::monostate();
+    if (generator.getProfiler()) {
+        Profiler::FunctionScope scope(*generator.getProfiler(), function->getName());
+        body = evaluate(function->getBody().get(), generator);
+    }
+    else {
+        body = evaluate(function->getBody().get(), generator);
+    }
 
     // get return value from currentFunctionContext
     Value result = currentFunctionContext.top().returnValue;
@@ -40,5 +101,8 @@ Value FunctionHandler::callFunction(const FunctionCallNode* functionCallNode, Co
     // Pop the function context from the stack
     currentFunctionContext.pop();
 
+    if (!body.ok()) {
+        return body;
+    }
     return result;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <AST/AST.h>
 #include <Function/Function.h>
 #include <Value/Value.h>
+#include <Result/Result.h>
 #include <unordered_map>
 #include <memory>
 #include <string>
@@ -29,25 +30,44 @@ public:
      * @brief Calls a function.
      * @param functionCallNode The function call node containing the function name and arguments.
      * @param generator The code generator used for evaluating the function.
-     * @return The result of the function call.
+     * @return The result of the function call, or an error if the function is undefined, there is
+     * an argument count mismatch or the call fails.
      *
      * This function looks up the function by name, checks the argument count,
      * sets up the function context, evaluates the function body, and returns
      * the result.
-     *
-     * @throws std::runtime_error If the function is undefined or there is an argument count mismatch.
      */
-    Value callFunction(const FunctionCallNode* functionCallNode, CodeGenerator& generator);
+    Result<Value> callFunction(const FunctionCallNode* functionCallNode, CodeGenerator& generator);
+
+    /**
+     * @brief Gets the functions defined so far.
+     * @return A constant reference to the map of function names to function objects.
+     */
+    const std::unordered_map<std::string, std::unique_ptr<Function>>& getFunctions() const { return functions; }
 
 private:
     std::unordered_map<std::string, std::unique_ptr<Function>> functions; ///< Map of function names to function objects
     std::stack<FunctionContext> currentFunctionContext; ///< Stack of function contexts for nested function calls
 
-    friend Value evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode);
-    friend Value evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode);
-    friend Value evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode);
-    friend Value evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode);
-    friend Value getListValue(CodeGenerator& generator, const std::string& name, const Token& token);
+    /**
+     * @brief Runs a function body in the interpreter.
+     * @param function The function.
+     * @param context The context holding the bound parameters.
+     * @param generator The code generator used for evaluating the function.
+     * @return The value the body returned, or the error it failed with.
+     */
+    Result<Value> execute(const Function* function, FunctionContext context, CodeGenerator& generator);
+
+    friend Result<Value> evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode);
+    friend Result<Value> evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode);
+    friend Value* findAppendTarget(CodeGenerator& generator, const AssignNode* assignNode);
+    friend Result<Value> evaluateReturnNode(CodeGenerator& generator, const ReturnNode* returnNode);
+    friend Result<Value> evaluateWhileNode(CodeGenerator& generator, const WhileNode* whileNode);
+    friend Result<Value> evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode);
+    friend Result<Value> evaluateMapInitNode(CodeGenerator& generator, const MapInitNode* mapNode);
+    friend Result<Value> getListValue(CodeGenerator& generator, const std::string& name, const Token& token);
+    friend Value* findVariableSlot(CodeGenerator& generator, const std::string& name);
+    friend Value* findAssignmentSlot(CodeGenerator& generator, const std::string& name);
 };
 
 #endif // FUNCTIONHANDLER_H
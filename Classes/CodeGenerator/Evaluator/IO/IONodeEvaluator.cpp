@@ -2,15 +2,27 @@
 #include "CodeGenerator/CodeGenerator.h"
 #include <iostream>
 
-Value evaluatePrintNode(CodeGenerator& generator, const PrintNode* prNode) {
-    Value value = evaluate(prNode->getExpression().get(), generator);
-    generator.printValue(value);
+Result<Value> evaluatePrintNode(CodeGenerator& generator, const PrintNode* prNode) {
+    Result<Value> value = evaluate(prNode->getExpression().get(), generator);
+    if (value.ok()) {
+        generator.printValue(*value);
+    }
     return value;
 }
 
-Value evaluateInputNode(CodeGenerator& generator, const InputNode* inNode) {
-    Value value = evaluate(inNode->getExpression().get(), generator);
+Result<Value> evaluateInputNode(CodeGenerator& generator, const InputNode* inNode) {
+    Result<Value> value = evaluate(inNode->getExpression().get(), generator);
+    if (!value.ok()) {
+        return value;
+    }
+    // Make sure the prompt is visible before waiting for the user
+    generator.output.flush();
     std::string input;
     std::getline(std::cin, input);
     return input;
+}
+
+Result<Value> evaluateFlushNode(CodeGenerator& generator, const FlushNode*) {
+    generator.output.flush();
+    return std::monostate();
 }
\ No newline at end of file
@@ -7,20 +7,28 @@
  * @brief Evaluates a print node and outputs the result.
  * @param generator The code generator used for evaluation.
  * @param prNode The print node to evaluate.
- * @return The value that was printed.
+ * @return The value that was printed, or the error evaluating it failed with.
  *
  * This function evaluates the expression within the print node, prints its value,
  * and then returns the value.
  */
-Value evaluatePrintNode(CodeGenerator& generator, const PrintNode* prNode);
+Result<Value> evaluatePrintNode(CodeGenerator& generator, const PrintNode* prNode);
 
 /**
  * @brief Evaluates an input node and captures user input.
  * @param generator The code generator used for evaluation.
  * @param inNode The input node to evaluate.
- * @return The value entered by the user.
+ * @return The value entered by the user, or the error evaluating the prompt failed with.
  *
  * This function evaluates the expression within the input node, prompts the user for input,
  * and then returns the input as a string value.
  */
-Value evaluateInputNode(CodeGenerator& generator, const InputNode* inNode);
+Result<Value> evaluateInputNode(CodeGenerator& generator, const InputNode* inNode);
+
+/**
+ * @brief Evaluates a flush node, writing all buffered output to its target.
+ * @param generator The code generator used for evaluation.
+ * @param flushNode The flush node to evaluate.
+ * @return None.
+ */
+Result<Value> evaluateFlushNode(CodeGenerator& generator, const FlushNode* flushNode);
@@ -1,14 +1,25 @@
 #include "ListNodeEvaluator.h"
 #include "Function/Function.h"
 #include "CodeGenerator/Evaluator/Handler/FunctionHandler.h"
-#include <stdexcept>
+#include "TypedVector/ListKernels.h"
 
-Value evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode) {
+namespace {
+    // Evaluates a list index or slice bound, which must convert to an int
+    Result<int> evaluateIndex(CodeGenerator& generator, const ExprNode* node) {
+        Result<Value> value = evaluate(node, generator);
+        if (!value.ok()) {
+            return value.takeError();
+        }
+        return ValueHelper::asInt(*value);
+    }
+}
+
+Result<Value> evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode) {
     std::string type = listNode->getElementType();
     std::string name = listNode->getName();
     std::string line = std::to_string(listNode->getToken().line);
     if (type != "int" && type != "double" && type != "bool" && type != "string") {
-        throw std::runtime_error("List Init Error: Invalid list type " + type + " at line " + line);
+        return RuntimeError{ "List Init Error: Invalid list type " + type + " at line " + line };
     }
     // check if the list already exists in the function context
 
@@ -16,7 +27,7 @@ Value evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNod
         auto& context = generator.functionHandler->currentFunctionContext.top().variables;
         auto it = context.find(name);
         if (it != context.end()) {
-            throw std::runtime_error("List Init Error: List " + name + " already exists at line " + line);
+            return RuntimeError{ "List Init Error: List " + name + " already exists at line " + line };
         }
 
         context.insert({ name, std::make_shared<TypedVector>(type) });
@@ -25,121 +36,314 @@ Value evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNod
 
     std::shared_ptr<TypedVector> list = std::make_shared<TypedVector>(type);
     if (generator.variables.find(listNode->getName()) != generator.variables.end()) {
-        throw std::runtime_error("List Init Error: List " + name + " already exists at line " + line);
+        return RuntimeError{ "List Init Error: List " + name + " already exists at line " + line };
     }
     generator.variables.insert({ listNode->getName(), list });
     return std::monostate();
 }
 
-Value evaluateListAppendNode(CodeGenerator& generator, const ListAppendNode* listAppendNode) {
+Result<Value> evaluateListAppendNode(CodeGenerator& generator, const ListAppendNode* listAppendNode) {
     std::string line = std::to_string(listAppendNode->getToken().line);
     std::string name = listAppendNode->getListName();
-    Value value = evaluate(listAppendNode->getValue().get(), generator);
+    Result<Value> evaluated = evaluate(listAppendNode->getValue().get(), generator);
+    if (!evaluated.ok()) {
+        return evaluated;
+    }
+    Value& value = *evaluated;
 
-    const Value& list = getListValue(generator, name, listAppendNode->getToken());
+    Result<Value> listResult = getListValue(generator, name, listAppendNode->getToken());
+    if (!listResult.ok()) {
+        return listResult;
+    }
+    const Value& list = *listResult;
 
     if (ValueHelper::isVector(list)) {
         std::shared_ptr<TypedVector> vec = ValueHelper::asVector(list);
         if (vec->getElementType() != ValueHelper::type(value)) {
-            throw std::runtime_error("List Append Error: Type mismatch in list " + name + " at line " + line);
+            return RuntimeError{ "List Append Error: Type mismatch in list " + name + " at line " + line };
+        }
+        if (generator.stats) {
+            size_t capacity = vec->capacity();
+            vec->push_back(value);
+            generator.stats->vectorGrowths++;
+            if (vec->capacity() != capacity) {
+                generator.stats->vectorReallocations++;
+            }
+            generator.stats->countCopy(value);
+        }
+        else {
+            vec->push_back(value);
         }
-        vec->push_back(value);
     }
     else {
-        throw std::runtime_error("List Append Error: Variable " + name + " is not a list at line " + line);
+        return RuntimeError{ "List Append Error: Variable " + name + " is not a list at line " + line };
     }
 
     return std::monostate();
 }
 
-Value evaluateListPopNode(CodeGenerator& generator, const ListPopNode* listPopNode) {
+Result<Value> evaluateListPopNode(CodeGenerator& generator, const ListPopNode* listPopNode) {
     std::string line = std::to_string(listPopNode->getToken().line);
     std::string name = listPopNode->getListName();
-    int index = ValueHelper::asInt(evaluate(listPopNode->getIndex().get(), generator));
+    Result<int> indexResult = evaluateIndex(generator, listPopNode->getIndex().get());
+    if (!indexResult.ok()) {
+        return indexResult.takeError();
+    }
+    int index = *indexResult;
 
-    const Value& list = getListValue(generator, name, listPopNode->getToken());
+    Result<Value> listResult = getListValue(generator, name, listPopNode->getToken());
+    if (!listResult.ok()) {
+        return listResult;
+    }
+    const Value& list = *listResult;
     if (ValueHelper::isVector(list)) {
         std::shared_ptr<TypedVector> vec = ValueHelper::asVector(list);
-        if (index < 0 || index >= vec->getValues().size()) {
-            throw std::runtime_error("List Pop Error: Index out of bounds for list " + name + " at line " + line);
+        if (index < 0 || index >= vec->size()) {
+            return RuntimeError{ "List Pop Error: Index out of bounds for list " + name + " at line " + line };
         }
-        Value value = vec->getValues()[index];
-        vec->pop(index);
-        return value;
+        // The element is moved out of the list rather than copied
+        return vec->pop(index);
     }
     else {
-        throw std::runtime_error("List Pop Error: Variable " + name + " is not a list at line " + line);
+        return RuntimeError{ "List Pop Error: Variable " + name + " is not a list at line " + line };
     }
 }
 
-Value evaluateListLengthNode(CodeGenerator& generator, const ListLengthNode* listLengthNode) {
+Result<Value> evaluateListLengthNode(CodeGenerator& generator, const ListLengthNode* listLengthNode) {
     std::string line = std::to_string(listLengthNode->getToken().line);
     std::string name = listLengthNode->getListName();
     int length = 0;
 
-    const Value& list = getListValue(generator, name, listLengthNode->getToken());
+    Result<Value> listResult = getListValue(generator, name, listLengthNode->getToken());
+    if (!listResult.ok()) {
+        return listResult;
+    }
+    const Value& list = *listResult;
 
     if (ValueHelper::isVector(list)) {
         std::shared_ptr<TypedVector> vec = ValueHelper::asVector(list);
-        length = vec->getValues().size();
+        length = vec->size();
+    }
+    else if (ValueHelper::isMap(list)) {
+        length = ValueHelper::asMap(list)->size();
     }
     else {
-        throw std::runtime_error("List Length Error: Variable " + name + " is not a list at line " + line);
+        return RuntimeError{ "List Length Error: Variable " + name + " is not a list at line " + line };
     }
 
     return length;
 }
 
-Value evaluateListIndexNode(CodeGenerator& generator, const ListIndexNode* listIndexNode) {
+Result<Value> evaluateListIndexNode(CodeGenerator& generator, const ListIndexNode* listIndexNode) {
     std::string line = std::to_string(listIndexNode->getToken().line);
     std::string name = listIndexNode->getListName();
-    int index = ValueHelper::asInt(evaluate(listIndexNode->getIndex().get(), generator));
+    Result<int> indexResult = evaluateIndex(generator, listIndexNode->getIndex().get());
+    if (!indexResult.ok()) {
+        return indexResult.takeError();
+    }
+    int index = *indexResult;
 
-    const Value& list = getListValue(generator, name, listIndexNode->getToken());
+    Result<Value> listResult = getListValue(generator, name, listIndexNode->getToken());
+    if (!listResult.ok()) {
+        return listResult;
+    }
+    const Value& list = *listResult;
 
     if (ValueHelper::isVector(list)) {
         std::shared_ptr<TypedVector> vec = ValueHelper::asVector(list);
-        if (index < 0 || index >= vec->getValues().size()) {
-            throw std::runtime_error("List Index Error: Index out of bounds for list " + name + " at line " + line);
+        if (index < 0 || index >= vec->size()) {
+            return RuntimeError{ "List Index Error: Index out of bounds for list " + name + " at line " + line };
+        }
+        if (generator.stats) {
+            generator.stats->countCopy((*vec)[index]);
         }
-        return vec->getValues()[index];
+        return (*vec)[index];
     }
     else {
-        throw std::runtime_error("List Index Error: Variable " + name + " is not a list at line " + line);
+        return RuntimeError{ "List Index Error: Variable " + name + " is not a list at line " + line };
     }
 }
 
-Value evaluateListReplaceNode(CodeGenerator& generator, const ListReplaceNode* listReplaceNode) {
+Result<Value> evaluateListSliceNode(CodeGenerator& generator, const ListSliceNode* listSliceNode) {
+    std::string line = std::to_string(listSliceNode->getToken().line);
+    std::string name = listSliceNode->getListName();
+    const ExprNode* beginNode = listSliceNode->getBegin().get();
+    const ExprNode* endNode = listSliceNode->getEnd().get();
+    Result<int> begin = beginNode ? evaluateIndex(generator, beginNode) : Result<int>(0);
+    if (!begin.ok()) {
+        return begin.takeError();
+    }
+    Result<int> end = endNode ? evaluateIndex(generator, endNode) : Result<int>(0);
+    if (!end.ok()) {
+        return end.takeError();
+    }
+
+    Result<Value> listResult = getListValue(generator, name, listSliceNode->getToken());
+    if (!listResult.ok()) {
+        return listResult;
+    }
+    const Value& list = *listResult;
+
+    if (ValueHelper::isVector(list)) {
+        const std::shared_ptr<TypedVector>& vec = ValueHelper::asVector(list);
+        int length = static_cast<int>(vec->size());
+        if (!endNode) {
+            *end = length;
+        }
+        if (*begin < 0 || *end < *begin || *end > length) {
+            return RuntimeError{ "List Slice Error: Invalid range " + std::to_string(*begin) + ":" + std::to_string(*end) +
+                " for list " + name + " of length " + std::to_string(length) + " at line " + line };
+        }
+        return vec->slice(*begin, *end);
+    }
+    else {
+        return RuntimeError{ "List Slice Error: Variable " + name + " is not a list at line " + line };
+    }
+}
+
+Result<Value> evaluateListReplaceNode(CodeGenerator& generator, const ListReplaceNode* listReplaceNode) {
     const std::string& line = std::to_string(listReplaceNode->getToken().line);
     const std::string& name = listReplaceNode->getListName();
-    const Value& value = evaluate(listReplaceNode->getValue().get(), generator);
-    int index = ValueHelper::asInt(evaluate(listReplaceNode->getIndex().get(), generator));
+    Result<Value> evaluated = evaluate(listReplaceNode->getValue().get(), generator);
+    if (!evaluated.ok()) {
+        return evaluated;
+    }
+    const Value& value = *evaluated;
+    Result<int> indexResult = evaluateIndex(generator, listReplaceNode->getIndex().get());
+    if (!indexResult.ok()) {
+        return indexResult.takeError();
+    }
+    int index = *indexResult;
 
-    const Value& list = getListValue(generator, name, listReplaceNode->getToken());
+    Result<Value> listResult = getListValue(generator, name, listReplaceNode->getToken());
+    if (!listResult.ok()) {
+        return listResult;
+    }
+    const Value& list = *listResult;
 
     if (ValueHelper::isVector(list)) {
         std::shared_ptr<TypedVector> vec = ValueHelper::asVector(list);
-        if (index < 0 || index >= vec->getValues().size()) {
-            throw std::runtime_error("List Replace Error: Index out of bounds for list " + name + " at line " + line);
+        if (index < 0 || index >= vec->size()) {
+            return RuntimeError{ "List Replace Error: Index out of bounds for list " + name + " at line " + line };
         }
         if (vec->getElementType() != ValueHelper::type(value)) {
-            throw std::runtime_error("List Replace Error: Type mismatch in list " + name + " at line " + line);
+            return RuntimeError{ "List Replace Error: Type mismatch in list " + name + " at line " + line };
         }
         vec->replace(index, value);
     }
     else {
-        throw std::runtime_error("List Replace Error: Variable " + name + " is not a list at line " + line);
+        return RuntimeError{ "List Replace Error: Variable " + name + " is not a list at line " + line };
     }
 
     return std::monostate();
 }
 
+Result<Value> evaluateListMethodNode(CodeGenerator& generator, const ListMethodNode* listMethodNode) {
+    const std::string line = std::to_string(listMethodNode->getToken().line);
+    const std::string& name = listMethodNode->getListName();
+    const ListMethod method = listMethodNode->getMethod();
+    const std::string methodName = listMethodToString(method);
+    Result<Value> evaluated = listMethodNode->getArgument() ? evaluate(listMethodNode->getArgument().get(), generator) : Result<Value>(std::monostate());
+    if (!evaluated.ok()) {
+        return evaluated;
+    }
+    const Value& argument = *evaluated;
+
+    Result<Value> listResult = getListValue(generator, name, listMethodNode->getToken());
+    if (!listResult.ok()) {
+        return listResult;
+    }
+    const Value& list = *listResult;
+    if (method == ListMethod::CONTAINS && ValueHelper::isMap(list)) {
+        // Maps share contains with lists, and look the key up in their hash table
+        const TypedMap& map = *ValueHelper::asMap(list);
+        if (ValueHelper::type(argument) != map.getKeyType()) {
+            return RuntimeError{ "Map Method Error: Key type mismatch in contains on map " + name + " at line " + line };
+        }
+        return map.find(argument) != nullptr;
+    }
+    if (!ValueHelper::isVector(list)) {
+        return RuntimeError{ "List Method Error: Variable " + name + " is not a list at line " + line };
+    }
+    TypedVector& vec = *ValueHelper::asVector(list);
+    const std::string type = vec.getElementType();
+
+    switch (method) {
+        case ListMethod::SUM:
+            if (type != "int" && type != "double") {
+                return RuntimeError{ "List Method Error: Cannot sum list " + name + " of type " + type + " at line " + line };
+            }
+            return ListKernels::sum(vec);
+        case ListMethod::MIN:
+        case ListMethod::MAX:
+            if (vec.size() == 0) {
+                return RuntimeError{ "List Method Error: Cannot take the " + methodName + " of empty list " + name + " at line " + line };
+            }
+            return method == ListMethod::MIN ? ListKernels::min(vec) : ListKernels::max(vec);
+        case ListMethod::SORT:
+            ListKernels::sort(vec);
+            return std::monostate();
+        case ListMethod::CONTAINS:
+        case ListMethod::INDEX: {
+            if (ValueHelper::type(argument) != type) {
+                return RuntimeError{ "List Method Error: Type mismatch in " + methodName + " on list " + name + " at line " + line };
+            }
+            int index = ListKernels::indexOf(vec, argument);
+            return method == ListMethod::CONTAINS ? Value(index >= 0) : Value(index);
+        }
+        case ListMethod::EXTEND: {
+            if (!ValueHelper::isVector(argument)) {
+                return RuntimeError{ "List Method Error: Argument of extend on list " + name + " is not a list at line " + line };
+            }
+            const TypedVector& other = *ValueHelper::asVector(argument);
+            if (other.getElementType() != type) {
+                return RuntimeError{ "List Method Error: Type mismatch in extend on list " + name + " at line " + line };
+            }
+            if (generator.stats) {
+                size_t capacity = vec.capacity();
+                generator.stats->vectorGrowths += other.size();
+                vec.extend(other);
+                if (vec.capacity() != capacity) {
+                    generator.stats->vectorReallocations++;
+                }
+            }
+            else {
+                vec.extend(other);
+            }
+            return std::monostate();
+        }
+        case ListMethod::REVERSE:
+            ListKernels::reverse(vec);
+            return std::monostate();
+    }
+    return RuntimeError{ "List Method Error: Unsupported method " + methodName + " at line " + line };
+}
 
 // get the value of the list from the generator
-Value getListValue(CodeGenerator& generator, const std::string& name, const Token& token) {
+Result<Value> getListValue(CodeGenerator& generator, const std::string& name, const Token& token) {
+    // Lists declared or passed in a function are local to it
+    if (!generator.functionHandler->currentFunctionContext.empty()) {
+        auto& context = generator.functionHandler->currentFunctionContext.top().variables;
+        auto local = context.find(name);
+        if (local != context.end()) {
+            if (generator.stats) {
+                generator.stats->localHits++;
+                generator.stats->countCopy(local->second);
+            }
+            return local->second;
+        }
+    }
+
 	auto it = generator.variables.find(name);
     if (it == generator.variables.end()) {
-		throw std::runtime_error("List Error: Undefined list " + name + " at line " + std::to_string(token.line));
+        if (generator.stats) {
+            generator.stats->lookupMisses++;
+        }
+		return RuntimeError{ "List Error: Undefined list " + name + " at line " + std::to_string(token.line) };
 	}
+    if (generator.stats) {
+        (generator.functionHandler->currentFunctionContext.empty() ? generator.stats->globalHits : generator.stats->globalFallbacks)++;
+        generator.stats->countCopy(it->second);
+    }
 	return it->second;
 }
\ No newline at end of file
@@ -13,7 +13,7 @@
  * This function initializes a list with a specified element type and stores it
  * in the appropriate context.
  */
-Value evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode);
+Result<Value> evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNode);
 
 /**
  * @brief Evaluates a node that appends an element to a list.
@@ -23,7 +23,7 @@ Value evaluateListInitNode(CodeGenerator& generator, const ListInitNode* listNod
  *
  * This function appends an element to a list, ensuring type compatibility.
  */
-Value evaluateListAppendNode(CodeGenerator& generator, const ListAppendNode* listAppendNode);
+Result<Value> evaluateListAppendNode(CodeGenerator& generator, const ListAppendNode* listAppendNode);
 
 /**
  * @brief Evaluates a node that pops an element from a list.
@@ -33,7 +33,7 @@ Value evaluateListAppendNode(CodeGenerator& generator, const ListAppendNode* lis
  *
  * This function removes an element from a list at the specified index and returns it.
  */
-Value evaluateListPopNode(CodeGenerator& generator, const ListPopNode* listPopNode);
+Result<Value> evaluateListPopNode(CodeGenerator& generator, const ListPopNode* listPopNode);
 
 /**
  * @brief Evaluates a node that gets the length of a list.
@@ -43,7 +43,7 @@ Value evaluateListPopNode(CodeGenerator& generator, const ListPopNode* listPopNo
  *
  * This function returns the number of elements in a list.
  */
-Value evaluateListLengthNode(CodeGenerator& generator, const ListLengthNode* listLengthNode);
+Result<Value> evaluateListLengthNode(CodeGenerator& generator, const ListLengthNode* listLengthNode);
 
 /**
  * @brief Evaluates a node that accesses an element in a list by index.
@@ -53,7 +53,17 @@ Value evaluateListLengthNode(CodeGenerator& generator, const ListLengthNode* lis
  *
  * This function accesses an element in a list by its index and returns it.
  */
-Value evaluateListIndexNode(CodeGenerator& generator, const ListIndexNode* listIndexNode);
+Result<Value> evaluateListIndexNode(CodeGenerator& generator, const ListIndexNode* listIndexNode);
+
+/**
+ * @brief Evaluates a node that takes a slice of a list.
+ * @param generator The code generator used for evaluation.
+ * @param listSliceNode The list slice node.
+ * @return A new list value that shares the elements of the sliced list until either is modified.
+ *
+ * This function checks that the bounds form a valid range within the list and creates the slice in O(1).
+ */
+Result<Value> evaluateListSliceNode(CodeGenerator& generator, const ListSliceNode* listSliceNode);
 
 /**
  * @brief Evaluates a node that replaces an element in a list at a specified index.
@@ -63,15 +73,25 @@ Value evaluateListIndexNode(CodeGenerator& generator, const ListIndexNode* listI
  *
  * This function replaces an element in a list at the specified index with a new value.
  */
-Value evaluateListReplaceNode(CodeGenerator& generator, const ListReplaceNode* listReplaceNode);
+Result<Value> evaluateListReplaceNode(CodeGenerator& generator, const ListReplaceNode* listReplaceNode);
+
+/**
+ * @brief Evaluates a node that calls a built-in list method.
+ * @param generator The code generator used for evaluation.
+ * @param listMethodNode The list method node.
+ * @return The result of the method, or an empty value for methods that modify the list in place.
+ *
+ * This function checks the list and argument types and runs the native kernel for the method.
+ */
+Result<Value> evaluateListMethodNode(CodeGenerator& generator, const ListMethodNode* listMethodNode);
 
 /**
  * @brief Retrieves the value of a list from the code generator.
  * @param generator The code generator used for evaluation.
  * @param name The name of the list.
  * @param token The token associated with the list.
- * @return The value of the list.
+ * @return The value of the list, or an error if the list is undefined.
  *
- * This function retrieves the value of a list from the code generator's context, throwing an error if the list is undefined.
+ * This function retrieves the value of a list from the code generator's context.
  */
-Value getListValue(CodeGenerator& generator, const std::string& name, const Token& token);
+Result<Value> getListValue(CodeGenerator& generator, const std::string& name, const Token& token);
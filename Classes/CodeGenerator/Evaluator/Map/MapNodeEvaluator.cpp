@@ -0,0 +1,85 @@
+#include "MapNodeEvaluator.h"
+#include "Function/Function.h"
+#include "CodeGenerator/Evaluator/Handler/FunctionHandler.h"
+#include "CodeGenerator/Evaluator/List/ListNodeEvaluator.h"
+
+Result<Value> evaluateMapInitNode(CodeGenerator& generator, const MapInitNode* mapNode) {
+    const std::string& keyType = mapNode->getKeyType();
+    const std::string& valueType = mapNode->getValueType();
+    const std::string& name = mapNode->getName();
+    std::string line = std::to_string(mapNode->getToken().line);
+    if (!TypedMap::isKeyType(keyType)) {
+        return RuntimeError{ "Map Init Error: Invalid key type " + keyType + " at line " + line };
+    }
+    if (!TypedMap::isValueType(valueType)) {
+        return RuntimeError{ "Map Init Error: Invalid value type " + valueType + " at line " + line };
+    }
+
+    std::unordered_map<std::string, Value>& scope = generator.functionHandler->currentFunctionContext.empty()
+        ? generator.variables
+        : generator.functionHandler->currentFunctionContext.top().variables;
+    if (scope.find(name) != scope.end()) {
+        return RuntimeError{ "Map Init Error: Map " + name + " already exists at line " + line };
+    }
+    scope.insert({ name, std::make_shared<TypedMap>(keyType, valueType) });
+    return std::monostate();
+}
+
+Result<Value> evaluateMapMethodNode(CodeGenerator& generator, const MapMethodNode* mapMethodNode) {
+    const std::string line = std::to_string(mapMethodNode->getToken().line);
+    const std::string& name = mapMethodNode->getMapName();
+    const MapMethod method = mapMethodNode->getMethod();
+    const std::string methodName = mapMethodToString(method);
+    Result<Value> keyResult = mapMethodNode->getKey() ? evaluate(mapMethodNode->getKey().get(), generator) : Result<Value>(std::monostate());
+    if (!keyResult.ok()) {
+        return keyResult;
+    }
+    Result<Value> valueResult = mapMethodNode->getValue() ? evaluate(mapMethodNode->getValue().get(), generator) : Result<Value>(std::monostate());
+    if (!valueResult.ok()) {
+        return valueResult;
+    }
+    const Value& key = *keyResult;
+    const Value& value = *valueResult;
+
+    Result<Value> mapResult = getListValue(generator, name, mapMethodNode->getToken());
+    if (!mapResult.ok()) {
+        return mapResult;
+    }
+    const Value& map = *mapResult;
+    if (!ValueHelper::isMap(map)) {
+        return RuntimeError{ "Map Method Error: Variable " + name + " is not a map at line " + line };
+    }
+    TypedMap& typedMap = *ValueHelper::asMap(map);
+    if (mapMethodArgumentCount(method) > 0 && ValueHelper::type(key) != typedMap.getKeyType()) {
+        return RuntimeError{ "Map Method Error: Key type mismatch in " + methodName + " on map " + name + " at line " + line };
+    }
+
+    switch (method) {
+        case MapMethod::GET: {
+            const Value* found = typedMap.find(key);
+            if (!found) {
+                return RuntimeError{ "Map Error: Key " + ValueHelper::asString(key) + " not found in map " + name + " at line " + line };
+            }
+            if (generator.stats) {
+                generator.stats->countCopy(*found);
+            }
+            return *found;
+        }
+        case MapMethod::SET:
+            if (ValueHelper::type(value) != typedMap.getValueType()) {
+                return RuntimeError{ "Map Method Error: Value type mismatch in set on map " + name + " at line " + line };
+            }
+            if (generator.stats) {
+                generator.stats->countCopy(value);
+            }
+            typedMap.set(key, value);
+            return std::monostate();
+        case MapMethod::REMOVE:
+            return typedMap.remove(key);
+        case MapMethod::KEYS:
+            return typedMap.keys();
+        case MapMethod::VALUES:
+            return typedMap.values();
+    }
+    return RuntimeError{ "Map Method Error: Unsupported method " + methodName + " at line " + line };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <CodeGenerator/CodeGenerator.h>
+#include <Value/ValueHelper.h>
+#include <AST/AST.h>
+
+/**
+ * @brief Evaluates a node that initializes a map.
+ * @param generator The code generator used for evaluation.
+ * @param mapNode The map initialization node.
+ * @return An empty value, or an error if the map cannot be created.
+ *
+ * This function checks the key and value types, creates an empty map and stores it
+ * in the appropriate context.
+ */
+Result<Value> evaluateMapInitNode(CodeGenerator& generator, const MapInitNode* mapNode);
+
+/**
+ * @brief Evaluates a node that calls a built-in map method.
+ * @param generator The code generator used for evaluation.
+ * @param mapMethodNode The map method node.
+ * @return The result of the method, an empty value for set, or the error the method failed with.
+ *
+ * This function checks the map and argument types and runs the method on the map.
+ */
+Result<Value> evaluateMapMethodNode(CodeGenerator& generator, const MapMethodNode* mapMethodNode);
@@ -1,6 +1,6 @@
 #pragma once
 #include <string>
-#include <stdexcept>
+#include "Result/Result.h"
 
 /**
  * @struct EvaluatorHelper
@@ -18,24 +18,24 @@ struct EvaluatorHelper {
      * type. It handles basic types such as int, double, bool, and string.
      *
      * @param typeStr The type string to parse.
-     * @return A string representing the extracted list type.
-     * @throws std::runtime_error if the type string is invalid or incorrectly formatted.
+     * @return A string representing the extracted list type, or an error if the type string is
+     * invalid or incorrectly formatted.
      */
-    static std::string extractListType(const std::string& typeStr) {
+    static Result<std::string> extractListType(const std::string& typeStr) {
         std::string listType;
         if (typeStr.find(":") != std::string::npos) {
             std::string type = typeStr.substr(0, typeStr.find(":"));
             listType = typeStr.substr(typeStr.find(":") + 1);
 
             if (type != "list" && listType != "int" && listType != "double" && listType != "bool" && listType != "string") {
-                throw std::runtime_error("Runtime Error: Invalid parameter type " + type);
+                return RuntimeError{ "Runtime Error: Invalid parameter type " + type };
             }
             else if (type != "list") {
                 return typeStr;
             }
 
             if (listType != "int" && listType != "double" && listType != "bool" && listType != "string") {
-                throw std::runtime_error("Runtime Error: Invalid list type " + listType);
+                return RuntimeError{ "Runtime Error: Invalid list type " + listType };
             }
 
             if (listType == "string") listType = "std::string";
@@ -43,7 +43,7 @@ struct EvaluatorHelper {
             listType = "std::vector<" + listType + ">";
         }
         else if (typeStr == "list") {
-            throw std::runtime_error("Runtime Error: Invalid format, missing ':' in " + typeStr);
+            return RuntimeError{ "Runtime Error: Invalid format, missing ':' in " + typeStr };
         }
 
         return listType;
@@ -2,16 +2,36 @@
 #include "CodeGenerator/CodeGenerator.h"
 #include "Function/Function.h"
 #include "CodeGenerator/Evaluator/Handler/FunctionHandler.h"
-#include <stdexcept>
+#include <vector>
+#include <algorithm>
 
-Value evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode) {
+namespace {
+    // Checks whether an expression has the form `name + a + b ...` with the variable as its left-most operand
+    bool isAppendTo(const ExprNode* node, const std::string& name) {
+        while (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+            if (binNode->getToken().type != TokenType::ARITHMETIC || binNode->getOp() != "+") {
+                return false;
+            }
+            node = binNode->getLeft().get();
+        }
+        auto varNode = dynamic_cast<const VariableNode*>(node);
+        return varNode && varNode->getName() == name;
+    }
+}
+
+Result<Value> evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode) {
     std::string name = varNode->getName();
-    std::string line = std::to_string(varNode->getToken().line);
+    RuntimeStats* stats = generator.stats.get();
     // Check the current function context first
-    if (!generator.functionHandler->currentFunctionContext.empty()) {
+    bool inFunction = !generator.functionHandler->currentFunctionContext.empty();
+    if (inFunction) {
         auto& context = generator.functionHandler->currentFunctionContext.top().variables;
         auto it = context.find(name);
         if (it != context.end()) {
+            if (stats) {
+                stats->localHits++;
+                stats->countCopy(it->second);
+            }
             return it->second;
         }
     }
@@ -19,26 +39,98 @@ Value evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode
     // Fall back to global variables if not found in the function context
     auto it = generator.variables.find(name);
     if (it != generator.variables.end()) {
+        if (stats) {
+            (inFunction ? stats->globalFallbacks : stats->globalHits)++;
+            stats->countCopy(it->second);
+        }
         return it->second;
     }
 
-    throw std::runtime_error("Variable Error: Undefined variable " + name);
+    if (stats) {
+        stats->lookupMisses++;
+    }
+    return RuntimeError{ "Variable Error: Undefined variable " + name };
 }
 
-Value evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode) {
+Result<Value> evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode) {
     // Check the current function context first
 
     const std::string name = assignNode->getName();
-    const std::string line = std::to_string(assignNode->getToken().line);
-    const Value value = evaluate(assignNode->getValue().get(), generator);
+
+    Value* target = findAppendTarget(generator, assignNode);
+    if (target) {
+        return appendToString(generator, assignNode, *target);
+    }
+
+    Result<Value> evaluated = evaluate(assignNode->getValue().get(), generator);
+    if (!evaluated.ok()) {
+        return evaluated;
+    }
+    const Value& value = *evaluated;
+    if (generator.stats) {
+        generator.stats->countCopy(value);
+    }
 
     if (!generator.functionHandler->currentFunctionContext.empty()) {
 		auto& context = generator.functionHandler->currentFunctionContext.top().variables;
         // add the variable to the current function context
         context[name] = value;
-        return value;
+        return evaluated;
 	}
 
     generator.variables[name] = value;
-    return value;
-}
\ No newline at end of file
+    return evaluated;
+}
+
+Value* findAppendTarget(CodeGenerator& generator, const AssignNode* assignNode) {
+    if (!dynamic_cast<const BinaryExprNode*>(assignNode->getValue().get()) || !isAppendTo(assignNode->getValue().get(), assignNode->getName())) {
+        return nullptr;
+    }
+
+    // Inside a function the assignment always writes a local, so a global string must not be appended to
+    std::unordered_map<std::string, Value>& scope = generator.functionHandler->currentFunctionContext.empty()
+        ? generator.variables
+        : generator.functionHandler->currentFunctionContext.top().variables;
+    auto it = scope.find(assignNode->getName());
+    if (it == scope.end() || !ValueHelper::isString(it->second)) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+Result<Value> appendToString(CodeGenerator& generator, const AssignNode* assignNode, Value& target) {
+    // Walk down the left spine, then reverse so the operands are in evaluation order
+    std::vector<const BinaryExprNode*> operands;
+    for (auto node = dynamic_cast<const BinaryExprNode*>(assignNode->getValue().get()); node;
+        node = dynamic_cast<const BinaryExprNode*>(node->getLeft().get())) {
+        operands.push_back(node);
+    }
+    std::reverse(operands.begin(), operands.end());
+
+    // Operands are evaluated before appending so that `s = s + s` sees the original value.
+    // Evaluating them cannot replace the target, as element references in the scope map stay valid.
+    std::vector<Value> values;
+    values.reserve(operands.size());
+    for (const auto* operand : operands) {
+        Result<Value> value = evaluate(operand->getRight().get(), generator);
+        if (!value.ok()) {
+            return value;
+        }
+        values.push_back(std::move(*value));
+        if (!StringOperations::canAppend(values.back())) {
+            // Report the same error the binary operation would
+            Result<Value> failed = generator.performBinaryOperation(operand, target, values.back());
+            if (!failed.ok()) {
+                return failed;
+            }
+        }
+    }
+
+    std::string& text = std::get<std::string>(target);
+    for (const auto& value : values) {
+        ValueHelper::appendString(text, value);
+    }
+
+    // Assignments are statements, so the grown string is not copied back out
+    return std::monostate();
+}
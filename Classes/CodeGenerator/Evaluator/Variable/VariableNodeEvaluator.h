@@ -2,6 +2,7 @@
 #define VARIABLENODEEVALUATOR_H
 
 #include "Value/Value.h"
+#include "Result/Result.h"
 #include "AST/AST.h"
 
 class CodeGenerator;
@@ -15,10 +16,9 @@ class VariableNode;
  *
  * @param generator Reference to the CodeGenerator.
  * @param varNode Pointer to the VariableNode to be evaluated.
- * @return The value of the variable.
- * @throws std::runtime_error if the variable is undefined.
+ * @return The value of the variable, or an error if the variable is undefined.
  */
-Value evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode);
+Result<Value> evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode);
 
 /**
  * @brief Evaluates an assignment node.
@@ -28,8 +28,32 @@ Value evaluateVariableNode(CodeGenerator& generator, const VariableNode* varNode
  *
  * @param generator Reference to the CodeGenerator.
  * @param assignNode Pointer to the AssignNode to be evaluated.
- * @return The assigned value.
+ * @return The assigned value, or the error evaluating it failed with.
  */
-Value evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode);
+Result<Value> evaluateAssignNode(CodeGenerator& generator, const AssignNode* assignNode);
+
+/**
+ * @brief Finds the string variable an assignment of the form `name = name + ...` can append to in place.
+ *
+ * The variable must already hold a string in the scope the assignment writes to.
+ *
+ * @param generator Reference to the CodeGenerator.
+ * @param assignNode Pointer to the AssignNode being evaluated.
+ * @return Pointer to the variable's value, or nullptr if the assignment must be evaluated normally.
+ */
+Value* findAppendTarget(CodeGenerator& generator, const AssignNode* assignNode);
+
+/**
+ * @brief Evaluates `name = name + a + b ...` by appending to the existing string instead of rebuilding it.
+ *
+ * Appending reuses the string's capacity, so building a string in a loop takes amortised O(1)
+ * per append rather than copying the whole accumulated string on every iteration.
+ *
+ * @param generator Reference to the CodeGenerator.
+ * @param assignNode Pointer to the AssignNode being evaluated.
+ * @param target The string variable returned by findAppendTarget.
+ * @return An empty value, as the assignment is a statement, or an error if an operand fails or cannot be appended to a string.
+ */
+Result<Value> appendToString(CodeGenerator& generator, const AssignNode* assignNode, Value& target);
 
 #endif // VARIABLENODEEVALUATOR_H
@@ -0,0 +1,59 @@
+#include "ExecutableMemory.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+ExecutableMemory::ExecutableMemory(const std::vector<uint8_t>& code) : codeSize(code.size()) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t pageSize = info.dwPageSize;
+#else
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    mappedSize = (code.size() + pageSize - 1) / pageSize * pageSize;
+    if (mappedSize == 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    void* pages = VirtualAlloc(nullptr, mappedSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!pages) {
+        return;
+    }
+    std::memcpy(pages, code.data(), code.size());
+    DWORD previous;
+    if (!VirtualProtect(pages, mappedSize, PAGE_EXECUTE_READ, &previous)) {
+        VirtualFree(pages, 0, MEM_RELEASE);
+        return;
+    }
+    FlushInstructionCache(GetCurrentProcess(), pages, mappedSize);
+#else
+    void* pages = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pages == MAP_FAILED) {
+        return;
+    }
+    std::memcpy(pages, code.data(), code.size());
+    if (mprotect(pages, mappedSize, PROT_READ | PROT_EXEC) != 0) {
+        munmap(pages, mappedSize);
+        return;
+    }
+#endif
+    memory = pages;
+}
+
+ExecutableMemory::~ExecutableMemory() {
+    if (!memory) {
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, mappedSize);
+#endif
+}
@@ -0,0 +1,49 @@
+#ifndef EXECUTABLEMEMORY_H
+#define EXECUTABLEMEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ExecutableMemory
+ * @brief Owns a block of pages holding machine code.
+ *
+ * The code is copied into pages mapped writable, which are then made executable and read-only,
+ * so no page is ever writable and executable at once.
+ */
+class ExecutableMemory {
+public:
+    /**
+     * @brief Maps pages for the code, copies it in and makes them executable.
+     * @param code The machine code.
+     */
+    explicit ExecutableMemory(const std::vector<uint8_t>& code);
+
+    ~ExecutableMemory();
+
+    ExecutableMemory(const ExecutableMemory&) = delete;
+    ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+    /**
+     * @brief Checks whether the pages were mapped and made executable.
+     * @return True if the code can be run.
+     */
+    bool isValid() const { return memory != nullptr; }
+
+    /**
+     * @brief Gets the address of a byte of the code.
+     * @param offset The offset of the byte from the start of the code.
+     * @return The address.
+     */
+    const uint8_t* at(size_t offset) const { return static_cast<const uint8_t*>(memory) + offset; }
+
+    size_t size() const { return codeSize; }
+
+private:
+    void* memory = nullptr; ///< The start of the mapping, or null if mapping failed.
+    size_t mappedSize = 0; ///< The size of the mapping, a multiple of the page size.
+    size_t codeSize = 0; ///< The size of the code.
+};
+
+#endif // EXECUTABLEMEMORY_H
@@ -0,0 +1,254 @@
+#include "JITRuntime.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include "Value/ValueHelper.h"
+
+namespace {
+    using FunctionEntry = int (*)(const double* args, double* result);
+    using LoopEntry = int (*)(uint64_t* state);
+
+    // Native code holds whole numbers only as ints, so a whole double from a literal like 2.0 cannot enter it
+    bool toNative(const Value& value, double& number) {
+        if (ValueHelper::isInt(value)) {
+            number = std::get<int>(value);
+            return true;
+        }
+        if (ValueHelper::isDouble(value)) {
+            number = std::get<double>(value);
+            return std::floor(number) != number;
+        }
+        return false;
+    }
+
+    Value fromNative(double number) {
+        if (std::floor(number) == number) {
+            return static_cast<int>(number);
+        }
+        return number;
+    }
+
+    template <typename Entry>
+    Entry entryPoint(const NativeUnit& unit) {
+        return reinterpret_cast<Entry>(const_cast<uint8_t*>(unit.memory->at(unit.hostEntry)));
+    }
+}
+
+bool JITRuntime::isSupported() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;
+#else
+    return false;
+#endif
+}
+
+const NativeUnit* JITRuntime::prepare(const Function& function) {
+    const size_t calls = function.countCall();
+    FunctionState& state = functionStates[&function];
+    if (!state.attempted && calls >= options.threshold) {
+        compile(function, state);
+    }
+    // Native callers keep calling the code of a deoptimised function, as they always pass numbers
+    return state.deoptimized ? nullptr : state.unit.get();
+}
+
+void JITRuntime::compile(const Function& function, FunctionState& state) {
+    state.attempted = true;
+    state.compiling = true;
+    NativeCompiler compiler(*this);
+    state.unit = compiler.compileFunction(function);
+    state.failure = compiler.getFailure();
+    state.compiling = false;
+}
+
+const uint8_t* JITRuntime::resolveCallee(const Function& function) {
+    FunctionState& state = functionStates[&function];
+    if (!state.attempted) {
+        compile(function, state);
+    }
+    if (!state.unit) {
+        return nullptr;
+    }
+    return state.unit->memory->at(state.unit->callEntry);
+}
+
+Result<bool> JITRuntime::call(const Function& function, const NativeUnit& unit, const std::vector<Value>& args, Value& result) {
+    FunctionState& state = functionStates[&function];
+    std::vector<double> numbers(args.size());
+    for (size_t i = 0; i < args.size(); i++) {
+        if (!toNative(args[i], numbers[i])) {
+            state.deoptimized = ++state.guardFailures >= maxGuardFailures;
+            return false;
+        }
+    }
+
+    double returned = 0;
+    const int status = entryPoint<FunctionEntry>(unit)(numbers.data(), &returned);
+    state.runs++;
+    state.guardFailures = 0;
+    if (status != 0) {
+        return error(status);
+    }
+    result = fromNative(returned);
+    return true;
+}
+
+Result<bool> JITRuntime::runLoop(const WhileNode* loop, std::unordered_map<std::string, Value>& globals, bool replacing) {
+    LoopState& state = loopStates[loop];
+    if (state.line == 0) {
+        state.line = loop->getToken().line;
+        state.names = NativeCompiler::collectVariables(loop);
+    }
+
+    // The code is specialised for the kinds of the globals defined when the loop starts
+    std::unordered_map<std::string, NativeKind> shape;
+    for (const std::string& name : state.names) {
+        auto global = globals.find(name);
+        if (global == globals.end()) {
+            continue;
+        }
+        double number;
+        if (ValueHelper::isBool(global->second)) {
+            shape[name] = NativeKind::BOOL;
+        }
+        else if (toNative(global->second, number)) {
+            shape[name] = NativeKind::NUMBER;
+        }
+        else {
+            return false;
+        }
+    }
+    if (!state.attempted || shape != state.shape) {
+        if (state.compilations >= maxLoopCompilations) {
+            return false;
+        }
+        state.compilations++;
+        state.attempted = true;
+        state.shape = shape;
+        NativeCompiler compiler(*this);
+        state.unit = compiler.compileLoop(loop, shape);
+        state.failure = compiler.getFailure();
+    }
+    if (!state.unit) {
+        return false;
+    }
+
+    const NativeUnit& unit = *state.unit;
+    std::vector<uint64_t> frame(unit.frameSlots, 0);
+    for (const NativeVariable& variable : unit.variables) {
+        if (variable.flagSlot >= 0) {
+            continue;
+        }
+        const Value& value = globals.at(variable.name);
+        // The shape guarantees the kind of every global the code reads
+        if (variable.kind == NativeKind::BOOL) {
+            frame[variable.slot] = std::get<bool>(value) ? 1 : 0;
+        }
+        else {
+            double number = ValueHelper::isInt(value) ? std::get<int>(value) : std::get<double>(value);
+            std::memcpy(&frame[variable.slot], &number, sizeof(number));
+        }
+    }
+
+    const int status = entryPoint<LoopEntry>(unit)(frame.data());
+    state.runs++;
+    state.replacements += replacing ? 1 : 0;
+
+    // Assignments made before an error stay visible, as they would in the interpreter
+    for (const NativeVariable& variable : unit.variables) {
+        if (variable.flagSlot >= 0 && frame[variable.flagSlot] == 0) {
+            continue;
+        }
+        if (variable.kind == NativeKind::BOOL) {
+            globals[variable.name] = frame[variable.slot] != 0;
+        }
+        else {
+            double number;
+            std::memcpy(&number, &frame[variable.slot], sizeof(number));
+            globals[variable.name] = fromNative(number);
+        }
+    }
+    if (status != 0) {
+        return error(status);
+    }
+    return true;
+}
+
+void JITRuntime::invalidate() {
+    functionStates.clear();
+    loopStates.clear();
+    invalidations++;
+}
+
+int JITRuntime::addErrorSite(RuntimeError error) {
+    errorSites.push_back(std::move(error));
+    return static_cast<int>(errorSites.size());
+}
+
+const Function* JITRuntime::findFunction(const std::string& name) const {
+    auto it = functions.find(name);
+    return it == functions.end() ? nullptr : it->second.get();
+}
+
+RuntimeError JITRuntime::error(int status) const {
+    return errorSites[static_cast<size_t>(status - 1)];
+}
+
+std::string JITRuntime::report() const {
+    struct Row {
+        std::string unit;
+        size_t bytes;
+        size_t runs;
+        std::string status;
+    };
+    std::vector<Row> rows;
+    size_t compiled = 0;
+    size_t runs = 0;
+    size_t replacements = 0;
+    size_t deoptimizations = 0;
+
+    for (const auto& entry : functionStates) {
+        const FunctionState& state = entry.second;
+        if (!state.attempted) {
+            continue;
+        }
+        compiled += state.unit ? 1 : 0;
+        runs += state.runs;
+        deoptimizations += state.deoptimized ? 1 : 0;
+        std::string status = state.unit ? "compiled" : "rejected: " + state.failure;
+        if (state.deoptimized) {
+            status += ", deoptimized after " + std::to_string(maxGuardFailures) + " failed type guards";
+        }
+        rows.push_back({ entry.first->getName(), state.unit ? state.unit->memory->size() : 0, state.runs, status });
+    }
+    for (const auto& entry : loopStates) {
+        const LoopState& state = entry.second;
+        if (!state.attempted) {
+            continue;
+        }
+        compiled += state.unit ? 1 : 0;
+        runs += state.runs;
+        replacements += state.replacements;
+        std::string status = state.unit ? "compiled" : "rejected: " + state.failure;
+        if (state.replacements > 0) {
+            status += " (" + std::to_string(state.replacements) + " on-stack replacements)";
+        }
+        if (state.compilations > 1) {
+            status += " (" + std::to_string(state.compilations) + " compilations)";
+        }
+        rows.push_back({ "while at line " + std::to_string(state.line), state.unit ? state.unit->memory->size() : 0, state.runs, status });
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.unit < b.unit; });
+
+    std::ostringstream out;
+    out << "JIT: " << compiled << " of " << rows.size() << " units compiled, " << runs << " native runs, "
+        << replacements << " on-stack replacements, " << deoptimizations << " deoptimizations, " << invalidations << " invalidations\n";
+    out << std::left << std::setw(24) << "Unit" << std::right << std::setw(8) << "Bytes" << std::setw(12) << "Runs" << "  Status\n";
+    for (const Row& row : rows) {
+        out << std::left << std::setw(24) << row.unit << std::right << std::setw(8) << row.bytes << std::setw(12) << row.runs
+            << "  " << row.status << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,175 @@
+#ifndef JITRUNTIME_H
+#define JITRUNTIME_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AST/AST.h"
+#include "Function/Function.h"
+#include "Value/Value.h"
+#include "Result/Result.h"
+#include "Structs/JIT/JITOptions.h"
+#include "NativeCompiler.h"
+
+/**
+ * @class JITRuntime
+ * @brief Compiles hot functions and loops of the program body to machine code and runs them.
+ *
+ * Code starts in the interpreter. A function is compiled once it has been called the threshold
+ * number of times, and a loop of the program body once the interpreter has run the loop
+ * threshold number of its iterations, for the types its globals hold then. A loop that becomes
+ * hot while it runs is replaced on the stack: the interpreter hands its globals to the code,
+ * which continues from the top of the next iteration. Later runs of a hot loop are compiled
+ * when they start. Code that cannot be compiled, and calls whose arguments native code cannot
+ * take, keep running in the interpreter, and a function whose type guards keep failing is
+ * deoptimised so the interpreter stops offering it its arguments. Errors raised by native code
+ * are returned with the interpreter's message for the same failure.
+ */
+class JITRuntime {
+public:
+    /**
+     * @brief Constructs a runtime compiling the functions of an execution.
+     * @param options The options controlling when code is compiled.
+     * @param functions The functions defined so far, which calls are resolved against.
+     */
+    JITRuntime(const JITOptions& options, const std::unordered_map<std::string, std::unique_ptr<Function>>& functions)
+        : options(options), functions(functions) {}
+
+    /**
+     * @brief Checks whether native code can run on this platform.
+     * @return True on x86-64.
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Counts a call to a function and compiles it once it is hot.
+     * @param function The called function.
+     * @return The code of the function, or null if it is not compiled.
+     */
+    const NativeUnit* prepare(const Function& function);
+
+    /**
+     * @brief Runs a compiled function.
+     * @param function The function.
+     * @param unit The code of the function.
+     * @param args The evaluated arguments.
+     * @param result Receives the return value.
+     * @return False, without running anything, if an argument is not a number native code takes,
+     * or the error the code raised.
+     */
+    Result<bool> call(const Function& function, const NativeUnit& unit, const std::vector<Value>& args, Value& result);
+
+    /**
+     * @brief Checks whether a loop of the program body has run enough iterations to be compiled when it starts.
+     * @param loop The loop.
+     * @return True if the loop is hot.
+     */
+    bool isHot(const WhileNode* loop) const { return loop->getBackEdges() >= options.loopThreshold; }
+
+    /**
+     * @brief Counts an iteration of a loop the interpreter is running.
+     * @param loop The loop.
+     * @return True if the loop became hot with this iteration, so it should be replaced on the stack.
+     */
+    bool countBackEdge(const WhileNode* loop) const { return loop->countBackEdge() == options.loopThreshold; }
+
+    /**
+     * @brief Runs a loop of the program body natively, compiling it for the types of its globals if needed.
+     * @param loop The loop.
+     * @param globals The global variables, updated with the values the loop assigns.
+     * @param replacing Whether the interpreter is running the loop, and the code continues it from the top of the next iteration.
+     * @return False, without running anything, if the loop has to be interpreted, or the error the
+     * code raised, after the globals are updated.
+     */
+    Result<bool> runLoop(const WhileNode* loop, std::unordered_map<std::string, Value>& globals, bool replacing = false);
+
+    /**
+     * @brief Drops all code, because a function it may call or inline was redefined.
+     */
+    void invalidate();
+
+    /**
+     * @brief Records an error native code can raise.
+     * @param error The error.
+     * @return The number native code returns to raise it, starting at 1.
+     */
+    int addErrorSite(RuntimeError error);
+
+    /**
+     * @brief Finds a function by name.
+     * @param name The name.
+     * @return The function, or null if it is not defined.
+     */
+    const Function* findFunction(const std::string& name) const;
+
+    /**
+     * @brief Compiles a function native code calls, whether it is hot or not.
+     * @param function The function.
+     * @return The native entry of the function, or null if it cannot be compiled or is being compiled.
+     */
+    const uint8_t* resolveCallee(const Function& function);
+
+    /**
+     * @brief Builds a text report of the compiled and rejected functions and loops.
+     * @return The report.
+     */
+    std::string report() const;
+
+private:
+    /**
+     * @struct FunctionState
+     * @brief The code of one function and how its type guards fared.
+     */
+    struct FunctionState {
+        size_t runs = 0; ///< Calls run natively from the interpreter.
+        size_t guardFailures = 0; ///< Consecutive calls whose arguments native code could not take.
+        bool deoptimized = false; ///< Whether the interpreter stopped offering the code its arguments.
+        bool attempted = false; ///< Whether compiling has started.
+        bool compiling = false; ///< Whether the function is being compiled, so calls back to it cannot be resolved yet.
+        std::unique_ptr<NativeUnit> unit; ///< The code, or null.
+        std::string failure; ///< Why the function was rejected.
+    };
+
+    /**
+     * @struct LoopState
+     * @brief The code of one loop and the types of the globals it was compiled for.
+     */
+    struct LoopState {
+        size_t line = 0; ///< The line of the loop.
+        std::vector<std::string> names; ///< The variables the loop uses.
+        std::unordered_map<std::string, NativeKind> shape; ///< The kinds of the globals defined when the code was compiled.
+        bool attempted = false; ///< Whether the loop was compiled for the current shape.
+        size_t compilations = 0; ///< Times the loop was compiled.
+        size_t runs = 0; ///< Times the code ran.
+        size_t replacements = 0; ///< Runs that continued the loop from the interpreter.
+        std::unique_ptr<NativeUnit> unit; ///< The code, or null.
+        std::string failure; ///< Why the loop was rejected.
+    };
+
+    static constexpr size_t maxLoopCompilations = 4; ///< Compilations of a loop before its globals are considered unstable.
+    static constexpr size_t maxGuardFailures = 16; ///< Consecutive failed type guards before a function is deoptimised.
+
+    JITOptions options;
+    const std::unordered_map<std::string, std::unique_ptr<Function>>& functions;
+    std::unordered_map<const Function*, FunctionState> functionStates;
+    std::unordered_map<const WhileNode*, LoopState> loopStates;
+    std::vector<RuntimeError> errorSites; ///< The errors native code can raise, by number minus one.
+    size_t invalidations = 0;
+
+    /**
+     * @brief Compiles a function, recording the code or why it was rejected.
+     * @param function The function.
+     * @param state The state of the function.
+     */
+    void compile(const Function& function, FunctionState& state);
+
+    /**
+     * @brief Gets the error native code returned.
+     * @param status The number of the error site.
+     * @return A copy of the error.
+     */
+    RuntimeError error(int status) const;
+};
+
+#endif // JITRUNTIME_H
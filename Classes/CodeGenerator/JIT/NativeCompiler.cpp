@@ -0,0 +1,942 @@
+#include "NativeCompiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "JITRuntime.h"
+#include "CodeGenerator/Evaluator/Evaluator.h"
+#include "Optimizer/Utility/ASTHelper.h"
+
+namespace {
+    // The largest frame a body may use, so the stack is never touched more than a page below its top
+    constexpr int maxFrameSlots = 512;
+
+    void collectAssignments(const ExprNode* node, std::vector<const AssignNode*>& assignments) {
+        if (!node) {
+            return;
+        }
+        // Bindings and hoisted assignments are owned as AssignNodes, so the child walk only reaches their values
+        if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+            assignments.push_back(assignNode);
+        }
+        else if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+            for (const auto& binding : inlinedNode->getBindings()) {
+                assignments.push_back(binding.get());
+            }
+        }
+        else if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+            for (const auto& assignment : hoistedNode->getHoisted()) {
+                assignments.push_back(assignment.get());
+            }
+        }
+        ASTHelper::forEachChild(node, [&assignments](const ExprNode* child) {
+            collectAssignments(child, assignments);
+        });
+    }
+
+    uint64_t bitsOf(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    std::string atLine(const ExprNode* node) {
+        return " at line " + std::to_string(node->getToken().line);
+    }
+
+    X86Emitter::Condition inverse(X86Emitter::Condition condition) {
+        // Condition codes come in pairs differing only in the lowest bit
+        return static_cast<X86Emitter::Condition>(condition ^ 1);
+    }
+}
+
+std::vector<std::string> NativeCompiler::collectVariables(const WhileNode* loop) {
+    std::vector<std::string> names;
+    std::unordered_set<std::string> seen;
+    auto add = [&names, &seen](const std::string& name) {
+        if (seen.insert(name).second) {
+            names.push_back(name);
+        }
+    };
+
+    std::vector<const AssignNode*> assignments;
+    std::function<void(const ExprNode*)> walk = [&](const ExprNode* node) {
+        if (!node) {
+            return;
+        }
+        if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+            add(varNode->getName());
+        }
+        else if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+            add(assignNode->getName());
+        }
+        else if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+            for (const auto& binding : inlinedNode->getBindings()) {
+                add(binding->getName());
+            }
+        }
+        else if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+            for (const auto& assignment : hoistedNode->getHoisted()) {
+                add(assignment->getName());
+            }
+        }
+        ASTHelper::forEachChild(node, walk);
+    };
+    walk(loop);
+    return names;
+}
+
+void NativeCompiler::reset() {
+    emitter = X86Emitter();
+    failure.clear();
+    function = nullptr;
+    kinds.clear();
+    slots.clear();
+    flagSlots.clear();
+    defined.clear();
+    depth = 0;
+    maxDepth = 0;
+    errorTargets.clear();
+}
+
+bool NativeCompiler::reject(const std::string& reason) {
+    if (failure.empty()) {
+        failure = reason;
+    }
+    return false;
+}
+
+std::unique_ptr<NativeUnit> NativeCompiler::compileFunction(const Function& compiled) {
+    reset();
+    function = &compiled;
+
+    const std::string& returnType = compiled.getReturnType();
+    if (returnType != "int" && returnType != "double") {
+        reject("returns " + returnType);
+        return nullptr;
+    }
+    const BlockNode* body = compiled.getBody().get();
+    const bool returns = body && std::any_of(body->getStatements().begin(), body->getStatements().end(), [](const auto& statement) {
+        return dynamic_cast<const ReturnNode*>(statement.get()) != nullptr;
+    });
+    if (!returns) {
+        reject("may end without returning a value");
+        return nullptr;
+    }
+
+    int slot = 0;
+    for (const Parameter& parameter : compiled.getParameters()) {
+        if (parameter.type != "int" && parameter.type != "double") {
+            reject("takes a " + parameter.type + " parameter");
+            return nullptr;
+        }
+        if (slots.count(parameter.name)) {
+            reject("repeats the parameter " + parameter.name);
+            return nullptr;
+        }
+        kinds[parameter.name] = NativeKind::NUMBER;
+        slots[parameter.name] = slot++;
+        defined.insert(parameter.name);
+    }
+    if (!inferKinds(body)) {
+        return nullptr;
+    }
+
+    // Locals take the slots after the parameters, in name order so the code does not depend on hashing
+    std::vector<std::string> locals;
+    for (const auto& kind : kinds) {
+        if (!slots.count(kind.first)) {
+            locals.push_back(kind.first);
+        }
+    }
+    std::sort(locals.begin(), locals.end());
+    for (const std::string& name : locals) {
+        slots[name] = slot++;
+    }
+    returnFlagSlot = slot++;
+    returnValueSlot = slot++;
+    scratchSlot = slot++;
+    tempBase = slot;
+
+    auto unit = std::make_unique<NativeUnit>();
+    normalize = emitter.newLabel();
+    selfEntry = emitter.newLabel();
+    Label exit = emitter.newLabel();
+
+    // Host entry: int(const double* args, double* result), returning 0 or the error site that stopped it
+    unit->hostEntry = emitter.position();
+    emitter.push(Register::RBX);
+    emitter.push(Register::RSI);
+    emitter.push(Register::RDI);
+    emitter.push(Register::R12);
+#ifdef _WIN32
+    emitter.mov(Register::R12, Register::RDX);
+    emitter.mov(Register::RSI, Register::RCX);
+#else
+    emitter.mov(Register::R12, Register::RSI);
+    emitter.mov(Register::RSI, Register::RDI);
+#endif
+    emitter.call(selfEntry);
+    emitter.movsd(Register::R12, 0, Xmm::XMM0);
+    emitter.pop(Register::R12);
+    emitter.pop(Register::RDI);
+    emitter.pop(Register::RSI);
+    emitter.pop(Register::RBX);
+    emitter.ret();
+
+    // Native entry: arguments at RSI, result in XMM0, status in EAX
+    emitter.bind(selfEntry);
+    unit->callEntry = emitter.position();
+    emitter.push(Register::RBX);
+    const size_t frameReserve = emitter.subImm(Register::RSP, 0);
+    emitter.mov(Register::RBX, Register::RSP);
+    for (size_t i = 0; i < compiled.getParameters().size(); i++) {
+        emitter.load(Register::RAX, Register::RSI, static_cast<int32_t>(8 * i));
+        emitter.store(Register::RBX, slotOffset(static_cast<int>(i)), Register::RAX);
+    }
+    emitter.storeImm(Register::RBX, slotOffset(returnFlagSlot), 0);
+
+    errorTargets.push_back(exit);
+    if (!compileBlock(body)) {
+        return nullptr;
+    }
+    emitter.movsd(Xmm::XMM0, Register::RBX, slotOffset(returnValueSlot));
+    emitter.movImm32(Register::RAX, 0);
+    emitter.bind(exit);
+    const size_t frameRelease = emitter.addImm(Register::RSP, 0);
+    emitter.pop(Register::RBX);
+    emitter.ret();
+    emitNormalize();
+
+    const int frameSlots = tempBase + maxDepth;
+    if (frameSlots > maxFrameSlots) {
+        reject("needs more than " + std::to_string(maxFrameSlots) + " frame slots");
+        return nullptr;
+    }
+    // An odd number of slots keeps the stack 16-byte aligned after the return address and RBX
+    const uint32_t frameBytes = static_cast<uint32_t>((frameSlots | 1) * 8);
+    emitter.patch32(frameReserve, frameBytes);
+    emitter.patch32(frameRelease, frameBytes);
+
+    if (!install(*unit)) {
+        return nullptr;
+    }
+    return unit;
+}
+
+std::unique_ptr<NativeUnit> NativeCompiler::compileLoop(const WhileNode* loop, const std::unordered_map<std::string, NativeKind>& globals) {
+    reset();
+    for (const auto& global : globals) {
+        kinds[global.first] = global.second;
+        defined.insert(global.first);
+    }
+    if (!inferKinds(loop)) {
+        return nullptr;
+    }
+
+    auto unit = std::make_unique<NativeUnit>();
+    int slot = 0;
+    const std::vector<std::string> names = collectVariables(loop);
+    for (const std::string& name : names) {
+        // A name without a kind is read but never defined, which compiling the read rejects
+        auto kind = kinds.find(name);
+        if (kind != kinds.end()) {
+            slots[name] = slot++;
+            unit->variables.push_back({ name, kind->second, slots[name], -1 });
+        }
+    }
+    for (NativeVariable& variable : unit->variables) {
+        if (!globals.count(variable.name)) {
+            variable.flagSlot = slot++;
+            flagSlots[variable.name] = variable.flagSlot;
+        }
+    }
+    scratchSlot = slot++;
+    tempBase = slot;
+
+    normalize = emitter.newLabel();
+    Label exit = emitter.newLabel();
+
+    // Host entry: int(uint64_t* state), returning 0 or the error site that stopped it
+    unit->hostEntry = emitter.position();
+    emitter.push(Register::RBX);
+    emitter.push(Register::RSI);
+    emitter.push(Register::RDI);
+#ifdef _WIN32
+    emitter.mov(Register::RBX, Register::RCX);
+#else
+    emitter.mov(Register::RBX, Register::RDI);
+#endif
+    errorTargets.push_back(exit);
+    if (!compileWhile(loop)) {
+        return nullptr;
+    }
+    emitter.movImm32(Register::RAX, 0);
+    emitter.bind(exit);
+    emitter.pop(Register::RDI);
+    emitter.pop(Register::RSI);
+    emitter.pop(Register::RBX);
+    emitter.ret();
+    emitNormalize();
+
+    unit->frameSlots = static_cast<size_t>(tempBase + maxDepth);
+    if (!install(*unit)) {
+        return nullptr;
+    }
+    return unit;
+}
+
+bool NativeCompiler::install(NativeUnit& unit) {
+    unit.memory = std::make_unique<ExecutableMemory>(emitter.finish());
+    if (!unit.memory->isValid()) {
+        return reject("executable memory could not be mapped");
+    }
+    return true;
+}
+
+bool NativeCompiler::inferKinds(const ExprNode* body) {
+    std::vector<const AssignNode*> assignments;
+    collectAssignments(body, assignments);
+
+    // A variable takes the kind of the first value whose kind is known; later values must agree
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const AssignNode* assignNode : assignments) {
+            std::optional<NativeKind> kind = kindOf(assignNode->getValue().get());
+            if (!kind) {
+                continue;
+            }
+            auto known = kinds.find(assignNode->getName());
+            if (known == kinds.end()) {
+                kinds[assignNode->getName()] = *kind;
+                changed = true;
+            }
+            else if (known->second != *kind) {
+                return reject(assignNode->getName() + " holds both numbers and bools");
+            }
+        }
+    }
+    for (const AssignNode* assignNode : assignments) {
+        if (!kinds.count(assignNode->getName())) {
+            return reject("the type of " + assignNode->getName() + atLine(assignNode) + " is not a number or a bool");
+        }
+    }
+    return true;
+}
+
+std::optional<NativeKind> NativeCompiler::kindOf(const ExprNode* node) const {
+    if (!node) {
+        return std::nullopt;
+    }
+    if (dynamic_cast<const IntegerNode*>(node) || dynamic_cast<const DoubleNode*>(node) || dynamic_cast<const FunctionCallNode*>(node)) {
+        return NativeKind::NUMBER;
+    }
+    if (dynamic_cast<const BooleanNode*>(node)) {
+        return NativeKind::BOOL;
+    }
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        auto kind = kinds.find(varNode->getName());
+        if (kind == kinds.end()) {
+            return std::nullopt;
+        }
+        return kind->second;
+    }
+    if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        switch (binNode->getToken().type) {
+            case TokenType::ARITHMETIC: return NativeKind::NUMBER;
+            case TokenType::COMPARISON:
+            case TokenType::LOGICAL: return NativeKind::BOOL;
+            default: return std::nullopt;
+        }
+    }
+    if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        if (unNode->getOp() == "-") {
+            return NativeKind::NUMBER;
+        }
+        if (unNode->getOp() == "!") {
+            return NativeKind::BOOL;
+        }
+        return std::nullopt;
+    }
+    if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        return kindOf(inlinedNode->getBody().get());
+    }
+    return std::nullopt;
+}
+
+void NativeCompiler::emitNormalize() {
+    Label slow = emitter.newLabel();
+    Label done = emitter.newLabel();
+    Label outOfRange = emitter.newLabel();
+
+    // Most results convert to a 32-bit int directly; 0x80000000 is also what every failed conversion gives
+    emitter.bind(normalize);
+    emitter.cvttsd2si32(Register::RAX, Xmm::XMM0);
+    emitter.cmpImm32(Register::RAX, INT32_MIN);
+    emitter.jcc(X86Emitter::EQUAL, slow);
+    emitter.cvtsi2sd32(Xmm::XMM1, Register::RAX);
+    emitter.ucomisd(Xmm::XMM0, Xmm::XMM1);
+    emitter.jcc(X86Emitter::NOT_EQUAL, done);
+    // Replaces -0.0 by 0.0 as the int would
+    emitter.movapd(Xmm::XMM0, Xmm::XMM1);
+    emitter.bind(done);
+    emitter.ret();
+
+    // NaN stays a double; any other whole number outside the int range becomes INT_MIN like the cast in toValue
+    emitter.bind(slow);
+    emitter.ucomisd(Xmm::XMM0, Xmm::XMM0);
+    emitter.jcc(X86Emitter::PARITY, done);
+    emitter.cvttsd2si64(Register::RAX, Xmm::XMM0);
+    emitter.movImm64(Register::RCX, 0x8000000000000000ull);
+    emitter.cmp(Register::RAX, Register::RCX);
+    emitter.jcc(X86Emitter::EQUAL, outOfRange);
+    emitter.cvtsi2sd64(Xmm::XMM1, Register::RAX);
+    emitter.ucomisd(Xmm::XMM0, Xmm::XMM1);
+    emitter.jcc(X86Emitter::NOT_EQUAL, done);
+    emitter.bind(outOfRange);
+    emitter.movImm32(Register::RAX, 0x80000000u);
+    emitter.cvtsi2sd32(Xmm::XMM0, Register::RAX);
+    emitter.ret();
+}
+
+int NativeCompiler::pushTemp() {
+    const int slot = tempBase + depth++;
+    maxDepth = std::max(maxDepth, depth);
+    return slot;
+}
+
+void NativeCompiler::emitError(RuntimeError error) {
+    emitter.movImm32(Register::RAX, static_cast<uint32_t>(runtime.addErrorSite(std::move(error))));
+    emitter.jmp(errorTargets.back());
+}
+
+void NativeCompiler::emitErrorIf(X86Emitter::Condition condition, const RuntimeError& error) {
+    Label skip = emitter.newLabel();
+    emitter.jcc(inverse(condition), skip);
+    emitError(error);
+    emitter.bind(skip);
+}
+
+bool NativeCompiler::emitTypeCheck(const std::string& type, const Token& token) {
+    const std::string line = std::to_string(token.line);
+    const RuntimeError error{ "Type Error: Return type mismatch in function at line " + line };
+    if (type != "int" && type != "double") {
+        return reject("returns a number from a " + type + " function at line " + line);
+    }
+    // Numbers are stored canonically, so whole numbers are exactly the ints
+    emitter.cvttsd2si32(Register::RAX, Xmm::XMM0);
+    emitter.cvtsi2sd32(Xmm::XMM1, Register::RAX);
+    emitter.ucomisd(Xmm::XMM0, Xmm::XMM1);
+    if (type == "int") {
+        emitErrorIf(X86Emitter::PARITY, error);
+        emitErrorIf(X86Emitter::NOT_EQUAL, error);
+    }
+    else {
+        Label isDouble = emitter.newLabel();
+        emitter.jcc(X86Emitter::PARITY, isDouble);
+        emitErrorIf(X86Emitter::EQUAL, error);
+        emitter.bind(isDouble);
+    }
+    return true;
+}
+
+bool NativeCompiler::compileStatement(const ExprNode* node) {
+    if (!node) {
+        return true;
+    }
+    if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+        return compileAssign(assignNode);
+    }
+    if (auto ifNode = dynamic_cast<const IfNode*>(node)) {
+        return compileIf(ifNode);
+    }
+    if (auto whileNode = dynamic_cast<const WhileNode*>(node)) {
+        return compileWhile(whileNode);
+    }
+    if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+        return compileHoistedWhile(hoistedNode);
+    }
+    if (auto blockNode = dynamic_cast<const BlockNode*>(node)) {
+        return compileBlock(blockNode);
+    }
+    if (auto returnNode = dynamic_cast<const ReturnNode*>(node)) {
+        return compileReturn(returnNode);
+    }
+    // Any other statement is an expression evaluated for its effects, such as a call
+    NativeKind kind;
+    return compileValue(node, kind);
+}
+
+bool NativeCompiler::compileBlock(const BlockNode* block) {
+    if (!block) {
+        return true;
+    }
+    for (const auto& statement : block->getStatements()) {
+        if (!compileStatement(statement.get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NativeCompiler::compileAssign(const AssignNode* assignNode) {
+    NativeKind kind;
+    if (!compileValue(assignNode->getValue().get(), kind)) {
+        return false;
+    }
+    const std::string& name = assignNode->getName();
+    auto slot = slots.find(name);
+    if (slot == slots.end() || kinds.at(name) != kind) {
+        return reject("the assignment to " + name + atLine(assignNode) + " changes its type");
+    }
+    if (kind == NativeKind::NUMBER) {
+        emitter.movsd(Register::RBX, slotOffset(slot->second), Xmm::XMM0);
+    }
+    else {
+        emitter.store(Register::RBX, slotOffset(slot->second), Register::RAX);
+    }
+    auto flag = flagSlots.find(name);
+    if (flag != flagSlots.end()) {
+        emitter.storeImm(Register::RBX, slotOffset(flag->second), 1);
+    }
+    defined.insert(name);
+    return true;
+}
+
+bool NativeCompiler::compileIf(const IfNode* ifNode) {
+    if (!compileCondition(ifNode->getCondition().get())) {
+        return false;
+    }
+    Label elseBranch = emitter.newLabel();
+    Label end = emitter.newLabel();
+    emitter.test32(Register::RAX, Register::RAX);
+    emitter.jcc(X86Emitter::EQUAL, elseBranch);
+
+    const std::unordered_set<std::string> before = defined;
+    if (!compileBlock(ifNode->getThenBlock().get())) {
+        return false;
+    }
+    const std::unordered_set<std::string> afterThen = defined;
+    emitter.jmp(end);
+
+    emitter.bind(elseBranch);
+    defined = before;
+    if (!compileBlock(ifNode->getElseBlock().get())) {
+        return false;
+    }
+    emitter.bind(end);
+
+    // Only what both branches assign is assigned after the if
+    std::unordered_set<std::string> both;
+    for (const std::string& name : afterThen) {
+        if (defined.count(name)) {
+            both.insert(name);
+        }
+    }
+    defined = std::move(both);
+    return true;
+}
+
+bool NativeCompiler::compileWhile(const WhileNode* whileNode) {
+    Label head = emitter.newLabel();
+    Label exit = emitter.newLabel();
+    const std::unordered_set<std::string> before = defined;
+
+    // Like the interpreter, the condition is checked again after every statement of the body
+    emitter.bind(head);
+    if (!compileCondition(whileNode->getCondition().get())) {
+        return false;
+    }
+    emitter.test32(Register::RAX, Register::RAX);
+    emitter.jcc(X86Emitter::EQUAL, exit);
+    if (const BlockNode* block = whileNode->getBlock().get()) {
+        for (const auto& statement : block->getStatements()) {
+            if (!compileStatement(statement.get()) || !compileCondition(whileNode->getCondition().get())) {
+                return false;
+            }
+            emitter.test32(Register::RAX, Register::RAX);
+            emitter.jcc(X86Emitter::EQUAL, exit);
+        }
+    }
+    emitter.jmp(head);
+    emitter.bind(exit);
+
+    // The body may not have run at all
+    defined = before;
+    return true;
+}
+
+bool NativeCompiler::compileHoistedWhile(const HoistedWhileNode* hoistedNode) {
+    Label fallback = emitter.newLabel();
+    Label end = emitter.newLabel();
+    const std::unordered_set<std::string> before = defined;
+
+    // A failing hoisted assignment runs the original loop instead, as in the interpreter
+    errorTargets.push_back(fallback);
+    for (const auto& assignment : hoistedNode->getHoisted()) {
+        if (!compileAssign(assignment.get())) {
+            return false;
+        }
+    }
+    errorTargets.pop_back();
+    if (!compileStatement(hoistedNode->getLoop().get())) {
+        return false;
+    }
+    const std::unordered_set<std::string> afterLoop = defined;
+    emitter.jmp(end);
+
+    emitter.bind(fallback);
+    defined = before;
+    if (!compileStatement(hoistedNode->getFallback().get())) {
+        return false;
+    }
+    emitter.bind(end);
+
+    std::unordered_set<std::string> both;
+    for (const std::string& name : afterLoop) {
+        if (defined.count(name)) {
+            both.insert(name);
+        }
+    }
+    defined = std::move(both);
+    return true;
+}
+
+bool NativeCompiler::compileReturn(const ReturnNode* returnNode) {
+    if (!function) {
+        return reject("returns outside of a function" + atLine(returnNode));
+    }
+    if (!returnNode->getValue()) {
+        return reject("returns without a value" + atLine(returnNode));
+    }
+
+    // Only the first return executed sets the value; later ones are skipped without evaluating it
+    Label skip = emitter.newLabel();
+    emitter.cmpImm(Register::RBX, slotOffset(returnFlagSlot), 0);
+    emitter.jcc(X86Emitter::NOT_EQUAL, skip);
+    emitter.storeImm(Register::RBX, slotOffset(returnFlagSlot), 1);
+    NativeKind kind;
+    if (!compileValue(returnNode->getValue().get(), kind)) {
+        return false;
+    }
+    if (kind != NativeKind::NUMBER) {
+        return reject("returns a bool" + atLine(returnNode));
+    }
+    if (!emitTypeCheck(function->getReturnType(), returnNode->getToken())) {
+        return false;
+    }
+    emitter.movsd(Register::RBX, slotOffset(returnValueSlot), Xmm::XMM0);
+    emitter.bind(skip);
+    return true;
+}
+
+bool NativeCompiler::compileValue(const ExprNode* node, NativeKind& kind) {
+    // A whole double literal is a double in the interpreter but would be stored as an int here
+    if (auto doubleNode = dynamic_cast<const DoubleNode*>(node)) {
+        const double value = doubleNode->getValue();
+        if (std::floor(value) == value) {
+            return reject("the whole double literal" + atLine(node) + " is stored as a double");
+        }
+    }
+    return compileOperand(node, kind);
+}
+
+bool NativeCompiler::compileOperand(const ExprNode* node, NativeKind& kind) {
+    if (!node) {
+        return reject("an expression is missing");
+    }
+    if (auto intNode = dynamic_cast<const IntegerNode*>(node)) {
+        emitter.movImm64(Register::RAX, bitsOf(intNode->getValue()));
+        emitter.movq(Xmm::XMM0, Register::RAX);
+        kind = NativeKind::NUMBER;
+        return true;
+    }
+    if (auto doubleNode = dynamic_cast<const DoubleNode*>(node)) {
+        emitter.movImm64(Register::RAX, bitsOf(doubleNode->getValue()));
+        emitter.movq(Xmm::XMM0, Register::RAX);
+        kind = NativeKind::NUMBER;
+        return true;
+    }
+    if (auto boolNode = dynamic_cast<const BooleanNode*>(node)) {
+        emitter.movImm32(Register::RAX, boolNode->getValue() ? 1 : 0);
+        kind = NativeKind::BOOL;
+        return true;
+    }
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        const std::string name = varNode->getName();
+        if (!defined.count(name)) {
+            return reject(name + " may be read before it is assigned" + atLine(node));
+        }
+        kind = kinds.at(name);
+        if (kind == NativeKind::NUMBER) {
+            emitter.movsd(Xmm::XMM0, Register::RBX, slotOffset(slots.at(name)));
+        }
+        else {
+            emitter.load(Register::RAX, Register::RBX, slotOffset(slots.at(name)));
+        }
+        return true;
+    }
+    if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        return compileBinary(binNode, kind);
+    }
+    if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        return compileUnary(unNode, kind);
+    }
+    if (auto callNode = dynamic_cast<const FunctionCallNode*>(node)) {
+        kind = NativeKind::NUMBER;
+        return compileCall(callNode);
+    }
+    if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        return compileInlinedCall(inlinedNode, kind);
+    }
+    return reject(std::string(nodeKindName(typeid(*node))) + atLine(node) + " is not supported");
+}
+
+bool NativeCompiler::compileCondition(const ExprNode* node) {
+    NativeKind kind;
+    if (!compileValue(node, kind)) {
+        return false;
+    }
+    if (kind != NativeKind::BOOL) {
+        return reject("the condition" + atLine(node) + " is not a bool");
+    }
+    return true;
+}
+
+bool NativeCompiler::compileBinary(const BinaryExprNode* binNode, NativeKind& kind) {
+    const TokenType type = binNode->getToken().type;
+    if (type == TokenType::ARITHMETIC) {
+        kind = NativeKind::NUMBER;
+        return compileArithmetic(binNode);
+    }
+    if (type != TokenType::COMPARISON && type != TokenType::LOGICAL) {
+        return reject("the operator " + binNode->getOp() + atLine(binNode) + " is not supported");
+    }
+
+    // Both sides are always evaluated, left first
+    NativeKind left, right;
+    if (!compileOperand(binNode->getLeft().get(), left)) {
+        return false;
+    }
+    const int temp = pushTemp();
+    if (left == NativeKind::NUMBER) {
+        emitter.movsd(Register::RBX, slotOffset(temp), Xmm::XMM0);
+    }
+    else {
+        emitter.store(Register::RBX, slotOffset(temp), Register::RAX);
+    }
+    if (!compileOperand(binNode->getRight().get(), right)) {
+        return false;
+    }
+    popTemp();
+    if (left != right || (type == TokenType::LOGICAL && left != NativeKind::BOOL)) {
+        return reject("the operands of " + binNode->getOp() + atLine(binNode) + " have different types");
+    }
+
+    const std::string& op = binNode->getOp();
+    kind = NativeKind::BOOL;
+    if (left == NativeKind::BOOL) {
+        emitter.mov(Register::RCX, Register::RAX);
+        emitter.load(Register::RAX, Register::RBX, slotOffset(temp));
+        if (op == "and") {
+            emitter.and32(Register::RAX, Register::RCX);
+        }
+        else if (op == "or") {
+            emitter.or32(Register::RAX, Register::RCX);
+        }
+        else if (op == "==" || op == "!=") {
+            emitter.cmp32(Register::RAX, Register::RCX);
+            emitter.setcc(op == "==" ? X86Emitter::EQUAL : X86Emitter::NOT_EQUAL, Register::RAX);
+            emitter.movzx8(Register::RAX, Register::RAX);
+        }
+        else {
+            return reject("the operator " + op + atLine(binNode) + " is not supported for bools");
+        }
+        return true;
+    }
+
+    // ucomisd sets the parity flag for NaN, which compares unequal and unordered like in C++
+    emitter.movapd(Xmm::XMM1, Xmm::XMM0);
+    emitter.movsd(Xmm::XMM0, Register::RBX, slotOffset(temp));
+    if (op == "==") {
+        emitter.ucomisd(Xmm::XMM0, Xmm::XMM1);
+        emitter.setcc(X86Emitter::EQUAL, Register::RAX);
+        emitter.setcc(X86Emitter::NO_PARITY, Register::RCX);
+        emitter.and32(Register::RAX, Register::RCX);
+    }
+    else if (op == "!=") {
+        emitter.ucomisd(Xmm::XMM0, Xmm::XMM1);
+        emitter.setcc(X86Emitter::NOT_EQUAL, Register::RAX);
+        emitter.setcc(X86Emitter::PARITY, Register::RCX);
+        emitter.or32(Register::RAX, Register::RCX);
+    }
+    else if (op == "<" || op == "<=") {
+        emitter.ucomisd(Xmm::XMM1, Xmm::XMM0);
+        emitter.setcc(op == "<" ? X86Emitter::ABOVE : X86Emitter::ABOVE_EQUAL, Register::RAX);
+    }
+    else if (op == ">" || op == ">=") {
+        emitter.ucomisd(Xmm::XMM0, Xmm::XMM1);
+        emitter.setcc(op == ">" ? X86Emitter::ABOVE : X86Emitter::ABOVE_EQUAL, Register::RAX);
+    }
+    else {
+        return reject("the operator " + op + atLine(binNode) + " is not supported for numbers");
+    }
+    emitter.movzx8(Register::RAX, Register::RAX);
+    return true;
+}
+
+bool NativeCompiler::compileArithmetic(const BinaryExprNode* binNode) {
+    NativeKind left, right;
+    if (!compileOperand(binNode->getLeft().get(), left)) {
+        return false;
+    }
+    const int temp = pushTemp();
+    emitter.movsd(Register::RBX, slotOffset(temp), Xmm::XMM0);
+    if (!compileOperand(binNode->getRight().get(), right)) {
+        return false;
+    }
+    popTemp();
+    if (left != NativeKind::NUMBER || right != NativeKind::NUMBER) {
+        return reject("the operands of " + binNode->getOp() + atLine(binNode) + " are not numbers");
+    }
+
+    const std::string& op = binNode->getOp();
+    const std::string line = std::to_string(binNode->getToken().line);
+    emitter.movapd(Xmm::XMM1, Xmm::XMM0);
+    emitter.movsd(Xmm::XMM0, Register::RBX, slotOffset(temp));
+    if (op == "+") {
+        emitter.addsd(Xmm::XMM0, Xmm::XMM1);
+    }
+    else if (op == "-") {
+        emitter.subsd(Xmm::XMM0, Xmm::XMM1);
+    }
+    else if (op == "*") {
+        emitter.mulsd(Xmm::XMM0, Xmm::XMM1);
+    }
+    else if (op == "/" || op == "%") {
+        // NaN is unordered rather than equal to zero, so it divides like in C++
+        Label nonZero = emitter.newLabel();
+        emitter.xorpd(Xmm::XMM2, Xmm::XMM2);
+        emitter.ucomisd(Xmm::XMM1, Xmm::XMM2);
+        emitter.jcc(X86Emitter::PARITY, nonZero);
+        emitErrorIf(X86Emitter::EQUAL, RuntimeError{ op == "/" ? "Arithmetic Operation Error: Division by zero at line " + line
+                                                                : "Arithmetic Operation Error: Modulo by zero at line " + line });
+        emitter.bind(nonZero);
+        if (op == "/") {
+            emitter.divsd(Xmm::XMM0, Xmm::XMM1);
+        }
+        else {
+            // fprem computes the exact remainder truncated towards zero, like fmod, a few bits per step
+            Label partial = emitter.newLabel();
+            emitter.movsd(Register::RBX, slotOffset(scratchSlot), Xmm::XMM1);
+            emitter.fld(Register::RBX, slotOffset(scratchSlot));
+            emitter.movsd(Register::RBX, slotOffset(scratchSlot), Xmm::XMM0);
+            emitter.fld(Register::RBX, slotOffset(scratchSlot));
+            emitter.bind(partial);
+            emitter.fprem();
+            emitter.fnstswAx();
+            emitter.testAhImm(0x04);
+            emitter.jcc(X86Emitter::NOT_EQUAL, partial);
+            emitter.fstpSt1();
+            emitter.fstp(Register::RBX, slotOffset(scratchSlot));
+            emitter.movsd(Xmm::XMM0, Register::RBX, slotOffset(scratchSlot));
+        }
+    }
+    else {
+        return reject("the operator " + op + atLine(binNode) + " is not supported");
+    }
+    emitter.call(normalize);
+    return true;
+}
+
+bool NativeCompiler::compileUnary(const UnaryExprNode* unNode, NativeKind& kind) {
+    if (!compileValue(unNode->getOperand().get(), kind)) {
+        return false;
+    }
+    if (unNode->getOp() == "-" && kind == NativeKind::NUMBER) {
+        emitter.movImm64(Register::RAX, 0x8000000000000000ull);
+        emitter.movq(Xmm::XMM1, Register::RAX);
+        emitter.xorpd(Xmm::XMM0, Xmm::XMM1);
+        emitter.call(normalize);
+        return true;
+    }
+    if (unNode->getOp() == "!" && kind == NativeKind::BOOL) {
+        emitter.xorImm8(Register::RAX, 1);
+        return true;
+    }
+    return reject("the operator " + unNode->getOp() + atLine(unNode) + " is not supported for its operand");
+}
+
+bool NativeCompiler::compileCall(const FunctionCallNode* callNode) {
+    const std::string& name = callNode->getName();
+    const Function* callee = runtime.findFunction(name);
+    if (!callee) {
+        return reject("calls " + name + atLine(callNode) + ", which is not defined yet");
+    }
+    const auto& args = callNode->getArgs();
+    if (callee->getParameters().size() != args.size()) {
+        return reject("calls " + name + atLine(callNode) + " with the wrong number of arguments");
+    }
+    const uint8_t* target = nullptr;
+    if (callee != function) {
+        target = runtime.resolveCallee(*callee);
+        if (!target) {
+            return reject("calls " + name + atLine(callNode) + ", which is not compiled");
+        }
+    }
+
+    // The arguments are evaluated in order into consecutive slots, which the callee reads through RSI
+    const int base = tempBase + depth;
+    for (size_t i = 0; i < args.size(); i++) {
+        pushTemp();
+    }
+    for (size_t i = 0; i < args.size(); i++) {
+        NativeKind kind;
+        if (!compileValue(args[i].get(), kind)) {
+            return false;
+        }
+        if (kind != NativeKind::NUMBER) {
+            return reject("passes a bool to " + name + atLine(callNode));
+        }
+        emitter.movsd(Register::RBX, slotOffset(base + static_cast<int>(i)), Xmm::XMM0);
+    }
+    emitter.lea(Register::RSI, Register::RBX, slotOffset(base));
+    if (target) {
+        emitter.callAbsolute(target);
+    }
+    else {
+        emitter.call(selfEntry);
+    }
+    for (size_t i = 0; i < args.size(); i++) {
+        popTemp();
+    }
+
+    // The callee's error site is passed on unchanged
+    Label ok = emitter.newLabel();
+    emitter.test32(Register::RAX, Register::RAX);
+    emitter.jcc(X86Emitter::EQUAL, ok);
+    emitter.jmp(errorTargets.back());
+    emitter.bind(ok);
+    return true;
+}
+
+bool NativeCompiler::compileInlinedCall(const InlinedCallNode* inlinedNode, NativeKind& kind) {
+    for (const auto& binding : inlinedNode->getBindings()) {
+        if (!compileAssign(binding.get())) {
+            return false;
+        }
+    }
+    if (!compileValue(inlinedNode->getBody().get(), kind)) {
+        return false;
+    }
+    if (!inlinedNode->needsReturnTypeCheck()) {
+        return true;
+    }
+    if (kind == NativeKind::BOOL) {
+        if (inlinedNode->getReturnType() != "bool") {
+            return reject("the inlined call to " + inlinedNode->getName() + atLine(inlinedNode) + " returns a bool from a " + inlinedNode->getReturnType() + " function");
+        }
+        return true;
+    }
+    return emitTypeCheck(inlinedNode->getReturnType(), inlinedNode->getReturnToken());
+}
@@ -0,0 +1,222 @@
+#ifndef NATIVECOMPILER_H
+#define NATIVECOMPILER_H
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "AST/AST.h"
+#include "Function/Function.h"
+#include "Result/Result.h"
+#include "ExecutableMemory.h"
+#include "X86Emitter.h"
+
+class JITRuntime;
+
+/**
+ * @enum NativeKind
+ * @brief The kinds of values native code holds.
+ */
+enum class NativeKind {
+    NUMBER, ///< An int or a double, held as a double in an SSE register or an 8-byte slot.
+    BOOL    ///< A bool, held as 0 or 1 in a general purpose register or an 8-byte slot.
+};
+
+/**
+ * @struct NativeVariable
+ * @brief A variable of a compiled loop, held in a slot of the state array the loop runs on.
+ */
+struct NativeVariable {
+    std::string name; ///< The name of the global.
+    NativeKind kind; ///< The kind of value it holds.
+    int slot; ///< The slot holding its value.
+    int flagSlot; ///< The slot set to 1 once it is assigned, or -1 if it is defined when the loop starts.
+};
+
+/**
+ * @struct NativeUnit
+ * @brief The machine code of a compiled function or loop.
+ */
+struct NativeUnit {
+    std::unique_ptr<ExecutableMemory> memory; ///< The executable code.
+    size_t hostEntry = 0; ///< Offset of the entry point following the platform's C calling convention.
+    size_t callEntry = 0; ///< Offset of the entry point native calls of a function use.
+    size_t frameSlots = 0; ///< Number of 8-byte slots of the state array a loop runs on.
+    std::vector<NativeVariable> variables; ///< The globals a loop reads and writes.
+};
+
+/**
+ * @class NativeCompiler
+ * @brief Compiles functions and loops whose values are all numbers or bools to x86-64 machine code.
+ *
+ * Code is generated from templates, one per AST node, with a frame of 8-byte slots addressed
+ * from RBX holding the variables and the operands waiting for their other side. Numbers are
+ * computed as doubles and stored like the interpreter's toValue, so whole results in the int
+ * range are exactly the ints the interpreter would produce and every other result is a
+ * double. Operations that fail in the interpreter leave the code with the number of an error
+ * site, whose error the runtime returns.
+ *
+ * A body is rejected, and keeps running in the interpreter, if it contains a node with effects
+ * the code cannot have, such as output, strings or lists, if a variable may be read before it is
+ * assigned, or if a variable holds both numbers and bools.
+ */
+class NativeCompiler {
+public:
+    /**
+     * @brief Constructs a compiler for a runtime.
+     * @param runtime The runtime that resolves calls and records error sites.
+     */
+    explicit NativeCompiler(JITRuntime& runtime) : runtime(runtime) {}
+
+    /**
+     * @brief Compiles a function whose parameters and return value are int or double.
+     * @param function The function.
+     * @return The code, or null if the function is rejected.
+     */
+    std::unique_ptr<NativeUnit> compileFunction(const Function& function);
+
+    /**
+     * @brief Compiles a loop of the program body for the globals defined when it starts.
+     * @param loop The loop.
+     * @param globals The kind of each global the loop uses that is defined when it starts.
+     * @return The code, or null if the loop is rejected.
+     */
+    std::unique_ptr<NativeUnit> compileLoop(const WhileNode* loop, const std::unordered_map<std::string, NativeKind>& globals);
+
+    /**
+     * @brief Gets why the last body was rejected.
+     * @return The reason, or an empty string if it was compiled.
+     */
+    const std::string& getFailure() const { return failure; }
+
+    /**
+     * @brief Collects the variables a loop reads or assigns, in the order they first appear.
+     * @param loop The loop.
+     * @return The names.
+     */
+    static std::vector<std::string> collectVariables(const WhileNode* loop);
+
+private:
+    using Register = X86Emitter::Register;
+    using Xmm = X86Emitter::Xmm;
+    using Label = X86Emitter::Label;
+
+    JITRuntime& runtime; ///< The runtime that resolves calls and records error sites.
+    X86Emitter emitter; ///< The code of the body being compiled.
+    std::string failure; ///< Why the body was rejected.
+
+    const Function* function = nullptr; ///< The function being compiled, or null for a loop.
+    Label selfEntry = 0; ///< The native entry of the function being compiled, for recursive calls.
+    std::unordered_map<std::string, NativeKind> kinds; ///< The kind of each variable.
+    std::unordered_map<std::string, int> slots; ///< The slot of each variable.
+    std::unordered_map<std::string, int> flagSlots; ///< The assigned flag of each global not defined when the loop starts.
+    std::unordered_set<std::string> defined; ///< The variables assigned on every path to the current point.
+    int returnFlagSlot = 0; ///< The slot set to 1 once the function has returned.
+    int returnValueSlot = 0; ///< The slot holding the return value.
+    int scratchSlot = 0; ///< The slot moving values between SSE and x87 registers.
+    int tempBase = 0; ///< The first slot holding operands.
+    int depth = 0; ///< Number of operand slots in use.
+    int maxDepth = 0; ///< Largest number of operand slots in use at once.
+    Label normalize = 0; ///< The subroutine storing a number like the interpreter's toValue.
+    std::vector<Label> errorTargets; ///< Where failures go, innermost last.
+
+    /**
+     * @brief Resets the state for a new body.
+     */
+    void reset();
+
+    /**
+     * @brief Records why the body is rejected, keeping the first reason.
+     * @param reason The reason.
+     * @return False, so rejecting can end a compile step.
+     */
+    bool reject(const std::string& reason);
+
+    /**
+     * @brief Finds the kind of every variable assigned in a body from the values assigned to it.
+     * @param body The body.
+     * @return False if a variable holds values of both kinds or of no provable kind.
+     */
+    bool inferKinds(const ExprNode* body);
+
+    /**
+     * @brief Gets the kind of an expression from the kinds of the variables found so far.
+     * @param node The expression.
+     * @return The kind, or nothing if it is not known yet.
+     */
+    std::optional<NativeKind> kindOf(const ExprNode* node) const;
+
+    /**
+     * @brief Emits the subroutine that stores XMM0 like toValue: whole numbers become ints, or INT_MIN out of range.
+     */
+    void emitNormalize();
+
+    int slotOffset(int slot) const { return slot * 8; }
+    int pushTemp();
+    void popTemp() { depth--; }
+
+    /**
+     * @brief Leaves through the innermost error target with an error site's number in EAX.
+     * @param error The error.
+     */
+    void emitError(RuntimeError error);
+
+    /**
+     * @brief Emits an error raised when a condition holds.
+     * @param condition The condition, from the flags set before.
+     * @param error The error.
+     */
+    void emitErrorIf(X86Emitter::Condition condition, const RuntimeError& error);
+
+    /**
+     * @brief Checks the number in XMM0 against a declared type, like a return statement.
+     * @param type The declared type, int or double.
+     * @param token The token of the return statement, whose position is reported if the check fails.
+     */
+    bool emitTypeCheck(const std::string& type, const Token& token);
+
+    bool compileStatement(const ExprNode* node);
+    bool compileBlock(const BlockNode* block);
+    bool compileAssign(const AssignNode* assignNode);
+    bool compileIf(const IfNode* ifNode);
+    bool compileWhile(const WhileNode* whileNode);
+    bool compileHoistedWhile(const HoistedWhileNode* hoistedNode);
+    bool compileReturn(const ReturnNode* returnNode);
+
+    /**
+     * @brief Compiles an expression whose value may be stored, leaving it in XMM0 or EAX.
+     * @param node The expression.
+     * @param kind Receives the kind of the value.
+     */
+    bool compileValue(const ExprNode* node, NativeKind& kind);
+
+    /**
+     * @brief Compiles an operand of an arithmetic or comparison, which may also be a whole double literal.
+     * @param node The expression.
+     * @param kind Receives the kind of the value.
+     */
+    bool compileOperand(const ExprNode* node, NativeKind& kind);
+
+    /**
+     * @brief Compiles a condition, leaving 0 or 1 in EAX.
+     * @param node The condition.
+     */
+    bool compileCondition(const ExprNode* node);
+
+    bool compileBinary(const BinaryExprNode* binNode, NativeKind& kind);
+    bool compileArithmetic(const BinaryExprNode* binNode);
+    bool compileUnary(const UnaryExprNode* unNode, NativeKind& kind);
+    bool compileCall(const FunctionCallNode* callNode);
+    bool compileInlinedCall(const InlinedCallNode* inlinedNode, NativeKind& kind);
+
+    /**
+     * @brief Maps the code and checks it could be made executable.
+     * @param unit The unit receiving the code.
+     */
+    bool install(NativeUnit& unit);
+};
+
+#endif // NATIVECOMPILER_H
@@ -0,0 +1,327 @@
+#include "X86Emitter.h"
+
+X86Emitter::Label X86Emitter::newLabel() {
+    labels.push_back(unbound);
+    return labels.size() - 1;
+}
+
+void X86Emitter::bind(Label label) {
+    labels[label] = code.size();
+}
+
+void X86Emitter::patch32(size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        code[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+std::vector<uint8_t> X86Emitter::finish() {
+    for (const Fixup& fixup : fixups) {
+        // Offsets are relative to the end of the 32-bit field, which ends the instruction
+        patch32(fixup.offset, static_cast<uint32_t>(static_cast<int64_t>(labels[fixup.label]) - static_cast<int64_t>(fixup.offset + 4)));
+    }
+    fixups.clear();
+    return code;
+}
+
+void X86Emitter::int32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        byte(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void X86Emitter::int64(uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        byte(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void X86Emitter::rex(bool wide, uint8_t reg, uint8_t base, bool force) {
+    uint8_t prefix = static_cast<uint8_t>(0x40 | (wide ? 8 : 0) | (reg & 8) >> 1 | (base & 8) >> 3);
+    if (prefix != 0x40 || force) {
+        byte(prefix);
+    }
+}
+
+void X86Emitter::memory(uint8_t reg, Register base, int32_t disp) {
+    byte(static_cast<uint8_t>(0x80 | (reg & 7) << 3 | (base & 7)));
+    if ((base & 7) == RSP) {
+        // RSP and R12 as a base need a SIB byte
+        byte(0x24);
+    }
+    int32(static_cast<uint32_t>(disp));
+}
+
+void X86Emitter::rel32(Label label) {
+    fixups.push_back({ code.size(), label });
+    int32(0);
+}
+
+void X86Emitter::sse(uint8_t prefix, uint8_t opcode, uint8_t reg, uint8_t rm, bool wide) {
+    byte(prefix);
+    rex(wide, reg, rm);
+    byte(0x0F);
+    byte(opcode);
+    modrm(reg, rm);
+}
+
+void X86Emitter::sseMemory(uint8_t prefix, uint8_t opcode, uint8_t reg, Register base, int32_t disp) {
+    byte(prefix);
+    rex(false, reg, base);
+    byte(0x0F);
+    byte(opcode);
+    memory(reg, base, disp);
+}
+
+void X86Emitter::push(Register reg) {
+    rex(false, 0, reg);
+    byte(static_cast<uint8_t>(0x50 | (reg & 7)));
+}
+
+void X86Emitter::pop(Register reg) {
+    rex(false, 0, reg);
+    byte(static_cast<uint8_t>(0x58 | (reg & 7)));
+}
+
+void X86Emitter::mov(Register dst, Register src) {
+    rex(true, src, dst);
+    byte(0x89);
+    modrm(src, dst);
+}
+
+void X86Emitter::movImm64(Register dst, uint64_t value) {
+    rex(true, 0, dst);
+    byte(static_cast<uint8_t>(0xB8 | (dst & 7)));
+    int64(value);
+}
+
+void X86Emitter::movImm32(Register dst, uint32_t value) {
+    rex(false, 0, dst);
+    byte(static_cast<uint8_t>(0xB8 | (dst & 7)));
+    int32(value);
+}
+
+void X86Emitter::load(Register dst, Register base, int32_t disp) {
+    rex(true, dst, base);
+    byte(0x8B);
+    memory(dst, base, disp);
+}
+
+void X86Emitter::store(Register base, int32_t disp, Register src) {
+    rex(true, src, base);
+    byte(0x89);
+    memory(src, base, disp);
+}
+
+void X86Emitter::storeImm(Register base, int32_t disp, int32_t value) {
+    rex(true, 0, base);
+    byte(0xC7);
+    memory(0, base, disp);
+    int32(static_cast<uint32_t>(value));
+}
+
+void X86Emitter::lea(Register dst, Register base, int32_t disp) {
+    rex(true, dst, base);
+    byte(0x8D);
+    memory(dst, base, disp);
+}
+
+size_t X86Emitter::addImm(Register reg, int32_t value) {
+    rex(true, 0, reg);
+    byte(0x81);
+    modrm(0, reg);
+    size_t offset = code.size();
+    int32(static_cast<uint32_t>(value));
+    return offset;
+}
+
+size_t X86Emitter::subImm(Register reg, int32_t value) {
+    rex(true, 0, reg);
+    byte(0x81);
+    modrm(5, reg);
+    size_t offset = code.size();
+    int32(static_cast<uint32_t>(value));
+    return offset;
+}
+
+void X86Emitter::cmpImm32(Register reg, int32_t value) {
+    rex(false, 0, reg);
+    byte(0x81);
+    modrm(7, reg);
+    int32(static_cast<uint32_t>(value));
+}
+
+void X86Emitter::cmpImm(Register base, int32_t disp, int32_t value) {
+    rex(true, 0, base);
+    byte(0x81);
+    memory(7, base, disp);
+    int32(static_cast<uint32_t>(value));
+}
+
+void X86Emitter::cmp(Register left, Register right) {
+    rex(true, right, left);
+    byte(0x39);
+    modrm(right, left);
+}
+
+void X86Emitter::cmp32(Register left, Register right) {
+    rex(false, right, left);
+    byte(0x39);
+    modrm(right, left);
+}
+
+void X86Emitter::test32(Register left, Register right) {
+    rex(false, right, left);
+    byte(0x85);
+    modrm(right, left);
+}
+
+void X86Emitter::and32(Register dst, Register src) {
+    rex(false, src, dst);
+    byte(0x21);
+    modrm(src, dst);
+}
+
+void X86Emitter::or32(Register dst, Register src) {
+    rex(false, src, dst);
+    byte(0x09);
+    modrm(src, dst);
+}
+
+void X86Emitter::xorImm8(Register reg, int8_t value) {
+    rex(false, 0, reg);
+    byte(0x83);
+    modrm(6, reg);
+    byte(static_cast<uint8_t>(value));
+}
+
+void X86Emitter::setcc(Condition condition, Register dst) {
+    // Without a REX prefix the byte registers 4 to 7 would be AH to BH
+    rex(false, 0, dst, dst >= RSP);
+    byte(0x0F);
+    byte(static_cast<uint8_t>(0x90 | condition));
+    modrm(0, dst);
+}
+
+void X86Emitter::movzx8(Register dst, Register src) {
+    rex(false, dst, src, src >= RSP);
+    byte(0x0F);
+    byte(0xB6);
+    modrm(dst, src);
+}
+
+void X86Emitter::movsd(Xmm dst, Register base, int32_t disp) {
+    sseMemory(0xF2, 0x10, dst, base, disp);
+}
+
+void X86Emitter::movsd(Register base, int32_t disp, Xmm src) {
+    sseMemory(0xF2, 0x11, src, base, disp);
+}
+
+void X86Emitter::movq(Xmm dst, Register src) {
+    sse(0x66, 0x6E, dst, src, true);
+}
+
+void X86Emitter::movapd(Xmm dst, Xmm src) {
+    sse(0x66, 0x28, dst, src);
+}
+
+void X86Emitter::addsd(Xmm dst, Xmm src) {
+    sse(0xF2, 0x58, dst, src);
+}
+
+void X86Emitter::subsd(Xmm dst, Xmm src) {
+    sse(0xF2, 0x5C, dst, src);
+}
+
+void X86Emitter::mulsd(Xmm dst, Xmm src) {
+    sse(0xF2, 0x59, dst, src);
+}
+
+void X86Emitter::divsd(Xmm dst, Xmm src) {
+    sse(0xF2, 0x5E, dst, src);
+}
+
+void X86Emitter::xorpd(Xmm dst, Xmm src) {
+    sse(0x66, 0x57, dst, src);
+}
+
+void X86Emitter::ucomisd(Xmm left, Xmm right) {
+    sse(0x66, 0x2E, left, right);
+}
+
+void X86Emitter::cvttsd2si32(Register dst, Xmm src) {
+    sse(0xF2, 0x2C, dst, src);
+}
+
+void X86Emitter::cvttsd2si64(Register dst, Xmm src) {
+    sse(0xF2, 0x2C, dst, src, true);
+}
+
+void X86Emitter::cvtsi2sd32(Xmm dst, Register src) {
+    sse(0xF2, 0x2A, dst, src);
+}
+
+void X86Emitter::cvtsi2sd64(Xmm dst, Register src) {
+    sse(0xF2, 0x2A, dst, src, true);
+}
+
+void X86Emitter::fld(Register base, int32_t disp) {
+    rex(false, 0, base);
+    byte(0xDD);
+    memory(0, base, disp);
+}
+
+void X86Emitter::fstp(Register base, int32_t disp) {
+    rex(false, 0, base);
+    byte(0xDD);
+    memory(3, base, disp);
+}
+
+void X86Emitter::fstpSt1() {
+    byte(0xDD);
+    byte(0xD9);
+}
+
+void X86Emitter::fprem() {
+    byte(0xD9);
+    byte(0xF8);
+}
+
+void X86Emitter::fnstswAx() {
+    byte(0xDF);
+    byte(0xE0);
+}
+
+void X86Emitter::testAhImm(uint8_t value) {
+    byte(0xF6);
+    byte(0xC4);
+    byte(value);
+}
+
+void X86Emitter::jmp(Label label) {
+    byte(0xE9);
+    rel32(label);
+}
+
+void X86Emitter::jcc(Condition condition, Label label) {
+    byte(0x0F);
+    byte(static_cast<uint8_t>(0x80 | condition));
+    rel32(label);
+}
+
+void X86Emitter::call(Label label) {
+    byte(0xE8);
+    rel32(label);
+}
+
+void X86Emitter::callAbsolute(const void* target) {
+    // Separately mapped code may be further away than a 32-bit offset reaches
+    movImm64(RAX, reinterpret_cast<uint64_t>(target));
+    byte(0xFF);
+    modrm(2, RAX);
+}
+
+void X86Emitter::ret() {
+    byte(0xC3);
+}
@@ -0,0 +1,150 @@
+#ifndef X86EMITTER_H
+#define X86EMITTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class X86Emitter
+ * @brief Encodes the x86-64 instructions the native code generator uses into a byte buffer.
+ *
+ * Memory operands are always a base register plus a 32-bit displacement. Jumps and calls to
+ * labels are encoded with 32-bit offsets, which are filled in once every label is bound.
+ */
+class X86Emitter {
+public:
+    /**
+     * @enum Register
+     * @brief The general purpose registers, numbered as in their encoding.
+     */
+    enum Register : uint8_t { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+    /**
+     * @enum Xmm
+     * @brief The SSE registers, numbered as in their encoding.
+     */
+    enum Xmm : uint8_t { XMM0, XMM1, XMM2, XMM3 };
+
+    /**
+     * @enum Condition
+     * @brief The condition codes of conditional jumps and setcc, numbered as in their encoding.
+     */
+    enum Condition : uint8_t {
+        OVERFLOW, NO_OVERFLOW, BELOW, ABOVE_EQUAL, EQUAL, NOT_EQUAL, BELOW_EQUAL, ABOVE,
+        SIGN, NO_SIGN, PARITY, NO_PARITY, LESS, GREATER_EQUAL, LESS_EQUAL, GREATER
+    };
+
+    using Label = size_t;
+
+    /**
+     * @brief Creates a label that is not yet bound to a position.
+     * @return The label.
+     */
+    Label newLabel();
+
+    /**
+     * @brief Binds a label to the current position.
+     * @param label The label.
+     */
+    void bind(Label label);
+
+    size_t position() const { return code.size(); }
+
+    /**
+     * @brief Overwrites a 32-bit value emitted earlier.
+     * @param offset The offset of the value.
+     * @param value The new value.
+     */
+    void patch32(size_t offset, uint32_t value);
+
+    /**
+     * @brief Resolves the jumps and calls to labels.
+     * @return The machine code.
+     */
+    std::vector<uint8_t> finish();
+
+    // General purpose registers; 32-bit operations clear the upper half of the destination
+    void push(Register reg);
+    void pop(Register reg);
+    void mov(Register dst, Register src);
+    void movImm64(Register dst, uint64_t value);
+    void movImm32(Register dst, uint32_t value);
+    void load(Register dst, Register base, int32_t disp);
+    void store(Register base, int32_t disp, Register src);
+    void storeImm(Register base, int32_t disp, int32_t value);
+    void lea(Register dst, Register base, int32_t disp);
+    /// @return The offset of the immediate, for patch32.
+    size_t addImm(Register reg, int32_t value);
+    /// @return The offset of the immediate, for patch32.
+    size_t subImm(Register reg, int32_t value);
+    void cmpImm32(Register reg, int32_t value);
+    void cmpImm(Register base, int32_t disp, int32_t value);
+    void cmp(Register left, Register right);
+    void cmp32(Register left, Register right);
+    void test32(Register left, Register right);
+    void and32(Register dst, Register src);
+    void or32(Register dst, Register src);
+    void xorImm8(Register reg, int8_t value);
+    void setcc(Condition condition, Register dst);
+    void movzx8(Register dst, Register src);
+
+    // SSE2 scalar doubles
+    void movsd(Xmm dst, Register base, int32_t disp);
+    void movsd(Register base, int32_t disp, Xmm src);
+    void movq(Xmm dst, Register src);
+    void movapd(Xmm dst, Xmm src);
+    void addsd(Xmm dst, Xmm src);
+    void subsd(Xmm dst, Xmm src);
+    void mulsd(Xmm dst, Xmm src);
+    void divsd(Xmm dst, Xmm src);
+    void xorpd(Xmm dst, Xmm src);
+    void ucomisd(Xmm left, Xmm right);
+    void cvttsd2si32(Register dst, Xmm src);
+    void cvttsd2si64(Register dst, Xmm src);
+    void cvtsi2sd32(Xmm dst, Register src);
+    void cvtsi2sd64(Xmm dst, Register src);
+
+    // x87, for the exact remainder SSE2 has no instruction for
+    void fld(Register base, int32_t disp);
+    void fstp(Register base, int32_t disp);
+    void fstpSt1();
+    void fprem();
+    void fnstswAx();
+    void testAhImm(uint8_t value);
+
+    // Control flow
+    void jmp(Label label);
+    void jcc(Condition condition, Label label);
+    void call(Label label);
+    void callAbsolute(const void* target);
+    void ret();
+
+private:
+    static constexpr size_t unbound = static_cast<size_t>(-1);
+
+    /**
+     * @struct Fixup
+     * @brief A 32-bit offset to a label, filled in by finish.
+     */
+    struct Fixup {
+        size_t offset; ///< The offset of the 32-bit field.
+        Label label; ///< The label it refers to.
+    };
+
+    std::vector<uint8_t> code; ///< The code emitted so far.
+    std::vector<size_t> labels; ///< The position of each label, or unbound.
+    std::vector<Fixup> fixups; ///< The fields referring to labels.
+
+    void byte(uint8_t value) { code.push_back(value); }
+    void int32(uint32_t value);
+    void int64(uint64_t value);
+    void rex(bool wide, uint8_t reg, uint8_t base, bool force = false);
+    void modrm(uint8_t reg, uint8_t rm) { byte(static_cast<uint8_t>(0xC0 | (reg & 7) << 3 | (rm & 7))); }
+    void memory(uint8_t reg, Register base, int32_t disp);
+    void rel32(Label label);
+    void sse(uint8_t prefix, uint8_t opcode, uint8_t reg, uint8_t rm, bool wide = false);
+    void sseMemory(uint8_t prefix, uint8_t opcode, uint8_t reg, Register base, int32_t disp);
+};
+
+#endif // X86EMITTER_H
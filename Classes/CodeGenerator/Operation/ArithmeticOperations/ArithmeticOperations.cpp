@@ -1,27 +1,39 @@
 #include "ArithmeticOperations.h"
 
-Value ArithmeticOperations::performArithmeticOperation(const Token& token, const std::string& op, const double left, const double right) {
+Result<Value> ArithmeticOperations::performArithmeticOperation(const Token&, const std::string& op, const double left, const double right) {
     double result;
 
     if (op == "+") result = left + right;
     else if (op == "-") result = left - right;
     else if (op == "*") result = left * right;
     else if (op == "/") {
-        if (right == 0) throw std::runtime_error("Arithmetic Operation Error: Division by zero");
+        if (right == 0) return RuntimeError{ "Arithmetic Operation Error: Division by zero" };
         result = left / right;
     }
     else if (op == "%") {
-        if (right == 0) throw std::runtime_error("Arithmetic Operation Error: Modulo by zero");
+        if (right == 0) return RuntimeError{ "Arithmetic Operation Error: Modulo by zero" };
         result = std::fmod(left, right);
     }
     else {
-        throw std::runtime_error("Arithmetic Operation Error: Invalid Operator " + op);
+        return RuntimeError{ "Arithmetic Operation Error: Invalid Operator " + op };
     }
 
-    // Check if result is an integer
-    if (std::floor(result) == result) {
-        return static_cast<int>(result);
+    // Whole number results are stored as an int
+    return toValue(result);
+}
+
+BinaryKernel ArithmeticOperations::selectKernel(const std::string& op, const Value& left, const Value& right) {
+    const bool leftInt = ValueHelper::isInt(left);
+    const bool rightInt = ValueHelper::isInt(right);
+    if (!(leftInt || ValueHelper::isDouble(left)) || !(rightInt || ValueHelper::isDouble(right))) {
+        return nullptr;
     }
 
-    return result;
+    const bool bothInt = leftInt && rightInt;
+    if (op == "+") return bothInt ? intAdd : numberAdd;
+    if (op == "-") return bothInt ? intSubtract : numberSubtract;
+    if (op == "*") return bothInt ? intMultiply : numberMultiply;
+    if (op == "/") return bothInt ? intDivide : numberDivide;
+    if (op == "%") return bothInt ? intModulo : numberModulo;
+    return nullptr;
 }
@@ -3,6 +3,7 @@
 
 #include "Token/Token.h"
 #include "Value/ValueHelper.h"
+#include "Cache/InlineCache.h"
 #include <cmath>
 
 /**
@@ -17,10 +18,112 @@ public:
      * @param op The arithmetic operator as a string (e.g., "+", "-", "*", "/", "%").
      * @param left The left operand value.
      * @param right The right operand value.
-     * @return The result of the arithmetic operation.
-     * @throws std::runtime_error if the operator is invalid or if there is a division/modulo by zero.
+     * @return The result of the arithmetic operation, or an error without a line if the operator is
+     * invalid or if there is a division/modulo by zero.
      */
-    static Value performArithmeticOperation(const Token& token, const std::string& op, const double left, const double right);
+    static Result<Value> performArithmeticOperation(const Token& token, const std::string& op, const double left, const double right);
+
+    /**
+     * @brief Converts the result of an arithmetic operation to a value.
+     * @param result The result, computed in double.
+     * @return The result as an int if it is a whole number, and as a double otherwise.
+     */
+    static Value toValue(double result) {
+        if (std::floor(result) == result) {
+            return static_cast<int>(result);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Selects the kernel for an arithmetic operator and the types of its operands.
+     * @param op The arithmetic operator.
+     * @param left The left operand value.
+     * @param right The right operand value.
+     * @return The kernel, or nullptr if the operands are not both numbers or the operator is invalid.
+     */
+    static BinaryKernel selectKernel(const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @name Kernels
+     * Arithmetic on operands of known types, with the results and errors of performArithmeticOperation.
+     * The int kernels require two ints and compute in double, so results out of the int range
+     * behave the same; the number kernels accept an int or a double on either side.
+     * @{
+     */
+    static Result<Value> intAdd(const Token&, Value& left, Value& right) {
+        return static_cast<int>(static_cast<double>(std::get<int>(left)) + std::get<int>(right));
+    }
+
+    static Result<Value> intSubtract(const Token&, Value& left, Value& right) {
+        return static_cast<int>(static_cast<double>(std::get<int>(left)) - std::get<int>(right));
+    }
+
+    static Result<Value> intMultiply(const Token&, Value& left, Value& right) {
+        return static_cast<int>(static_cast<double>(std::get<int>(left)) * std::get<int>(right));
+    }
+
+    static Result<Value> intDivide(const Token& token, Value& left, Value& right) {
+        if (std::get<int>(right) == 0) {
+            return zeroDivisorError(token, "Division");
+        }
+        return toValue(static_cast<double>(std::get<int>(left)) / std::get<int>(right));
+    }
+
+    static Result<Value> intModulo(const Token& token, Value& left, Value& right) {
+        if (std::get<int>(right) == 0) {
+            return zeroDivisorError(token, "Modulo");
+        }
+        // INT_MIN % -1 overflows, while the remainder computed in double is 0
+        return std::get<int>(right) == -1 ? 0 : std::get<int>(left) % std::get<int>(right);
+    }
+
+    static Result<Value> numberAdd(const Token&, Value& left, Value& right) {
+        return toValue(asNumber(left) + asNumber(right));
+    }
+
+    static Result<Value> numberSubtract(const Token&, Value& left, Value& right) {
+        return toValue(asNumber(left) - asNumber(right));
+    }
+
+    static Result<Value> numberMultiply(const Token&, Value& left, Value& right) {
+        return toValue(asNumber(left) * asNumber(right));
+    }
+
+    static Result<Value> numberDivide(const Token& token, Value& left, Value& right) {
+        if (asNumber(right) == 0) {
+            return zeroDivisorError(token, "Division");
+        }
+        return toValue(asNumber(left) / asNumber(right));
+    }
+
+    static Result<Value> numberModulo(const Token& token, Value& left, Value& right) {
+        if (asNumber(right) == 0) {
+            return zeroDivisorError(token, "Modulo");
+        }
+        return toValue(std::fmod(asNumber(left), asNumber(right)));
+    }
+    /** @} */
+
+private:
+    /**
+     * @brief Reads an operand that is known to be an int or a double.
+     * @param value The operand value.
+     * @return The operand as a double.
+     */
+    static double asNumber(const Value& value) {
+        return std::holds_alternative<int>(value) ? std::get<int>(value) : std::get<double>(value);
+    }
+
+    /**
+     * @brief Builds the error the generic path reports for a zero divisor.
+     * @param token The token of the operator, giving the position of the error.
+     * @param operation "Division" or "Modulo".
+     * @return The error.
+     */
+    static RuntimeError zeroDivisorError(const Token& token, const char* operation) {
+        return RuntimeError{ std::string("Arithmetic Operation Error: ") + operation + " by zero at line " + std::to_string(token.line) };
+    }
 };
 
 #endif // ARITHMETICOPERATIONS_H
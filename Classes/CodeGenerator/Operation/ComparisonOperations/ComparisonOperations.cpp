@@ -1,10 +1,28 @@
 #include "ComparisonOperations.h"
 
-Value ComparisonOperations::performComparisonOperation(const Token& token, const std::string& op, const Value& left, const Value& right) {
+namespace {
+    // Reads an operand compared with a number, converting anything but a double like an int
+    Result<double> toNumber(const Value& value) {
+        if (ValueHelper::isDouble(value)) {
+            return std::get<double>(value);
+        }
+        return ValueHelper::asInt(value);
+    }
+}
+
+Result<Value> ComparisonOperations::performComparisonOperation(const Token&, const std::string& op, const Value& left, const Value& right) {
         // check if the values are of type double or int
     if (ValueHelper::isDouble(left) || ValueHelper::isDouble(right) || ValueHelper::isInt(left) || ValueHelper::isInt(right)) {
-        double l = ValueHelper::isDouble(left) ? ValueHelper::asDouble(left) : ValueHelper::asInt(left);
-        double r = ValueHelper::isDouble(right) ? ValueHelper::asDouble(right) : ValueHelper::asInt(right);
+        Result<double> leftNumber = toNumber(left);
+        if (!leftNumber.ok()) {
+            return leftNumber.takeError();
+        }
+        Result<double> rightNumber = toNumber(right);
+        if (!rightNumber.ok()) {
+            return rightNumber.takeError();
+        }
+        double l = *leftNumber;
+        double r = *rightNumber;
         if (op == "==") return l == r;
         if (op == "!=") return l != r;
         if (op == "<") return l < r;
@@ -16,5 +34,31 @@ Value ComparisonOperations::performComparisonOperation(const Token& token, const
         if (op == "==") return left == right;
         if (op == "!=") return left != right;
     }
-    throw std::runtime_error("Comparison Operation Error: Unsupported comparison operator " + op);
+    return RuntimeError{ "Comparison Operation Error: Unsupported comparison operator " + op };
+}
+
+BinaryKernel ComparisonOperations::selectKernel(const std::string& op, const Value& left, const Value& right) {
+    const bool leftInt = ValueHelper::isInt(left);
+    const bool rightInt = ValueHelper::isInt(right);
+    if ((leftInt || ValueHelper::isDouble(left)) && (rightInt || ValueHelper::isDouble(right))) {
+        const bool bothInt = leftInt && rightInt;
+        if (op == "==") return bothInt ? intEqual : numberEqual;
+        if (op == "!=") return bothInt ? intNotEqual : numberNotEqual;
+        if (op == "<") return bothInt ? intLess : numberLess;
+        if (op == "<=") return bothInt ? intLessEqual : numberLessEqual;
+        if (op == ">") return bothInt ? intGreater : numberGreater;
+        if (op == ">=") return bothInt ? intGreaterEqual : numberGreaterEqual;
+        return nullptr;
+    }
+
+    // A string or bool compared with a number is converted to a number, which only the full dispatch does
+    if (ValueHelper::isString(left) && ValueHelper::isString(right)) {
+        if (op == "==") return stringEqual;
+        if (op == "!=") return stringNotEqual;
+    }
+    else if (ValueHelper::isBool(left) && ValueHelper::isBool(right)) {
+        if (op == "==") return boolEqual;
+        if (op == "!=") return boolNotEqual;
+    }
+    return nullptr;
 }
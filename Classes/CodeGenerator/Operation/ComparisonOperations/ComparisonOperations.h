@@ -3,6 +3,7 @@
 
 #include "Token/Token.h"
 #include "Value/ValueHelper.h"
+#include "Cache/InlineCache.h"
 
 /**
  * @class ComparisonOperations
@@ -16,10 +17,54 @@ public:
      * @param op The comparison operator as a string (e.g., "==", "!=", "<", "<=", ">", ">=").
      * @param left The left operand value.
      * @param right The right operand value.
-     * @return The result of the comparison operation as a Value (boolean).
-     * @throws std::runtime_error if the operator is unsupported or the comparison is invalid.
+     * @return The result of the comparison operation as a Value (boolean), or an error without a
+     * line if the operator is unsupported or the comparison is invalid.
      */
-    static Value performComparisonOperation(const Token& token, const std::string& op, const Value& left, const Value& right);
+    static Result<Value> performComparisonOperation(const Token& token, const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @brief Selects the kernel for a comparison operator and the types of its operands.
+     * @param op The comparison operator.
+     * @param left The left operand value.
+     * @param right The right operand value.
+     * @return The kernel, or nullptr unless both operands are numbers, or both are strings or bools compared with == or !=.
+     */
+    static BinaryKernel selectKernel(const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @name Kernels
+     * Comparisons of operands of known types, with the results of performComparisonOperation.
+     * The int kernels require two ints, the number kernels accept an int or a double on either
+     * side, and the string and bool kernels require two operands of that type.
+     * @{
+     */
+    static Result<Value> intEqual(const Token&, Value& left, Value& right) { return std::get<int>(left) == std::get<int>(right); }
+    static Result<Value> intNotEqual(const Token&, Value& left, Value& right) { return std::get<int>(left) != std::get<int>(right); }
+    static Result<Value> intLess(const Token&, Value& left, Value& right) { return std::get<int>(left) < std::get<int>(right); }
+    static Result<Value> intLessEqual(const Token&, Value& left, Value& right) { return std::get<int>(left) <= std::get<int>(right); }
+    static Result<Value> intGreater(const Token&, Value& left, Value& right) { return std::get<int>(left) > std::get<int>(right); }
+    static Result<Value> intGreaterEqual(const Token&, Value& left, Value& right) { return std::get<int>(left) >= std::get<int>(right); }
+    static Result<Value> numberEqual(const Token&, Value& left, Value& right) { return asNumber(left) == asNumber(right); }
+    static Result<Value> numberNotEqual(const Token&, Value& left, Value& right) { return asNumber(left) != asNumber(right); }
+    static Result<Value> numberLess(const Token&, Value& left, Value& right) { return asNumber(left) < asNumber(right); }
+    static Result<Value> numberLessEqual(const Token&, Value& left, Value& right) { return asNumber(left) <= asNumber(right); }
+    static Result<Value> numberGreater(const Token&, Value& left, Value& right) { return asNumber(left) > asNumber(right); }
+    static Result<Value> numberGreaterEqual(const Token&, Value& left, Value& right) { return asNumber(left) >= asNumber(right); }
+    static Result<Value> stringEqual(const Token&, Value& left, Value& right) { return std::get<std::string>(left) == std::get<std::string>(right); }
+    static Result<Value> stringNotEqual(const Token&, Value& left, Value& right) { return std::get<std::string>(left) != std::get<std::string>(right); }
+    static Result<Value> boolEqual(const Token&, Value& left, Value& right) { return std::get<bool>(left) == std::get<bool>(right); }
+    static Result<Value> boolNotEqual(const Token&, Value& left, Value& right) { return std::get<bool>(left) != std::get<bool>(right); }
+    /** @} */
+
+private:
+    /**
+     * @brief Reads an operand that is known to be an int or a double.
+     * @param value The operand value.
+     * @return The operand as a double.
+     */
+    static double asNumber(const Value& value) {
+        return std::holds_alternative<int>(value) ? std::get<int>(value) : std::get<double>(value);
+    }
 };
 
 #endif // COMPARISONOPERATIONS_H
@@ -1,8 +1,6 @@
 #include "LogicalOperations.h"
 
-Value LogicalOperations::performLogicalOperation(const Token& token, const std::string& op, const Value& left, const Value& right) {
-    std::string line = std::to_string(token.line);
-
+Result<Value> LogicalOperations::performLogicalOperation(const Token&, const std::string& op, const Value& left, const Value& right) {
     bool leftBool;
     bool rightBool;
 
@@ -26,11 +24,20 @@ Value LogicalOperations::performLogicalOperation(const Token& token, const std::
         rightBool = (std::get<std::string>(right) == "true");
     }
     else {
-        throw std::runtime_error("Logical Operation Error: Type mismatch or unsupported operation " + op);
+        return RuntimeError{ "Logical Operation Error: Type mismatch or unsupported operation " + op };
     }
 
     if (op == "and") return leftBool && rightBool;
     if (op == "or") return leftBool || rightBool;
 
-    throw std::runtime_error("Logical Operation Error: Unsupported logical operator " + op);
+    return RuntimeError{ "Logical Operation Error: Unsupported logical operator " + op };
+}
+
+BinaryKernel LogicalOperations::selectKernel(const std::string& op, const Value& left, const Value& right) {
+    if (!ValueHelper::isBool(left) || !ValueHelper::isBool(right)) {
+        return nullptr;
+    }
+    if (op == "and") return boolAnd;
+    if (op == "or") return boolOr;
+    return nullptr;
 }
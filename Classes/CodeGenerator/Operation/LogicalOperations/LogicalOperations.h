@@ -3,6 +3,7 @@
 
 #include "Token/Token.h"
 #include "Value/ValueHelper.h"
+#include "Cache/InlineCache.h"
 
 /**
  * @class LogicalOperations
@@ -16,10 +17,28 @@ public:
      * @param op The logical operator as a string (e.g., "and", "or").
      * @param left The left operand value.
      * @param right The right operand value.
-     * @return The result of the logical operation as a Value (boolean).
-     * @throws std::runtime_error if the operator is unsupported or the operation is invalid.
+     * @return The result of the logical operation as a Value (boolean), or an error without a line
+     * if the operator is unsupported or the operation is invalid.
      */
-    static Value performLogicalOperation(const Token& token, const std::string& op, const Value& left, const Value& right);
+    static Result<Value> performLogicalOperation(const Token& token, const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @brief Selects the kernel for a logical operator and the types of its operands.
+     * @param op The logical operator.
+     * @param left The left operand value.
+     * @param right The right operand value.
+     * @return The kernel, or nullptr unless both operands are bools.
+     */
+    static BinaryKernel selectKernel(const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @name Kernels
+     * Logical operations on two bools, with the results of performLogicalOperation.
+     * @{
+     */
+    static Result<Value> boolAnd(const Token&, Value& left, Value& right) { return std::get<bool>(left) && std::get<bool>(right); }
+    static Result<Value> boolOr(const Token&, Value& left, Value& right) { return std::get<bool>(left) || std::get<bool>(right); }
+    /** @} */
 };
 
 #endif // LOGICALOPERATIONS_H
@@ -1,25 +1,21 @@
 #include "OperationDispatcher.h"
 
-Value OperationDispatcher::dispatchOperation(const BinaryExprNode* binNode, const Value& left, const Value& right) {
-    const std::string& op = binNode->getOp();
-    Token token = binNode->getToken();
-    std::string line = std::to_string(token.line);
-    try {
+namespace {
+    // Performs an operation, failing with an error that does not name the line yet
+    Result<Value> performOperation(const Token& token, const std::string& op, const Value& left, const Value& right) {
         if (token.type == TokenType::ARITHMETIC) {
 
             if (ValueHelper::isDouble(left) && ValueHelper::isDouble(right)) {
-                double leftValue = ValueHelper::isDouble(left) ? ValueHelper::asDouble(left) : ValueHelper::asInt(left);
-                double rightValue = ValueHelper::isDouble(right) ? ValueHelper::asDouble(right) : ValueHelper::asInt(right);
-                return ArithmeticOperations::performArithmeticOperation(token, op, leftValue, rightValue);
+                return ArithmeticOperations::performArithmeticOperation(token, op, std::get<double>(left), std::get<double>(right));
             }
             else if (ValueHelper::isInt(left) && ValueHelper::isInt(right)) {
-                return ArithmeticOperations::performArithmeticOperation(token, op, ValueHelper::asInt(left), ValueHelper::asInt(right));
+                return ArithmeticOperations::performArithmeticOperation(token, op, std::get<int>(left), std::get<int>(right));
             }
             else if (ValueHelper::isDouble(left) && ValueHelper::isInt(right)) {
-                return ArithmeticOperations::performArithmeticOperation(token, op, ValueHelper::asDouble(left), ValueHelper::asInt(right));
+                return ArithmeticOperations::performArithmeticOperation(token, op, std::get<double>(left), std::get<int>(right));
             }
             else if (ValueHelper::isInt(left) && ValueHelper::isDouble(right)) {
-                return ArithmeticOperations::performArithmeticOperation(token, op, ValueHelper::asInt(left), ValueHelper::asDouble(right));
+                return ArithmeticOperations::performArithmeticOperation(token, op, std::get<int>(left), std::get<double>(right));
             }
             else if (ValueHelper::isString(left) && ValueHelper::isString(right)) {
                 return StringOperations::performStringOperation(token, op, left, right);
@@ -34,8 +30,8 @@ Value OperationDispatcher::dispatchOperation(const BinaryExprNode* binNode, cons
                 return StringOperations::performStringOperation(token, op, left, right);
             }
             else {
-                throw std::runtime_error("Arithmetic Operation Error: Unsupported operation " + op + " with types " + ValueHelper::type(left)
-                    + " and " + ValueHelper::type(right));
+                return RuntimeError{ "Arithmetic Operation Error: Unsupported operation " + op + " with types " + ValueHelper::type(left)
+                    + " and " + ValueHelper::type(right) };
             }
         }
 
@@ -47,12 +43,53 @@ Value OperationDispatcher::dispatchOperation(const BinaryExprNode* binNode, cons
             return LogicalOperations::performLogicalOperation(token, op, left, right);
         }
 
-        throw std::runtime_error("Arithmetic Operation Error: Type mismatch or unsupported operation " + op);
+        return RuntimeError{ "Arithmetic Operation Error: Type mismatch or unsupported operation " + op };
+    }
+}
+
+Result<Value> OperationDispatcher::dispatchOperation(const BinaryExprNode* binNode, const Value& left, const Value& right) {
+    return dispatchOperation(binNode->getToken(), binNode->getOp(), left, right);
+}
+
+Result<Value> OperationDispatcher::dispatchOperation(const Token& token, const std::string& op, const Value& left, const Value& right) {
+    Result<Value> result = performOperation(token, op, left, right);
+    if (!result.ok()) {
+        return RuntimeError{ result.getError().message + " at line " + std::to_string(token.line) };
     }
-    catch (const std::runtime_error& e) {
-        throw std::runtime_error(std::string(e.what()) + " at line " + line);
+    return result;
+}
+
+Result<Value> OperationDispatcher::dispatchMiss(const BinaryExprNode* binNode, const Value& left, const Value& right) {
+    InlineCache& cache = binNode->getCache();
+    cache.misses++;
+    if (cache.state != InlineCache::State::MEGAMORPHIC) {
+        if (cache.misses > InlineCache::maxMisses) {
+            cache.state = InlineCache::State::MEGAMORPHIC;
+            cache.kernel = nullptr;
+        }
+        else if (BinaryKernel kernel = selectKernel(binNode, left, right)) {
+            cache.kernel = kernel;
+            cache.leftType = static_cast<uint8_t>(left.index());
+            cache.rightType = static_cast<uint8_t>(right.index());
+            cache.state = InlineCache::State::MONOMORPHIC;
+        }
+    }
+    return dispatchOperation(binNode, left, right);
+}
+
+BinaryKernel OperationDispatcher::selectKernel(const BinaryExprNode* binNode, const Value& left, const Value& right) {
+    const std::string& op = binNode->getOp();
+    switch (binNode->getToken().type) {
+        case TokenType::ARITHMETIC:
+            if (BinaryKernel kernel = ArithmeticOperations::selectKernel(op, left, right)) {
+                return kernel;
+            }
+            return StringOperations::selectKernel(op, left, right);
+        case TokenType::COMPARISON:
+            return ComparisonOperations::selectKernel(op, left, right);
+        case TokenType::LOGICAL:
+            return LogicalOperations::selectKernel(op, left, right);
+        default:
+            return nullptr;
     }
-    catch (const std::exception& e) {
-		throw std::runtime_error("Exception: " + std::string(e.what()) + " at line " + line);
-	}
 }
@@ -20,10 +20,44 @@ public:
      * @param binNode Pointer to the binary expression node.
      * @param left The left operand value.
      * @param right The right operand value.
-     * @return The result of the dispatched operation.
-     * @throws std::runtime_error if the operation type is unsupported or if there is a type mismatch.
+     * @return The result of the dispatched operation, or an error naming the line of the token
+     * if the operation type is unsupported or if there is a type mismatch.
      */
-    static Value dispatchOperation(const BinaryExprNode* binNode, const Value& left, const Value& right);
+    static Result<Value> dispatchOperation(const BinaryExprNode* binNode, const Value& left, const Value& right);
+
+    /**
+     * @brief Dispatches an operation given by its token rather than a node, as generated code does.
+     * @param token The token of the operator, whose type selects the kind of operation and whose line is reported.
+     * @param op The operator.
+     * @param left The left operand value.
+     * @param right The right operand value.
+     * @return The result of the dispatched operation, or an error naming the line of the token
+     * if the operation type is unsupported or if there is a type mismatch.
+     */
+    static Result<Value> dispatchOperation(const Token& token, const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @brief Dispatches an operation whose operand types missed the inline cache of its site, and updates the cache.
+     *
+     * The cache is pointed at the kernel for the new operand types, or becomes megamorphic once
+     * the site has missed more than InlineCache::maxMisses times.
+     *
+     * @param binNode Pointer to the binary expression node.
+     * @param left The left operand value.
+     * @param right The right operand value.
+     * @return The result of the dispatched operation, or an error naming the line of the token
+     * if the operation type is unsupported or if there is a type mismatch.
+     */
+    static Result<Value> dispatchMiss(const BinaryExprNode* binNode, const Value& left, const Value& right);
+
+    /**
+     * @brief Selects the kernel that performs an operation for the types of its operands.
+     * @param binNode Pointer to the binary expression node.
+     * @param left The left operand value.
+     * @param right The right operand value.
+     * @return The kernel, or nullptr if the operand types are only handled by the full dispatch.
+     */
+    static BinaryKernel selectKernel(const BinaryExprNode* binNode, const Value& left, const Value& right);
 };
 
 #endif // OPERATIONDISPATCHER_H
@@ -1,6 +1,18 @@
 #include "StringOperations.h"
 
-Value StringOperations::performStringOperation(const Token& token, const std::string& op, const Value& left, const Value& right) {
-    if (op == "+") return ValueHelper::asString(left) + ValueHelper::asString(right);
-    throw std::runtime_error("String Operation Error: Invalid Operator " + op);
+Result<Value> StringOperations::performStringOperation(const Token&, const std::string& op, const Value& left, const Value& right) {
+    if (op == "+") {
+        std::string result = ValueHelper::asString(left);
+        ValueHelper::appendString(result, right);
+        return result;
+    }
+    return RuntimeError{ "String Operation Error: Invalid Operator " + op };
+}
+
+bool StringOperations::canAppend(const Value& value) {
+    return ValueHelper::isString(value) || ValueHelper::isInt(value) || ValueHelper::isDouble(value) || ValueHelper::isBool(value);
+}
+
+BinaryKernel StringOperations::selectKernel(const std::string& op, const Value& left, const Value& right) {
+    return op == "+" && ValueHelper::isString(left) && canAppend(right) ? concatenate : nullptr;
 }
@@ -3,6 +3,7 @@
 
 #include "Token/Token.h"
 #include "Value/ValueHelper.h"
+#include "Cache/InlineCache.h"
 
 /**
  * @class StringOperations
@@ -16,10 +17,37 @@ public:
      * @param op The string operator as a string (e.g., "+").
      * @param left The left operand value.
      * @param right The right operand value.
-     * @return The result of the string operation as a Value (string).
-     * @throws std::runtime_error if the operator is invalid.
+     * @return The result of the string operation as a Value (string), or an error without a line if the operator is invalid.
      */
-    static Value performStringOperation(const Token& token, const std::string& op, const Value& left, const Value& right);
+    static Result<Value> performStringOperation(const Token& token, const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @brief Checks whether a value can be appended to a string with the + operator.
+     * @param value The right operand value.
+     * @return True if the value is a string, int, double or bool.
+     */
+    static bool canAppend(const Value& value);
+
+    /**
+     * @brief Selects the kernel for a string operator and the types of its operands.
+     * @param op The string operator.
+     * @param left The left operand value.
+     * @param right The right operand value.
+     * @return The kernel, or nullptr unless a string is concatenated with a value that can be appended.
+     */
+    static BinaryKernel selectKernel(const std::string& op, const Value& left, const Value& right);
+
+    /**
+     * @brief Concatenates a string with a string, int, double or bool, reusing the text of the left operand.
+     * @param left The left operand, which must be a string and is moved from.
+     * @param right The right operand.
+     * @return The concatenated string.
+     */
+    static Result<Value> concatenate(const Token&, Value& left, Value& right) {
+        std::string result = std::move(std::get<std::string>(left));
+        ValueHelper::appendString(result, right);
+        return result;
+    }
 };
 
 #endif // STRINGOPERATIONS_H
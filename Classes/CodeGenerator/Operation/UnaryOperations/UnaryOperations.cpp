@@ -1,17 +1,15 @@
 #include "UnaryOperations.h"
 
-Value UnaryOperations::performUnaryOperation(const Token& token, const std::string& op, const Value& operand) {
-    std::string line = std::to_string(token.line);
-
+Result<Value> UnaryOperations::performUnaryOperation(const Token& token, const std::string& op, const Value& operand) {
     // Check for integer and double types
     if (ValueHelper::isInt(operand)) {
-        int o = ValueHelper::asInt(operand);
+        int o = std::get<int>(operand);
         if (op == "-") {
             return -o;
         }
     }
     else if (ValueHelper::isDouble(operand)) {
-        double o = ValueHelper::asDouble(operand);
+        double o = std::get<double>(operand);
         if (op == "-") {
             return -o;
         }
@@ -22,5 +20,5 @@ Value UnaryOperations::performUnaryOperation(const Token& token, const std::stri
         return !std::get<bool>(operand);
     }
 
-    throw std::runtime_error("Unary Operation Error: Unsupported unary operator " + op + " at line " + line);
+    return RuntimeError{ "Unary Operation Error: Unsupported unary operator " + op + " at line " + std::to_string(token.line) };
 }
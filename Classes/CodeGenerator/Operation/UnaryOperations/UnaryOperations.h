@@ -15,10 +15,9 @@ public:
      * @param token The token representing the unary operator.
      * @param op The unary operator as a string (e.g., "-", "!").
      * @param operand The operand value.
-     * @return The result of the unary operation as a Value.
-     * @throws std::runtime_error if the operator is unsupported or the operation is invalid.
+     * @return The result of the unary operation as a Value, or an error if the operator is unsupported or the operation is invalid.
      */
-    static Value performUnaryOperation(const Token& token, const std::string& op, const Value& operand);
+    static Result<Value> performUnaryOperation(const Token& token, const std::string& op, const Value& operand);
 };
 
 #endif // UNARYOPERATIONS_H
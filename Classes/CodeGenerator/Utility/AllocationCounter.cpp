@@ -0,0 +1,19 @@
+#include "AllocationCounter.h"
+
+namespace {
+    thread_local uint64_t allocationCount = 0;
+    thread_local uint64_t allocatedBytes = 0;
+}
+
+void AllocationCounter::record(std::size_t size) {
+    ++allocationCount;
+    allocatedBytes += size;
+}
+
+uint64_t AllocationCounter::allocations() {
+    return allocationCount;
+}
+
+uint64_t AllocationCounter::bytes() {
+    return allocatedBytes;
+}
@@ -0,0 +1,52 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct AllocationCounter
+ * @brief Reports the heap allocations counted by the driver's global operator new.
+ *
+ * The replacement operator new lives in AllocationHook.cpp, which only the driver links, so
+ * programs linking the runtime library keep their own allocator and see no allocations. It
+ * counts only once the statistics or the profiler enabled counting, so other runs pay a single
+ * branch per allocation. Counts are kept per thread, so files run concurrently do not affect
+ * each other.
+ */
+struct AllocationCounter {
+    /**
+     * @brief Starts counting allocations, for every thread.
+     */
+    static void enable() { enabled.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Checks whether allocations are counted.
+     * @return True once counting was enabled.
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Counts an allocation made by the calling thread.
+     * @param size The number of bytes requested.
+     */
+    static void record(std::size_t size);
+
+    /**
+     * @brief Gets the number of allocations made by the calling thread so far.
+     * @return The allocation count.
+     */
+    static uint64_t allocations();
+
+    /**
+     * @brief Gets the number of bytes requested by the calling thread so far.
+     * @return The allocated byte count, not reduced by deallocations.
+     */
+    static uint64_t bytes();
+
+private:
+    static inline std::atomic<bool> enabled{ false }; ///< Whether allocations are counted.
+};
+
+#endif // ALLOCATIONCOUNTER_H
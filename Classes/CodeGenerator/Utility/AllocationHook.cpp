@@ -0,0 +1,23 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocator of the driver so the statistics and the profiler can count allocations
+
+void* operator new(std::size_t size) {
+    if (AllocationCounter::isEnabled()) {
+        AllocationCounter::record(size);
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,65 @@
+#include "InlineCacheReport.h"
+#include "Optimizer/Utility/ASTHelper.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // Type names by Value alternative, as reported by ValueHelper::type
+    const char* const typeNames[] = { "double", "int", "bool", "string", "null", "vector", "map" };
+
+    const char* stateName(InlineCache::State state) {
+        switch (state) {
+            case InlineCache::State::EMPTY: return "empty";
+            case InlineCache::State::MONOMORPHIC: return "monomorphic";
+            case InlineCache::State::MEGAMORPHIC: return "megamorphic";
+        }
+        return "unknown";
+    }
+
+    double hitRate(uint64_t hits, uint64_t misses) {
+        return hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0;
+    }
+}
+
+void InlineCacheReport::collect(const ExprNode* node) {
+    if (!node) {
+        return;
+    }
+    if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        const InlineCache& cache = binNode->getCache();
+        if (cache.hits + cache.misses > 0) {
+            sites.push_back({ binNode->getToken().line, binNode->getOp(), cache });
+        }
+    }
+    ASTHelper::forEachChild(node, [this](const ExprNode* child) { collect(child); });
+}
+
+std::string InlineCacheReport::report() const {
+    std::vector<const Site*> sorted;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    for (const Site& site : sites) {
+        sorted.push_back(&site);
+        hits += site.cache.hits;
+        misses += site.cache.misses;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Site* a, const Site* b) { return a->line < b->line; });
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << "Inline caches: " << sites.size() << " sites, " << hits << " hits, " << misses << " misses ("
+        << hitRate(hits, misses) << "% hit rate)\n";
+    out << std::setw(8) << "Line" << std::setw(6) << "Op" << std::setw(14) << "State" << std::setw(18) << "Types"
+        << std::setw(14) << "Hits" << std::setw(10) << "Misses" << std::setw(10) << "Hit %" << "\n";
+    for (const Site* site : sorted) {
+        const InlineCache& cache = site->cache;
+        std::string types = cache.state == InlineCache::State::MONOMORPHIC
+            ? std::string(typeNames[cache.leftType]) + ", " + typeNames[cache.rightType]
+            : "-";
+        out << std::setw(8) << site->line << std::setw(6) << site->op << std::setw(14) << stateName(cache.state)
+            << std::setw(18) << types << std::setw(14) << cache.hits << std::setw(10) << cache.misses
+            << std::setw(10) << hitRate(cache.hits, cache.misses) << "\n";
+    }
+    return out.str();
+}
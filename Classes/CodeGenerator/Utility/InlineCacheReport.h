@@ -0,0 +1,43 @@
+#ifndef INLINECACHEREPORT_H
+#define INLINECACHEREPORT_H
+
+#include <string>
+#include <vector>
+#include "AST/AST.h"
+
+/**
+ * @class InlineCacheReport
+ * @brief Collects the inline caches of the binary operation sites of a program and reports their hit rates.
+ *
+ * Sites that never ran are left out, as are operations specialised by type inference, which
+ * do not use their cache.
+ */
+class InlineCacheReport {
+public:
+    /**
+     * @struct Site
+     * @brief The cache of one binary operation site, copied when it was collected.
+     */
+    struct Site {
+        size_t line; ///< The line of the operator.
+        std::string op; ///< The operator.
+        InlineCache cache; ///< The state and counters of the site's cache.
+    };
+
+    /**
+     * @brief Records the caches of every binary operation in a subtree.
+     * @param node The root of the subtree, which may be null.
+     */
+    void collect(const ExprNode* node);
+
+    /**
+     * @brief Builds a text report of the collected sites by line, with their state, cached types and hit rate.
+     * @return The report.
+     */
+    std::string report() const;
+
+private:
+    std::vector<Site> sites; ///< The collected sites, in the order they were found.
+};
+
+#endif // INLINECACHEREPORT_H
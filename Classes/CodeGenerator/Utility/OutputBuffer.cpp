@@ -0,0 +1,106 @@
+#include "OutputBuffer.h"
+#include <iostream>
+#include "Value/NumberConversion.h"
+
+OutputBuffer::OutputBuffer() {
+    buffer.reserve(flushThreshold);
+}
+
+OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+void OutputBuffer::useStdout() {
+    flush();
+    file.close();
+    target = Target::Stdout;
+}
+
+bool OutputBuffer::useFile(const std::string& path) {
+    flush();
+    std::ofstream newFile(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!newFile.is_open()) {
+        return false;
+    }
+    file = std::move(newFile);
+    target = Target::File;
+    return true;
+}
+
+void OutputBuffer::useMemory() {
+    flush();
+    file.close();
+    target = Target::Memory;
+}
+
+void OutputBuffer::setFlushThreshold(size_t threshold) {
+    flushThreshold = threshold;
+    if (buffer.size() >= flushThreshold) {
+        flush();
+    }
+    buffer.reserve(flushThreshold);
+}
+
+void OutputBuffer::write(std::string_view text) {
+    buffer.append(text);
+}
+
+void OutputBuffer::writeChar(char character) {
+    buffer.push_back(character);
+}
+
+void OutputBuffer::writeInt(int value) {
+    char digits[NumberConversion::maxLength];
+    buffer.append(digits, NumberConversion::formatInt(digits, value));
+}
+
+void OutputBuffer::writeDouble(double value) {
+    char digits[NumberConversion::maxLength];
+    buffer.append(digits, NumberConversion::formatDouble(digits, value));
+}
+
+void OutputBuffer::writeBool(bool value) {
+    buffer.append(value ? "true" : "false");
+}
+
+void OutputBuffer::endLine() {
+    buffer.push_back('\n');
+    if (buffer.size() >= flushThreshold) {
+        flush();
+    }
+}
+
+void OutputBuffer::flush() {
+    if (!buffer.empty()) {
+        switch (target) {
+            case Target::Stdout:
+                std::cout.write(buffer.data(), buffer.size());
+                break;
+            case Target::File:
+                file.write(buffer.data(), buffer.size());
+                break;
+            case Target::Memory:
+                memory.append(buffer);
+                break;
+        }
+        buffer.clear();
+    }
+
+    if (target == Target::Stdout) {
+        std::cout.flush();
+    }
+    else if (target == Target::File) {
+        file.flush();
+    }
+}
+
+const std::string& OutputBuffer::getContents() {
+    if (target == Target::Memory) {
+        flush();
+    }
+    return memory;
+}
+
+void OutputBuffer::clearContents() {
+    memory.clear();
+}
@@ -0,0 +1,131 @@
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <string>
+#include <string_view>
+#include <fstream>
+
+/**
+ * @class OutputBuffer
+ * @brief Collects program output in a large buffer and writes it to the selected target in bulk.
+ *
+ * Output is written to the target when the buffer reaches its flush threshold, when flush() is
+ * called (for example before reading input or by the flush builtin) and when the buffer is destroyed.
+ * Numbers are formatted straight into the buffer without creating temporary strings.
+ */
+class OutputBuffer {
+public:
+    /**
+     * @enum Target
+     * @brief The destinations output can be written to.
+     */
+    enum class Target {
+        Stdout, ///< Write to the standard output.
+        File,   ///< Write to a file.
+        Memory  ///< Keep the output in memory so it can be read back.
+    };
+
+    static constexpr size_t defaultFlushThreshold = 64 * 1024; ///< Default buffer size in bytes before it is flushed.
+
+    /**
+     * @brief Constructs an OutputBuffer writing to the standard output.
+     */
+    OutputBuffer();
+
+    /**
+     * @brief Destructor that flushes any remaining output.
+     */
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    /**
+     * @brief Directs future output to the standard output, flushing pending output first.
+     */
+    void useStdout();
+
+    /**
+     * @brief Directs future output to a file, flushing pending output first.
+     * @param path The path of the file to write to. The file is truncated.
+     * @return True if the file could be opened, false otherwise (the target is then left unchanged).
+     */
+    bool useFile(const std::string& path);
+
+    /**
+     * @brief Directs future output to memory, flushing pending output first.
+     */
+    void useMemory();
+
+    /**
+     * @brief Gets the current output target.
+     * @return The current target.
+     */
+    Target getTarget() const { return target; }
+
+    /**
+     * @brief Sets the number of buffered bytes at which output is flushed automatically.
+     * @param threshold The threshold in bytes.
+     */
+    void setFlushThreshold(size_t threshold);
+
+    /**
+     * @brief Appends text to the buffer.
+     * @param text The text to append.
+     */
+    void write(std::string_view text);
+
+    /**
+     * @brief Appends a single character to the buffer.
+     * @param character The character to append.
+     */
+    void writeChar(char character);
+
+    /**
+     * @brief Formats an integer directly into the buffer.
+     * @param value The integer to append.
+     */
+    void writeInt(int value);
+
+    /**
+     * @brief Formats a double directly into the buffer using its shortest round-trip representation.
+     * @param value The double to append.
+     */
+    void writeDouble(double value);
+
+    /**
+     * @brief Appends "true" or "false" to the buffer.
+     * @param value The boolean to append.
+     */
+    void writeBool(bool value);
+
+    /**
+     * @brief Ends the current line, flushing if the threshold has been reached.
+     */
+    void endLine();
+
+    /**
+     * @brief Writes all buffered output to the target.
+     */
+    void flush();
+
+    /**
+     * @brief Gets the output collected by the memory target, including pending output.
+     * @return The collected output.
+     */
+    const std::string& getContents();
+
+    /**
+     * @brief Clears the output collected by the memory target.
+     */
+    void clearContents();
+
+private:
+    Target target = Target::Stdout; ///< The current output target.
+    std::string buffer; ///< Output waiting to be written.
+    std::string memory; ///< Output collected by the memory target.
+    std::ofstream file; ///< The file written by the file target.
+    size_t flushThreshold = defaultFlushThreshold; ///< Buffered bytes at which output is flushed.
+};
+
+#endif // OUTPUTBUFFER_H
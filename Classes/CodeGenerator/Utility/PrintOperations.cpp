@@ -1,51 +1,65 @@
 #include "PrintOperations.h"
-#include <iostream>
 
-void PrintOperations::printValue(const Value& value) {
-    std::string output;
-    // Convert value to string properly
+void PrintOperations::printValue(const Value& value, OutputBuffer& output) {
+    // Format the value straight into the output buffer
     if (std::holds_alternative<int>(value)) {
-        output = std::to_string(std::get<int>(value));
+        output.writeInt(std::get<int>(value));
     }
     else if (std::holds_alternative<double>(value)) {
-        output = std::to_string(std::get<double>(value));
+        output.writeDouble(std::get<double>(value));
     }
     else if (std::holds_alternative<bool>(value)) {
-        output = std::get<bool>(value) ? "true" : "false";
+        output.writeBool(std::get<bool>(value));
     }
     else if (std::holds_alternative<std::string>(value)) {
-        output = std::get<std::string>(value);
+        output.write(std::get<std::string>(value));
     }
     else if (std::holds_alternative<std::monostate>(value)) {
-        output = "None";
+        output.write("None");
     }
     else if (std::holds_alternative<std::shared_ptr<TypedVector>>(value)) {
         const auto& vec = std::get<std::shared_ptr<TypedVector>>(value);
-        const auto& values = vec->getValues();
-        // Create string representation of vector
-        output = "[";
+        const TypedVector& values = *vec;
+        // Write the string representation of the vector
+        output.writeChar('[');
         for (size_t i = 0; i < values.size(); i++) {
-            if (std::holds_alternative<int>(values[i])) {
-                output += std::to_string(std::get<int>(values[i]));
-            }
-            else if (std::holds_alternative<double>(values[i])) {
-                output += std::to_string(std::get<double>(values[i]));
-            }
-            else if (std::holds_alternative<bool>(values[i])) {
-                output += std::to_string(std::get<bool>(values[i]));
-            }
-            else if (std::holds_alternative<std::string>(values[i])) {
-                output += std::get<std::string>(values[i]);
-            }
+            printElement(values[i], output);
             if (i != values.size() - 1) {
-                output += ", ";
+                output.write(", ");
             }
         }
-        output += "]";
+        output.writeChar(']');
     }
     else {
-        throw std::runtime_error("Print Error: Unsupported type " + ValueHelper::type(value));
+        // The remaining alternative is a map, whose entries are written in insertion order as {key: value, ...}
+        bool first = true;
+        output.writeChar('{');
+        std::get<std::shared_ptr<TypedMap>>(value)->forEach([&output, &first](const Value& key, const Value& element) {
+            if (!first) {
+                output.write(", ");
+            }
+            first = false;
+            printElement(key, output);
+            output.write(": ");
+            printElement(element, output);
+        });
+        output.writeChar('}');
     }
 
-    std::cout << output << std::endl;
+    output.endLine();
 }
+
+void PrintOperations::printElement(const Value& value, OutputBuffer& output) {
+    if (std::holds_alternative<int>(value)) {
+        output.writeInt(std::get<int>(value));
+    }
+    else if (std::holds_alternative<double>(value)) {
+        output.writeDouble(std::get<double>(value));
+    }
+    else if (std::holds_alternative<bool>(value)) {
+        output.writeInt(std::get<bool>(value));
+    }
+    else if (std::holds_alternative<std::string>(value)) {
+        output.write(std::get<std::string>(value));
+    }
+}
\ No newline at end of file
@@ -2,20 +2,28 @@
 #define PRINTOPERATIONS_H
 
 #include "Value/ValueHelper.h"
-#include <iostream>
+#include "OutputBuffer.h"
 
 /**
  * @class PrintOperations
- * @brief Provides functionality to print different types of values to the standard output.
+ * @brief Provides functionality to print different types of values to an output buffer.
  */
 class PrintOperations {
 public:
     /**
-     * @brief Prints the given value to the standard output.
-     * @param value The value to be printed. The value can be of type int, double, bool, string, None (monostate), or a shared_ptr to a TypedVector.
-     * @throws std::runtime_error if the value type is unsupported.
+     * @brief Prints the given value, followed by a newline, to the output buffer.
+     * @param value The value to be printed. The value can be of type int, double, bool, string, None (monostate), a shared_ptr to a TypedVector, or a shared_ptr to a TypedMap.
+     * @param output The buffer the value is written to.
      */
-    static void printValue(const Value& value);
+    static void printValue(const Value& value, OutputBuffer& output);
+
+private:
+    /**
+     * @brief Prints an element of a list or a key or value of a map, without a newline.
+     * @param value The element, which is an int, double, bool or string. Bools are written as 1 or 0.
+     * @param output The buffer the element is written to.
+     */
+    static void printElement(const Value& value, OutputBuffer& output);
 };
 
 #endif // PRINTOPERATIONS_H
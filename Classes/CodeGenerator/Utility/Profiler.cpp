@@ -0,0 +1,126 @@
+#include "Profiler.h"
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // Appends entries sorted by descending exclusive time as aligned table rows
+    void appendTable(std::ostringstream& out, const std::string& title, const std::string& keyHeader, std::vector<const Profiler::Entry*> entries) {
+        std::sort(entries.begin(), entries.end(), [](const Profiler::Entry* a, const Profiler::Entry* b) {
+            return a->exclusiveNanoseconds != b->exclusiveNanoseconds ? a->exclusiveNanoseconds > b->exclusiveNanoseconds : a->name < b->name;
+        });
+
+        out << title << "\n";
+        out << std::setw(16) << keyHeader << std::setw(12) << "Count" << std::setw(16) << "Inclusive ms"
+            << std::setw(16) << "Exclusive ms" << std::setw(14) << "Allocations" << "\n";
+        for (const auto* entry : entries) {
+            out << std::setw(16) << entry->name << std::setw(12) << entry->count
+                << std::setw(16) << entry->inclusiveNanoseconds / 1e6 << std::setw(16) << entry->exclusiveNanoseconds / 1e6
+                << std::setw(14) << entry->allocations << "\n";
+        }
+    }
+}
+
+uint64_t Profiler::allocationCount() {
+    return AllocationCounter::allocations();
+}
+
+bool Profiler::enterLine(int line) {
+    if (!lineFrames.empty() && lineFrames.back().line == line) {
+        return false;
+    }
+
+    Entry& entry = lines[line];
+    if (entry.name.empty()) {
+        entry.name = std::to_string(line);
+    }
+    entry.count++;
+    entry.active++;
+    lineFrames.push_back(Frame{ &entry, line, 0, Clock::now(), 0, AllocationCounter::allocations(), 0 });
+    return true;
+}
+
+void Profiler::exitLine() {
+    popFrame(lineFrames);
+}
+
+void Profiler::enterFunction(const std::string& name) {
+    Entry& entry = functions[name];
+    if (entry.name.empty()) {
+        entry.name = name;
+    }
+    entry.count++;
+    entry.active++;
+
+    std::string stackName = functionFrames.empty() ? name : stackNames[functionFrames.back().stack] + ";" + name;
+    auto it = stackIndices.find(stackName);
+    if (it == stackIndices.end()) {
+        it = stackIndices.emplace(stackName, stackNames.size()).first;
+        stackNames.push_back(stackName);
+        stackNanoseconds.push_back(0);
+    }
+
+    functionFrames.push_back(Frame{ &entry, 0, it->second, Clock::now(), 0, AllocationCounter::allocations(), 0 });
+}
+
+void Profiler::exitFunction() {
+    size_t stack = functionFrames.back().stack;
+    stackNanoseconds[stack] += popFrame(functionFrames).second;
+}
+
+std::pair<int64_t, int64_t> Profiler::popFrame(std::vector<Frame>& frames) {
+    Frame frame = frames.back();
+    frames.pop_back();
+
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frame.start).count();
+    int64_t exclusive = elapsed - frame.childNanoseconds;
+    uint64_t made = AllocationCounter::allocations() - frame.startAllocations;
+
+    Entry& entry = *frame.entry;
+    entry.active--;
+    if (entry.active == 0) {
+        // Only the outermost frame of a recursive line or function adds its inclusive time
+        entry.inclusiveNanoseconds += elapsed;
+    }
+    entry.exclusiveNanoseconds += exclusive;
+    entry.allocations += made - frame.childAllocations;
+
+    if (!frames.empty()) {
+        frames.back().childNanoseconds += elapsed;
+        frames.back().childAllocations += made;
+    }
+    return { elapsed, exclusive };
+}
+
+std::string Profiler::report() const {
+    std::vector<const Entry*> lineEntries;
+    for (const auto& [line, entry] : lines) {
+        lineEntries.push_back(&entry);
+    }
+    std::vector<const Entry*> functionEntries;
+    for (const auto& [name, entry] : functions) {
+        functionEntries.push_back(&entry);
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    appendTable(out, "Profile: lines by exclusive time", "Line", std::move(lineEntries));
+    appendTable(out, "Profile: functions by exclusive time", "Function", std::move(functionEntries));
+    return out.str();
+}
+
+bool Profiler::writeCollapsedStacks(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    for (size_t i = 0; i < stackNames.size(); ++i) {
+        int64_t microseconds = stackNanoseconds[i] / 1000;
+        if (microseconds > 0) {
+            file << stackNames[i] << " " << microseconds << "\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,153 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class Profiler
+ * @brief Records execution counts, inclusive and exclusive time and allocations per source line and per function.
+ *
+ * A line is entered whenever a node on a different line than the innermost active line starts evaluating,
+ * so nested nodes on the same line are counted once. Exclusive line time excludes other lines evaluated
+ * within it, including the bodies of called functions, while exclusive function time only excludes nested
+ * calls. Recursive frames only add their inclusive time once. Top-level code is reported as the function
+ * "<main>". Allocations are counted by AllocationCounter.
+ */
+class Profiler {
+public:
+    /**
+     * @struct Entry
+     * @brief The statistics recorded for one line or function.
+     */
+    struct Entry {
+        std::string name; ///< The line number or function name.
+        uint64_t count = 0; ///< Number of times the line or function was entered.
+        int64_t inclusiveNanoseconds = 0; ///< Time spent inside, including nested lines or calls.
+        int64_t exclusiveNanoseconds = 0; ///< Time spent inside, excluding nested lines or calls.
+        uint64_t allocations = 0; ///< Allocations made directly inside, excluding nested lines or calls.
+        size_t active = 0; ///< Number of frames for this entry currently on the stack.
+    };
+
+    /**
+     * @class LineScope
+     * @brief Records the evaluation of a node on a source line for the lifetime of the scope.
+     */
+    class LineScope {
+    public:
+        LineScope(Profiler& profiler, int line) : profiler(profiler.enterLine(line) ? &profiler : nullptr) {}
+        ~LineScope() { if (profiler) profiler->exitLine(); }
+        LineScope(const LineScope&) = delete;
+        LineScope& operator=(const LineScope&) = delete;
+    private:
+        Profiler* profiler; ///< The profiler to report to, or nullptr if the line was already active.
+    };
+
+    /**
+     * @class FunctionScope
+     * @brief Records a function call for the lifetime of the scope.
+     */
+    class FunctionScope {
+    public:
+        FunctionScope(Profiler& profiler, const std::string& name) : profiler(profiler) { profiler.enterFunction(name); }
+        ~FunctionScope() { profiler.exitFunction(); }
+        FunctionScope(const FunctionScope&) = delete;
+        FunctionScope& operator=(const FunctionScope&) = delete;
+    private:
+        Profiler& profiler; ///< The profiler to report to.
+    };
+
+    /**
+     * @brief Gets the number of allocations made by the calling thread so far.
+     * @return The allocation count.
+     */
+    static uint64_t allocationCount();
+
+    /**
+     * @brief Builds a text report with lines and functions sorted by exclusive time.
+     * @return The report.
+     */
+    std::string report() const;
+
+    /**
+     * @brief Writes the exclusive time of every call stack in the collapsed format used by flame graph tools.
+     *
+     * Each line holds the semicolon-separated function names of a stack followed by its exclusive time in microseconds.
+     *
+     * @param path The file to write.
+     * @return True if the file could be written, false otherwise.
+     */
+    bool writeCollapsedStacks(const std::string& path) const;
+
+    /**
+     * @brief Gets the statistics recorded per source line.
+     * @return Map of line numbers to their statistics.
+     */
+    const std::unordered_map<int, Entry>& getLines() const { return lines; }
+
+    /**
+     * @brief Gets the statistics recorded per function.
+     * @return Map of function names to their statistics.
+     */
+    const std::unordered_map<std::string, Entry>& getFunctions() const { return functions; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Frame
+     * @brief An active line or function on the profiler's stacks.
+     */
+    struct Frame {
+        Entry* entry; ///< The statistics of the line or function.
+        int line; ///< The line number of a line frame.
+        size_t stack; ///< Index of the collapsed stack of a function frame.
+        Clock::time_point start; ///< When the frame was entered.
+        int64_t childNanoseconds; ///< Inclusive time of nested frames.
+        uint64_t startAllocations; ///< Allocation count when the frame was entered.
+        uint64_t childAllocations; ///< Allocations made by nested frames.
+    };
+
+    std::unordered_map<int, Entry> lines; ///< Statistics per source line.
+    std::unordered_map<std::string, Entry> functions; ///< Statistics per function.
+    std::vector<Frame> lineFrames; ///< Active lines, innermost last.
+    std::vector<Frame> functionFrames; ///< Active functions, innermost last.
+    std::vector<std::string> stackNames; ///< Collapsed stack names, indexed by Frame::stack.
+    std::unordered_map<std::string, size_t> stackIndices; ///< Index of each collapsed stack name.
+    std::vector<int64_t> stackNanoseconds; ///< Exclusive time of each collapsed stack.
+
+    /**
+     * @brief Enters a line unless it is already the innermost active line.
+     * @param line The line number.
+     * @return True if a frame was pushed and exitLine must be called.
+     */
+    bool enterLine(int line);
+
+    /**
+     * @brief Leaves the innermost line.
+     */
+    void exitLine();
+
+    /**
+     * @brief Enters a function.
+     * @param name The function name.
+     */
+    void enterFunction(const std::string& name);
+
+    /**
+     * @brief Leaves the innermost function.
+     */
+    void exitFunction();
+
+    /**
+     * @brief Pops a frame and adds its time and allocations to its entry and its parent.
+     * @param frames The stack to pop from.
+     * @return The elapsed and exclusive time of the popped frame.
+     */
+    static std::pair<int64_t, int64_t> popFrame(std::vector<Frame>& frames);
+};
+
+#endif // PROFILER_H
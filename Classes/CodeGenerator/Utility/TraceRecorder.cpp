@@ -0,0 +1,70 @@
+#include "TraceRecorder.h"
+#include <cstdio>
+#include <fstream>
+
+namespace {
+    // Writes a string as a JSON string literal
+    void writeString(std::ofstream& file, const std::string& text) {
+        file << '"';
+        for (char character : text) {
+            switch (character) {
+                case '"': file << "\\\""; break;
+                case '\\': file << "\\\\"; break;
+                case '\n': file << "\\n"; break;
+                case '\t': file << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(character) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+                        file << escaped;
+                    }
+                    else {
+                        file << character;
+                    }
+            }
+        }
+        file << '"';
+    }
+}
+
+TraceRecorder::TraceRecorder(const std::string& threadName, Clock::time_point origin)
+    : threadName(threadName), origin(origin) {}
+
+void TraceRecorder::begin(const std::string& name, const char* category) {
+    record(name, category, 'B');
+}
+
+void TraceRecorder::end(const std::string& name, const char* category) {
+    record(name, category, 'E');
+}
+
+void TraceRecorder::record(const std::string& name, const char* category, char phase) {
+    double timestamp = std::chrono::duration<double, std::micro>(Clock::now() - origin).count();
+    events.push_back(Event{ name, category, phase, timestamp });
+}
+
+bool TraceRecorder::writeJson(const std::string& path, const std::vector<TraceRecorder>& recorders) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < recorders.size(); ++i) {
+        const TraceRecorder& recorder = recorders[i];
+        size_t threadId = i + 1;
+        file << (i == 0 ? "\n" : ",\n");
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId << ",\"args\":{\"name\":";
+        writeString(file, recorder.threadName);
+        file << "}}";
+
+        for (const auto& event : recorder.events) {
+            file << ",\n{\"name\":";
+            writeString(file, event.name);
+            file << ",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase << "\",\"ts\":" << std::fixed << event.timestamp
+                << ",\"pid\":1,\"tid\":" << threadId << "}";
+        }
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,102 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @class TraceRecorder
+ * @brief Records begin and end events of interpreter phases and function calls for one file.
+ *
+ * The events of several recorders can be written as one Chrome trace-event JSON file, with each
+ * recorder shown as its own thread, so they can be inspected in chrome://tracing or Perfetto.
+ * Recorders are not thread-safe; each concurrently processed file uses its own.
+ */
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @class Scope
+     * @brief Records a begin event when constructed and the matching end event when destroyed.
+     *
+     * The scope does nothing when no recorder is given, so call sites do not need to check
+     * whether tracing is enabled.
+     */
+    class Scope {
+    public:
+        Scope(TraceRecorder* recorder, const std::string& name, const char* category)
+            : recorder(recorder), category(category) {
+            if (recorder) {
+                this->name = name;
+                recorder->begin(name, category);
+            }
+        }
+        ~Scope() { if (recorder) recorder->end(name, category); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        TraceRecorder* recorder; ///< The recorder, or nullptr if tracing is disabled.
+        std::string name; ///< The event name, only copied when tracing is enabled.
+        const char* category; ///< The event category.
+    };
+
+    /**
+     * @brief Constructs a recorder.
+     * @param threadName The name the recorder's events are grouped under, typically the file title.
+     * @param origin The time all timestamps are measured from.
+     */
+    TraceRecorder(const std::string& threadName, Clock::time_point origin);
+
+    /**
+     * @brief Records the beginning of an event.
+     * @param name The event name.
+     * @param category The event category, such as "phase" or "function".
+     */
+    void begin(const std::string& name, const char* category);
+
+    /**
+     * @brief Records the end of the innermost open event.
+     * @param name The event name.
+     * @param category The event category.
+     */
+    void end(const std::string& name, const char* category);
+
+    /**
+     * @brief Writes the events of the given recorders as Chrome trace-event JSON.
+     *
+     * Each recorder is written as a separate thread, numbered by its position in the list.
+     *
+     * @param path The file to write.
+     * @param recorders The recorders whose events are written.
+     * @return True if the file could be written, false otherwise.
+     */
+    static bool writeJson(const std::string& path, const std::vector<TraceRecorder>& recorders);
+
+private:
+    /**
+     * @struct Event
+     * @brief A single begin or end event.
+     */
+    struct Event {
+        std::string name; ///< The event name.
+        const char* category; ///< The event category.
+        char phase; ///< 'B' for begin or 'E' for end.
+        double timestamp; ///< Microseconds since the origin.
+    };
+
+    std::string threadName; ///< The name shown for the recorder's thread.
+    Clock::time_point origin; ///< The time timestamps are measured from.
+    std::vector<Event> events; ///< The recorded events in order.
+
+    /**
+     * @brief Appends an event stamped with the current time.
+     * @param name The event name.
+     * @param category The event category.
+     * @param phase The event phase.
+     */
+    void record(const std::string& name, const char* category, char phase);
+};
+
+#endif // TRACERECORDER_H
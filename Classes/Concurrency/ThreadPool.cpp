@@ -0,0 +1,87 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = defaultThreadCount();
+    }
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+    }
+    available.notify_one();
+}
+
+void ThreadPool::forEach(size_t count, const std::function<void(size_t)>& task) {
+    struct State {
+        std::atomic<size_t> next{ 0 };
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    // Helpers that start after every index was claimed only touch the shared state, never the task
+    auto state = std::make_shared<State>();
+    auto run = [state, count, &task] {
+        size_t ran = 0;
+        for (size_t i = state->next++; i < count; i = state->next++) {
+            task(i);
+            ran++;
+        }
+        if (ran > 0) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done += ran;
+            if (state->done == count) {
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(workers.size(), count > 0 ? count - 1 : 0);
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, count] { return state->done == count; });
+}
+
+size_t ThreadPool::defaultThreadCount() {
+    size_t count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs submitted tasks on a fixed set of worker threads.
+ *
+ * Tasks are started in the order they are submitted. The destructor waits for all
+ * queued tasks to finish before joining the workers.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount The number of workers; 0 selects defaultThreadCount().
+     */
+    explicit ThreadPool(size_t threadCount);
+
+    /**
+     * @brief Finishes all queued tasks and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task to be run by the next free worker.
+     * @param task The task to run. It must not throw.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Runs a task once for every index and waits for all of them to finish.
+     *
+     * Indices are claimed one at a time by the workers and the calling thread, so threads that
+     * finish early take over the remaining indices. It may be called from several threads at once.
+     *
+     * @param count The number of indices.
+     * @param task The task to run for each index in [0, count). It must not throw.
+     */
+    void forEach(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of workers.
+     */
+    size_t size() const { return workers.size(); }
+
+    /**
+     * @brief Gets the number of threads the hardware can run concurrently.
+     * @return The hardware concurrency, or 1 if it cannot be determined.
+     */
+    static size_t defaultThreadCount();
+
+private:
+    std::vector<std::thread> workers; ///< The worker threads.
+    std::queue<std::function<void()>> tasks; ///< Tasks waiting for a worker.
+    std::mutex mutex; ///< Guards the task queue and the stopping flag.
+    std::condition_variable available; ///< Signalled when a task is queued or the pool stops.
+    bool stopping = false; ///< Set when the pool is being destroyed.
+
+    /**
+     * @brief Runs queued tasks until the pool stops and the queue is empty.
+     */
+    void work();
+};
+
+#endif // THREADPOOL_H
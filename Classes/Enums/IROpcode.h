@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * @enum IROpcode
+ * @brief Defines the operations of the SSA intermediate representation used by the optimiser.
+ *
+ * Every instruction is also the value it produces. Stores to variables are ASSIGN instructions
+ * and the values of a variable that meet where control flow joins are merged by PHI
+ * instructions, so every read of a variable refers to exactly one definition.
+ */
+enum class IROpcode {
+    ENTRY,          ///< The value of a variable when the function starts: a parameter, a global or nothing.
+    CONSTANT,       ///< A literal.
+    PHI,            ///< The value of a variable at a join, one operand per predecessor block.
+    ASSIGN,         ///< A store to a variable, holding the value of its operand.
+    BINARY,         ///< An arithmetic, comparison or logical operator.
+    UNARY,          ///< A unary operator.
+    OPAQUE,         ///< Any other expression, whose value is unknown and which may have effects.
+    RETURN,         ///< A return statement.
+    BRANCH,         ///< Ends a block, continuing in its first successor if the operand is true and the second otherwise.
+    JUMP            ///< Ends a block, continuing in its only successor.
+};
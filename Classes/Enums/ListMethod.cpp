@@ -0,0 +1,36 @@
+#include "ListMethod.h"
+
+std::string listMethodToString(ListMethod method)
+{
+    switch (method) {
+        case ListMethod::SUM: return "sum";
+        case ListMethod::MIN: return "min";
+        case ListMethod::MAX: return "max";
+        case ListMethod::SORT: return "sort";
+        case ListMethod::CONTAINS: return "contains";
+        case ListMethod::INDEX: return "index";
+        case ListMethod::EXTEND: return "extend";
+        case ListMethod::REVERSE: return "reverse";
+        default: return "unknown";
+    }
+}
+
+bool listMethodFromString(const std::string& name, ListMethod& method)
+{
+    static const ListMethod methods[] = {
+        ListMethod::SUM, ListMethod::MIN, ListMethod::MAX, ListMethod::SORT,
+        ListMethod::CONTAINS, ListMethod::INDEX, ListMethod::EXTEND, ListMethod::REVERSE
+    };
+    for (ListMethod candidate : methods) {
+        if (listMethodToString(candidate) == name) {
+            method = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool listMethodTakesArgument(ListMethod method)
+{
+    return method == ListMethod::CONTAINS || method == ListMethod::INDEX || method == ListMethod::EXTEND;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+
+/**
+ * @enum ListMethod
+ * @brief Defines the built-in list methods that run natively over a whole list.
+ */
+enum class ListMethod {
+    SUM,               ///< Returns the sum of an int or double list.
+    MIN,               ///< Returns the smallest element.
+    MAX,               ///< Returns the largest element.
+    SORT,              ///< Sorts the list in ascending order in place.
+    CONTAINS,          ///< Returns whether the list contains a value.
+    INDEX,             ///< Returns the index of the first occurrence of a value, or -1.
+    EXTEND,            ///< Appends every element of another list.
+    REVERSE            ///< Reverses the list in place.
+};
+
+/**
+ * @brief Converts a ListMethod enum value to the method name used in scripts.
+ * @param method The ListMethod value to convert.
+ * @return The method name, e.g. "sum".
+ */
+std::string listMethodToString(ListMethod method);
+
+/**
+ * @brief Looks up a list method by the name used in scripts.
+ * @param name The method name.
+ * @param method Set to the matching method if one exists.
+ * @return True if the name is a built-in list method, false otherwise.
+ */
+bool listMethodFromString(const std::string& name, ListMethod& method);
+
+/**
+ * @brief Checks whether a list method takes an argument.
+ * @param method The method to check.
+ * @return True for contains, index and extend, false otherwise.
+ */
+bool listMethodTakesArgument(ListMethod method);
@@ -0,0 +1,37 @@
+#include "MapMethod.h"
+
+std::string mapMethodToString(MapMethod method)
+{
+    switch (method) {
+        case MapMethod::GET: return "get";
+        case MapMethod::SET: return "set";
+        case MapMethod::REMOVE: return "remove";
+        case MapMethod::KEYS: return "keys";
+        case MapMethod::VALUES: return "values";
+        default: return "unknown";
+    }
+}
+
+bool mapMethodFromString(const std::string& name, MapMethod& method)
+{
+    static const MapMethod methods[] = {
+        MapMethod::GET, MapMethod::SET, MapMethod::REMOVE, MapMethod::KEYS, MapMethod::VALUES
+    };
+    for (MapMethod candidate : methods) {
+        if (mapMethodToString(candidate) == name) {
+            method = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+int mapMethodArgumentCount(MapMethod method)
+{
+    switch (method) {
+        case MapMethod::SET: return 2;
+        case MapMethod::GET:
+        case MapMethod::REMOVE: return 1;
+        default: return 0;
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+
+/**
+ * @enum MapMethod
+ * @brief Defines the built-in map methods. The contains and length methods are shared with lists.
+ */
+enum class MapMethod {
+    GET,               ///< Returns the value stored for a key.
+    SET,               ///< Stores a value for a key.
+    REMOVE,            ///< Removes a key and returns whether it was present.
+    KEYS,              ///< Returns a list of the keys in insertion order.
+    VALUES             ///< Returns a list of the values in insertion order.
+};
+
+/**
+ * @brief Converts a MapMethod enum value to the method name used in scripts.
+ * @param method The MapMethod value to convert.
+ * @return The method name, e.g. "get".
+ */
+std::string mapMethodToString(MapMethod method);
+
+/**
+ * @brief Looks up a map method by the name used in scripts.
+ * @param name The method name.
+ * @param method Set to the matching method if one exists.
+ * @return True if the name is a built-in map method, false otherwise.
+ */
+bool mapMethodFromString(const std::string& name, MapMethod& method);
+
+/**
+ * @brief Gets the number of arguments a map method takes.
+ * @param method The method to check.
+ * @return 2 for set, 1 for get and remove, and 0 for keys and values.
+ */
+int mapMethodArgumentCount(MapMethod method);
@@ -0,0 +1,41 @@
+#pragma once
+
+/**
+ * @enum TypedBinaryOp
+ * @brief Defines the binary operations whose operand types were proven before execution.
+ *
+ * Int operations read both operands as ints. Double operations read each operand as an int or
+ * a double and compute in double, like the generic path; their result is stored as an int when
+ * it is a whole number.
+ */
+enum class TypedBinaryOp {
+    INT_ADD,                ///< int + int
+    INT_SUB,                ///< int - int
+    INT_MUL,                ///< int * int
+    INT_DIV,                ///< int / int, an int if the quotient is whole and a double otherwise
+    INT_MOD,                ///< int % int
+    DOUBLE_ADD,             ///< + of two numbers, at least one possibly a double
+    DOUBLE_SUB,             ///< - of two numbers, at least one possibly a double
+    DOUBLE_MUL,             ///< * of two numbers, at least one possibly a double
+    DOUBLE_DIV,             ///< / of two numbers, at least one possibly a double
+    DOUBLE_MOD,             ///< % of two numbers, at least one possibly a double
+    INT_EQUAL,              ///< int == int
+    INT_NOT_EQUAL,          ///< int != int
+    INT_LESS,               ///< int < int
+    INT_LESS_EQUAL,         ///< int <= int
+    INT_GREATER,            ///< int > int
+    INT_GREATER_EQUAL,      ///< int >= int
+    DOUBLE_EQUAL,           ///< == of two numbers, at least one possibly a double
+    DOUBLE_NOT_EQUAL,       ///< != of two numbers, at least one possibly a double
+    DOUBLE_LESS,            ///< < of two numbers, at least one possibly a double
+    DOUBLE_LESS_EQUAL,      ///< <= of two numbers, at least one possibly a double
+    DOUBLE_GREATER,         ///< > of two numbers, at least one possibly a double
+    DOUBLE_GREATER_EQUAL,   ///< >= of two numbers, at least one possibly a double
+    STRING_CONCAT,          ///< string + string, int, double or bool
+    STRING_EQUAL,           ///< string == string
+    STRING_NOT_EQUAL,       ///< string != string
+    BOOL_EQUAL,             ///< bool == bool
+    BOOL_NOT_EQUAL,         ///< bool != bool
+    BOOL_AND,               ///< bool and bool
+    BOOL_OR                 ///< bool or bool
+};
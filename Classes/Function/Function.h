@@ -46,11 +46,24 @@ public:
      */
     const std::unique_ptr<BlockNode>& getBody() const { return body; }
 
+    /**
+     * @brief Counts a call made from the interpreter.
+     * @return The number of calls counted so far, including this one.
+     */
+    size_t countCall() const { return ++calls; }
+
+    /**
+     * @brief Gets the number of calls made from the interpreter.
+     * @return The number of calls counted so far.
+     */
+    size_t getCalls() const { return calls; }
+
 private:
     std::string name; ///< The name of the function.
     std::string returnType; ///< The return type of the function.
     std::vector<Parameter> parameters; ///< The parameters of the function.
     std::unique_ptr<BlockNode> body; ///< The body of the function, represented as a BlockNode.
+    mutable size_t calls = 0; ///< Calls made from the interpreter, which decide when the function is compiled.
 };
 
 #endif // FUNCTION_H
@@ -0,0 +1,288 @@
+#include "DeadCodeElimination.h"
+#include "Optimizer/Utility/ASTHelper.h"
+#include <algorithm>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    // Finds the value of a condition that is a bool literal or a comparison of two int literals
+    bool constantCondition(const ExprNode* condition, bool& value) {
+        if (auto boolNode = dynamic_cast<const BooleanNode*>(condition)) {
+            value = boolNode->getValue();
+            return true;
+        }
+        auto binNode = dynamic_cast<const BinaryExprNode*>(condition);
+        if (!binNode || binNode->getToken().type != TokenType::COMPARISON) {
+            return false;
+        }
+        auto left = dynamic_cast<const IntegerNode*>(binNode->getLeft().get());
+        auto right = dynamic_cast<const IntegerNode*>(binNode->getRight().get());
+        if (!left || !right) {
+            return false;
+        }
+        const std::string& op = binNode->getOp();
+        const int a = left->getValue();
+        const int b = right->getValue();
+        if (op == "==") {
+            value = a == b;
+        }
+        else if (op == "!=") {
+            value = a != b;
+        }
+        else if (op == "<") {
+            value = a < b;
+        }
+        else if (op == "<=") {
+            value = a <= b;
+        }
+        else if (op == ">") {
+            value = a > b;
+        }
+        else if (op == ">=") {
+            value = a >= b;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    std::string statementCount(const BlockNode* block) {
+        size_t count = block ? block->getStatements().size() : 0;
+        return std::to_string(count) + (count == 1 ? " statement" : " statements");
+    }
+}
+
+size_t DeadCodeElimination::run(BlockNode& program) {
+    removeUnreachable(&program, false);
+
+    // Reads are collected after unreachable code is gone, so reads in removed branches do not keep stores alive
+    std::unordered_set<std::string> reads;
+    collectReads(&program, reads);
+    removeDeadStores(&program, reads);
+    return removals.size();
+}
+
+std::string DeadCodeElimination::report() const {
+    std::vector<const Removal*> sorted;
+    for (const Removal& removal : removals) {
+        sorted.push_back(&removal);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Removal* a, const Removal* b) { return a->line < b->line; });
+
+    std::ostringstream out;
+    out << "Dead code elimination: " << removals.size() << " removals\n";
+    out << std::setw(8) << "Line" << std::setw(14) << "Kind" << "  Removed\n";
+    for (const Removal* removal : sorted) {
+        out << std::setw(8) << removal->line << std::setw(14) << removal->kind << "  " << removal->detail << "\n";
+    }
+    return out.str();
+}
+
+void DeadCodeElimination::removeUnreachable(BlockNode* block, bool functionBody) {
+    if (!block) {
+        return;
+    }
+    auto& statements = block->getStatements();
+    std::deque<std::unique_ptr<ExprNode>> pending(std::make_move_iterator(statements.begin()), std::make_move_iterator(statements.end()));
+    statements.clear();
+    size_t returnLine = 0;
+
+    while (!pending.empty()) {
+        std::unique_ptr<ExprNode> statement = std::move(pending.front());
+        pending.pop_front();
+        if (!statement) {
+            statements.push_back(std::move(statement));
+            continue;
+        }
+        const size_t line = statement->getToken().line;
+
+        if (auto ifNode = dynamic_cast<IfNode*>(statement.get())) {
+            bool value = false;
+            if (constantCondition(ifNode->getCondition().get(), value)) {
+                // The taken branch is spliced in place of the if, so its statements are processed next
+                std::unique_ptr<BlockNode>& taken = value ? ifNode->getThenBlock() : ifNode->getElseBlock();
+                std::unique_ptr<BlockNode>& untaken = value ? ifNode->getElseBlock() : ifNode->getThenBlock();
+                if (untaken) {
+                    removals.push_back({ line, "unreachable", (value ? "else branch of if (" : "then branch of if (")
+                        + ASTHelper::describe(ifNode->getCondition().get()) + "), " + statementCount(untaken.get()) });
+                }
+                if (taken) {
+                    auto& branch = taken->getStatements();
+                    for (auto it = branch.rbegin(); it != branch.rend(); ++it) {
+                        pending.push_front(std::move(*it));
+                    }
+                }
+                continue;
+            }
+        }
+        else if (auto whileNode = dynamic_cast<WhileNode*>(statement.get())) {
+            bool value = true;
+            if (constantCondition(whileNode->getCondition().get(), value) && !value) {
+                removals.push_back({ line, "unreachable", "while (" + ASTHelper::describe(whileNode->getCondition().get()) + ") loop, "
+                    + statementCount(whileNode->getBlock().get()) });
+                continue;
+            }
+        }
+
+        if (returnLine != 0) {
+            auto returnNode = dynamic_cast<const ReturnNode*>(statement.get());
+            if (returnNode && returnNode->getValue()) {
+                removals.push_back({ line, "unused return", ASTHelper::describe(returnNode) + " after the return at line " + std::to_string(returnLine) });
+                continue;
+            }
+            removeLaterReturns(statement.get(), returnLine);
+        }
+        else if (functionBody && dynamic_cast<const ReturnNode*>(statement.get())) {
+            returnLine = line;
+        }
+
+        if (auto ifNode = dynamic_cast<IfNode*>(statement.get())) {
+            removeUnreachable(ifNode->getThenBlock().get(), false);
+            removeUnreachable(ifNode->getElseBlock().get(), false);
+        }
+        else if (auto whileNode = dynamic_cast<WhileNode*>(statement.get())) {
+            removeUnreachable(whileNode->getBlock().get(), false);
+        }
+        else if (auto defNode = dynamic_cast<FunctionDefNode*>(statement.get())) {
+            removeUnreachable(defNode->getBody().get(), true);
+        }
+        else if (auto blockNode = dynamic_cast<BlockNode*>(statement.get())) {
+            removeUnreachable(blockNode, false);
+        }
+        statements.push_back(std::move(statement));
+    }
+}
+
+void DeadCodeElimination::removeLaterReturns(ExprNode* node, size_t returnLine) {
+    std::vector<BlockNode*> blocks;
+    if (auto ifNode = dynamic_cast<IfNode*>(node)) {
+        blocks = { ifNode->getThenBlock().get(), ifNode->getElseBlock().get() };
+    }
+    else if (auto whileNode = dynamic_cast<WhileNode*>(node)) {
+        blocks = { whileNode->getBlock().get() };
+    }
+    else if (auto blockNode = dynamic_cast<BlockNode*>(node)) {
+        blocks = { blockNode };
+    }
+
+    for (BlockNode* block : blocks) {
+        if (!block) {
+            continue;
+        }
+        auto& statements = block->getStatements();
+        for (auto it = statements.begin(); it != statements.end();) {
+            auto returnNode = dynamic_cast<const ReturnNode*>(it->get());
+            if (returnNode && returnNode->getValue()) {
+                removals.push_back({ returnNode->getToken().line, "unused return",
+                    ASTHelper::describe(returnNode) + " after the return at line " + std::to_string(returnLine) });
+                it = statements.erase(it);
+                continue;
+            }
+            removeLaterReturns(it->get(), returnLine);
+            ++it;
+        }
+    }
+}
+
+void DeadCodeElimination::removeDeadStores(BlockNode* block, const std::unordered_set<std::string>& reads) {
+    if (!block) {
+        return;
+    }
+    auto& statements = block->getStatements();
+    for (auto it = statements.begin(); it != statements.end();) {
+        std::unique_ptr<ExprNode>& statement = *it;
+        if (!statement) {
+            ++it;
+            continue;
+        }
+        const size_t line = statement->getToken().line;
+
+        if (auto ifNode = dynamic_cast<IfNode*>(statement.get())) {
+            removeDeadStores(ifNode->getThenBlock().get(), reads);
+            removeDeadStores(ifNode->getElseBlock().get(), reads);
+        }
+        else if (auto whileNode = dynamic_cast<WhileNode*>(statement.get())) {
+            removeDeadStores(whileNode->getBlock().get(), reads);
+        }
+        else if (auto defNode = dynamic_cast<FunctionDefNode*>(statement.get())) {
+            // Assignments in a function always write locals, which only the function itself can read
+            std::unordered_set<std::string> localReads;
+            collectReads(defNode->getBody().get(), localReads);
+            removeDeadStores(defNode->getBody().get(), localReads);
+        }
+        else if (auto blockNode = dynamic_cast<BlockNode*>(statement.get())) {
+            removeDeadStores(blockNode, reads);
+        }
+        else if (typeid(*statement) == typeid(AssignNode)) {
+            auto assignNode = static_cast<AssignNode*>(statement.get());
+            if (reads.count(assignNode->getName()) == 0) {
+                if (isSafe(assignNode->getValue().get())) {
+                    removals.push_back({ line, "dead store", ASTHelper::describe(assignNode) });
+                    it = statements.erase(it);
+                    continue;
+                }
+                removals.push_back({ line, "dead store", ASTHelper::describe(assignNode) + ", value still evaluated" });
+                statement = std::move(assignNode->getValue());
+            }
+        }
+        else if (isSafe(statement.get())) {
+            removals.push_back({ line, "no effect", ASTHelper::describe(statement.get()) });
+            it = statements.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+void DeadCodeElimination::collectReads(const ExprNode* node, std::unordered_set<std::string>& reads) {
+    if (!node) {
+        return;
+    }
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        reads.insert(varNode->getName());
+    }
+    else if (auto appendNode = dynamic_cast<const ListAppendNode*>(node)) {
+        reads.insert(appendNode->getListName());
+    }
+    else if (auto popNode = dynamic_cast<const ListPopNode*>(node)) {
+        reads.insert(popNode->getListName());
+    }
+    else if (auto lengthNode = dynamic_cast<const ListLengthNode*>(node)) {
+        reads.insert(lengthNode->getListName());
+    }
+    else if (auto indexNode = dynamic_cast<const ListIndexNode*>(node)) {
+        reads.insert(indexNode->getListName());
+    }
+    else if (auto sliceNode = dynamic_cast<const ListSliceNode*>(node)) {
+        reads.insert(sliceNode->getListName());
+    }
+    else if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        reads.insert(methodNode->getListName());
+    }
+    else if (auto replaceNode = dynamic_cast<const ListReplaceNode*>(node)) {
+        reads.insert(replaceNode->getListName());
+    }
+    else if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        reads.insert(mapMethodNode->getMapName());
+    }
+    ASTHelper::forEachChild(node, [&reads](const ExprNode* child) {
+        collectReads(child, reads);
+    });
+}
+
+bool DeadCodeElimination::isSafe(const ExprNode* node) {
+    if (dynamic_cast<const IntegerNode*>(node) || dynamic_cast<const DoubleNode*>(node)
+        || dynamic_cast<const StringNode*>(node) || dynamic_cast<const BooleanNode*>(node)) {
+        return true;
+    }
+    if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        const ExprNode* operand = unNode->getOperand().get();
+        if (unNode->getOp() == "-") {
+            return dynamic_cast<const IntegerNode*>(operand) || dynamic_cast<const DoubleNode*>(operand);
+        }
+        return unNode->getOp() == "!" && dynamic_cast<const BooleanNode*>(operand);
+    }
+    return false;
+}
@@ -0,0 +1,95 @@
+#ifndef DEADCODEELIMINATION_H
+#define DEADCODEELIMINATION_H
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "AST/AST.h"
+
+/**
+ * @class DeadCodeElimination
+ * @brief Removes statements that can never run and assignments whose value is never read.
+ *
+ * Unreachable code is removed first. A condition is constant when it is a bool literal or a
+ * comparison of two int literals, such as `1 == 0`.
+ * - The branch of an if with a constant condition that is not taken is removed, and the other
+ *   branch is spliced into the enclosing block.
+ * - A while loop whose condition is constantly false is removed.
+ * - A return that follows a return at the top level of a function body is removed.
+ *
+ * A return only records the function's result and the statements after it still run, so those
+ * statements are kept. The returns among them are removed because a function returns once and
+ * every later return does nothing.
+ *
+ * Dead stores are removed next. An assignment is dead when no statement in its scope reads the
+ * variable: the function body for a local, and the whole program for a global, since functions
+ * read globals they do not assign. If the assigned value is a literal the whole assignment is
+ * removed. Otherwise the value is kept as a statement, so its prints, input, list mutations,
+ * function calls and errors still happen, and only the store is removed.
+ */
+class DeadCodeElimination {
+public:
+    /**
+     * @brief Removes the unreachable statements and dead stores of a program, including function bodies.
+     * @param program The top-level block of the program.
+     * @return The number of statements that were removed or reduced to their value.
+     */
+    size_t run(BlockNode& program);
+
+    /**
+     * @brief Formats the removed code as a table ordered by line.
+     * @return The report, with a summary line followed by one row per removal.
+     */
+    std::string report() const;
+
+private:
+    /**
+     * @struct Removal
+     * @brief One piece of code removed, recorded for the report.
+     */
+    struct Removal {
+        size_t line; ///< The line of the removed code.
+        std::string kind; ///< Why it was removed, such as "unreachable" or "dead store".
+        std::string detail; ///< What was removed.
+    };
+
+    std::vector<Removal> removals; ///< The code removed so far, in the order it was removed.
+
+    /**
+     * @brief Removes the untaken branches of constant ifs, loops that never run and returns after a return from a block.
+     * @param block The block, which may be null.
+     * @param functionBody Whether the block is the body of a function.
+     */
+    void removeUnreachable(BlockNode* block, bool functionBody);
+
+    /**
+     * @brief Removes every return statement in the blocks nested in a statement that follows a return.
+     * @param node The statement.
+     * @param returnLine The line of the return that ends the function.
+     */
+    void removeLaterReturns(ExprNode* node, size_t returnLine);
+
+    /**
+     * @brief Removes the assignments of a block and its nested blocks to variables that are never read.
+     * @param block The block, which may be null.
+     * @param reads The variables read in the block's scope.
+     */
+    void removeDeadStores(BlockNode* block, const std::unordered_set<std::string>& reads);
+
+    /**
+     * @brief Records the variables, lists and maps a subtree reads, including those in function bodies.
+     * @param node The root of the subtree.
+     * @param reads Updated with the names read by the subtree.
+     */
+    static void collectReads(const ExprNode* node, std::unordered_set<std::string>& reads);
+
+    /**
+     * @brief Checks whether evaluating an expression has no effect and cannot fail.
+     * @param node The expression.
+     * @return True for literals and negated literals.
+     */
+    static bool isSafe(const ExprNode* node);
+};
+
+#endif // DEADCODEELIMINATION_H
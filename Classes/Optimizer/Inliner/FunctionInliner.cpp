@@ -0,0 +1,306 @@
+#include "FunctionInliner.h"
+#include <functional>
+#include "Optimizer/Utility/ASTHelper.h"
+
+namespace {
+    // Collects the names of all functions called within a subtree
+    void collectCalls(const ExprNode* node, std::unordered_set<std::string>& calls) {
+        if (!node) {
+            return;
+        }
+        if (auto callNode = dynamic_cast<const FunctionCallNode*>(node)) {
+            calls.insert(callNode->getName());
+        }
+        ASTHelper::forEachChild(node, [&calls](const ExprNode* child) {
+            collectCalls(child, calls);
+        });
+    }
+
+    // Counts how often each function name is defined anywhere in the subtree
+    void countDefinitions(const ExprNode* node, std::unordered_map<std::string, size_t>& counts) {
+        if (!node) {
+            return;
+        }
+        if (auto defNode = dynamic_cast<const FunctionDefNode*>(node)) {
+            counts[defNode->getName()]++;
+        }
+        ASTHelper::forEachChild(node, [&counts](const ExprNode* child) {
+            countDefinitions(child, counts);
+        });
+    }
+
+    // Counts references to a variable within a subtree
+    size_t countUses(const ExprNode* node, const std::string& name) {
+        if (!node) {
+            return 0;
+        }
+        if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+            return varNode->getName() == name ? 1 : 0;
+        }
+        size_t uses = 0;
+        ASTHelper::forEachChild(node, [&uses, &name](const ExprNode* child) {
+            uses += countUses(child, name);
+        });
+        return uses;
+    }
+
+    bool isLiteral(const ExprNode* node) {
+        return dynamic_cast<const IntegerNode*>(node) || dynamic_cast<const DoubleNode*>(node)
+            || dynamic_cast<const StringNode*>(node) || dynamic_cast<const BooleanNode*>(node);
+    }
+}
+
+FunctionInliner::FunctionInliner(const OptimizerOptions& options) : options(options) {}
+
+size_t FunctionInliner::run(BlockNode& program) {
+    collectCandidates(program);
+    removeRecursiveCandidates();
+    if (candidates.empty()) {
+        return 0;
+    }
+
+    auto& statements = program.getStatements();
+    for (size_t i = 0; i < statements.size(); ++i) {
+        rewrite(statements[i], i);
+    }
+    return inlinedCount;
+}
+
+void FunctionInliner::collectCandidates(const BlockNode& program) {
+    std::unordered_map<std::string, size_t> definitionCounts;
+    countDefinitions(&program, definitionCounts);
+
+    const auto& statements = program.getStatements();
+    for (size_t i = 0; i < statements.size(); ++i) {
+        auto defNode = dynamic_cast<const FunctionDefNode*>(statements[i].get());
+        if (!defNode || definitionCounts[defNode->getName()] != 1 || defNode->getReturnType() == "void") {
+            continue;
+        }
+
+        const auto& body = defNode->getBody();
+        if (!body || body->getStatements().size() != 1) {
+            continue;
+        }
+
+        auto returnNode = dynamic_cast<const ReturnNode*>(body->getStatements().front().get());
+        if (!returnNode || !returnNode->getValue()) {
+            continue;
+        }
+
+        // List arguments are copied on write, which substituting them would not preserve
+        auto isList = [](const std::string& type) { return type.compare(0, 5, "list:") == 0; };
+        std::unordered_set<std::string> parameters;
+        bool takesList = isList(defNode->getReturnType());
+        for (const auto& param : defNode->getParameters()) {
+            parameters.insert(param.first);
+            takesList = takesList || isList(param.second);
+        }
+        if (parameters.size() != defNode->getParameters().size() || takesList) {
+            continue;
+        }
+
+        bool callsFunctions = false;
+        if (ASTHelper::countNodes(returnNode->getValue().get()) > options.inlineThreshold
+            || !isInlinableExpression(returnNode->getValue().get(), parameters, callsFunctions)) {
+            continue;
+        }
+
+        candidates[defNode->getName()] = Candidate{ defNode, returnNode, i, callsFunctions };
+    }
+}
+
+void FunctionInliner::removeRecursiveCandidates() {
+    std::unordered_map<std::string, std::unordered_set<std::string>> callGraph;
+    for (const auto& [name, candidate] : candidates) {
+        collectCalls(candidate.returnNode->getValue().get(), callGraph[name]);
+    }
+
+    std::unordered_set<std::string> recursive;
+    for (const auto& [name, candidate] : candidates) {
+        std::unordered_set<std::string> visited;
+        std::function<bool(const std::string&)> reaches = [&](const std::string& current) {
+            auto it = callGraph.find(current);
+            if (it == callGraph.end()) {
+                return false;
+            }
+            for (const auto& callee : it->second) {
+                if (callee == name) {
+                    return true;
+                }
+                if (visited.insert(callee).second && reaches(callee)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        if (reaches(name)) {
+            recursive.insert(name);
+        }
+    }
+
+    for (const auto& name : recursive) {
+        candidates.erase(name);
+    }
+}
+
+void FunctionInliner::rewrite(std::unique_ptr<ExprNode>& slot, size_t index) {
+    if (!slot) {
+        return;
+    }
+
+    ASTHelper::forEachChildSlot(slot.get(), [this, index](std::unique_ptr<ExprNode>& child) {
+        rewrite(child, index);
+    });
+
+    auto callNode = dynamic_cast<FunctionCallNode*>(slot.get());
+    if (!callNode) {
+        return;
+    }
+
+    auto it = candidates.find(callNode->getName());
+    if (it == candidates.end() || it->second.index >= index) {
+        return;
+    }
+
+    auto inlined = expand(callNode, it->second);
+    if (inlined) {
+        slot = std::move(inlined);
+        inlinedCount++;
+    }
+}
+
+std::unique_ptr<ExprNode> FunctionInliner::expand(FunctionCallNode* callNode, const Candidate& candidate) {
+    const auto& params = candidate.definition->getParameters();
+    auto& args = callNode->getArgs();
+    if (params.size() != args.size()) {
+        // Leave the call alone so the argument count error is still reported at runtime
+        return nullptr;
+    }
+
+    const ExprNode* returnValue = candidate.returnNode->getValue().get();
+    const Token& token = callNode->getToken();
+
+    std::vector<std::unique_ptr<AssignNode>> bindings;
+    std::vector<std::unique_ptr<ExprNode>> slotReferences;
+    std::unordered_map<std::string, const ExprNode*> substitutions;
+
+    for (size_t i = 0; i < params.size(); ++i) {
+        const std::string& paramName = params[i].first;
+        bool usedInBody = countUses(returnValue, paramName) > 0;
+
+        // Literals can always be substituted; variables only when nothing in the body can modify them first
+        if (isLiteral(args[i].get()) || (usedInBody && !candidate.callsFunctions && dynamic_cast<const VariableNode*>(args[i].get()))) {
+            substitutions[paramName] = args[i].get();
+            continue;
+        }
+
+        std::string slotName = "__inline_" + candidate.definition->getName() + "_" + paramName + "_" + std::to_string(slotCounter++);
+        bindings.push_back(std::make_unique<AssignNode>(token, slotName, std::move(args[i])));
+        slotReferences.push_back(std::make_unique<VariableNode>(token, slotName));
+        substitutions[paramName] = slotReferences.back().get();
+    }
+
+    auto body = substitute(returnValue, substitutions);
+    const std::string& returnType = candidate.definition->getReturnType();
+    bool checkReturnType = staticType(body.get()) != returnType;
+
+    return std::make_unique<InlinedCallNode>(token, callNode->getName(), std::move(bindings), std::move(body),
+        candidate.returnNode->getToken(), returnType, checkReturnType);
+}
+
+std::unique_ptr<ExprNode> FunctionInliner::substitute(const ExprNode* node, const std::unordered_map<std::string, const ExprNode*>& substitutions) {
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        auto it = substitutions.find(varNode->getName());
+        if (it != substitutions.end()) {
+            return ASTHelper::clone(it->second);
+        }
+    }
+
+    auto copy = ASTHelper::clone(node);
+    std::function<void(std::unique_ptr<ExprNode>&)> replace = [&](std::unique_ptr<ExprNode>& slot) {
+        if (auto varNode = dynamic_cast<const VariableNode*>(slot.get())) {
+            auto it = substitutions.find(varNode->getName());
+            if (it != substitutions.end()) {
+                slot = ASTHelper::clone(it->second);
+            }
+            return;
+        }
+        ASTHelper::forEachChildSlot(slot.get(), replace);
+    };
+    ASTHelper::forEachChildSlot(copy.get(), replace);
+    return copy;
+}
+
+bool FunctionInliner::isInlinableExpression(const ExprNode* node, const std::unordered_set<std::string>& parameters, bool& callsFunctions) {
+    if (!node) {
+        return false;
+    }
+
+    if (isLiteral(node)) {
+        return true;
+    }
+
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        // Globals could be shadowed by locals of the caller, so only parameters may be referenced
+        return parameters.count(varNode->getName()) > 0;
+    }
+
+    if (dynamic_cast<const FunctionCallNode*>(node)) {
+        callsFunctions = true;
+    }
+    else if (!dynamic_cast<const BinaryExprNode*>(node) && !dynamic_cast<const UnaryExprNode*>(node) && !dynamic_cast<const TypeCastNode*>(node)) {
+        return false;
+    }
+
+    bool inlinable = true;
+    ASTHelper::forEachChild(node, [&](const ExprNode* child) {
+        inlinable = inlinable && isInlinableExpression(child, parameters, callsFunctions);
+    });
+    return inlinable;
+}
+
+std::string FunctionInliner::staticType(const ExprNode* node) {
+    if (dynamic_cast<const IntegerNode*>(node)) return "int";
+    if (dynamic_cast<const DoubleNode*>(node)) return "double";
+    if (dynamic_cast<const StringNode*>(node)) return "string";
+    if (dynamic_cast<const BooleanNode*>(node)) return "bool";
+
+    if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        TokenType type = binNode->getToken().type;
+        if (type == TokenType::COMPARISON || type == TokenType::LOGICAL) {
+            return "bool";
+        }
+        if (type == TokenType::ARITHMETIC) {
+            std::string left = staticType(binNode->getLeft().get());
+            std::string right = staticType(binNode->getRight().get());
+            const std::string& op = binNode->getOp();
+            if (op == "+" && left == "string") {
+                return "string";
+            }
+            // Whole number results are stored as int, so only +, - and * of two ints are known ahead of time
+            if ((op == "+" || op == "-" || op == "*") && left == "int" && right == "int") {
+                return "int";
+            }
+        }
+        return "";
+    }
+
+    if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        if (unNode->getOp() == "!") {
+            return "bool";
+        }
+        std::string operand = staticType(unNode->getOperand().get());
+        return operand == "int" || operand == "double" ? operand : "";
+    }
+
+    if (auto castNode = dynamic_cast<const TypeCastNode*>(node)) {
+        const std::string& type = castNode->getType();
+        return type == "string" || type == "double" || type == "bool" ? type : "";
+    }
+
+    if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        return inlinedNode->getReturnType();
+    }
+
+    return "";
+}
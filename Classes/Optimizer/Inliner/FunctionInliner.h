@@ -0,0 +1,103 @@
+#ifndef FUNCTIONINLINER_H
+#define FUNCTIONINLINER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "AST/AST.h"
+#include "Structs/Optimizer/OptimizerOptions.h"
+
+/**
+ * @class FunctionInliner
+ * @brief Expands calls to small, non-recursive functions at their call sites.
+ *
+ * A function is a candidate when it is defined exactly once at the top level of the program,
+ * its body is a single return statement, the return expression only refers to the function's
+ * parameters and its size does not exceed the configured threshold. Calls are only expanded
+ * after the definition in program order, so undefined function errors are preserved.
+ */
+class FunctionInliner {
+public:
+    /**
+     * @brief Constructs a FunctionInliner with the given options.
+     * @param options The optimiser options holding the inlining threshold.
+     */
+    explicit FunctionInliner(const OptimizerOptions& options);
+
+    /**
+     * @brief Inlines eligible call sites throughout the program.
+     * @param program The top-level block of the program.
+     * @return The number of call sites that were inlined.
+     */
+    size_t run(BlockNode& program);
+
+private:
+    /**
+     * @struct Candidate
+     * @brief Describes a function that may be expanded at its call sites.
+     */
+    struct Candidate {
+        const FunctionDefNode* definition; ///< The definition of the function.
+        const ReturnNode* returnNode; ///< The single return statement forming the body.
+        size_t index; ///< Index of the definition among the top-level statements.
+        bool callsFunctions; ///< Whether the return expression contains further function calls.
+    };
+
+    const OptimizerOptions& options; ///< The optimiser options.
+    std::unordered_map<std::string, Candidate> candidates; ///< Inlinable functions by name.
+    size_t slotCounter = 0; ///< Counter used to create unique caller-local slot names.
+    size_t inlinedCount = 0; ///< Number of call sites inlined so far.
+
+    /**
+     * @brief Collects the functions eligible for inlining.
+     * @param program The top-level block of the program.
+     */
+    void collectCandidates(const BlockNode& program);
+
+    /**
+     * @brief Removes candidates that can reach themselves through calls.
+     */
+    void removeRecursiveCandidates();
+
+    /**
+     * @brief Rewrites call sites in the subtree held by the given slot.
+     * @param slot The slot holding the subtree.
+     * @param index Index of the enclosing top-level statement.
+     */
+    void rewrite(std::unique_ptr<ExprNode>& slot, size_t index);
+
+    /**
+     * @brief Builds the inlined replacement for a call to a candidate function.
+     * @param callNode The call to expand.
+     * @param candidate The function being called.
+     * @return The inlined call node replacing the call.
+     */
+    std::unique_ptr<ExprNode> expand(FunctionCallNode* callNode, const Candidate& candidate);
+
+    /**
+     * @brief Copies an expression, replacing parameter references with their arguments or slots.
+     * @param node The expression to copy.
+     * @param substitutions Map of parameter names to the expressions replacing them.
+     * @return The substituted copy.
+     */
+    static std::unique_ptr<ExprNode> substitute(const ExprNode* node, const std::unordered_map<std::string, const ExprNode*>& substitutions);
+
+    /**
+     * @brief Checks whether a return expression only uses constructs that can be safely inlined.
+     * @param node The expression to check.
+     * @param parameters The names of the function's parameters.
+     * @param callsFunctions Set to true if the expression contains function calls.
+     * @return True if the expression can be inlined.
+     */
+    static bool isInlinableExpression(const ExprNode* node, const std::unordered_set<std::string>& parameters, bool& callsFunctions);
+
+    /**
+     * @brief Determines the type an expression always produces, if it can be known before execution.
+     * @param node The expression to inspect.
+     * @return The type name, or an empty string if it depends on runtime values.
+     */
+    static std::string staticType(const ExprNode* node);
+};
+
+#endif // FUNCTIONINLINER_H
@@ -0,0 +1,197 @@
+#include "LoopInvariantMotion.h"
+#include "Optimizer/Utility/ASTHelper.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    bool mutatesList(ListMethod method) {
+        return method == ListMethod::SORT || method == ListMethod::EXTEND || method == ListMethod::REVERSE;
+    }
+
+    bool mutatesMap(MapMethod method) {
+        return method == MapMethod::SET || method == MapMethod::REMOVE;
+    }
+}
+
+size_t LoopInvariantMotion::run(BlockNode& program) {
+    for (auto& statement : program.getStatements()) {
+        visit(statement);
+    }
+    return hoists.size();
+}
+
+std::string LoopInvariantMotion::report() const {
+    std::vector<const Hoist*> sorted;
+    for (const Hoist& hoist : hoists) {
+        sorted.push_back(&hoist);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Hoist* a, const Hoist* b) { return a->line < b->line; });
+
+    std::ostringstream out;
+    out << "Loop-invariant code motion: " << hoists.size() << " expressions hoisted from " << loopCount << " loops\n";
+    out << std::setw(8) << "Line" << std::setw(8) << "Loop" << std::setw(12) << "Slot" << "  Expression\n";
+    for (const Hoist* hoist : sorted) {
+        out << std::setw(8) << hoist->line << std::setw(8) << hoist->loopLine << std::setw(12) << hoist->slot
+            << "  " << hoist->expression << "\n";
+    }
+    return out.str();
+}
+
+void LoopInvariantMotion::visit(std::unique_ptr<ExprNode>& slot) {
+    if (!slot) {
+        return;
+    }
+    ASTHelper::forEachChildSlot(slot.get(), [this](std::unique_ptr<ExprNode>& child) {
+        visit(child);
+    });
+    if (typeid(*slot) == typeid(WhileNode)) {
+        hoistLoop(slot);
+    }
+}
+
+void LoopInvariantMotion::hoistLoop(std::unique_ptr<ExprNode>& slot) {
+    auto whileNode = static_cast<WhileNode*>(slot.get());
+    LoopEffects effects;
+    collectEffects(whileNode, effects);
+
+    // The copy is taken before any expression is replaced, so it runs exactly as written
+    std::unique_ptr<ExprNode> fallback = ASTHelper::clone(whileNode);
+    std::vector<std::unique_ptr<AssignNode>> hoisted;
+    const size_t loopLine = whileNode->getToken().line;
+    hoistFrom(whileNode->getCondition(), effects, loopLine, hoisted);
+    for (auto& statement : whileNode->getBlock()->getStatements()) {
+        hoistFrom(statement, effects, loopLine, hoisted);
+    }
+    if (hoisted.empty()) {
+        return;
+    }
+
+    loopCount++;
+    const Token token = whileNode->getToken();
+    slot = std::make_unique<HoistedWhileNode>(token, std::move(hoisted), std::move(slot), std::move(fallback));
+}
+
+void LoopInvariantMotion::hoistFrom(std::unique_ptr<ExprNode>& slot, const LoopEffects& effects, size_t loopLine,
+    std::vector<std::unique_ptr<AssignNode>>& hoisted) {
+    if (!slot || dynamic_cast<const FunctionDefNode*>(slot.get())) {
+        // A function defined in the loop runs in its own scope, where the loop's variables mean something else
+        return;
+    }
+    if (isInvariant(slot.get(), effects) && isWorthHoisting(slot.get())) {
+        const Token token = slot->getToken();
+        std::string slotName = "__licm_" + std::to_string(slotCounter++);
+        hoists.push_back({ token.line, loopLine, slotName, ASTHelper::describe(slot.get()) });
+        hoisted.push_back(std::make_unique<AssignNode>(token, slotName, std::move(slot)));
+        slot = std::make_unique<VariableNode>(token, slotName);
+        return;
+    }
+    if (auto hoistedNode = dynamic_cast<HoistedWhileNode*>(slot.get())) {
+        // The fallback of an inner loop only runs when its own hoisting failed, so it is left as written
+        for (auto& assignment : hoistedNode->getHoisted()) {
+            hoistFrom(assignment->getValue(), effects, loopLine, hoisted);
+        }
+        hoistFrom(hoistedNode->getLoop(), effects, loopLine, hoisted);
+        return;
+    }
+    ASTHelper::forEachChildSlot(slot.get(), [&](std::unique_ptr<ExprNode>& child) {
+        hoistFrom(child, effects, loopLine, hoisted);
+    });
+}
+
+void LoopInvariantMotion::collectEffects(const ExprNode* node, LoopEffects& effects) {
+    if (!node || dynamic_cast<const FunctionDefNode*>(node)) {
+        return;
+    }
+    if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+        effects.writes.insert(assignNode->getName());
+    }
+    else if (auto listNode = dynamic_cast<const ListInitNode*>(node)) {
+        effects.writes.insert(listNode->getName());
+        effects.mutatesContainers = true;
+    }
+    else if (auto mapNode = dynamic_cast<const MapInitNode*>(node)) {
+        effects.writes.insert(mapNode->getName());
+        effects.mutatesContainers = true;
+    }
+    else if (dynamic_cast<const ListAppendNode*>(node) || dynamic_cast<const ListPopNode*>(node) || dynamic_cast<const ListReplaceNode*>(node)) {
+        effects.mutatesContainers = true;
+    }
+    else if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        effects.mutatesContainers |= mutatesList(methodNode->getMethod());
+    }
+    else if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        effects.mutatesContainers |= mutatesMap(mapMethodNode->getMethod());
+    }
+    else if (dynamic_cast<const FunctionCallNode*>(node)) {
+        // A function cannot assign the caller's variables, but it can change a global list or map
+        effects.mutatesContainers = true;
+    }
+    else if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        for (const auto& binding : inlinedNode->getBindings()) {
+            effects.writes.insert(binding->getName());
+        }
+    }
+    else if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+        for (const auto& assignment : hoistedNode->getHoisted()) {
+            effects.writes.insert(assignment->getName());
+        }
+    }
+    ASTHelper::forEachChild(node, [&effects](const ExprNode* child) {
+        collectEffects(child, effects);
+    });
+}
+
+bool LoopInvariantMotion::isInvariant(const ExprNode* node, const LoopEffects& effects) {
+    if (!node) {
+        return true;
+    }
+    if (dynamic_cast<const IntegerNode*>(node) || dynamic_cast<const DoubleNode*>(node)
+        || dynamic_cast<const StringNode*>(node) || dynamic_cast<const BooleanNode*>(node)) {
+        return true;
+    }
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        return effects.writes.count(varNode->getName()) == 0;
+    }
+    if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        return isInvariant(binNode->getLeft().get(), effects) && isInvariant(binNode->getRight().get(), effects);
+    }
+    if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        return isInvariant(unNode->getOperand().get(), effects);
+    }
+    if (auto castNode = dynamic_cast<const TypeCastNode*>(node)) {
+        return isInvariant(castNode->getValue().get(), effects);
+    }
+
+    // Reads of lists and maps are invariant only when no list or map can change while the loop runs
+    if (effects.mutatesContainers) {
+        return false;
+    }
+    if (auto lengthNode = dynamic_cast<const ListLengthNode*>(node)) {
+        return effects.writes.count(lengthNode->getListName()) == 0;
+    }
+    if (auto indexNode = dynamic_cast<const ListIndexNode*>(node)) {
+        return effects.writes.count(indexNode->getListName()) == 0 && isInvariant(indexNode->getIndex().get(), effects);
+    }
+    if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        return !mutatesList(methodNode->getMethod()) && effects.writes.count(methodNode->getListName()) == 0
+            && isInvariant(methodNode->getArgument().get(), effects);
+    }
+    if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        return mapMethodNode->getMethod() == MapMethod::GET && effects.writes.count(mapMethodNode->getMapName()) == 0
+            && isInvariant(mapMethodNode->getKey().get(), effects);
+    }
+    return false;
+}
+
+bool LoopInvariantMotion::isWorthHoisting(const ExprNode* node) {
+    if (dynamic_cast<const BinaryExprNode*>(node) || dynamic_cast<const TypeCastNode*>(node)
+        || dynamic_cast<const ListLengthNode*>(node) || dynamic_cast<const ListIndexNode*>(node)
+        || dynamic_cast<const ListMethodNode*>(node) || dynamic_cast<const MapMethodNode*>(node)) {
+        return true;
+    }
+    if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        return isWorthHoisting(unNode->getOperand().get());
+    }
+    return false;
+}
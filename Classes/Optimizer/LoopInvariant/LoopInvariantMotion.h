@@ -0,0 +1,113 @@
+#ifndef LOOPINVARIANTMOTION_H
+#define LOOPINVARIANTMOTION_H
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "AST/AST.h"
+
+/**
+ * @class LoopInvariantMotion
+ * @brief Moves expressions whose value cannot change while a while loop runs in front of the loop.
+ *
+ * For each loop the pass collects the variables written by its condition and body, and whether
+ * the loop may change the contents of a list or map. A list or map may be shared between
+ * variables and is visible to every function through the globals, so any append, pop, replace,
+ * mutating method or function call in the loop counts as a change to all of them.
+ *
+ * An expression is invariant when it is pure and reads only variables the loop does not write:
+ * literals, variables, operators, casts, and reads of lists and maps (length, indexing, sum,
+ * min, max, contains, index and get) in loops that change none. The largest invariant
+ * expressions that do some work are stored in slots by a HoistedWhileNode before the loop
+ * starts and replaced by reads of the slots. Expressions producing a list are never hoisted,
+ * since every evaluation has to produce a new list.
+ *
+ * Inner loops are processed first, so an expression invariant in several nested loops ends up
+ * in front of the outermost of them.
+ */
+class LoopInvariantMotion {
+public:
+    /**
+     * @brief Hoists the invariant expressions of every while loop in the program, including function bodies.
+     * @param program The top-level block of the program.
+     * @return The number of expressions that were hoisted.
+     */
+    size_t run(BlockNode& program);
+
+    /**
+     * @brief Formats the hoisted expressions as a table ordered by line.
+     * @return The report, with a summary line followed by one row per hoisted expression.
+     */
+    std::string report() const;
+
+private:
+    /**
+     * @struct LoopEffects
+     * @brief What a loop may change while it runs.
+     */
+    struct LoopEffects {
+        std::unordered_set<std::string> writes; ///< Names of the variables the loop assigns or declares.
+        bool mutatesContainers = false; ///< Whether the loop may change the contents of any list or map.
+    };
+
+    /**
+     * @struct Hoist
+     * @brief One expression moved in front of a loop, recorded for the report.
+     */
+    struct Hoist {
+        size_t line; ///< The line of the expression.
+        size_t loopLine; ///< The line of the loop it was moved out of.
+        std::string slot; ///< The slot holding its value.
+        std::string expression; ///< The expression as it appears in the script.
+    };
+
+    std::vector<Hoist> hoists; ///< The expressions hoisted so far, in the order they were hoisted.
+    size_t loopCount = 0; ///< Number of loops that had expressions hoisted.
+    size_t slotCounter = 0; ///< Counter used to give every slot a unique name.
+
+    /**
+     * @brief Processes the loops below the node held by a slot, then the node itself if it is a loop.
+     * @param slot The slot holding the node, which is replaced if a loop has expressions hoisted.
+     */
+    void visit(std::unique_ptr<ExprNode>& slot);
+
+    /**
+     * @brief Hoists the invariant expressions of a loop and wraps it in a HoistedWhileNode if there are any.
+     * @param slot The slot holding the WhileNode.
+     */
+    void hoistLoop(std::unique_ptr<ExprNode>& slot);
+
+    /**
+     * @brief Replaces the largest invariant expressions below a slot with reads of new slots.
+     * @param slot The slot holding the expression or statement.
+     * @param effects What the loop may change.
+     * @param loopLine The line of the loop, for the report.
+     * @param hoisted Receives the assignments computing the hoisted expressions.
+     */
+    void hoistFrom(std::unique_ptr<ExprNode>& slot, const LoopEffects& effects, size_t loopLine, std::vector<std::unique_ptr<AssignNode>>& hoisted);
+
+    /**
+     * @brief Records the variables a subtree writes and whether it may change a list or map.
+     * @param node The root of the subtree.
+     * @param effects Updated with the effects of the subtree.
+     */
+    static void collectEffects(const ExprNode* node, LoopEffects& effects);
+
+    /**
+     * @brief Checks whether an expression is pure and reads nothing the loop changes.
+     * @param node The expression.
+     * @param effects What the loop may change.
+     * @return True if every evaluation of the expression in the loop produces the same value.
+     */
+    static bool isInvariant(const ExprNode* node, const LoopEffects& effects);
+
+    /**
+     * @brief Checks whether an invariant expression does enough work to be worth a slot.
+     * @param node The expression.
+     * @return True if the expression contains an operator, a cast or a read of a list or map.
+     */
+    static bool isWorthHoisting(const ExprNode* node);
+};
+
+#endif // LOOPINVARIANTMOTION_H
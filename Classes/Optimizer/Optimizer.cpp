@@ -0,0 +1,54 @@
+#include "Optimizer.h"
+#include "Optimizer/DeadCode/DeadCodeElimination.h"
+#include "Optimizer/SSA/SSAOptimizer.h"
+#include "Optimizer/Inliner/FunctionInliner.h"
+#include "Optimizer/TypeInference/TypeInference.h"
+#include "Optimizer/LoopInvariant/LoopInvariantMotion.h"
+#include "Optimizer/Superinstructions/SuperinstructionFuser.h"
+
+Optimizer::Optimizer(const OptimizerOptions& options) : options(options) {}
+
+void Optimizer::optimize(BlockNode& program) {
+    report.clear();
+    // Dead code is removed first, so the later passes do not spend time on it
+    DeadCodeElimination elimination;
+    if (options.eliminateDeadCode) {
+        elimination.run(program);
+    }
+    // The SSA passes only model the nodes the parser creates, so they run before any pass adds its own
+    if (options.optimizeSSA) {
+        SSAOptimizer ssa;
+        // Folded conditions leave branches and loops that never run, which a second elimination removes
+        if (ssa.run(program) > 0 && options.eliminateDeadCode) {
+            elimination.run(program);
+        }
+        if (options.dumpIR) {
+            report += ssa.dump();
+        }
+    }
+    if (options.eliminateDeadCode && options.reportDeadCode) {
+        report += elimination.report();
+    }
+    if (options.inlineFunctions) {
+        FunctionInliner inliner(options);
+        inliner.run(program);
+    }
+    // Inlined calls expose their arguments to the type inference, so it runs after inlining
+    if (options.specializeTypes) {
+        TypeInference inference;
+        inference.run(program);
+    }
+    // Hoisted expressions keep the typed operations inference proved inside the loop, since their operands hold the same values
+    if (options.hoistInvariants) {
+        LoopInvariantMotion motion;
+        motion.run(program);
+        if (options.reportHoisting) {
+            report += motion.report();
+        }
+    }
+    // Fused nodes record the shape of their operands, so fusion runs after every pass that rewrites them
+    if (options.fuseStatements) {
+        SuperinstructionFuser fuser;
+        fuser.run(program);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <string>
+#include "AST/AST.h"
+#include "Structs/Optimizer/OptimizerOptions.h"
+
+/**
+ * @class Optimizer
+ * @brief Runs the enabled optimisation passes over a parsed program before it is executed.
+ */
+class Optimizer {
+public:
+    /**
+     * @brief Constructs an Optimizer with the given options.
+     * @param options The options selecting and configuring the passes.
+     */
+    explicit Optimizer(const OptimizerOptions& options);
+
+    /**
+     * @brief Optimises the program in place.
+     * @param program The top-level block of the program.
+     */
+    void optimize(BlockNode& program);
+
+    /**
+     * @brief Gets the diagnostics of the passes that were asked to report.
+     * @return The reports of the last optimised program, empty if none was requested.
+     */
+    const std::string& getReport() const { return report; }
+
+private:
+    const OptimizerOptions& options; ///< The options selecting and configuring the passes.
+    std::string report; ///< The diagnostics of the passes that were asked to report.
+};
+
+#endif // OPTIMIZER_H
@@ -0,0 +1,286 @@
+#include "IR.h"
+#include "Value/ValueHelper.h"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+    std::string literal(const Value& value) {
+        if (ValueHelper::isInt(value)) {
+            return std::to_string(std::get<int>(value));
+        }
+        if (ValueHelper::isDouble(value)) {
+            std::ostringstream out;
+            out << std::get<double>(value);
+            return out.str();
+        }
+        if (ValueHelper::isString(value)) {
+            return "\"" + std::get<std::string>(value) + "\"";
+        }
+        if (ValueHelper::isBool(value)) {
+            return std::get<bool>(value) ? "true" : "false";
+        }
+        return "?";
+    }
+
+    std::string blockName(const IRBlock* block) {
+        return "bb" + std::to_string(block->id);
+    }
+}
+
+IRFunction::IRFunction(std::string name) : name(std::move(name)) {
+    addBlock();
+}
+
+IRBlock* IRFunction::addBlock() {
+    blocks.push_back(std::make_unique<IRBlock>());
+    blocks.back()->id = blocks.size() - 1;
+    return blocks.back().get();
+}
+
+void IRFunction::addEdge(IRBlock* from, IRBlock* to) {
+    from->successors.push_back(to);
+    to->predecessors.push_back(from);
+}
+
+IRInstruction* IRFunction::append(IRBlock* block, IROpcode opcode, std::vector<IRInstruction*> operands, const ExprNode* source) {
+    auto instruction = std::make_unique<IRInstruction>();
+    instruction->opcode = opcode;
+    instruction->id = instructionCount++;
+    instruction->block = block;
+    instruction->operands = std::move(operands);
+    instruction->source = source;
+    block->instructions.push_back(std::move(instruction));
+    return block->instructions.back().get();
+}
+
+IRInstruction* IRFunction::addPhi(IRBlock* block, const std::string& variable) {
+    auto phi = std::make_unique<IRInstruction>();
+    phi->opcode = IROpcode::PHI;
+    phi->id = instructionCount++;
+    phi->block = block;
+    phi->name = variable;
+    phi->version = nextVersion(variable);
+    block->phis.push_back(std::move(phi));
+    return block->phis.back().get();
+}
+
+IRInstruction* IRFunction::getEntryValue(const std::string& variable, const std::string& label) {
+    for (const auto& entryValue : entryValues) {
+        if (entryValue->name == variable) {
+            return entryValue.get();
+        }
+    }
+    auto entryValue = std::make_unique<IRInstruction>();
+    entryValue->opcode = IROpcode::ENTRY;
+    entryValue->id = instructionCount++;
+    entryValue->block = getEntry();
+    entryValue->name = variable;
+    entryValue->label = label;
+    entryValues.push_back(std::move(entryValue));
+    return entryValues.back().get();
+}
+
+int IRFunction::nextVersion(const std::string& variable) {
+    return ++versions[variable];
+}
+
+std::vector<IRBlock*> IRFunction::reversePostorder() const {
+    std::vector<IRBlock*> order;
+    std::vector<bool> visited(blocks.size(), false);
+    // Each entry holds a block and the index of the next successor to visit
+    std::vector<std::pair<IRBlock*, size_t>> stack = { { getEntry(), 0 } };
+    visited[getEntry()->id] = true;
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next < block->successors.size()) {
+            IRBlock* successor = block->successors[next++];
+            if (!visited[successor->id]) {
+                visited[successor->id] = true;
+                stack.push_back({ successor, 0 });
+            }
+            continue;
+        }
+        order.push_back(block);
+        stack.pop_back();
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+void IRFunction::computeDominators() {
+    // The iterative algorithm of Cooper, Harvey and Kennedy, walking up the tree by postorder number
+    std::vector<IRBlock*> order = reversePostorder();
+    std::vector<size_t> position(blocks.size(), 0);
+    for (size_t i = 0; i < order.size(); i++) {
+        position[order[i]->id] = i;
+    }
+    for (const auto& block : blocks) {
+        block->dominator = nullptr;
+        block->dominated.clear();
+    }
+    IRBlock* entry = getEntry();
+    entry->dominator = entry;
+
+    auto intersect = [&position](IRBlock* a, IRBlock* b) {
+        while (a != b) {
+            while (position[a->id] > position[b->id]) {
+                a = a->dominator;
+            }
+            while (position[b->id] > position[a->id]) {
+                b = b->dominator;
+            }
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (IRBlock* block : order) {
+            if (block == entry) {
+                continue;
+            }
+            IRBlock* dominator = nullptr;
+            for (IRBlock* predecessor : block->predecessors) {
+                if (predecessor->dominator) {
+                    dominator = dominator ? intersect(predecessor, dominator) : predecessor;
+                }
+            }
+            if (dominator != block->dominator) {
+                block->dominator = dominator;
+                changed = true;
+            }
+        }
+    }
+
+    entry->dominator = nullptr;
+    for (IRBlock* block : order) {
+        if (block->dominator) {
+            block->dominator->dominated.push_back(block);
+        }
+    }
+}
+
+std::string IRFunction::toString() const {
+    std::ostringstream out;
+    out << "function " << name << "\n";
+    for (const auto& entryValue : entryValues) {
+        out << "    " << valueName(entryValue.get()) << " = " << entryValue->label << " " << entryValue->name << "\n";
+    }
+
+    for (const auto& block : blocks) {
+        out << "  " << blockName(block.get()) << ":";
+        for (size_t i = 0; i < block->predecessors.size(); i++) {
+            out << (i == 0 ? "  ; from " : ", ") << blockName(block->predecessors[i]);
+        }
+        out << "\n";
+
+        for (const auto& phi : block->phis) {
+            if (phi->replacement) {
+                continue;
+            }
+            out << "    " << valueName(phi.get()) << " = phi ";
+            for (size_t i = 0; i < phi->operands.size(); i++) {
+                out << (i == 0 ? "" : ", ") << operandName(phi->operands[i]) << " (" << blockName(block->predecessors[i]) << ")";
+            }
+            if (phi->isConstant) {
+                out << "  ; constant " << literal(phi->folded);
+            }
+            out << "\n";
+        }
+
+        for (const auto& instruction : block->instructions) {
+            IRInstruction* ins = instruction.get();
+            const std::vector<IRInstruction*>& operands = ins->operands;
+            out << "    ";
+            switch (ins->opcode) {
+                case IROpcode::CONSTANT:
+                    out << valueName(ins) << " = " << literal(ins->constant);
+                    break;
+                case IROpcode::ASSIGN:
+                    out << valueName(ins) << " = " << operandName(operands[0]);
+                    break;
+                case IROpcode::BINARY:
+                    out << valueName(ins) << " = " << operandName(operands[0]) << " " << ins->name << " " << operandName(operands[1]);
+                    break;
+                case IROpcode::UNARY:
+                    out << valueName(ins) << " = " << ins->name << operandName(operands[0]);
+                    break;
+                case IROpcode::OPAQUE:
+                    out << valueName(ins) << " = " << ins->label << "(";
+                    for (size_t i = 0; i < operands.size(); i++) {
+                        out << (i == 0 ? "" : ", ") << operandName(operands[i]);
+                    }
+                    out << ")";
+                    for (size_t i = 0; i < ins->reads.size(); i++) {
+                        out << (i == 0 ? " reads " : ", ") << valueName(resolve(ins->reads[i]));
+                    }
+                    break;
+                case IROpcode::RETURN:
+                    out << "return" << (operands.empty() ? "" : " " + operandName(operands[0]));
+                    break;
+                case IROpcode::BRANCH:
+                    out << "branch " << operandName(operands[0]) << ", " << blockName(block->successors[0]) << ", "
+                        << blockName(block->successors[1]);
+                    break;
+                case IROpcode::JUMP:
+                    out << "jump " << blockName(block->successors[0]);
+                    break;
+                default:
+                    break;
+            }
+            if ((ins->opcode == IROpcode::BINARY || ins->opcode == IROpcode::UNARY) && ins->isConstant) {
+                out << "  ; folded to " << literal(ins->folded);
+            }
+            else if (ins->leader) {
+                out << "  ; same as " << valueName(valueOf(ins->leader));
+            }
+            else if (ins->dead) {
+                out << "  ; dead store";
+            }
+            out << "\n";
+        }
+    }
+    return out.str();
+}
+
+IRInstruction* IRFunction::resolve(IRInstruction* value) {
+    while (value && value->replacement) {
+        value = value->replacement;
+    }
+    return value;
+}
+
+IRInstruction* IRFunction::valueOf(IRInstruction* value) {
+    while (value) {
+        value = resolve(value);
+        if (value->opcode == IROpcode::ASSIGN) {
+            value = value->operands[0];
+        }
+        else if (value->leader) {
+            value = value->leader;
+        }
+        else {
+            break;
+        }
+    }
+    return value;
+}
+
+std::string IRFunction::valueName(const IRInstruction* value) {
+    if (!value) {
+        return "none";
+    }
+    if (value->opcode == IROpcode::ENTRY || value->opcode == IROpcode::PHI || value->opcode == IROpcode::ASSIGN) {
+        return value->name + "." + std::to_string(value->version);
+    }
+    return "%" + std::to_string(value->id);
+}
+
+std::string IRFunction::operandName(IRInstruction* value) {
+    IRInstruction* resolved = resolve(value);
+    if (resolved && resolved->isConstant) {
+        return literal(resolved->folded);
+    }
+    return valueName(valueOf(value));
+}
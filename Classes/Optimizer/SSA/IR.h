@@ -0,0 +1,166 @@
+#ifndef IR_H
+#define IR_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AST/AST.h"
+#include "Enums/IROpcode.h"
+
+struct IRBlock;
+
+/**
+ * @struct IRInstruction
+ * @brief One operation of the SSA intermediate representation and the value it produces.
+ */
+struct IRInstruction {
+    IROpcode opcode = IROpcode::OPAQUE; ///< The operation.
+    size_t id = 0; ///< Number of the instruction, unique within its function.
+    IRBlock* block = nullptr; ///< The block holding the instruction, the entry block for an ENTRY.
+    std::string name; ///< The variable of an ENTRY, PHI or ASSIGN, or the operator of a BINARY or UNARY.
+    std::string label; ///< What an OPAQUE evaluates, or whether an ENTRY is a "param", a "global" or "undefined".
+    int version = 0; ///< The SSA version of the variable an ENTRY, PHI or ASSIGN defines.
+    std::vector<IRInstruction*> operands; ///< The values used; a PHI has one per predecessor, in the order of the predecessors.
+    std::vector<IRInstruction*> reads; ///< The definitions of the lists, maps and globals an OPAQUE reads by name.
+    Value constant; ///< The literal of a CONSTANT.
+    const ExprNode* source = nullptr; ///< The AST node the instruction was lowered from, if any.
+
+    IRInstruction* replacement = nullptr; ///< For a PHI whose operands all have one value, that value.
+    IRInstruction* leader = nullptr; ///< A dominating instruction found by value numbering to compute the same value.
+    bool isConstant = false; ///< Whether constant propagation proved the value to be the same on every execution.
+    Value folded; ///< The value, if isConstant.
+    bool dead = false; ///< For an ASSIGN, whether no read of the variable observes the store.
+};
+
+/**
+ * @struct IRBlock
+ * @brief A basic block: a straight run of instructions that control flow enters at the top and leaves at the bottom.
+ */
+struct IRBlock {
+    size_t id = 0; ///< Number of the block, unique within its function.
+    std::vector<std::unique_ptr<IRInstruction>> phis; ///< The PHIs, which take their values on entry to the block.
+    std::vector<std::unique_ptr<IRInstruction>> instructions; ///< The other instructions in order, ending with a BRANCH or JUMP unless the block ends the function.
+    std::vector<IRBlock*> predecessors; ///< The blocks that continue in this one.
+    std::vector<IRBlock*> successors; ///< The blocks this one continues in, the taken branch first.
+    IRBlock* dominator = nullptr; ///< The immediate dominator, null for the entry block.
+    std::vector<IRBlock*> dominated; ///< The blocks this one immediately dominates.
+};
+
+/**
+ * @class IRFunction
+ * @brief The control flow graph of the program body or of one function, in SSA form.
+ */
+class IRFunction {
+public:
+    /**
+     * @brief Constructs a function with an empty entry block.
+     * @param name The name of the function, or "main" for the program body.
+     */
+    explicit IRFunction(std::string name);
+
+    const std::string& getName() const { return name; }
+    IRBlock* getEntry() const { return blocks.front().get(); }
+    const std::vector<std::unique_ptr<IRBlock>>& getBlocks() const { return blocks; }
+    const std::vector<std::unique_ptr<IRInstruction>>& getEntryValues() const { return entryValues; }
+
+    /**
+     * @brief Adds an empty block to the function.
+     * @return The new block.
+     */
+    IRBlock* addBlock();
+
+    /**
+     * @brief Adds a control flow edge between two blocks.
+     * @param from The block control flow leaves.
+     * @param to The block control flow enters.
+     */
+    static void addEdge(IRBlock* from, IRBlock* to);
+
+    /**
+     * @brief Appends an instruction to a block.
+     * @param block The block.
+     * @param opcode The operation.
+     * @param operands The values the instruction uses.
+     * @param source The AST node the instruction is lowered from, if any.
+     * @return The new instruction.
+     */
+    IRInstruction* append(IRBlock* block, IROpcode opcode, std::vector<IRInstruction*> operands, const ExprNode* source);
+
+    /**
+     * @brief Adds a PHI without operands for a variable to a block.
+     * @param block The block.
+     * @param variable The variable whose values the PHI merges.
+     * @return The new PHI.
+     */
+    IRInstruction* addPhi(IRBlock* block, const std::string& variable);
+
+    /**
+     * @brief Gets the value a variable has when the function starts, adding it the first time it is asked for.
+     * @param variable The variable.
+     * @param label "param" for a parameter, "global" for a global read by a function, "undefined" otherwise.
+     * @return The ENTRY instruction of the variable.
+     */
+    IRInstruction* getEntryValue(const std::string& variable, const std::string& label);
+
+    /**
+     * @brief Gives the next SSA version number of a variable.
+     * @param variable The variable.
+     * @return The version, starting at 1 for the first definition in the function.
+     */
+    int nextVersion(const std::string& variable);
+
+    /**
+     * @brief Lists the blocks so that every block comes before its successors, except along loop back edges.
+     * @return The blocks in reverse postorder.
+     */
+    std::vector<IRBlock*> reversePostorder() const;
+
+    /**
+     * @brief Computes the immediate dominator of every block and the dominator tree.
+     */
+    void computeDominators();
+
+    /**
+     * @brief Formats the function for inspection, leaving out removed PHIs.
+     * @return One line per block header and per instruction.
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Follows the replacements of trivial PHIs.
+     * @param value The value.
+     * @return The value the PHI was replaced by, or the value itself.
+     */
+    static IRInstruction* resolve(IRInstruction* value);
+
+    /**
+     * @brief Finds the instruction that computes a value, looking through copies, trivial PHIs and redundant instructions.
+     * @param value The value.
+     * @return The instruction producing the value, which is never an ASSIGN.
+     */
+    static IRInstruction* valueOf(IRInstruction* value);
+
+    /**
+     * @brief Formats the name of a value: `x.2` for a definition of a variable and `%7` for any other value.
+     * @param value The value.
+     * @return The name.
+     */
+    static std::string valueName(const IRInstruction* value);
+
+private:
+    std::string name; ///< The name of the function, or "main".
+    std::vector<std::unique_ptr<IRBlock>> blocks; ///< The blocks, the entry block first.
+    std::vector<std::unique_ptr<IRInstruction>> entryValues; ///< The ENTRY instructions, in the order they were asked for.
+    std::unordered_map<std::string, int> versions; ///< The last SSA version given to each variable.
+    size_t instructionCount = 0; ///< Number of instructions created, used to number them.
+
+    /**
+     * @brief Formats an operand, writing constants as literals.
+     * @param value The operand.
+     * @return The literal or the name of the value the operand resolves to.
+     */
+    static std::string operandName(IRInstruction* value);
+};
+
+#endif // IR_H
@@ -0,0 +1,400 @@
+#include "IRBuilder.h"
+#include "Optimizer/Utility/ASTHelper.h"
+#include <algorithm>
+#include <typeinfo>
+
+namespace {
+    // Names what an opaque node evaluates, for the IR dump
+    std::string opaqueLabel(const ExprNode* node) {
+        if (auto callNode = dynamic_cast<const FunctionCallNode*>(node)) {
+            return "call " + callNode->getName();
+        }
+        if (dynamic_cast<const PrintNode*>(node)) {
+            return "print";
+        }
+        if (dynamic_cast<const InputNode*>(node)) {
+            return "input";
+        }
+        if (dynamic_cast<const FlushNode*>(node)) {
+            return "flush";
+        }
+        if (dynamic_cast<const ListInitNode*>(node)) {
+            return "list";
+        }
+        if (dynamic_cast<const MapInitNode*>(node)) {
+            return "map";
+        }
+        if (auto castNode = dynamic_cast<const TypeCastNode*>(node)) {
+            return castNode->getType();
+        }
+        if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+            return methodNode->getListName() + "." + listMethodToString(methodNode->getMethod());
+        }
+        if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+            return mapMethodNode->getMapName() + "." + mapMethodToString(mapMethodNode->getMethod());
+        }
+        const std::string container = IRBuilder::containerName(node);
+        if (dynamic_cast<const ListAppendNode*>(node)) {
+            return container + ".append";
+        }
+        if (dynamic_cast<const ListPopNode*>(node)) {
+            return container + ".pop";
+        }
+        if (dynamic_cast<const ListLengthNode*>(node)) {
+            return container + ".length";
+        }
+        if (dynamic_cast<const ListIndexNode*>(node)) {
+            return container + "[]";
+        }
+        if (dynamic_cast<const ListSliceNode*>(node)) {
+            return container + "[:]";
+        }
+        if (dynamic_cast<const ListReplaceNode*>(node)) {
+            return container + "[]=";
+        }
+        return "eval";
+    }
+}
+
+IRBuilder::IRBuilder(const std::string& name, const std::vector<std::string>& parameters, const std::vector<std::string>* callReads)
+    : function(name), parameters(parameters.begin(), parameters.end()), callReads(callReads) {
+    current = function.getEntry();
+    sealed.insert(current);
+}
+
+bool IRBuilder::build(const BlockNode* body) {
+    lowerStatements(body);
+    function.computeDominators();
+    return supported;
+}
+
+const std::vector<IRBuilder::Site>* IRBuilder::findSites(const ExprNode* node) const {
+    auto it = sites.find(node);
+    return it != sites.end() ? &it->second : nullptr;
+}
+
+IRInstruction* IRBuilder::findStore(const AssignNode* node) const {
+    auto it = stores.find(node);
+    return it != stores.end() ? it->second : nullptr;
+}
+
+IRInstruction* IRBuilder::readAt(const std::string& variable, IRBlock* block, size_t index) {
+    for (size_t i = std::min(index, block->instructions.size()); i-- > 0;) {
+        IRInstruction* instruction = block->instructions[i].get();
+        if (instruction->opcode == IROpcode::ASSIGN && instruction->name == variable) {
+            return instruction;
+        }
+    }
+    return readOnEntry(variable, block);
+}
+
+std::string IRBuilder::containerName(const ExprNode* node) {
+    if (auto appendNode = dynamic_cast<const ListAppendNode*>(node)) {
+        return appendNode->getListName();
+    }
+    if (auto popNode = dynamic_cast<const ListPopNode*>(node)) {
+        return popNode->getListName();
+    }
+    if (auto lengthNode = dynamic_cast<const ListLengthNode*>(node)) {
+        return lengthNode->getListName();
+    }
+    if (auto indexNode = dynamic_cast<const ListIndexNode*>(node)) {
+        return indexNode->getListName();
+    }
+    if (auto sliceNode = dynamic_cast<const ListSliceNode*>(node)) {
+        return sliceNode->getListName();
+    }
+    if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        return methodNode->getListName();
+    }
+    if (auto replaceNode = dynamic_cast<const ListReplaceNode*>(node)) {
+        return replaceNode->getListName();
+    }
+    if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        return mapMethodNode->getMapName();
+    }
+    return "";
+}
+
+IRInstruction* IRBuilder::lower(const ExprNode* node) {
+    if (!node || !supported) {
+        return nullptr;
+    }
+    auto literal = [this, node](Value value) {
+        IRInstruction* constant = function.append(current, IROpcode::CONSTANT, {}, node);
+        constant->constant = std::move(value);
+        return constant;
+    };
+
+    const std::type_info& type = typeid(*node);
+    if (type == typeid(IntegerNode)) {
+        return literal(static_cast<const IntegerNode*>(node)->getValue());
+    }
+    if (type == typeid(DoubleNode)) {
+        return literal(static_cast<const DoubleNode*>(node)->getValue());
+    }
+    if (type == typeid(StringNode)) {
+        return literal(static_cast<const StringNode*>(node)->getValue());
+    }
+    if (type == typeid(BooleanNode)) {
+        return literal(static_cast<const BooleanNode*>(node)->getValue());
+    }
+    if (type == typeid(VariableNode)) {
+        IRInstruction* definition = readVariable(static_cast<const VariableNode*>(node)->getName(), current);
+        addSite(node, definition, current->instructions.size());
+        return definition;
+    }
+    if (type == typeid(BinaryExprNode)) {
+        auto binNode = static_cast<const BinaryExprNode*>(node);
+        IRInstruction* left = lowerValue(binNode->getLeft().get());
+        IRInstruction* right = lowerValue(binNode->getRight().get());
+        IRInstruction* operation = function.append(current, IROpcode::BINARY, { left, right }, node);
+        operation->name = binNode->getOp();
+        addSite(node, operation, current->instructions.size() - 1);
+        return operation;
+    }
+    if (type == typeid(UnaryExprNode)) {
+        auto unNode = static_cast<const UnaryExprNode*>(node);
+        IRInstruction* operand = lowerValue(unNode->getOperand().get());
+        IRInstruction* operation = function.append(current, IROpcode::UNARY, { operand }, node);
+        operation->name = unNode->getOp();
+        addSite(node, operation, current->instructions.size() - 1);
+        return operation;
+    }
+    if (type == typeid(AssignNode)) {
+        auto assignNode = static_cast<const AssignNode*>(node);
+        IRInstruction* value = lowerValue(assignNode->getValue().get());
+        stores[assignNode] = assign(assignNode->getName(), value, node);
+        return nullptr;
+    }
+    if (type == typeid(IfNode)) {
+        lowerIf(static_cast<const IfNode*>(node));
+        return nullptr;
+    }
+    if (type == typeid(WhileNode)) {
+        lowerWhile(static_cast<const WhileNode*>(node));
+        return nullptr;
+    }
+    if (type == typeid(BlockNode)) {
+        lowerStatements(static_cast<const BlockNode*>(node));
+        return nullptr;
+    }
+    if (type == typeid(FunctionDefNode)) {
+        // The body runs in its own scope and is lowered as a function of its own
+        return nullptr;
+    }
+    if (type == typeid(ReturnNode)) {
+        IRInstruction* value = lower(static_cast<const ReturnNode*>(node)->getValue().get());
+        function.append(current, IROpcode::RETURN, value ? std::vector<IRInstruction*>{ value } : std::vector<IRInstruction*>{}, node);
+        return nullptr;
+    }
+    if (type == typeid(ListInitNode) || type == typeid(MapInitNode)) {
+        IRInstruction* created = lowerOpaque(node);
+        const std::string& name = type == typeid(ListInitNode) ? static_cast<const ListInitNode*>(node)->getName()
+            : static_cast<const MapInitNode*>(node)->getName();
+        assign(name, created, node);
+        return nullptr;
+    }
+    if (dynamic_cast<const AssignNode*>(node) || dynamic_cast<const BinaryExprNode*>(node) || dynamic_cast<const HoistedWhileNode*>(node)
+        || dynamic_cast<const InlinedCallNode*>(node)) {
+        // The nodes created by later passes read and write variables in ways the IR does not model
+        supported = false;
+        return nullptr;
+    }
+    return lowerOpaque(node);
+}
+
+IRInstruction* IRBuilder::lowerValue(const ExprNode* node) {
+    IRInstruction* value = lower(node);
+    if (!value) {
+        value = function.append(current, IROpcode::OPAQUE, {}, node);
+        value->label = "none";
+    }
+    return value;
+}
+
+void IRBuilder::lowerStatements(const BlockNode* block) {
+    if (!block) {
+        return;
+    }
+    for (const auto& statement : block->getStatements()) {
+        lower(statement.get());
+    }
+}
+
+void IRBuilder::lowerIf(const IfNode* ifNode) {
+    IRInstruction* condition = lowerValue(ifNode->getCondition().get());
+    IRBlock* thenBlock = function.addBlock();
+    IRBlock* elseBlock = ifNode->getElseBlock() ? function.addBlock() : nullptr;
+    IRBlock* join = function.addBlock();
+    branch(condition, thenBlock, elseBlock ? elseBlock : join);
+
+    seal(thenBlock);
+    current = thenBlock;
+    lowerStatements(ifNode->getThenBlock().get());
+    jump(join);
+    if (elseBlock) {
+        seal(elseBlock);
+        current = elseBlock;
+        lowerStatements(ifNode->getElseBlock().get());
+        jump(join);
+    }
+    seal(join);
+    current = join;
+}
+
+void IRBuilder::lowerWhile(const WhileNode* whileNode) {
+    IRBlock* header = function.addBlock();
+    jump(header);
+    current = header;
+    IRInstruction* condition = lowerValue(whileNode->getCondition().get());
+    IRBlock* body = function.addBlock();
+    IRBlock* exit = function.addBlock();
+    branch(condition, body, exit);
+    seal(body);
+    current = body;
+
+    const BlockNode* block = whileNode->getBlock().get();
+    const size_t count = block ? block->getStatements().size() : 0;
+    if (count == 0) {
+        jump(header);
+    }
+    for (size_t i = 0; i < count; i++) {
+        lower(block->getStatements()[i].get());
+        // The loop tests its condition after every statement and leaves as soon as it is false
+        condition = lowerValue(whileNode->getCondition().get());
+        IRBlock* next = i + 1 < count ? function.addBlock() : header;
+        branch(condition, next, exit);
+        if (next != header) {
+            seal(next);
+            current = next;
+        }
+    }
+    seal(header);
+    seal(exit);
+    current = exit;
+}
+
+IRInstruction* IRBuilder::lowerOpaque(const ExprNode* node) {
+    std::vector<IRInstruction*> operands;
+    ASTHelper::forEachChild(node, [this, &operands](const ExprNode* child) {
+        if (IRInstruction* value = lower(child)) {
+            operands.push_back(value);
+        }
+    });
+    IRInstruction* opaque = function.append(current, IROpcode::OPAQUE, std::move(operands), node);
+    opaque->label = opaqueLabel(node);
+
+    const std::string container = containerName(node);
+    if (!container.empty()) {
+        opaque->reads.push_back(readVariable(container, current));
+    }
+    if (callReads && dynamic_cast<const FunctionCallNode*>(node)) {
+        // The called function may read any global a function reads, so the call keeps their stores alive
+        for (const std::string& name : *callReads) {
+            opaque->reads.push_back(readVariable(name, current));
+        }
+    }
+    addSite(node, opaque, current->instructions.size() - 1);
+    return opaque;
+}
+
+IRInstruction* IRBuilder::assign(const std::string& variable, IRInstruction* value, const ExprNode* source) {
+    IRInstruction* store = function.append(current, IROpcode::ASSIGN, { value }, source);
+    store->name = variable;
+    store->version = function.nextVersion(variable);
+    exitDefinitions[current][variable] = store;
+    return store;
+}
+
+void IRBuilder::addSite(const ExprNode* node, IRInstruction* value, size_t index) {
+    sites[node].push_back({ current, index, value });
+}
+
+void IRBuilder::jump(IRBlock* target) {
+    function.append(current, IROpcode::JUMP, {}, nullptr);
+    IRFunction::addEdge(current, target);
+}
+
+void IRBuilder::branch(IRInstruction* condition, IRBlock* taken, IRBlock* untaken) {
+    function.append(current, IROpcode::BRANCH, { condition }, nullptr);
+    IRFunction::addEdge(current, taken);
+    IRFunction::addEdge(current, untaken);
+}
+
+IRInstruction* IRBuilder::readVariable(const std::string& variable, IRBlock* block) {
+    auto& definitions = exitDefinitions[block];
+    auto it = definitions.find(variable);
+    if (it != definitions.end()) {
+        return it->second;
+    }
+    // A block without a store to the variable ends with the definition it started with
+    IRInstruction* definition = readOnEntry(variable, block);
+    exitDefinitions[block][variable] = definition;
+    return definition;
+}
+
+IRInstruction* IRBuilder::readOnEntry(const std::string& variable, IRBlock* block) {
+    auto& definitions = entryDefinitions[block];
+    auto it = definitions.find(variable);
+    if (it != definitions.end()) {
+        return it->second;
+    }
+
+    IRInstruction* definition = nullptr;
+    if (!sealed.count(block)) {
+        // More predecessors are coming, so the PHI gets its operands when the block is sealed
+        definition = function.addPhi(block, variable);
+        incompletePhis[block].push_back(definition);
+    }
+    else if (block->predecessors.empty()) {
+        const char* label = parameters.count(variable) ? "param" : callReads ? "undefined" : "global";
+        definition = function.getEntryValue(variable, label);
+    }
+    else if (block->predecessors.size() == 1) {
+        definition = readVariable(variable, block->predecessors.front());
+    }
+    else {
+        // The PHI is recorded before its operands are read, so a loop reading the variable finds it
+        IRInstruction* phi = function.addPhi(block, variable);
+        entryDefinitions[block][variable] = phi;
+        definition = addPhiOperands(phi);
+    }
+    entryDefinitions[block][variable] = definition;
+    return definition;
+}
+
+IRInstruction* IRBuilder::addPhiOperands(IRInstruction* phi) {
+    for (IRBlock* predecessor : phi->block->predecessors) {
+        phi->operands.push_back(readVariable(phi->name, predecessor));
+    }
+    return tryRemoveTrivialPhi(phi);
+}
+
+IRInstruction* IRBuilder::tryRemoveTrivialPhi(IRInstruction* phi) {
+    IRInstruction* same = nullptr;
+    for (IRInstruction* operand : phi->operands) {
+        operand = IRFunction::resolve(operand);
+        if (operand == same || operand == phi) {
+            continue;
+        }
+        if (same) {
+            return phi;
+        }
+        same = operand;
+    }
+    if (!same) {
+        return phi;
+    }
+    phi->replacement = same;
+    return same;
+}
+
+void IRBuilder::seal(IRBlock* block) {
+    std::vector<IRInstruction*>& phis = incompletePhis[block];
+    for (size_t i = 0; i < phis.size(); i++) {
+        addPhiOperands(phis[i]);
+    }
+    incompletePhis.erase(block);
+    sealed.insert(block);
+}
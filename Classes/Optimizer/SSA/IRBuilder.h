@@ -0,0 +1,212 @@
+#ifndef IRBUILDER_H
+#define IRBUILDER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "AST/AST.h"
+#include "IR.h"
+
+/**
+ * @class IRBuilder
+ * @brief Lowers the program body or a function body from the AST to the SSA IR.
+ *
+ * SSA form is built while lowering, following Braun et al., "Simple and Efficient Construction
+ * of Static Single Assignment Form": a read of a variable looks for its definition in the
+ * current block and then in the predecessors, placing a PHI where several definitions meet.
+ * A block is sealed once all its predecessors are known, and PHIs whose operands turn out to
+ * have one value are replaced by it.
+ *
+ * A while loop evaluates its condition again after every statement of its body and leaves as
+ * soon as it is false, so each statement ends its block with a branch to the next statement or
+ * out of the loop. Function definitions are lowered separately, and a call in the program body
+ * reads every global a function reads.
+ *
+ * Every place an expression is evaluated is recorded as a site, so the results of the passes
+ * can be written back to the AST.
+ */
+class IRBuilder {
+public:
+    /**
+     * @struct Site
+     * @brief One place in the IR where an AST expression is evaluated.
+     */
+    struct Site {
+        IRBlock* block; ///< The block evaluating the expression.
+        size_t index; ///< Number of instructions in the block before the expression's value is computed.
+        IRInstruction* value; ///< The value the expression produces, which for a variable is the definition it reads.
+    };
+
+    /**
+     * @brief Constructs a builder for the program body or one function.
+     * @param name The name of the function, or "main" for the program body.
+     * @param parameters The parameters of the function, empty for the program body.
+     * @param callReads The globals functions read, which every call in the program body reads; null for a function.
+     */
+    IRBuilder(const std::string& name, const std::vector<std::string>& parameters, const std::vector<std::string>* callReads);
+
+    /**
+     * @brief Lowers a body to the IR.
+     * @param body The statements of the program or function.
+     * @return False if the body contains a node the IR does not model, such as the nodes created by later passes.
+     */
+    bool build(const BlockNode* body);
+
+    IRFunction& getFunction() { return function; }
+    const IRFunction& getFunction() const { return function; }
+
+    /**
+     * @brief Gets the places an expression is evaluated.
+     * @param node The expression.
+     * @return The sites, or null if the expression was not lowered to an instruction of its own.
+     */
+    const std::vector<Site>* findSites(const ExprNode* node) const;
+
+    /**
+     * @brief Gets the store an assignment statement was lowered to.
+     * @param node The assignment.
+     * @return The ASSIGN instruction, or null if the assignment was not lowered.
+     */
+    IRInstruction* findStore(const AssignNode* node) const;
+
+    /**
+     * @brief Finds the definition of a variable that reaches a point of the function.
+     * @param variable The variable.
+     * @param block The block.
+     * @param index Number of instructions of the block executed before the point.
+     * @return The definition read there, which may be a new PHI.
+     */
+    IRInstruction* readAt(const std::string& variable, IRBlock* block, size_t index);
+
+    /**
+     * @brief Gets the list or map a node reads or changes by name.
+     * @param node The node.
+     * @return The name of the list or map, or an empty string if the node names none.
+     */
+    static std::string containerName(const ExprNode* node);
+
+private:
+    IRFunction function; ///< The function being built.
+    std::unordered_set<std::string> parameters; ///< The names of the parameters.
+    const std::vector<std::string>* callReads; ///< The globals functions read, in order, or null for a function.
+    IRBlock* current = nullptr; ///< The block instructions are appended to.
+    bool supported = true; ///< Whether every node lowered so far is modelled by the IR.
+
+    std::unordered_map<const ExprNode*, std::vector<Site>> sites; ///< The places each expression is evaluated.
+    std::unordered_map<const AssignNode*, IRInstruction*> stores; ///< The store of each assignment statement.
+
+    std::unordered_map<IRBlock*, std::unordered_map<std::string, IRInstruction*>> exitDefinitions; ///< The definition of each variable at the end of each block.
+    std::unordered_map<IRBlock*, std::unordered_map<std::string, IRInstruction*>> entryDefinitions; ///< The definition of each variable on entry to each block.
+    std::unordered_map<IRBlock*, std::vector<IRInstruction*>> incompletePhis; ///< PHIs of unsealed blocks, which get their operands when sealed.
+    std::unordered_set<IRBlock*> sealed; ///< The blocks whose predecessors are all known.
+
+    /**
+     * @brief Lowers a statement or expression into the current block.
+     * @param node The node, which may be null.
+     * @return The value of an expression, or null for a statement.
+     */
+    IRInstruction* lower(const ExprNode* node);
+
+    /**
+     * @brief Lowers an expression whose value is needed.
+     * @param node The expression.
+     * @return Its value, an OPAQUE if the node has no value of its own.
+     */
+    IRInstruction* lowerValue(const ExprNode* node);
+
+    /**
+     * @brief Lowers the statements of a block in order.
+     * @param block The block, which may be null.
+     */
+    void lowerStatements(const BlockNode* block);
+
+    /**
+     * @brief Lowers an if statement to a branch, the then and else blocks and the block they join in.
+     * @param ifNode The if statement.
+     */
+    void lowerIf(const IfNode* ifNode);
+
+    /**
+     * @brief Lowers a while loop to a header testing the condition and a block per statement of the body.
+     * @param whileNode The loop.
+     */
+    void lowerWhile(const WhileNode* whileNode);
+
+    /**
+     * @brief Lowers a node that is neither a literal, a variable, an operator nor a statement changing control flow.
+     * @param node The node.
+     * @return The OPAQUE instruction evaluating it.
+     */
+    IRInstruction* lowerOpaque(const ExprNode* node);
+
+    /**
+     * @brief Appends a store to a variable to the current block.
+     * @param variable The variable.
+     * @param value The value stored.
+     * @param source The node doing the store.
+     * @return The ASSIGN instruction.
+     */
+    IRInstruction* assign(const std::string& variable, IRInstruction* value, const ExprNode* source);
+
+    /**
+     * @brief Records an evaluation of an expression in the current block.
+     * @param node The expression.
+     * @param value The value it produces.
+     * @param index Number of instructions of the block executed before the value is computed.
+     */
+    void addSite(const ExprNode* node, IRInstruction* value, size_t index);
+
+    /**
+     * @brief Ends the current block with a jump.
+     * @param target The block to continue in.
+     */
+    void jump(IRBlock* target);
+
+    /**
+     * @brief Ends the current block with a branch.
+     * @param condition The value deciding the branch.
+     * @param taken The block to continue in if the condition is true.
+     * @param untaken The block to continue in otherwise.
+     */
+    void branch(IRInstruction* condition, IRBlock* taken, IRBlock* untaken);
+
+    /**
+     * @brief Finds the definition of a variable at the end of a block.
+     * @param variable The variable.
+     * @param block The block.
+     * @return The definition.
+     */
+    IRInstruction* readVariable(const std::string& variable, IRBlock* block);
+
+    /**
+     * @brief Finds the definition of a variable on entry to a block, adding a PHI where definitions meet.
+     * @param variable The variable.
+     * @param block The block.
+     * @return The definition.
+     */
+    IRInstruction* readOnEntry(const std::string& variable, IRBlock* block);
+
+    /**
+     * @brief Gives a PHI one operand per predecessor of its block.
+     * @param phi The PHI.
+     * @return The PHI, or the value replacing it if it is trivial.
+     */
+    IRInstruction* addPhiOperands(IRInstruction* phi);
+
+    /**
+     * @brief Replaces a PHI whose operands other than itself all have one value by that value.
+     * @param phi The PHI.
+     * @return The PHI, or the value replacing it.
+     */
+    static IRInstruction* tryRemoveTrivialPhi(IRInstruction* phi);
+
+    /**
+     * @brief Marks a block as having all its predecessors, completing its PHIs.
+     * @param block The block.
+     */
+    void seal(IRBlock* block);
+};
+
+#endif // IRBUILDER_H
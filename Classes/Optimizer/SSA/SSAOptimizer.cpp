@@ -0,0 +1,519 @@
+#include "SSAOptimizer.h"
+#include "Optimizer/Utility/ASTHelper.h"
+#include "CodeGenerator/Operation/OperationDispatcher/OperationDispatcher.h"
+#include "CodeGenerator/Operation/UnaryOperations/UnaryOperations.h"
+#include <algorithm>
+#include <sstream>
+#include <typeinfo>
+
+namespace {
+    enum class Lattice {
+        UNKNOWN,    // No value seen yet
+        CONSTANT,   // The same value on every execution
+        VARYING     // Possibly different values
+    };
+
+    struct Cell {
+        Lattice state = Lattice::UNKNOWN;
+        Value value;
+    };
+
+    bool hasLiteral(const Value& value) {
+        return ValueHelper::isInt(value) || ValueHelper::isDouble(value) || ValueHelper::isBool(value) || ValueHelper::isString(value);
+    }
+
+    Cell meet(const Cell& a, const Cell& b) {
+        if (a.state == Lattice::UNKNOWN) {
+            return b;
+        }
+        if (b.state == Lattice::UNKNOWN) {
+            return a;
+        }
+        if (a.state == Lattice::CONSTANT && b.state == Lattice::CONSTANT && a.value == b.value) {
+            return a;
+        }
+        return { Lattice::VARYING, Value() };
+    }
+
+    // Identifies a constant operand for value numbering, telling an int from a double of the same value
+    std::string constantKey(const Value& value) {
+        std::ostringstream out;
+        out << "c" << value.index() << ":";
+        if (ValueHelper::isInt(value)) {
+            out << std::get<int>(value);
+        }
+        else if (ValueHelper::isDouble(value)) {
+            out << std::hexfloat << std::get<double>(value);
+        }
+        else if (ValueHelper::isBool(value)) {
+            out << std::get<bool>(value);
+        }
+        else if (ValueHelper::isString(value)) {
+            out << std::get<std::string>(value).size() << ":" << std::get<std::string>(value);
+        }
+        return out.str();
+    }
+}
+
+size_t SSAOptimizer::run(BlockNode& program) {
+    std::unordered_set<std::string> functionReads;
+    collectFunctionReads(&program, false, functionReads);
+    callReads.assign(functionReads.begin(), functionReads.end());
+    std::sort(callReads.begin(), callReads.end());
+
+    optimize("main", &program, {}, &callReads);
+    optimizeFunctions(&program);
+    return constantsFolded + valuesReused + copiesPropagated + storesRemoved;
+}
+
+std::string SSAOptimizer::dump() const {
+    std::ostringstream out;
+    out << "SSA IR: " << constantsFolded << " constants folded, " << valuesReused << " values reused, "
+        << copiesPropagated << " copies propagated, " << storesRemoved << " dead stores removed\n";
+    for (const Body& body : bodies) {
+        if (!body.supported) {
+            out << "function " << body.builder->getFunction().getName() << " not optimised, it contains nodes the IR does not model\n";
+            continue;
+        }
+        out << body.builder->getFunction().toString();
+    }
+    return out.str();
+}
+
+void SSAOptimizer::optimizeFunctions(ExprNode* node) {
+    if (!node) {
+        return;
+    }
+    if (auto defNode = dynamic_cast<FunctionDefNode*>(node)) {
+        std::vector<std::string> parameters;
+        for (const auto& parameter : defNode->getParameters()) {
+            parameters.push_back(parameter.first);
+        }
+        optimize(defNode->getName(), defNode->getBody().get(), parameters, nullptr);
+    }
+    ASTHelper::forEachChildSlot(node, [this](std::unique_ptr<ExprNode>& child) {
+        optimizeFunctions(child.get());
+    });
+}
+
+void SSAOptimizer::optimize(const std::string& name, BlockNode* block, const std::vector<std::string>& parameters,
+    const std::vector<std::string>* callReads) {
+    bodies.push_back(Body());
+    Body& body = bodies.back();
+    body.builder = std::make_unique<IRBuilder>(name, parameters, callReads);
+    body.supported = body.builder->build(block);
+    if (!body.supported || !block) {
+        return;
+    }
+
+    IRFunction& function = body.builder->getFunction();
+    propagateCopies(function);
+    propagateConstants(function);
+    numberValues(function);
+    // Operands found equal by value numbering can make more PHIs trivial
+    propagateCopies(function);
+
+    auto addHolder = [&body](IRInstruction* definition) {
+        if (!definition->replacement) {
+            body.holders[IRFunction::valueOf(definition)].push_back(definition);
+        }
+    };
+    for (const auto& entryValue : function.getEntryValues()) {
+        addHolder(entryValue.get());
+    }
+    for (const auto& irBlock : function.getBlocks()) {
+        for (const auto& phi : irBlock->phis) {
+            addHolder(phi.get());
+        }
+        for (const auto& instruction : irBlock->instructions) {
+            if (instruction->opcode == IROpcode::ASSIGN) {
+                addHolder(instruction.get());
+            }
+        }
+    }
+    for (auto& [value, definitions] : body.holders) {
+        std::sort(definitions.begin(), definitions.end(), [](const IRInstruction* a, const IRInstruction* b) { return a->id < b->id; });
+    }
+
+    std::unordered_set<IRInstruction*> observed;
+    for (auto& statement : block->getStatements()) {
+        rewrite(body, statement, observed);
+    }
+    // A PHI that is read observes every definition flowing into it
+    std::vector<IRInstruction*> pending(observed.begin(), observed.end());
+    while (!pending.empty()) {
+        IRInstruction* definition = pending.back();
+        pending.pop_back();
+        if (definition->opcode != IROpcode::PHI) {
+            continue;
+        }
+        for (IRInstruction* operand : definition->operands) {
+            if (operand && observed.insert(operand).second) {
+                pending.push_back(operand);
+            }
+        }
+    }
+    removeDeadStores(body, block, observed);
+}
+
+void SSAOptimizer::propagateCopies(IRFunction& function) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& block : function.getBlocks()) {
+            for (const auto& phi : block->phis) {
+                if (phi->replacement) {
+                    continue;
+                }
+                IRInstruction* same = nullptr;
+                bool trivial = true;
+                for (IRInstruction* operand : phi->operands) {
+                    IRInstruction* value = IRFunction::valueOf(operand);
+                    if (value == phi.get() || value == same) {
+                        continue;
+                    }
+                    if (same) {
+                        trivial = false;
+                        break;
+                    }
+                    same = value;
+                }
+                if (trivial && same) {
+                    phi->replacement = same;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+void SSAOptimizer::propagateConstants(IRFunction& function) {
+    std::unordered_map<IRInstruction*, Cell> cells;
+    auto cellOf = [&cells](IRInstruction* value) -> const Cell& {
+        return cells[IRFunction::resolve(value)];
+    };
+    for (const auto& entryValue : function.getEntryValues()) {
+        cells[entryValue.get()] = { Lattice::VARYING, Value() };
+    }
+
+    // Values start unknown and only ever move towards varying, so the loop ends
+    const std::vector<IRBlock*> order = function.reversePostorder();
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        auto update = [&cells, &changed](IRInstruction* instruction, Cell cell) {
+            Cell& current = cells[instruction];
+            if (current.state != cell.state) {
+                current = std::move(cell);
+                changed = true;
+            }
+        };
+
+        for (IRBlock* block : order) {
+            for (const auto& phi : block->phis) {
+                if (phi->replacement) {
+                    continue;
+                }
+                Cell cell;
+                for (IRInstruction* operand : phi->operands) {
+                    cell = meet(cell, cellOf(operand));
+                }
+                update(phi.get(), cell);
+            }
+
+            for (const auto& instruction : block->instructions) {
+                IRInstruction* ins = instruction.get();
+                switch (ins->opcode) {
+                    case IROpcode::CONSTANT:
+                        update(ins, { Lattice::CONSTANT, ins->constant });
+                        break;
+                    case IROpcode::ASSIGN:
+                        update(ins, cellOf(ins->operands[0]));
+                        break;
+                    case IROpcode::BINARY:
+                    case IROpcode::UNARY: {
+                        const Cell left = cellOf(ins->operands[0]);
+                        const Cell right = ins->opcode == IROpcode::BINARY ? cellOf(ins->operands[1]) : Cell{ Lattice::CONSTANT, Value() };
+                        if (left.state == Lattice::VARYING || right.state == Lattice::VARYING) {
+                            update(ins, { Lattice::VARYING, Value() });
+                            break;
+                        }
+                        if (left.state == Lattice::UNKNOWN || right.state == Lattice::UNKNOWN) {
+                            break;
+                        }
+                        // An operation that fails is left to fail when it runs, with its own error
+                        Cell cell{ Lattice::VARYING, Value() };
+                        Result<Value> value = ins->opcode == IROpcode::BINARY
+                            ? OperationDispatcher::dispatchOperation(static_cast<const BinaryExprNode*>(ins->source), left.value, right.value)
+                            : UnaryOperations::performUnaryOperation(ins->source->getToken(), ins->name, left.value);
+                        if (value.ok() && hasLiteral(*value)) {
+                            cell = { Lattice::CONSTANT, std::move(*value) };
+                        }
+                        update(ins, std::move(cell));
+                        break;
+                    }
+                    default:
+                        update(ins, { Lattice::VARYING, Value() });
+                        break;
+                }
+            }
+        }
+    }
+
+    for (auto& [instruction, cell] : cells) {
+        instruction->isConstant = cell.state == Lattice::CONSTANT;
+        instruction->folded = cell.value;
+    }
+}
+
+void SSAOptimizer::numberValues(IRFunction& function) {
+    std::unordered_map<std::string, IRInstruction*> table;
+    auto operandKey = [](IRInstruction* operand) {
+        IRInstruction* resolved = IRFunction::resolve(operand);
+        if (resolved->isConstant) {
+            return constantKey(resolved->folded);
+        }
+        return "%" + std::to_string(IRFunction::valueOf(operand)->id);
+    };
+
+    // The dominator tree is walked depth first, so an entry of the table is only seen by the blocks its block dominates
+    struct Frame {
+        IRBlock* block;
+        size_t next;
+        std::vector<std::string> keys;
+    };
+    std::vector<Frame> stack;
+    stack.push_back({ function.getEntry(), 0, {} });
+    bool entered = false;
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (!entered) {
+            for (const auto& instruction : frame.block->instructions) {
+                IRInstruction* ins = instruction.get();
+                if ((ins->opcode != IROpcode::BINARY && ins->opcode != IROpcode::UNARY) || ins->isConstant) {
+                    continue;
+                }
+                std::string key = std::to_string(static_cast<int>(ins->opcode)) + "|" + std::to_string(static_cast<int>(ins->source->getToken().type))
+                    + "|" + ins->name;
+                for (IRInstruction* operand : ins->operands) {
+                    key += "|" + operandKey(operand);
+                }
+                auto it = table.find(key);
+                if (it != table.end()) {
+                    ins->leader = it->second;
+                    continue;
+                }
+                table.emplace(key, ins);
+                frame.keys.push_back(std::move(key));
+            }
+        }
+        if (frame.next < frame.block->dominated.size()) {
+            IRBlock* child = frame.block->dominated[frame.next++];
+            stack.push_back({ child, 0, {} });
+            entered = false;
+            continue;
+        }
+        for (const std::string& key : frame.keys) {
+            table.erase(key);
+        }
+        stack.pop_back();
+        entered = true;
+    }
+}
+
+void SSAOptimizer::rewrite(Body& body, std::unique_ptr<ExprNode>& slot, std::unordered_set<IRInstruction*>& observed) {
+    if (!slot || dynamic_cast<const FunctionDefNode*>(slot.get())) {
+        // A function body is rewritten with its own IR
+        return;
+    }
+    ExprNode* node = slot.get();
+    const std::vector<IRBuilder::Site>* sites = body.builder->findSites(node);
+    const std::type_info& type = typeid(*node);
+    const bool isVariable = type == typeid(VariableNode);
+
+    if (sites && (isVariable || type == typeid(BinaryExprNode) || type == typeid(UnaryExprNode))) {
+        const Value* constant = nullptr;
+        for (const IRBuilder::Site& site : *sites) {
+            IRInstruction* resolved = IRFunction::resolve(site.value);
+            if (!resolved->isConstant || (constant && !(resolved->folded == *constant))) {
+                constant = nullptr;
+                break;
+            }
+            constant = &resolved->folded;
+        }
+        if (constant) {
+            if (std::unique_ptr<ExprNode> literal = makeLiteral(node->getToken(), *constant)) {
+                constantsFolded++;
+                slot = std::move(literal);
+                return;
+            }
+        }
+
+        std::vector<IRInstruction*> definitions;
+        const std::string excluded = isVariable ? static_cast<const VariableNode*>(node)->getName() : "";
+        const std::string holder = findHolder(body, *sites, excluded, definitions);
+        if (!holder.empty()) {
+            (isVariable ? copiesPropagated : valuesReused)++;
+            observed.insert(definitions.begin(), definitions.end());
+            slot = std::make_unique<VariableNode>(node->getToken(), holder);
+            body.reads[slot.get()] = std::move(definitions);
+            return;
+        }
+
+        if (isVariable) {
+            std::vector<IRInstruction*>& reads = body.reads[node];
+            for (const IRBuilder::Site& site : *sites) {
+                observed.insert(site.value);
+                reads.push_back(site.value);
+            }
+            return;
+        }
+    }
+    else if (sites) {
+        for (const IRBuilder::Site& site : *sites) {
+            observed.insert(site.value->reads.begin(), site.value->reads.end());
+        }
+    }
+
+    ASTHelper::forEachChildSlot(node, [this, &body, &observed](std::unique_ptr<ExprNode>& child) {
+        rewrite(body, child, observed);
+    });
+}
+
+std::string SSAOptimizer::findHolder(Body& body, const std::vector<IRBuilder::Site>& sites, const std::string& excluded,
+    std::vector<IRInstruction*>& definitions) {
+    auto it = body.holders.find(IRFunction::valueOf(sites.front().value));
+    if (it == body.holders.end()) {
+        return "";
+    }
+    // The oldest holder is tried first, so a copy is replaced by its original and not the other way round
+    std::unordered_set<std::string> tried;
+    for (IRInstruction* candidate : it->second) {
+        const std::string& name = candidate->name;
+        if (name == excluded) {
+            return "";
+        }
+        if (!tried.insert(name).second) {
+            continue;
+        }
+        definitions.clear();
+        bool holds = true;
+        for (const IRBuilder::Site& site : sites) {
+            IRInstruction* definition = body.builder->readAt(name, site.block, site.index);
+            if (IRFunction::valueOf(definition) != IRFunction::valueOf(site.value)) {
+                holds = false;
+                break;
+            }
+            definitions.push_back(definition);
+        }
+        if (holds) {
+            return name;
+        }
+    }
+    return "";
+}
+
+void SSAOptimizer::removeDeadStores(Body& body, BlockNode* block, const std::unordered_set<IRInstruction*>& observed) {
+    if (!block) {
+        return;
+    }
+    auto& statements = block->getStatements();
+    for (auto it = statements.begin(); it != statements.end();) {
+        std::unique_ptr<ExprNode>& statement = *it;
+        if (!statement) {
+            ++it;
+            continue;
+        }
+        if (auto ifNode = dynamic_cast<IfNode*>(statement.get())) {
+            removeDeadStores(body, ifNode->getThenBlock().get(), observed);
+            removeDeadStores(body, ifNode->getElseBlock().get(), observed);
+        }
+        else if (auto whileNode = dynamic_cast<WhileNode*>(statement.get())) {
+            removeDeadStores(body, whileNode->getBlock().get(), observed);
+        }
+        else if (auto blockNode = dynamic_cast<BlockNode*>(statement.get())) {
+            removeDeadStores(body, blockNode, observed);
+        }
+        else if (typeid(*statement) == typeid(AssignNode)) {
+            auto assignNode = static_cast<AssignNode*>(statement.get());
+            IRInstruction* store = body.builder->findStore(assignNode);
+            if (store && !observed.count(store)) {
+                store->dead = true;
+                storesRemoved++;
+                const ExprNode* value = assignNode->getValue().get();
+                bool safe = dynamic_cast<const IntegerNode*>(value) || dynamic_cast<const DoubleNode*>(value)
+                    || dynamic_cast<const StringNode*>(value) || dynamic_cast<const BooleanNode*>(value);
+                auto reads = body.reads.find(value);
+                if (!safe && reads != body.reads.end()) {
+                    // Reading a variable has no effect and only fails if it may be undefined
+                    safe = std::all_of(reads->second.begin(), reads->second.end(), [](IRInstruction* definition) {
+                        std::unordered_set<IRInstruction*> visiting;
+                        return isDefined(definition, visiting);
+                    });
+                }
+                if (safe) {
+                    it = statements.erase(it);
+                    continue;
+                }
+                statement = std::move(assignNode->getValue());
+            }
+        }
+        ++it;
+    }
+}
+
+bool SSAOptimizer::isDefined(IRInstruction* definition, std::unordered_set<IRInstruction*>& visiting) {
+    if (!definition) {
+        return false;
+    }
+    switch (definition->opcode) {
+        case IROpcode::ASSIGN:
+            return true;
+        case IROpcode::ENTRY:
+            return definition->label == "param";
+        case IROpcode::PHI:
+            if (!visiting.insert(definition).second) {
+                return true;
+            }
+            return std::all_of(definition->operands.begin(), definition->operands.end(), [&visiting](IRInstruction* operand) {
+                return isDefined(operand, visiting);
+            });
+        default:
+            return false;
+    }
+}
+
+std::unique_ptr<ExprNode> SSAOptimizer::makeLiteral(const Token& token, const Value& value) {
+    if (ValueHelper::isInt(value)) {
+        return std::make_unique<IntegerNode>(token, std::get<int>(value));
+    }
+    if (ValueHelper::isDouble(value)) {
+        return std::make_unique<DoubleNode>(token, std::get<double>(value));
+    }
+    if (ValueHelper::isBool(value)) {
+        return std::make_unique<BooleanNode>(token, std::get<bool>(value));
+    }
+    if (ValueHelper::isString(value)) {
+        return std::make_unique<StringNode>(token, std::get<std::string>(value));
+    }
+    return nullptr;
+}
+
+void SSAOptimizer::collectFunctionReads(const ExprNode* node, bool inFunction, std::unordered_set<std::string>& reads) {
+    if (!node) {
+        return;
+    }
+    if (inFunction) {
+        if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+            reads.insert(varNode->getName());
+        }
+        const std::string container = IRBuilder::containerName(node);
+        if (!container.empty()) {
+            reads.insert(container);
+        }
+    }
+    const bool nested = inFunction || dynamic_cast<const FunctionDefNode*>(node);
+    ASTHelper::forEachChild(node, [&reads, nested](const ExprNode* child) {
+        collectFunctionReads(child, nested, reads);
+    });
+}
@@ -0,0 +1,154 @@
+#ifndef SSAOPTIMIZER_H
+#define SSAOPTIMIZER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "AST/AST.h"
+#include "IRBuilder.h"
+
+/**
+ * @class SSAOptimizer
+ * @brief Lowers the program and every function to the SSA IR, optimises the IR and writes the results back to the AST.
+ *
+ * The passes run on each function in order:
+ * - Copy propagation looks through assignments of one variable to another and removes PHIs
+ *   whose operands all have the same value.
+ * - Constant propagation evaluates operators whose operands are constant with the same
+ *   operation kernels the interpreter uses. An operation that fails is left alone, so its
+ *   error is still raised when it runs.
+ * - Global value numbering finds operators computing the same value as an operator that
+ *   dominates them, since operators depend only on their operands.
+ * - Dead code elimination finds stores no read observes. A call in the program body observes
+ *   every global a function reads.
+ *
+ * The AST is the execution backend, so the results are lowered back into it. An expression
+ * proven constant becomes a literal. An operator repeating a computation whose value a variable
+ * still holds becomes a read of that variable, and so does a read of a variable copied from
+ * another. A dead store is removed, keeping its value as a statement unless evaluating it can
+ * neither fail nor have an effect. The condition of a while loop is evaluated after every
+ * statement, and is only rewritten when the rewrite holds at all of those places.
+ */
+class SSAOptimizer {
+public:
+    /**
+     * @brief Optimises the program body and every function body.
+     * @param program The top-level block of the program.
+     * @return The number of expressions and statements rewritten.
+     */
+    size_t run(BlockNode& program);
+
+    /**
+     * @brief Formats the optimised IR of every function, with a summary of the rewrites.
+     * @return The dump, one line per block header and per instruction.
+     */
+    std::string dump() const;
+
+private:
+    /**
+     * @struct Body
+     * @brief The IR of the program body or of one function, with the AST it was lowered from.
+     */
+    struct Body {
+        std::unique_ptr<IRBuilder> builder; ///< The builder holding the IR and the sites of the statements.
+        bool supported = false; ///< Whether the whole body could be lowered, so the results may be applied.
+        std::unordered_map<IRInstruction*, std::vector<IRInstruction*>> holders; ///< The definitions holding each value, in the order they were created.
+        std::unordered_map<const ExprNode*, std::vector<IRInstruction*>> reads; ///< The definitions each remaining variable read observes.
+    };
+
+    std::vector<Body> bodies; ///< The program body first, then the functions in the order they are defined.
+    std::vector<std::string> callReads; ///< The globals functions read, sorted by name.
+    size_t constantsFolded = 0; ///< Number of expressions replaced by literals.
+    size_t valuesReused = 0; ///< Number of operators replaced by a read of a variable holding their value.
+    size_t copiesPropagated = 0; ///< Number of reads of a copy replaced by a read of the original.
+    size_t storesRemoved = 0; ///< Number of dead stores removed.
+
+    /**
+     * @brief Lowers and optimises the bodies of the functions defined below a node.
+     * @param node The node.
+     */
+    void optimizeFunctions(ExprNode* node);
+
+    /**
+     * @brief Lowers and optimises one body and writes the results back to its AST.
+     * @param name The name of the function, or "main".
+     * @param block The statements of the body.
+     * @param parameters The parameters of the function.
+     * @param callReads The globals functions read, for the program body; null for a function.
+     */
+    void optimize(const std::string& name, BlockNode* block, const std::vector<std::string>& parameters,
+        const std::vector<std::string>* callReads);
+
+    /**
+     * @brief Replaces PHIs whose operands, looking through copies, all have one value by that value.
+     * @param function The function.
+     */
+    static void propagateCopies(IRFunction& function);
+
+    /**
+     * @brief Finds the values that are the same on every execution and evaluates them.
+     * @param function The function.
+     */
+    static void propagateConstants(IRFunction& function);
+
+    /**
+     * @brief Links every operator to a dominating operator computing the same value, if there is one.
+     * @param function The function, whose dominators are computed.
+     */
+    static void numberValues(IRFunction& function);
+
+    /**
+     * @brief Writes the results of the passes back to the expressions below a slot.
+     * @param body The body being rewritten.
+     * @param slot The slot holding the expression or statement.
+     * @param observed Receives the definitions read by the expressions that remain.
+     */
+    void rewrite(Body& body, std::unique_ptr<ExprNode>& slot, std::unordered_set<IRInstruction*>& observed);
+
+    /**
+     * @brief Finds a variable other than the one read that holds the value of an expression wherever it is evaluated.
+     * @param body The body being rewritten.
+     * @param sites The places the expression is evaluated.
+     * @param excluded The variable the expression reads, if it is a variable; it stops the search.
+     * @param definitions Receives the definition of the variable read at each site.
+     * @return The variable, or an empty string if there is none.
+     */
+    std::string findHolder(Body& body, const std::vector<IRBuilder::Site>& sites, const std::string& excluded,
+        std::vector<IRInstruction*>& definitions);
+
+    /**
+     * @brief Removes the stores no remaining read observes from a block and its nested blocks.
+     * @param body The body being rewritten.
+     * @param block The block, which may be null.
+     * @param observed The definitions read, including through PHIs.
+     */
+    void removeDeadStores(Body& body, BlockNode* block, const std::unordered_set<IRInstruction*>& observed);
+
+    /**
+     * @brief Checks whether a definition holds a value on every path, so reading it cannot fail.
+     * @param definition The definition.
+     * @param visiting The PHIs being checked, which are assumed to be defined.
+     * @return True if the definition is a store or parameter, or a PHI of such definitions.
+     */
+    static bool isDefined(IRInstruction* definition, std::unordered_set<IRInstruction*>& visiting);
+
+    /**
+     * @brief Creates a literal holding a value.
+     * @param token The token of the expression the literal replaces.
+     * @param value The value.
+     * @return The literal, or null if the value has no literal form.
+     */
+    static std::unique_ptr<ExprNode> makeLiteral(const Token& token, const Value& value);
+
+    /**
+     * @brief Collects the variables, lists and maps read in the bodies of the functions defined below a node.
+     * @param node The node.
+     * @param inFunction Whether the node is in a function body.
+     * @param reads Updated with the names read.
+     */
+    static void collectFunctionReads(const ExprNode* node, bool inFunction, std::unordered_set<std::string>& reads);
+};
+
+#endif // SSAOPTIMIZER_H
@@ -0,0 +1,90 @@
+#include "SuperinstructionFuser.h"
+#include "Optimizer/Utility/ASTHelper.h"
+#include <unordered_map>
+
+namespace {
+    bool isVariable(const ExprNode* node, const std::string& name) {
+        auto varNode = dynamic_cast<const VariableNode*>(node);
+        return varNode && varNode->getName() == name;
+    }
+}
+
+size_t SuperinstructionFuser::run(BlockNode& program) {
+    for (auto& statement : program.getStatements()) {
+        fuse(statement);
+    }
+    return fusedCount;
+}
+
+void SuperinstructionFuser::fuse(std::unique_ptr<ExprNode>& slot) {
+    if (!slot) {
+        return;
+    }
+    ASTHelper::forEachChildSlot(slot.get(), [this](std::unique_ptr<ExprNode>& child) {
+        fuse(child);
+    });
+
+    // Only the exact node types are matched, so nodes that were fused or specialised otherwise keep their form
+    const std::type_info& type = typeid(*slot);
+    if (type == typeid(AssignNode)) {
+        fusedCount += fuseAssignment(slot);
+    }
+    else if (type == typeid(ListAppendNode)) {
+        auto appendNode = static_cast<ListAppendNode*>(slot.get());
+        slot = std::make_unique<ListAppendInPlaceNode>(appendNode->getToken(), appendNode->getListName(), std::move(appendNode->getValue()));
+        fusedCount++;
+    }
+    else if (type == typeid(BinaryExprNode) || type == typeid(TypedBinaryExprNode)) {
+        fusedCount += fuseComparison(slot);
+    }
+}
+
+bool SuperinstructionFuser::fuseAssignment(std::unique_ptr<ExprNode>& slot) {
+    auto assignNode = static_cast<AssignNode*>(slot.get());
+    const std::string name = assignNode->getName();
+    auto binNode = dynamic_cast<BinaryExprNode*>(assignNode->getValue().get());
+    if (!binNode || binNode->getToken().type != TokenType::ARITHMETIC || !isVariable(binNode->getLeft().get(), name)) {
+        return false;
+    }
+
+    const std::string& op = binNode->getOp();
+    auto literal = dynamic_cast<const IntegerNode*>(binNode->getRight().get());
+    if (literal && (op == "+" || op == "-")) {
+        int delta = op == "+" ? literal->getValue() : -literal->getValue();
+        slot = std::make_unique<IncrementNode>(assignNode->getToken(), name, std::move(assignNode->getValue()), delta);
+        return true;
+    }
+
+    std::unique_ptr<BinaryExprNode> operation(static_cast<BinaryExprNode*>(assignNode->getValue().release()));
+    slot = std::make_unique<UpdateAssignNode>(assignNode->getToken(), name, std::move(operation));
+    return true;
+}
+
+bool SuperinstructionFuser::fuseComparison(std::unique_ptr<ExprNode>& slot) {
+    static const std::unordered_map<std::string, TypedBinaryOp> intComparison = {
+        { "==", TypedBinaryOp::INT_EQUAL }, { "!=", TypedBinaryOp::INT_NOT_EQUAL }, { "<", TypedBinaryOp::INT_LESS },
+        { "<=", TypedBinaryOp::INT_LESS_EQUAL }, { ">", TypedBinaryOp::INT_GREATER }, { ">=", TypedBinaryOp::INT_GREATER_EQUAL }
+    };
+
+    auto binNode = static_cast<BinaryExprNode*>(slot.get());
+    if (binNode->getToken().type != TokenType::COMPARISON || !dynamic_cast<VariableNode*>(binNode->getLeft().get())) {
+        return false;
+    }
+    ExprNode* right = binNode->getRight().get();
+    if (!dynamic_cast<VariableNode*>(right) && !dynamic_cast<IntegerNode*>(right)) {
+        return false;
+    }
+    auto it = intComparison.find(binNode->getOp());
+    if (it == intComparison.end()) {
+        return false;
+    }
+    // A comparison proven to be on other types is already specialised and would never take the int path
+    auto typedNode = dynamic_cast<TypedBinaryExprNode*>(binNode);
+    if (typedNode && typedNode->getTypedOp() != it->second) {
+        return false;
+    }
+
+    std::unique_ptr<VariableNode> left(static_cast<VariableNode*>(binNode->getLeft().release()));
+    slot = std::make_unique<VariableCompareNode>(binNode->getToken(), std::move(left), binNode->getOp(), std::move(binNode->getRight()), it->second);
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef SUPERINSTRUCTIONFUSER_H
+#define SUPERINSTRUCTIONFUSER_H
+
+#include <memory>
+#include "AST/AST.h"
+
+/**
+ * @class SuperinstructionFuser
+ * @brief Replaces the statement shapes that dominate loops with fused nodes that work on variables where they are stored.
+ *
+ * The fused shapes are:
+ * - `i = i + k` and `i = i - k` with an int literal k, as an IncrementNode;
+ * - `x = x op <expr>` with an arithmetic operator, as an UpdateAssignNode;
+ * - `list.append(<expr>)`, as a ListAppendInPlaceNode;
+ * - comparisons of a variable with a variable or an int literal, such as the condition of
+ *   `while (i < n)`, as a VariableCompareNode.
+ *
+ * Each fused node keeps the children of the node it replaces and behaves like it for types it
+ * does not specialise. Fused nodes record the names and literals of their operands, so the pass
+ * runs after every other pass that rewrites expressions.
+ */
+class SuperinstructionFuser {
+public:
+    /**
+     * @brief Fuses every matching statement and comparison in the program, including function bodies.
+     * @param program The top-level block of the program.
+     * @return The number of nodes that were fused.
+     */
+    size_t run(BlockNode& program);
+
+private:
+    size_t fusedCount = 0; ///< Number of nodes fused so far.
+
+    /**
+     * @brief Fuses the children of the node held by a slot, then the node itself if it matches a shape.
+     * @param slot The slot holding the node, which is replaced by the fused node.
+     */
+    void fuse(std::unique_ptr<ExprNode>& slot);
+
+    /**
+     * @brief Replaces an assignment of the form `x = x op <expr>` with an IncrementNode or UpdateAssignNode.
+     * @param slot The slot holding the assignment.
+     * @return True if the assignment was fused.
+     */
+    static bool fuseAssignment(std::unique_ptr<ExprNode>& slot);
+
+    /**
+     * @brief Replaces a comparison of a variable with a variable or int literal with a VariableCompareNode.
+     * @param slot The slot holding the comparison.
+     * @return True if the comparison was fused.
+     */
+    static bool fuseComparison(std::unique_ptr<ExprNode>& slot);
+};
+
+#endif // SUPERINSTRUCTIONFUSER_H
@@ -0,0 +1,342 @@
+#include "TypeInference.h"
+#include "Optimizer/Utility/ASTHelper.h"
+
+namespace {
+    bool isNumeric(const std::string& type) {
+        return type == "int" || type == "double" || type == "number";
+    }
+
+    // Gets the type a variable holds, or an empty string if it is unknown
+    std::string typeOf(const std::unordered_map<std::string, std::string>& types, const std::string& name) {
+        auto it = types.find(name);
+        return it != types.end() ? it->second : "";
+    }
+
+    // Gets the element type of a "list:T" type, or an empty string for any other type
+    std::string elementType(const std::string& type) {
+        return type.compare(0, 5, "list:") == 0 ? type.substr(5) : "";
+    }
+
+    // Gets the key or value type of a "map:K:V" type, or an empty string for any other type
+    std::string mapPart(const std::string& type, bool key) {
+        if (type.compare(0, 4, "map:") != 0) {
+            return "";
+        }
+        size_t separator = type.find(':', 4);
+        return key ? type.substr(4, separator - 4) : type.substr(separator + 1);
+    }
+}
+
+size_t TypeInference::run(BlockNode& program) {
+    collectReturnTypes(&program);
+    TypeMap types;
+    inferBlock(&program, types);
+    return specializedCount;
+}
+
+void TypeInference::collectReturnTypes(const ExprNode* node) {
+    if (!node) {
+        return;
+    }
+    if (auto defNode = dynamic_cast<const FunctionDefNode*>(node)) {
+        // A function defined twice with different return types is looked up at runtime, so its type is unknown
+        const std::string type = defNode->getReturnType() == "void" ? "" : defNode->getReturnType();
+        auto result = returnTypes.insert({ defNode->getName(), type });
+        if (!result.second && result.first->second != type) {
+            result.first->second.clear();
+        }
+    }
+    ASTHelper::forEachChild(node, [this](const ExprNode* child) {
+        collectReturnTypes(child);
+    });
+}
+
+void TypeInference::inferBlock(BlockNode* block, TypeMap& types) {
+    if (!block) {
+        return;
+    }
+    for (auto& statement : block->getStatements()) {
+        infer(statement, types);
+    }
+}
+
+std::string TypeInference::infer(std::unique_ptr<ExprNode>& slot, TypeMap& types) {
+    ExprNode* node = slot.get();
+    if (!node) {
+        return "";
+    }
+
+    if (dynamic_cast<IntegerNode*>(node)) return "int";
+    if (dynamic_cast<DoubleNode*>(node)) return "double";
+    if (dynamic_cast<StringNode*>(node)) return "string";
+    if (dynamic_cast<BooleanNode*>(node)) return "bool";
+
+    if (auto varNode = dynamic_cast<VariableNode*>(node)) {
+        return typeOf(types, varNode->getName());
+    }
+    if (auto assignNode = dynamic_cast<AssignNode*>(node)) {
+        // Appending to a string in place yields no value, so the value of an assignment itself is not known
+        types[assignNode->getName()] = infer(assignNode->getValue(), types);
+        return "";
+    }
+    if (dynamic_cast<BinaryExprNode*>(node)) {
+        return inferBinary(slot, types);
+    }
+    if (auto unNode = dynamic_cast<UnaryExprNode*>(node)) {
+        std::string operand = infer(unNode->getOperand(), types);
+        if (unNode->getOp() == "!") {
+            return "bool";
+        }
+        return unNode->getOp() == "-" && isNumeric(operand) ? operand : "";
+    }
+    if (auto ifNode = dynamic_cast<IfNode*>(node)) {
+        infer(ifNode->getCondition(), types);
+        TypeMap elseTypes = types;
+        inferBlock(ifNode->getThenBlock().get(), types);
+        inferBlock(ifNode->getElseBlock().get(), elseTypes);
+        types = join(types, elseTypes);
+        return "";
+    }
+    if (auto whileNode = dynamic_cast<WhileNode*>(node)) {
+        inferWhile(whileNode, types);
+        return "";
+    }
+    if (auto blockNode = dynamic_cast<BlockNode*>(node)) {
+        inferBlock(blockNode, types);
+        return "";
+    }
+    if (auto defNode = dynamic_cast<FunctionDefNode*>(node)) {
+        inferFunction(defNode);
+        return "";
+    }
+    if (auto listNode = dynamic_cast<ListInitNode*>(node)) {
+        types[listNode->getName()] = "list:" + listNode->getElementType();
+        return "";
+    }
+    if (auto mapNode = dynamic_cast<MapInitNode*>(node)) {
+        types[mapNode->getName()] = "map:" + mapNode->getKeyType() + ":" + mapNode->getValueType();
+        return "";
+    }
+    if (auto indexNode = dynamic_cast<ListIndexNode*>(node)) {
+        infer(indexNode->getIndex(), types);
+        return elementType(typeOf(types, indexNode->getListName()));
+    }
+    if (auto popNode = dynamic_cast<ListPopNode*>(node)) {
+        infer(popNode->getIndex(), types);
+        return elementType(typeOf(types, popNode->getListName()));
+    }
+    if (auto sliceNode = dynamic_cast<ListSliceNode*>(node)) {
+        infer(sliceNode->getBegin(), types);
+        infer(sliceNode->getEnd(), types);
+        std::string type = typeOf(types, sliceNode->getListName());
+        return elementType(type).empty() ? "" : type;
+    }
+    if (dynamic_cast<ListLengthNode*>(node)) {
+        return "int";
+    }
+    if (auto methodNode = dynamic_cast<ListMethodNode*>(node)) {
+        infer(methodNode->getArgument(), types);
+        ListMethod method = methodNode->getMethod();
+        return method == ListMethod::CONTAINS ? "bool" : method == ListMethod::INDEX ? "int" : "";
+    }
+    if (auto mapMethodNode = dynamic_cast<MapMethodNode*>(node)) {
+        infer(mapMethodNode->getKey(), types);
+        infer(mapMethodNode->getValue(), types);
+        std::string type = typeOf(types, mapMethodNode->getMapName());
+        switch (mapMethodNode->getMethod()) {
+            case MapMethod::GET: return mapPart(type, false);
+            case MapMethod::REMOVE: return "bool";
+            case MapMethod::KEYS: return mapPart(type, true).empty() ? "" : "list:" + mapPart(type, true);
+            case MapMethod::VALUES: return mapPart(type, false).empty() ? "" : "list:" + mapPart(type, false);
+            default: return "";
+        }
+    }
+    if (auto castNode = dynamic_cast<TypeCastNode*>(node)) {
+        infer(castNode->getValue(), types);
+        // A cast to int only converts strings, so its result is not known for other operands
+        return castNode->getType() != "int" ? castNode->getType() : "";
+    }
+    if (auto inNode = dynamic_cast<InputNode*>(node)) {
+        infer(inNode->getExpression(), types);
+        return "string";
+    }
+    if (auto callNode = dynamic_cast<FunctionCallNode*>(node)) {
+        for (auto& arg : callNode->getArgs()) {
+            infer(arg, types);
+        }
+        // Every function ends in a return statement that checks the value against the declared type
+        auto it = returnTypes.find(callNode->getName());
+        return it != returnTypes.end() ? it->second : "";
+    }
+    if (auto inlinedNode = dynamic_cast<InlinedCallNode*>(node)) {
+        for (auto& binding : inlinedNode->getBindings()) {
+            types[binding->getName()] = infer(binding->getValue(), types);
+        }
+        std::string type = infer(inlinedNode->getBody(), types);
+        return inlinedNode->needsReturnTypeCheck() ? inlinedNode->getReturnType() : type;
+    }
+
+    // Other nodes cannot change the type of a variable, so only their children are visited
+    ASTHelper::forEachChildSlot(node, [this, &types](std::unique_ptr<ExprNode>& child) {
+        infer(child, types);
+    });
+    return "";
+}
+
+std::string TypeInference::inferBinary(std::unique_ptr<ExprNode>& slot, TypeMap& types) {
+    auto binNode = static_cast<BinaryExprNode*>(slot.get());
+    std::string left = infer(binNode->getLeft(), types);
+    std::string right = infer(binNode->getRight(), types);
+    TokenType tokenType = binNode->getToken().type;
+
+    TypedBinaryOp typedOp;
+    std::string resultType;
+    if (!selectTypedOp(tokenType, binNode->getOp(), left, right, typedOp, resultType)) {
+        // Comparisons and logical operations produce a bool whenever they succeed
+        return tokenType == TokenType::COMPARISON || tokenType == TokenType::LOGICAL ? "bool" : "";
+    }
+
+    if (rewrite && !dynamic_cast<TypedBinaryExprNode*>(binNode)) {
+        const std::string op = binNode->getOp();
+        slot = std::make_unique<TypedBinaryExprNode>(binNode->getToken(), std::move(binNode->getLeft()), op,
+            std::move(binNode->getRight()), typedOp);
+        specializedCount++;
+    }
+    return resultType;
+}
+
+void TypeInference::inferWhile(WhileNode* whileNode, TypeMap& types) {
+    // The condition is checked again after every statement of the body, and the loop is left as soon as it
+    // fails, so the types at the head of the loop must hold on entry and after each statement
+    bool rewriting = rewrite;
+    rewrite = false;
+    TypeMap head = types;
+    while (true) {
+        TypeMap next = head;
+        TypeMap state = head;
+        infer(whileNode->getCondition(), state);
+        for (auto& statement : whileNode->getBlock()->getStatements()) {
+            infer(statement, state);
+            infer(whileNode->getCondition(), state);
+            next = join(next, state);
+        }
+        if (next == head) {
+            break;
+        }
+        head = std::move(next);
+    }
+    rewrite = rewriting;
+
+    // Every state the loop can be left in is covered by the head, and the body is rewritten with the types from there
+    infer(whileNode->getCondition(), head);
+    types = head;
+    inferBlock(whileNode->getBlock().get(), head);
+}
+
+void TypeInference::inferFunction(FunctionDefNode* defNode) {
+    bool wasInFunction = inFunction;
+    inFunction = true;
+
+    // Only list parameters are checked when the function is called
+    TypeMap types;
+    for (const auto& parameter : defNode->getParameters()) {
+        if (!elementType(parameter.second).empty()) {
+            types[parameter.first] = parameter.second;
+        }
+    }
+    inferBlock(defNode->getBody().get(), types);
+
+    inFunction = wasInFunction;
+}
+
+TypeInference::TypeMap TypeInference::join(const TypeMap& first, const TypeMap& second) const {
+    TypeMap joined;
+    for (const auto& entry : first) {
+        auto it = second.find(entry.first);
+        if (it != second.end()) {
+            joined[entry.first] = joinTypes(entry.second, it->second);
+        }
+        else if (!inFunction) {
+            // A global assigned on one path only is undefined on the other, where reading it is an error
+            joined.insert(entry);
+        }
+    }
+    if (!inFunction) {
+        for (const auto& entry : second) {
+            joined.insert(entry);
+        }
+    }
+    // In a function a name missing on one path may refer to a global there, so its type is unknown
+    return joined;
+}
+
+std::string TypeInference::joinTypes(const std::string& first, const std::string& second) {
+    if (first == second) {
+        return first;
+    }
+    return isNumeric(first) && isNumeric(second) ? "number" : "";
+}
+
+bool TypeInference::selectTypedOp(TokenType tokenType, const std::string& op, const std::string& left, const std::string& right,
+    TypedBinaryOp& typedOp, std::string& resultType) {
+    static const std::unordered_map<std::string, TypedBinaryOp> intArithmetic = {
+        { "+", TypedBinaryOp::INT_ADD }, { "-", TypedBinaryOp::INT_SUB }, { "*", TypedBinaryOp::INT_MUL },
+        { "/", TypedBinaryOp::INT_DIV }, { "%", TypedBinaryOp::INT_MOD }
+    };
+    static const std::unordered_map<std::string, TypedBinaryOp> doubleArithmetic = {
+        { "+", TypedBinaryOp::DOUBLE_ADD }, { "-", TypedBinaryOp::DOUBLE_SUB }, { "*", TypedBinaryOp::DOUBLE_MUL },
+        { "/", TypedBinaryOp::DOUBLE_DIV }, { "%", TypedBinaryOp::DOUBLE_MOD }
+    };
+    static const std::unordered_map<std::string, TypedBinaryOp> intComparison = {
+        { "==", TypedBinaryOp::INT_EQUAL }, { "!=", TypedBinaryOp::INT_NOT_EQUAL }, { "<", TypedBinaryOp::INT_LESS },
+        { "<=", TypedBinaryOp::INT_LESS_EQUAL }, { ">", TypedBinaryOp::INT_GREATER }, { ">=", TypedBinaryOp::INT_GREATER_EQUAL }
+    };
+    static const std::unordered_map<std::string, TypedBinaryOp> doubleComparison = {
+        { "==", TypedBinaryOp::DOUBLE_EQUAL }, { "!=", TypedBinaryOp::DOUBLE_NOT_EQUAL }, { "<", TypedBinaryOp::DOUBLE_LESS },
+        { "<=", TypedBinaryOp::DOUBLE_LESS_EQUAL }, { ">", TypedBinaryOp::DOUBLE_GREATER }, { ">=", TypedBinaryOp::DOUBLE_GREATER_EQUAL }
+    };
+
+    const bool bothInt = left == "int" && right == "int";
+    const std::unordered_map<std::string, TypedBinaryOp>* table = nullptr;
+
+    if (tokenType == TokenType::ARITHMETIC) {
+        if (isNumeric(left) && isNumeric(right)) {
+            table = bothInt ? &intArithmetic : &doubleArithmetic;
+            // Whole number results are stored as ints, so only int +, -, * and % are known to produce an int
+            resultType = bothInt && op != "/" ? "int" : "number";
+        }
+        else if (left == "string" && op == "+" && (right == "string" || right == "bool" || isNumeric(right))) {
+            typedOp = TypedBinaryOp::STRING_CONCAT;
+            resultType = "string";
+            return true;
+        }
+    }
+    else if (tokenType == TokenType::COMPARISON) {
+        resultType = "bool";
+        if (isNumeric(left) && isNumeric(right)) {
+            table = bothInt ? &intComparison : &doubleComparison;
+        }
+        else if (left == right && (left == "string" || left == "bool") && (op == "==" || op == "!=")) {
+            bool equal = op == "==";
+            typedOp = left == "string"
+                ? (equal ? TypedBinaryOp::STRING_EQUAL : TypedBinaryOp::STRING_NOT_EQUAL)
+                : (equal ? TypedBinaryOp::BOOL_EQUAL : TypedBinaryOp::BOOL_NOT_EQUAL);
+            return true;
+        }
+    }
+    else if (tokenType == TokenType::LOGICAL && left == "bool" && right == "bool" && (op == "and" || op == "or")) {
+        typedOp = op == "and" ? TypedBinaryOp::BOOL_AND : TypedBinaryOp::BOOL_OR;
+        resultType = "bool";
+        return true;
+    }
+
+    if (!table) {
+        return false;
+    }
+    auto it = table->find(op);
+    if (it == table->end()) {
+        return false;
+    }
+    typedOp = it->second;
+    return true;
+}
@@ -0,0 +1,115 @@
+#ifndef TYPEINFERENCE_H
+#define TYPEINFERENCE_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "AST/AST.h"
+
+/**
+ * @class TypeInference
+ * @brief Infers the types of variables and expressions, and specialises binary operations on proven types.
+ *
+ * The analysis walks the program in execution order and tracks the type each variable holds at
+ * every point, joining the types from both branches of an if and iterating while loops until
+ * the types stop changing. It is seeded by literals, list and map declarations, list parameters
+ * and the declared return types of functions, which are checked when a function returns.
+ *
+ * Types are the names used by the interpreter ("int", "double", "string", "bool", "list:int",
+ * "map:string:int") together with "number" for a value that is an int or a double, which is
+ * what arithmetic on doubles produces because whole number results are stored as ints. An
+ * empty string means the type is unknown.
+ *
+ * A BinaryExprNode whose operand types are proven is replaced by a TypedBinaryExprNode, and
+ * every other operation keeps dispatching on the runtime types.
+ */
+class TypeInference {
+public:
+    /**
+     * @brief Specialises the binary operations of a program whose operand types can be proven.
+     * @param program The top-level block of the program.
+     * @return The number of operations that were specialised.
+     */
+    size_t run(BlockNode& program);
+
+private:
+    using TypeMap = std::unordered_map<std::string, std::string>; ///< Variable names mapped to the type they hold.
+
+    std::unordered_map<std::string, std::string> returnTypes; ///< Function names mapped to their return type, empty if definitions disagree.
+    bool inFunction = false; ///< Whether a function body is being analysed, where unassigned names may fall back to globals.
+    bool rewrite = true; ///< Whether nodes are replaced; false while a loop is iterated to its fixed point.
+    size_t specializedCount = 0; ///< Number of operations specialised so far.
+
+    /**
+     * @brief Records the declared return type of every function defined in a subtree.
+     * @param node The root of the subtree.
+     */
+    void collectReturnTypes(const ExprNode* node);
+
+    /**
+     * @brief Infers the type of the expression held by a slot and updates the variable types for its effects.
+     * @param slot The slot holding the expression, which is replaced if the expression is specialised.
+     * @param types The variable types before the expression, updated to those after it.
+     * @return The type of the expression's value, or an empty string if it is unknown.
+     */
+    std::string infer(std::unique_ptr<ExprNode>& slot, TypeMap& types);
+
+    /**
+     * @brief Infers the types through the statements of a block in order.
+     * @param block The block, which may be null.
+     * @param types The variable types before the block, updated to those after it.
+     */
+    void inferBlock(BlockNode* block, TypeMap& types);
+
+    /**
+     * @brief Infers the type of a binary expression and specialises it if its operand types are proven.
+     * @param slot The slot holding the binary expression.
+     * @param types The variable types before the expression, updated to those after it.
+     * @return The type of the expression's value, or an empty string if it is unknown.
+     */
+    std::string inferBinary(std::unique_ptr<ExprNode>& slot, TypeMap& types);
+
+    /**
+     * @brief Infers the types through a while loop, iterating the body until the types stop changing.
+     * @param whileNode The loop.
+     * @param types The variable types before the loop, updated to those after it.
+     */
+    void inferWhile(WhileNode* whileNode, TypeMap& types);
+
+    /**
+     * @brief Infers the types through a function body, starting from its parameters.
+     * @param defNode The function definition.
+     */
+    void inferFunction(FunctionDefNode* defNode);
+
+    /**
+     * @brief Combines the variable types of two paths that meet.
+     * @param first The types on one path.
+     * @param second The types on the other path.
+     * @return The types that hold on either path.
+     */
+    TypeMap join(const TypeMap& first, const TypeMap& second) const;
+
+    /**
+     * @brief Combines two types of the same value on paths that meet.
+     * @param first One type.
+     * @param second The other type.
+     * @return The type both have in common: the type itself if they are equal, "number" for two numeric types, and empty otherwise.
+     */
+    static std::string joinTypes(const std::string& first, const std::string& second);
+
+    /**
+     * @brief Chooses the specialised operation for an operator and proven operand types.
+     * @param tokenType The token type of the operator.
+     * @param op The operator.
+     * @param left The type of the left operand.
+     * @param right The type of the right operand.
+     * @param typedOp Set to the specialised operation if one applies.
+     * @param resultType Set to the type of the result if one applies.
+     * @return True if the operation can be specialised.
+     */
+    static bool selectTypedOp(TokenType tokenType, const std::string& op, const std::string& left, const std::string& right,
+        TypedBinaryOp& typedOp, std::string& resultType);
+};
+
+#endif // TYPEINFERENCE_H
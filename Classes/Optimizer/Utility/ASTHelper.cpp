@@ -0,0 +1,369 @@
+#include "ASTHelper.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    void visitBlockSlots(BlockNode* block, const std::function<void(std::unique_ptr<ExprNode>&)>& visit) {
+        if (!block) {
+            return;
+        }
+        for (auto& statement : block->getStatements()) {
+            visit(statement);
+        }
+    }
+
+    // Binding strength of a binary operator, used to parenthesise operands when describing expressions.
+    // Arithmetic operators share one level, and comparisons and logical operators bind more loosely
+    int precedence(const std::string& op) {
+        return op == "+" || op == "-" || op == "*" || op == "/" || op == "%" ? 1 : 0;
+    }
+
+    std::string describeArguments(const std::vector<std::unique_ptr<ExprNode>>& args) {
+        std::string text;
+        for (const auto& arg : args) {
+            text += (text.empty() ? "" : ", ") + ASTHelper::describe(arg.get());
+        }
+        return text;
+    }
+}
+
+void ASTHelper::forEachChildSlot(ExprNode* node, const std::function<void(std::unique_ptr<ExprNode>&)>& visit) {
+    if (auto binNode = dynamic_cast<BinaryExprNode*>(node)) {
+        visit(binNode->getLeft());
+        visit(binNode->getRight());
+    }
+    else if (auto unNode = dynamic_cast<UnaryExprNode*>(node)) {
+        visit(unNode->getOperand());
+    }
+    else if (auto assignNode = dynamic_cast<AssignNode*>(node)) {
+        visit(assignNode->getValue());
+    }
+    else if (auto prNode = dynamic_cast<PrintNode*>(node)) {
+        visit(prNode->getExpression());
+    }
+    else if (auto inNode = dynamic_cast<InputNode*>(node)) {
+        visit(inNode->getExpression());
+    }
+    else if (auto blockNode = dynamic_cast<BlockNode*>(node)) {
+        visitBlockSlots(blockNode, visit);
+    }
+    else if (auto callNode = dynamic_cast<FunctionCallNode*>(node)) {
+        for (auto& arg : callNode->getArgs()) {
+            visit(arg);
+        }
+    }
+    else if (auto ifNode = dynamic_cast<IfNode*>(node)) {
+        visit(ifNode->getCondition());
+        visitBlockSlots(ifNode->getThenBlock().get(), visit);
+        visitBlockSlots(ifNode->getElseBlock().get(), visit);
+    }
+    else if (auto whileNode = dynamic_cast<WhileNode*>(node)) {
+        visit(whileNode->getCondition());
+        visitBlockSlots(whileNode->getBlock().get(), visit);
+    }
+    else if (auto appendNode = dynamic_cast<ListAppendNode*>(node)) {
+        visit(appendNode->getValue());
+    }
+    else if (auto indexNode = dynamic_cast<ListIndexNode*>(node)) {
+        visit(indexNode->getIndex());
+    }
+    else if (auto sliceNode = dynamic_cast<ListSliceNode*>(node)) {
+        if (sliceNode->getBegin()) {
+            visit(sliceNode->getBegin());
+        }
+        if (sliceNode->getEnd()) {
+            visit(sliceNode->getEnd());
+        }
+    }
+    else if (auto popNode = dynamic_cast<ListPopNode*>(node)) {
+        visit(popNode->getIndex());
+    }
+    else if (auto methodNode = dynamic_cast<ListMethodNode*>(node)) {
+        if (methodNode->getArgument()) {
+            visit(methodNode->getArgument());
+        }
+    }
+    else if (auto replaceNode = dynamic_cast<ListReplaceNode*>(node)) {
+        visit(replaceNode->getIndex());
+        visit(replaceNode->getValue());
+    }
+    else if (auto mapMethodNode = dynamic_cast<MapMethodNode*>(node)) {
+        if (mapMethodNode->getKey()) {
+            visit(mapMethodNode->getKey());
+        }
+        if (mapMethodNode->getValue()) {
+            visit(mapMethodNode->getValue());
+        }
+    }
+    else if (auto castNode = dynamic_cast<TypeCastNode*>(node)) {
+        visit(castNode->getValue());
+    }
+    else if (auto defNode = dynamic_cast<FunctionDefNode*>(node)) {
+        visitBlockSlots(defNode->getBody().get(), visit);
+    }
+    else if (auto returnNode = dynamic_cast<ReturnNode*>(node)) {
+        visit(returnNode->getValue());
+    }
+    else if (auto inlinedNode = dynamic_cast<InlinedCallNode*>(node)) {
+        for (auto& binding : inlinedNode->getBindings()) {
+            visit(binding->getValue());
+        }
+        visit(inlinedNode->getBody());
+    }
+    else if (auto hoistedNode = dynamic_cast<HoistedWhileNode*>(node)) {
+        for (auto& assignment : hoistedNode->getHoisted()) {
+            visit(assignment->getValue());
+        }
+        visit(hoistedNode->getLoop());
+        visit(hoistedNode->getFallback());
+    }
+}
+
+void ASTHelper::forEachChild(const ExprNode* node, const std::function<void(const ExprNode*)>& visit) {
+    // The mutable walk never modifies the tree itself, so it is reused to keep one list of node layouts
+    ASTHelper::forEachChildSlot(const_cast<ExprNode*>(node), [&visit](std::unique_ptr<ExprNode>& child) {
+        visit(child.get());
+    });
+}
+
+std::unique_ptr<BlockNode> ASTHelper::cloneBlock(const BlockNode* block) {
+    if (!block) {
+        return nullptr;
+    }
+    std::vector<std::unique_ptr<ExprNode>> statements;
+    for (const auto& statement : block->getStatements()) {
+        statements.push_back(clone(statement.get()));
+    }
+    return std::make_unique<BlockNode>(block->getToken(), std::move(statements));
+}
+
+std::unique_ptr<ExprNode> ASTHelper::clone(const ExprNode* node) {
+    if (!node) {
+        return nullptr;
+    }
+
+    const Token& token = node->getToken();
+
+    if (auto strNode = dynamic_cast<const StringNode*>(node)) {
+        return std::make_unique<StringNode>(token, strNode->getValue());
+    }
+    else if (auto doubleNode = dynamic_cast<const DoubleNode*>(node)) {
+        return std::make_unique<DoubleNode>(token, doubleNode->getValue());
+    }
+    else if (auto boolNode = dynamic_cast<const BooleanNode*>(node)) {
+        return std::make_unique<BooleanNode>(token, boolNode->getValue());
+    }
+    else if (auto intNode = dynamic_cast<const IntegerNode*>(node)) {
+        return std::make_unique<IntegerNode>(token, intNode->getValue());
+    }
+    else if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        return std::make_unique<VariableNode>(token, varNode->getName());
+    }
+    else if (auto listNode = dynamic_cast<const ListInitNode*>(node)) {
+        return std::make_unique<ListInitNode>(token, listNode->getName(), listNode->getElementType());
+    }
+    else if (auto appendNode = dynamic_cast<const ListAppendInPlaceNode*>(node)) {
+        return std::make_unique<ListAppendInPlaceNode>(token, appendNode->getListName(), clone(appendNode->getValue().get()));
+    }
+    else if (auto appendNode = dynamic_cast<const ListAppendNode*>(node)) {
+        return std::make_unique<ListAppendNode>(token, appendNode->getListName(), clone(appendNode->getValue().get()));
+    }
+    else if (auto popNode = dynamic_cast<const ListPopNode*>(node)) {
+        return std::make_unique<ListPopNode>(token, popNode->getListName(), clone(popNode->getIndex().get()));
+    }
+    else if (auto lengthNode = dynamic_cast<const ListLengthNode*>(node)) {
+        return std::make_unique<ListLengthNode>(token, lengthNode->getListName());
+    }
+    else if (auto indexNode = dynamic_cast<const ListIndexNode*>(node)) {
+        return std::make_unique<ListIndexNode>(token, indexNode->getListName(), clone(indexNode->getIndex().get()));
+    }
+    else if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        return std::make_unique<ListMethodNode>(token, methodNode->getListName(), methodNode->getMethod(), clone(methodNode->getArgument().get()));
+    }
+    else if (auto sliceNode = dynamic_cast<const ListSliceNode*>(node)) {
+        return std::make_unique<ListSliceNode>(token, sliceNode->getListName(), clone(sliceNode->getBegin().get()), clone(sliceNode->getEnd().get()));
+    }
+    else if (auto replaceNode = dynamic_cast<const ListReplaceNode*>(node)) {
+        return std::make_unique<ListReplaceNode>(token, replaceNode->getListName(), clone(replaceNode->getIndex().get()), clone(replaceNode->getValue().get()));
+    }
+    else if (auto mapNode = dynamic_cast<const MapInitNode*>(node)) {
+        return std::make_unique<MapInitNode>(token, mapNode->getName(), mapNode->getKeyType(), mapNode->getValueType());
+    }
+    else if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        return std::make_unique<MapMethodNode>(token, mapMethodNode->getMapName(), mapMethodNode->getMethod(),
+            clone(mapMethodNode->getKey().get()), clone(mapMethodNode->getValue().get()));
+    }
+    else if (auto incrementNode = dynamic_cast<const IncrementNode*>(node)) {
+        return std::make_unique<IncrementNode>(token, incrementNode->getName(), clone(incrementNode->getValue().get()), incrementNode->getDelta());
+    }
+    else if (auto updateNode = dynamic_cast<const UpdateAssignNode*>(node)) {
+        std::unique_ptr<BinaryExprNode> operation(static_cast<BinaryExprNode*>(clone(updateNode->getOperation()).release()));
+        return std::make_unique<UpdateAssignNode>(token, updateNode->getName(), std::move(operation));
+    }
+    else if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+        return std::make_unique<AssignNode>(token, assignNode->getName(), clone(assignNode->getValue().get()));
+    }
+    else if (auto compareNode = dynamic_cast<const VariableCompareNode*>(node)) {
+        std::unique_ptr<VariableNode> left(static_cast<VariableNode*>(clone(compareNode->getLeft().get()).release()));
+        return std::make_unique<VariableCompareNode>(token, std::move(left), compareNode->getOp(), clone(compareNode->getRight().get()), compareNode->getIntOp());
+    }
+    else if (auto typedNode = dynamic_cast<const TypedBinaryExprNode*>(node)) {
+        return std::make_unique<TypedBinaryExprNode>(token, clone(typedNode->getLeft().get()), typedNode->getOp(), clone(typedNode->getRight().get()), typedNode->getTypedOp());
+    }
+    else if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        return std::make_unique<BinaryExprNode>(token, clone(binNode->getLeft().get()), binNode->getOp(), clone(binNode->getRight().get()));
+    }
+    else if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        return std::make_unique<UnaryExprNode>(token, unNode->getOp(), clone(unNode->getOperand().get()));
+    }
+    else if (auto prNode = dynamic_cast<const PrintNode*>(node)) {
+        return std::make_unique<PrintNode>(token, clone(prNode->getExpression().get()));
+    }
+    else if (auto inNode = dynamic_cast<const InputNode*>(node)) {
+        return std::make_unique<InputNode>(token, clone(inNode->getExpression().get()));
+    }
+    else if (dynamic_cast<const FlushNode*>(node)) {
+        return std::make_unique<FlushNode>(token);
+    }
+    else if (auto ifNode = dynamic_cast<const IfNode*>(node)) {
+        return std::make_unique<IfNode>(token, clone(ifNode->getCondition().get()), cloneBlock(ifNode->getThenBlock().get()), cloneBlock(ifNode->getElseBlock().get()));
+    }
+    else if (auto whileNode = dynamic_cast<const WhileNode*>(node)) {
+        return std::make_unique<WhileNode>(token, clone(whileNode->getCondition().get()), cloneBlock(whileNode->getBlock().get()));
+    }
+    else if (auto blockNode = dynamic_cast<const BlockNode*>(node)) {
+        return cloneBlock(blockNode);
+    }
+    else if (auto castNode = dynamic_cast<const TypeCastNode*>(node)) {
+        return std::make_unique<TypeCastNode>(token, castNode->getType(), clone(castNode->getValue().get()));
+    }
+    else if (auto defNode = dynamic_cast<const FunctionDefNode*>(node)) {
+        return std::make_unique<FunctionDefNode>(token, defNode->getName(), defNode->getReturnType(), defNode->getParameters(), cloneBlock(defNode->getBody().get()));
+    }
+    else if (auto callNode = dynamic_cast<const FunctionCallNode*>(node)) {
+        std::vector<std::unique_ptr<ExprNode>> args;
+        for (const auto& arg : callNode->getArgs()) {
+            args.push_back(clone(arg.get()));
+        }
+        return std::make_unique<FunctionCallNode>(token, callNode->getName(), std::move(args));
+    }
+    else if (auto returnNode = dynamic_cast<const ReturnNode*>(node)) {
+        return std::make_unique<ReturnNode>(token, clone(returnNode->getValue().get()));
+    }
+    else if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        std::vector<std::unique_ptr<AssignNode>> bindings;
+        for (const auto& binding : inlinedNode->getBindings()) {
+            bindings.push_back(std::make_unique<AssignNode>(binding->getToken(), binding->getName(), clone(binding->getValue().get())));
+        }
+        return std::make_unique<InlinedCallNode>(token, inlinedNode->getName(), std::move(bindings), clone(inlinedNode->getBody().get()),
+            inlinedNode->getReturnToken(), inlinedNode->getReturnType(), inlinedNode->needsReturnTypeCheck());
+    }
+    else if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+        std::vector<std::unique_ptr<AssignNode>> hoisted;
+        for (const auto& assignment : hoistedNode->getHoisted()) {
+            hoisted.push_back(std::make_unique<AssignNode>(assignment->getToken(), assignment->getName(), clone(assignment->getValue().get())));
+        }
+        return std::make_unique<HoistedWhileNode>(token, std::move(hoisted), clone(hoistedNode->getLoop().get()), clone(hoistedNode->getFallback().get()));
+    }
+
+    throw std::runtime_error("Optimizer Error: Unsupported node type at line " + std::to_string(token.line));
+}
+
+size_t ASTHelper::countNodes(const ExprNode* node) {
+    if (!node) {
+        return 0;
+    }
+    size_t count = 1;
+    forEachChild(node, [&count](const ExprNode* child) {
+        count += countNodes(child);
+    });
+    return count;
+}
+
+std::string ASTHelper::describe(const ExprNode* node) {
+    if (!node) {
+        return "";
+    }
+    if (auto intNode = dynamic_cast<const IntegerNode*>(node)) {
+        return std::to_string(intNode->getValue());
+    }
+    if (auto doubleNode = dynamic_cast<const DoubleNode*>(node)) {
+        std::ostringstream out;
+        out << doubleNode->getValue();
+        return out.str();
+    }
+    if (auto strNode = dynamic_cast<const StringNode*>(node)) {
+        return "\"" + strNode->getValue() + "\"";
+    }
+    if (auto boolNode = dynamic_cast<const BooleanNode*>(node)) {
+        return boolNode->getValue() ? "true" : "false";
+    }
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        return varNode->getName();
+    }
+    if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        // Operators are left associative, so a right operand of equal precedence needs parentheses too
+        const int outer = precedence(binNode->getOp());
+        auto operand = [outer](const ExprNode* child, bool right) {
+            std::string text = describe(child);
+            auto childBin = dynamic_cast<const BinaryExprNode*>(child);
+            if (!childBin) {
+                return text;
+            }
+            const int inner = precedence(childBin->getOp());
+            return inner < outer || (right && inner == outer) ? "(" + text + ")" : text;
+        };
+        return operand(binNode->getLeft().get(), false) + " " + binNode->getOp() + " " + operand(binNode->getRight().get(), true);
+    }
+    if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        const ExprNode* operand = unNode->getOperand().get();
+        std::string text = describe(operand);
+        return unNode->getOp() + (dynamic_cast<const BinaryExprNode*>(operand) ? "(" + text + ")" : text);
+    }
+    if (auto castNode = dynamic_cast<const TypeCastNode*>(node)) {
+        return castNode->getType() + "(" + describe(castNode->getValue().get()) + ")";
+    }
+    if (auto lengthNode = dynamic_cast<const ListLengthNode*>(node)) {
+        return lengthNode->getListName() + ".length()";
+    }
+    if (auto indexNode = dynamic_cast<const ListIndexNode*>(node)) {
+        return indexNode->getListName() + "[" + describe(indexNode->getIndex().get()) + "]";
+    }
+    if (auto sliceNode = dynamic_cast<const ListSliceNode*>(node)) {
+        return sliceNode->getListName() + "[" + describe(sliceNode->getBegin().get()) + ":" + describe(sliceNode->getEnd().get()) + "]";
+    }
+    if (auto appendNode = dynamic_cast<const ListAppendNode*>(node)) {
+        return appendNode->getListName() + ".append(" + describe(appendNode->getValue().get()) + ")";
+    }
+    if (auto popNode = dynamic_cast<const ListPopNode*>(node)) {
+        return popNode->getListName() + ".pop(" + describe(popNode->getIndex().get()) + ")";
+    }
+    if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        return methodNode->getListName() + "." + listMethodToString(methodNode->getMethod()) + "(" + describe(methodNode->getArgument().get()) + ")";
+    }
+    if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        std::string args = describe(mapMethodNode->getKey().get());
+        if (mapMethodNode->getValue()) {
+            args += ", " + describe(mapMethodNode->getValue().get());
+        }
+        return mapMethodNode->getMapName() + "." + mapMethodToString(mapMethodNode->getMethod()) + "(" + args + ")";
+    }
+    if (auto callNode = dynamic_cast<const FunctionCallNode*>(node)) {
+        return callNode->getName() + "(" + describeArguments(callNode->getArgs()) + ")";
+    }
+    if (auto prNode = dynamic_cast<const PrintNode*>(node)) {
+        return "print(" + describe(prNode->getExpression().get()) + ")";
+    }
+    if (auto inNode = dynamic_cast<const InputNode*>(node)) {
+        // The prompt of an input is held by the print node that shows it
+        auto prompt = dynamic_cast<const PrintNode*>(inNode->getExpression().get());
+        return "input(" + describe(prompt ? prompt->getExpression().get() : inNode->getExpression().get()) + ")";
+    }
+    if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+        return assignNode->getName() + " = " + describe(assignNode->getValue().get());
+    }
+    if (auto returnNode = dynamic_cast<const ReturnNode*>(node)) {
+        return "return " + describe(returnNode->getValue().get());
+    }
+    return "...";
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include "AST/AST.h"
+
+/**
+ * @struct ASTHelper
+ * @brief Provides static utility functions for walking, copying, measuring and describing AST nodes.
+ */
+struct ASTHelper {
+    /**
+     * @brief Visits every expression slot owned directly by a node, allowing the child to be replaced.
+     *
+     * Statements of nested blocks (if, else, while and function bodies) are visited as slots of
+     * the owning node. For inlined calls the values of the argument bindings and the body are visited, and for
+     * hoisted loops the hoisted values, the loop and its fallback.
+     *
+     * @param node The node whose children are visited.
+     * @param visit Callback receiving a reference to each owned child pointer.
+     */
+    static void forEachChildSlot(ExprNode* node, const std::function<void(std::unique_ptr<ExprNode>&)>& visit);
+
+    /**
+     * @brief Visits every expression owned directly by a node without modifying it.
+     * @param node The node whose children are visited.
+     * @param visit Callback receiving each child node.
+     */
+    static void forEachChild(const ExprNode* node, const std::function<void(const ExprNode*)>& visit);
+
+    /**
+     * @brief Creates a deep copy of an expression node and all of its children.
+     * @param node The node to copy.
+     * @return A unique pointer to the copy, or nullptr if the node is null.
+     * @throws std::runtime_error if the node type is not supported.
+     */
+    static std::unique_ptr<ExprNode> clone(const ExprNode* node);
+
+    /**
+     * @brief Creates a deep copy of a block node.
+     * @param block The block to copy.
+     * @return A unique pointer to the copy, or nullptr if the block is null.
+     */
+    static std::unique_ptr<BlockNode> cloneBlock(const BlockNode* block);
+
+    /**
+     * @brief Counts the nodes in the subtree rooted at the given node.
+     * @param node The root of the subtree.
+     * @return The number of nodes in the subtree, including the root.
+     */
+    static size_t countNodes(const ExprNode* node);
+
+    /**
+     * @brief Formats an expression or simple statement the way it is written in a script, for reports.
+     * @param node The node to format.
+     * @return The node as text, with "..." standing in for nodes that have no short form, such as blocks.
+     */
+    static std::string describe(const ExprNode* node);
+};
@@ -50,3 +50,7 @@ void Parser::expectEOL() {
 std::unique_ptr<ASTNode> Parser::parse() {
     return StatementParser::parse_statements(*this);
 }
+
+std::unique_ptr<BlockNode> Parser::parseProgram() {
+    return StatementParser::parse_program(*this);
+}
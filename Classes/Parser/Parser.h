@@ -26,9 +26,15 @@ public:
      */
     std::unique_ptr<ASTNode> parse();
 
+    /**
+     * @brief Parses the tokens into the program's top-level block without optimising or executing it.
+     * @return A unique pointer to the block holding the program's statements.
+     */
+    std::unique_ptr<BlockNode> parseProgram();
+
 private:
     const std::vector<Token>& tokens; ///< The vector of tokens to be parsed.
-    const std::unordered_set<std::string> reservedWords = { "if", "else", "while", "print", "input" }; ///< Reserved words in the language.
+    const std::unordered_set<std::string> reservedWords = { "if", "else", "while", "print", "input", "flush" }; ///< Reserved words in the language.
     size_t pos; ///< Current position in the token vector.
     CodeGenerator& codeGen; ///< Reference to the code generator.
 
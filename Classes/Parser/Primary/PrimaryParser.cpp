@@ -3,17 +3,24 @@
 #include <stdexcept>
 #include <Parser/Statement/StatementParser.h>
 #include <Parser/Expression/ExpressionParser.h>
+#include <Value/NumberConversion.h>
 
 std::unique_ptr<ExprNode> PrimaryParser::parse_primary(Parser& parser) {
     Token token = parser.current_token();
 
     if (token.type == TokenType::INTEGER) {
-        int value = std::stoi(token.value);
+        int value;
+        if (NumberConversion::parseInt(token.value, value) != NumberConversion::ParseResult::Ok) {
+            throw std::runtime_error("Syntax Error: Invalid Integer " + token.value + " at line " + std::to_string(token.line));
+        }
         return ExpressionParser::parse_numeric_node<IntegerNode>(parser, token, value);
     }
 
     if (token.type == TokenType::DOUBLE) {
-        double value = std::stod(token.value);
+        double value;
+        if (NumberConversion::parseDouble(token.value, value) != NumberConversion::ParseResult::Ok) {
+            throw std::runtime_error("Syntax Error: Invalid Double " + token.value + " at line " + std::to_string(token.line));
+        }
         return ExpressionParser::parse_numeric_node<DoubleNode>(parser, token, value);
     }
 
@@ -90,6 +97,19 @@ std::unique_ptr<ExprNode> PrimaryParser::handle_assignment(Parser& parser, Token
             }
         }
     }
+    else if (newToken.type == TokenType::IDENTIFIER && newToken.value == "map") {
+        // A map is declared with its key and value types, e.g. map:string:int()
+        parser.advance();
+        parser.expect(TokenType::COLON);
+        Token keyTypeToken = parser.current_token();
+        parser.expect(TokenType::TYPE);
+        parser.expect(TokenType::COLON);
+        Token valueTypeToken = parser.current_token();
+        parser.expect(TokenType::TYPE);
+        parser.expect(TokenType::LPARENTHESIS);
+        parser.expect(TokenType::RPARENTHESIS);
+        return std::make_unique<MapInitNode>(token, identifier, keyTypeToken.value, valueTypeToken.value);
+    }
     else {
         // It's an assignment
         auto value = ExpressionParser::parse_expression(parser);
@@ -100,6 +120,8 @@ std::unique_ptr<ExprNode> PrimaryParser::handle_assignment(Parser& parser, Token
 std::unique_ptr<ExprNode> PrimaryParser::handle_method_access(Parser& parser, Token& token, std::string& identifier) {
     parser.advance();
     Token newToken = parser.current_token();
+    ListMethod method;
+    MapMethod mapMethod;
 
     if (newToken.type == TokenType::IDENTIFIER && newToken.value == "append") {
         parser.advance();
@@ -130,6 +152,31 @@ std::unique_ptr<ExprNode> PrimaryParser::handle_method_access(Parser& parser, To
         parser.expect(TokenType::RPARENTHESIS);
         return std::make_unique<ListReplaceNode>(token, identifier, std::move(index), std::move(value));
     }
+    else if (newToken.type == TokenType::IDENTIFIER && listMethodFromString(newToken.value, method)) {
+        parser.advance();
+        parser.expect(TokenType::LPARENTHESIS);
+        std::unique_ptr<ExprNode> argument;
+        if (listMethodTakesArgument(method)) {
+            argument = ExpressionParser::parse_expression(parser);
+        }
+        parser.expect(TokenType::RPARENTHESIS);
+        return std::make_unique<ListMethodNode>(token, identifier, method, std::move(argument));
+    }
+    else if (newToken.type == TokenType::IDENTIFIER && mapMethodFromString(newToken.value, mapMethod)) {
+        parser.advance();
+        parser.expect(TokenType::LPARENTHESIS);
+        std::unique_ptr<ExprNode> key;
+        std::unique_ptr<ExprNode> value;
+        if (mapMethodArgumentCount(mapMethod) > 0) {
+            key = ExpressionParser::parse_expression(parser);
+        }
+        if (mapMethodArgumentCount(mapMethod) > 1) {
+            parser.expect(TokenType::COMMA);
+            value = ExpressionParser::parse_expression(parser);
+        }
+        parser.expect(TokenType::RPARENTHESIS);
+        return std::make_unique<MapMethodNode>(token, identifier, mapMethod, std::move(key), std::move(value));
+    }
     else {
         std::string line = std::to_string(newToken.line);
         throw std::runtime_error("Syntax Error: Invalid Method " + newToken.value + " at line " + line);
@@ -138,7 +185,20 @@ std::unique_ptr<ExprNode> PrimaryParser::handle_method_access(Parser& parser, To
 
 std::unique_ptr<ExprNode> PrimaryParser::handle_list_index(Parser& parser, Token& token, std::string& identifier) {
     parser.advance();
-    auto index = ExpressionParser::parse_expression(parser);
+    std::unique_ptr<ExprNode> index;
+    if (parser.current_token().type != TokenType::COLON) {
+        index = ExpressionParser::parse_expression(parser);
+    }
+    if (parser.current_token().type == TokenType::COLON) {
+        // A slice, where either bound may be left out
+        parser.advance();
+        std::unique_ptr<ExprNode> end;
+        if (parser.current_token().type != TokenType::RBRACKET) {
+            end = ExpressionParser::parse_expression(parser);
+        }
+        parser.expect(TokenType::RBRACKET);
+        return std::make_unique<ListSliceNode>(token, identifier, std::move(index), std::move(end));
+    }
     parser.expect(TokenType::RBRACKET);
     return std::make_unique<ListIndexNode>(token, identifier, std::move(index));
 }
@@ -166,6 +226,13 @@ std::unique_ptr<ExprNode> PrimaryParser::handle_functions(Parser& parser, std::s
 
             return std::make_unique<PrintNode>(token, std::move(args[0])); // Assuming print takes only one argument
         }
+        else if (identifier == "flush") {
+            if (!args.empty()) {
+                std::string line = std::to_string(token.line);
+                throw std::runtime_error("Syntax Error: Expected 0 Arguments For flush Function at line " + line);
+            }
+            return std::make_unique<FlushNode>(token);
+        }
         else if (identifier == "input") {
             // create a print node to print the value
             check_arguments(args, 1, identifier, token);
@@ -202,9 +269,23 @@ std::unique_ptr<ExprNode> PrimaryParser::parse_function_definition(Parser& parse
 
 std::string PrimaryParser::parse_return_type(Parser& parser) {
     parser.expect(TokenType::COLON);
-    Token returnTypeToken = parser.current_token();
+    return parse_type(parser);
+}
+
+std::string PrimaryParser::parse_type(Parser& parser) {
+    Token typeToken = parser.current_token();
+    if (typeToken.type == TokenType::IDENTIFIER && typeToken.value == "list") {
+        parser.advance();
+        parser.expect(TokenType::COLON);
+        Token elementTypeToken = parser.current_token();
+        parser.expect(TokenType::TYPE);
+        if (elementTypeToken.value == "void") {
+            throw std::runtime_error("Syntax Error: Invalid list type void at line " + std::to_string(elementTypeToken.line));
+        }
+        return "list:" + elementTypeToken.value;
+    }
     parser.expect(TokenType::TYPE);
-    return returnTypeToken.value;
+    return typeToken.value;
 }
 
 std::string PrimaryParser::parse_function_name(Parser& parser) {
@@ -223,9 +304,7 @@ std::vector<std::pair<std::string, std::string>> PrimaryParser::parse_parameters
             std::string paramName = paramNameToken.value;
 
             parser.expect(TokenType::COLON);
-            Token paramTypeToken = parser.current_token();
-            parser.expect(TokenType::TYPE);
-            std::string paramType = paramTypeToken.value;
+            std::string paramType = parse_type(parser);
 
             parameters.emplace_back(paramName, paramType);
 
@@ -50,6 +50,13 @@ private:
      */
     static std::string parse_return_type(Parser& parser);
 
+    /**
+     * @brief Parses a parameter or return type, which is a type name or `list:` followed by an element type.
+     * @param parser The parser to use for parsing the type.
+     * @return The type as a string, e.g. "int" or "list:int".
+     */
+    static std::string parse_type(Parser& parser);
+
     /**
      * @brief Parses the name of a function.
      * @param parser The parser to use for parsing the function name.
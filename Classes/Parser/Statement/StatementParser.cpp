@@ -1,7 +1,29 @@
 #include "StatementParser.h"
 #include <Parser/Expression/ExpressionParser.h>
+#include <Optimizer/Optimizer.h>
 
 std::unique_ptr<ASTNode> StatementParser::parse_statements(Parser& parser) {
+    TraceRecorder* tracer = parser.codeGen.getTracer();
+
+    std::unique_ptr<BlockNode> blockNode;
+    {
+        TraceRecorder::Scope trace(tracer, "Parser", "phase");
+        blockNode = parse_program(parser);
+    }
+    {
+        TraceRecorder::Scope trace(tracer, "Optimizer", "phase");
+        Optimizer optimizer(parser.codeGen.getOptimizerOptions());
+        optimizer.optimize(*blockNode);
+        parser.codeGen.setOptimizerReport(optimizer.getReport());
+    }
+    {
+        TraceRecorder::Scope trace(tracer, "Execute", "phase");
+        parser.codeGen.execute(blockNode.get());
+    }
+    return blockNode;
+}
+
+std::unique_ptr<BlockNode> StatementParser::parse_program(Parser& parser) {
     std::vector<std::unique_ptr<ExprNode>> statements;
     while (parser.current_token().type != TokenType::EOFI) {
         if (parser.current_token().type == TokenType::EOL) {
@@ -11,9 +33,7 @@ std::unique_ptr<ASTNode> StatementParser::parse_statements(Parser& parser) {
         statements.push_back(std::unique_ptr<ExprNode>(dynamic_cast<ExprNode*>(parse_statement(parser).release())));
     }
     const Token blockToken = parser.tokens.front();
-    auto blockNode = std::make_unique<BlockNode>(blockToken, std::move(statements));
-    parser.codeGen.execute(blockNode.get());
-    return blockNode;
+    return std::make_unique<BlockNode>(blockToken, std::move(statements));
 }
 
 std::unique_ptr<ExprNode> StatementParser::parse_statement(Parser& parser) {
@@ -14,6 +14,13 @@ public:
      */
     static std::unique_ptr<ASTNode> parse_statements(Parser& parser);
 
+    /**
+     * @brief Parses all statements into the program's top-level block without optimising or executing it.
+     * @param parser The parser to use for parsing the statements.
+     * @return A unique pointer to the block holding the program's statements.
+     */
+    static std::unique_ptr<BlockNode> parse_program(Parser& parser);
+
     /**
      * @brief Parses a single statement from the input using the given parser.
      * @param parser The parser to use for parsing the statement.
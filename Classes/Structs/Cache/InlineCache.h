@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include "Token/Token.h"
+#include "Value/Value.h"
+#include "Result/Result.h"
+
+/**
+ * @typedef BinaryKernel
+ * @brief A binary operation specialised for one pair of operand types.
+ *
+ * The token supplies the position of errors, which are returned rather than thrown. The operands
+ * are temporaries owned by the caller, so a kernel may move from them.
+ */
+using BinaryKernel = Result<Value> (*)(const Token& token, Value& left, Value& right);
+
+/**
+ * @struct InlineCache
+ * @brief Remembers the operand types a binary operation site saw and the kernel that handles them.
+ *
+ * A site starts empty. When the types of its operands differ from the cached pair, which is
+ * always the case the first time, the operation is a miss: it is dispatched in full and the
+ * cache is pointed at the kernel for the new pair, if there is one. A site that keeps missing
+ * is megamorphic; it stops caching and every later operation is dispatched in full.
+ */
+struct InlineCache {
+    /**
+     * @enum State
+     * @brief The states a site moves through as it sees operand types.
+     */
+    enum class State : uint8_t {
+        EMPTY,          ///< No kernel is cached yet.
+        MONOMORPHIC,    ///< The kernel for one pair of operand types is cached.
+        MEGAMORPHIC     ///< The site missed too often and always dispatches in full.
+    };
+
+    static constexpr uint64_t maxMisses = 4; ///< Misses a site may take before it becomes megamorphic.
+
+    BinaryKernel kernel = nullptr; ///< The cached kernel, valid while the site is monomorphic.
+    uint8_t leftType = 0; ///< The variant index of the cached left operand type.
+    uint8_t rightType = 0; ///< The variant index of the cached right operand type.
+    State state = State::EMPTY; ///< The state of the site.
+    uint64_t hits = 0; ///< Operations performed by the cached kernel.
+    uint64_t misses = 0; ///< Operations that were dispatched in full.
+};
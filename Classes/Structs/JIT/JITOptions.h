@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @struct JITOptions
+ * @brief Holds the settings of the native code generator.
+ */
+struct JITOptions {
+    bool enabled = true; ///< Whether functions and loops over numbers are compiled to x86-64 machine code.
+    size_t threshold = 10; ///< Number of calls after which a function is compiled.
+    size_t loopThreshold = 100; ///< Number of interpreted iterations after which a loop of the program body is compiled and continued natively.
+    bool report = false; ///< Whether the compiled and rejected functions and loops are reported.
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @struct OptimizerOptions
+ * @brief Holds the settings that control which AST optimisations run before execution.
+ */
+struct OptimizerOptions {
+    bool eliminateDeadCode = true; ///< Whether unreachable statements and assignments to variables that are never read are removed.
+    bool reportDeadCode = false; ///< Whether the removed code is reported.
+    bool optimizeSSA = true; ///< Whether the program is lowered to SSA form for constant and copy propagation, value numbering and dead store removal.
+    bool dumpIR = false; ///< Whether the optimised SSA form of every function is printed.
+    bool inlineFunctions = true; ///< Whether small, non-recursive functions are expanded at their call sites.
+    size_t inlineThreshold = 24; ///< Maximum number of nodes in a function's return expression for it to be inlined.
+    bool specializeTypes = true; ///< Whether binary operations on operands of proven types are replaced by type-specialised nodes.
+    bool hoistInvariants = true; ///< Whether loop-invariant expressions are computed once in front of their while loop.
+    bool reportHoisting = false; ///< Whether the expressions moved out of loops are reported.
+    bool fuseStatements = true; ///< Whether common statement shapes such as `i = i + 1` are replaced by fused nodes.
+};
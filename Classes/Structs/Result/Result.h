@@ -0,0 +1,124 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @struct RuntimeError
+ * @brief An error raised while a program runs.
+ *
+ * The message is the text reported to the user, which names the line wherever its format always did.
+ */
+struct RuntimeError {
+    std::string message; ///< The text reported to the user.
+};
+
+/**
+ * @class Result
+ * @brief The value of an operation that can fail, or the error it failed with.
+ *
+ * The runtime returns errors instead of throwing them, so evaluating a program needs no
+ * unwinding tables or landing pads. A caller checks ok() and hands a failed result on to its
+ * own caller, until CodeGenerator::execute reports the error. The error is held out of line,
+ * so a successful result costs its value and a null pointer.
+ *
+ * @tparam T The type of the value.
+ */
+template <typename T>
+class [[nodiscard]] Result {
+public:
+    /**
+     * @brief Creates a successful result.
+     * @param value The value, or anything the value can be constructed from.
+     */
+    template <typename U = T, typename = std::enable_if_t<std::is_constructible_v<T, U&&>
+        && !std::is_same_v<std::decay_t<U>, RuntimeError> && !std::is_same_v<std::decay_t<U>, Result>>>
+    Result(U&& value) : value(std::forward<U>(value)) {}
+
+    /**
+     * @brief Creates a failed result.
+     * @param error The error.
+     */
+    Result(RuntimeError error) : error(std::make_unique<RuntimeError>(std::move(error))) {}
+
+    /**
+     * @brief Converts the result of an operation with another value type, such as a conversion to int.
+     * @param other The result, which is moved from.
+     */
+    template <typename U, typename = std::enable_if_t<!std::is_same_v<U, T> && std::is_constructible_v<T, U&&>>>
+    Result(Result<U>&& other) : error(std::move(other.error)) {
+        if (!error) {
+            value = T(std::move(other.value));
+        }
+    }
+
+    /**
+     * @return True if the operation succeeded.
+     */
+    bool ok() const { return !error; }
+
+    /**
+     * @name Value access
+     * The value of a successful result.
+     * @{
+     */
+    T& operator*() { return value; }
+    const T& operator*() const { return value; }
+    T* operator->() { return &value; }
+    const T* operator->() const { return &value; }
+    /** @} */
+
+    /**
+     * @name Error access
+     * The error of a failed result. takeError moves it out, to be returned as a result of another type.
+     * @{
+     */
+    RuntimeError& getError() { return *error; }
+    const RuntimeError& getError() const { return *error; }
+    RuntimeError takeError() { return std::move(*error); }
+    /** @} */
+
+private:
+    T value{}; ///< The value, meaningful if there is no error.
+    std::unique_ptr<RuntimeError> error; ///< The error, or null if the operation succeeded.
+
+    template <typename> friend class Result;
+};
+
+/**
+ * @class Result<void>
+ * @brief The outcome of an operation that can fail and has no value.
+ */
+template <>
+class [[nodiscard]] Result<void> {
+public:
+    /**
+     * @brief Creates a successful result.
+     */
+    Result() = default;
+
+    /**
+     * @brief Creates a failed result.
+     * @param error The error.
+     */
+    Result(RuntimeError error) : error(std::make_unique<RuntimeError>(std::move(error))) {}
+
+    /**
+     * @return True if the operation succeeded.
+     */
+    bool ok() const { return !error; }
+
+    /**
+     * @name Error access
+     * The error of a failed result. takeError moves it out, to be returned as a result of another type.
+     * @{
+     */
+    RuntimeError& getError() { return *error; }
+    const RuntimeError& getError() const { return *error; }
+    RuntimeError takeError() { return std::move(*error); }
+    /** @} */
+
+private:
+    std::unique_ptr<RuntimeError> error; ///< The error, or null if the operation succeeded.
+};
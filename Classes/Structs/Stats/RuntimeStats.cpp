@@ -0,0 +1,26 @@
+#include "RuntimeStats.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+std::string RuntimeStats::report() const {
+    std::ostringstream out;
+    out << "Runtime statistics\n";
+
+    // Node kinds are listed by descending count
+    std::vector<std::pair<std::string, uint64_t>> kinds(nodesByKind.begin(), nodesByKind.end());
+    std::stable_sort(kinds.begin(), kinds.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    out << "Nodes evaluated: " << nodesEvaluated() << "\n";
+    for (const auto& kind : kinds) {
+        out << std::setw(24) << kind.first << std::setw(14) << kind.second << "\n";
+    }
+
+    out << "Variable lookups: " << localHits << " local hits, " << globalHits << " global hits, "
+        << globalFallbacks << " global fallbacks, " << lookupMisses << " misses\n";
+    out << "Function calls: " << functionCalls << " (max depth " << maxCallDepth << ")\n";
+    out << "List appends: " << vectorGrowths << " (" << vectorReallocations << " reallocations)\n";
+    out << "Value copies: " << stringCopies << " strings, " << listCopies << " lists\n";
+    out << "Allocations: " << allocations << " (" << bytesAllocated << " bytes)\n";
+    return out.str();
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "Value/Value.h"
+
+/**
+ * @struct RuntimeStats
+ * @brief Holds the counters the interpreter maintains while statistics are enabled.
+ *
+ * The counters accumulate over every execution of the code generator they belong to.
+ */
+struct RuntimeStats {
+    std::map<std::string, uint64_t> nodesByKind; ///< Number of evaluated nodes per AST node class.
+
+    uint64_t localHits = 0; ///< Variable reads found in the current function's scope.
+    uint64_t globalHits = 0; ///< Variable reads at top level found in the global scope.
+    uint64_t globalFallbacks = 0; ///< Variable reads inside a function that fell back to the global scope.
+    uint64_t lookupMisses = 0; ///< Variable and list reads of undefined names.
+
+    uint64_t functionCalls = 0; ///< Number of user function calls.
+    size_t maxCallDepth = 0; ///< Deepest nesting of active function calls.
+
+    uint64_t vectorGrowths = 0; ///< Number of elements appended to lists.
+    uint64_t vectorReallocations = 0; ///< Appends that had to reallocate the list's storage.
+
+    uint64_t stringCopies = 0; ///< String values copied out of or into variables and lists.
+    uint64_t listCopies = 0; ///< List handles copied out of or into variables.
+
+    uint64_t allocations = 0; ///< Heap allocations made while executing.
+    uint64_t bytesAllocated = 0; ///< Bytes requested by those allocations.
+
+    /**
+     * @brief Counts a copy of a value if it is a string or a list.
+     * @param value The value that was copied.
+     */
+    void countCopy(const Value& value) {
+        if (std::holds_alternative<std::string>(value)) {
+            stringCopies++;
+        }
+        else if (std::holds_alternative<std::shared_ptr<TypedVector>>(value)) {
+            listCopies++;
+        }
+    }
+
+    /**
+     * @brief Gets the total number of evaluated nodes.
+     * @return The sum of the per-kind node counts.
+     */
+    uint64_t nodesEvaluated() const {
+        uint64_t total = 0;
+        for (const auto& kind : nodesByKind) {
+            total += kind.second;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Builds a text report of all counters.
+     * @return The report.
+     */
+    std::string report() const;
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @struct NumberConversion
+ * @brief Provides locale-independent conversions between numbers and text using std::to_chars and std::from_chars.
+ *
+ * Doubles are written in the shortest form that reads back to the same value. Whole doubles keep a
+ * trailing ".0" so they can still be told apart from integers when printed.
+ */
+struct NumberConversion {
+    /**
+     * @brief The size of a character buffer large enough for any formatted int or double.
+     */
+    static constexpr size_t maxLength = 32;
+
+    /**
+     * @enum ParseResult
+     * @brief The outcome of parsing a number from text.
+     */
+    enum class ParseResult {
+        Ok,         ///< A number was parsed.
+        Invalid,    ///< The text does not start with a number.
+        OutOfRange  ///< The number does not fit in the target type.
+    };
+
+    /**
+     * @brief Formats an integer into a character buffer.
+     * @param first Start of the buffer, which must hold at least maxLength characters.
+     * @param value The integer to format.
+     * @return Pointer one past the last character written.
+     */
+    static char* formatInt(char* first, int value) {
+        return std::to_chars(first, first + maxLength, value).ptr;
+    }
+
+    /**
+     * @brief Formats a double into a character buffer using the shortest round-trip representation.
+     * @param first Start of the buffer, which must hold at least maxLength characters.
+     * @param value The double to format.
+     * @return Pointer one past the last character written.
+     */
+    static char* formatDouble(char* first, double value) {
+        char* last = std::to_chars(first, first + maxLength - 2, value).ptr;
+        if (std::isfinite(value) && std::string_view(first, last - first).find_first_of(".e") == std::string_view::npos) {
+            *last++ = '.';
+            *last++ = '0';
+        }
+        return last;
+    }
+
+    /**
+     * @brief Converts an integer to a string.
+     * @param value The integer to convert.
+     * @return The decimal representation of the integer.
+     */
+    static std::string toString(int value) {
+        char buffer[maxLength];
+        return std::string(buffer, formatInt(buffer, value));
+    }
+
+    /**
+     * @brief Converts a double to a string using the shortest round-trip representation.
+     * @param value The double to convert.
+     * @return The representation of the double.
+     */
+    static std::string toString(double value) {
+        char buffer[maxLength];
+        return std::string(buffer, formatDouble(buffer, value));
+    }
+
+    /**
+     * @brief Parses an integer from the start of the text.
+     *
+     * Leading whitespace and a leading '+' are accepted and any characters after the number are ignored.
+     *
+     * @param text The text to parse.
+     * @param value Receives the parsed integer on success.
+     * @return The outcome of the parse.
+     */
+    static ParseResult parseInt(std::string_view text, int& value) {
+        text = trimStart(text);
+        return toParseResult(std::from_chars(text.data(), text.data() + text.size(), value).ec);
+    }
+
+    /**
+     * @brief Parses a double from the start of the text.
+     *
+     * Leading whitespace and a leading '+' are accepted and any characters after the number are ignored.
+     * Like std::stod, hexadecimal numbers with a "0x" or "0X" prefix are accepted, such as "0x1A" or "-0x1.8p3".
+     *
+     * @param text The text to parse.
+     * @param value Receives the parsed double on success.
+     * @return The outcome of the parse.
+     */
+    static ParseResult parseDouble(std::string_view text, double& value) {
+        text = trimStart(text);
+        // std::from_chars reads hexadecimal numbers only without their prefix
+        const bool negative = !text.empty() && text[0] == '-';
+        const std::string_view digits = text.substr(negative ? 1 : 0);
+        if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')
+            && (std::isxdigit(static_cast<unsigned char>(digits[2])) || digits[2] == '.')) {
+            double magnitude;
+            const std::errc error = std::from_chars(digits.data() + 2, digits.data() + digits.size(), magnitude, std::chars_format::hex).ec;
+            // Without hex digits, such as in "0x.", only the leading 0 is a number
+            if (error == std::errc()) {
+                value = negative ? -magnitude : magnitude;
+            }
+            if (error != std::errc::invalid_argument) {
+                return toParseResult(error);
+            }
+        }
+        return toParseResult(std::from_chars(text.data(), text.data() + text.size(), value).ec);
+    }
+
+private:
+    // Skips leading whitespace and a '+' sign, which std::from_chars does not accept
+    static std::string_view trimStart(std::string_view text) {
+        size_t start = 0;
+        while (start < text.size() && std::isspace(static_cast<unsigned char>(text[start]))) {
+            ++start;
+        }
+        if (start + 1 < text.size() && text[start] == '+' && text[start + 1] != '-') {
+            ++start;
+        }
+        return text.substr(start);
+    }
+
+    static ParseResult toParseResult(std::errc error) {
+        if (error == std::errc()) return ParseResult::Ok;
+        if (error == std::errc::result_out_of_range) return ParseResult::OutOfRange;
+        return ParseResult::Invalid;
+    }
+};
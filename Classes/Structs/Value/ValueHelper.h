@@ -1,9 +1,11 @@
 #pragma once
 #include <variant>
-#include <stdexcept>
 #include <string>
 #include <vector>
 #include "TypedVector/TypedVector.h"
+#include "TypedMap/TypedMap.h"
+#include "NumberConversion.h"
+#include "Result/Result.h"
 #include <cmath> 
 
 /**
@@ -56,98 +58,70 @@ struct ValueHelper {
         return std::holds_alternative<std::shared_ptr<TypedVector>>(value);
     }
 
+    /**
+     * @brief Checks if the value is a map.
+     * @param value The value to check.
+     * @return True if the value is a map, false otherwise.
+     */
+    static bool isMap(const Value& value) {
+        return std::holds_alternative<std::shared_ptr<TypedMap>>(value);
+    }
+
     /**
      * @brief Converts the value to an integer.
-     * @param value The value to convert.
-     * @return The integer value.
-     * @throws std::runtime_error if the value is not an integer or cannot be converted to an integer.
-     */
-    static int asInt(const Value& value) {
-        if (!isInt(value)) {
-            // Check if the value is a double and try to convert it to an int
-            try {
-                if (isString(value) || isDouble(value)) {
-                    double doubleValue;
-                    if (isString(value)) {
-                        // Try to convert the string to an double
-                        doubleValue = asDouble(value);
-                    }
-                    else {
-						doubleValue = asDouble(value);
-					}
-
-                    if (doubleValue != std::floor(doubleValue)) { // Check if double has a fractional part
-                        throw std::runtime_error("Value is a double with a fractional part");
-                    }
-                    return static_cast<int>(doubleValue);
-                }
-                else if (isBool(value)) {
-                    return std::get<bool>(value) ? 1 : 0;
-                }
-            }
-            catch (const std::runtime_error& e) {
-				// Handle runtime_error exceptions by rethrowing them
-				throw;
-			}
-            catch (const std::bad_variant_access&) {
-                // Handle bad_variant_access exceptions by throwing a runtime_error
-                throw std::runtime_error("Value is not an integer");
+     * @param value The value to convert: an int, a bool, a whole double or a string holding a whole number.
+     * @return The integer value, or an error if the value cannot be converted to an integer.
+     */
+    static Result<int> asInt(const Value& value) {
+        if (isInt(value)) {
+            return std::get<int>(value);
+        }
+        if (isBool(value)) {
+            return std::get<bool>(value) ? 1 : 0;
+        }
+        if (isString(value) || isDouble(value)) {
+            // A string is converted like a double, and fails with that conversion's error
+            Result<double> doubleValue = asDouble(value);
+            if (!doubleValue.ok()) {
+                return doubleValue.takeError();
             }
-            // error fomr std::stoi
-            catch (const std::invalid_argument& e) {
-                throw std::runtime_error("Value is not an integer");
+            if (*doubleValue != std::floor(*doubleValue)) { // Check if double has a fractional part
+                return RuntimeError{ "Value is a double with a fractional part" };
             }
-            catch (const std::exception& e) {
-				// Handle other standard exceptions
-				throw std::runtime_error(std::string("An error occurred: ") + e.what());
-			}
-            throw std::runtime_error("Value is not an integer");
-        }
-        else {
-            // If it's already an integer, return it as is
-            return std::get<int>(value);
+            return static_cast<int>(*doubleValue);
         }
+        return RuntimeError{ "Value is not an integer" };
     }
 
     /**
      * @brief Converts the value to a double.
      * @param value The value to convert.
-     * @return The double value.
-     * @throws std::runtime_error if the value is not a double.
-     */
-    static double asDouble(const Value& value) {
-        try {
-            // Check if the value is an integer and try to convert it to a double
-            if (!isDouble(value)) {
-                // check if it's a string and try to convert it to a double
-                if (isString(value)) {
-					return std::stod(std::get<std::string>(value));
-                }
-                else if (isInt(value)) {
-					return static_cast<double>(std::get<int>(value));
-				}
-                else if (isBool(value)) {
-					return std::get<bool>(value) ? 1.0 : 0.0;
-				}
-            }
-            else {
-                // If it's already a double, return it as is
-                return std::get<double>(value);
-            }
+     * @return The double value, or an error if the value is not a number, a bool or a string holding a number.
+     */
+    static Result<double> asDouble(const Value& value) {
+        if (isDouble(value)) {
+            // If it's already a double, return it as is
+            return std::get<double>(value);
         }
-        catch (const std::bad_variant_access&) {
-            // Handle bad_variant_access exceptions by throwing a runtime_error
-            throw std::runtime_error("Value is not a double or integer");
+        if (isInt(value)) {
+            return static_cast<double>(std::get<int>(value));
         }
-        catch (const std::invalid_argument& e) {
-            throw std::runtime_error("Value is not an double or integer");
+        if (isBool(value)) {
+            return std::get<bool>(value) ? 1.0 : 0.0;
         }
-        catch (const std::exception& e) {
-            // Handle other standard exceptions
-            throw std::runtime_error(std::string("An error occurred: ") + e.what());
+        if (isString(value)) {
+            // Parse the string without locale lookups or exceptions
+            double result;
+            switch (NumberConversion::parseDouble(std::get<std::string>(value), result)) {
+                case NumberConversion::ParseResult::Ok:
+                    return result;
+                case NumberConversion::ParseResult::OutOfRange:
+                    return RuntimeError{ "Value is out of range for a double" };
+                default:
+                    return RuntimeError{ "Value is not an double or integer" };
+            }
         }
-        
-        return std::get<double>(value);
+        return RuntimeError{ "Value is not a double or integer" };
     }
 
     /**
@@ -156,74 +130,103 @@ struct ValueHelper {
      * @return The string representation of the value.
      */
     static std::string asString(const Value& value) {
-        // Static empty string to return in case of errors or empty values
-        static const std::string emptyString = "";
-
-        try {
-            // Check if the value is already a string
-            if (std::holds_alternative<std::string>(value)) {
-                return std::get<std::string>(value);
-            }
+        // Check if the value is already a string
+        if (std::holds_alternative<std::string>(value)) {
+            return std::get<std::string>(value);
+        }
 
-            // Convert int or double to string
-            if (std::holds_alternative<int>(value)) {
-                return std::to_string(asInt(value));
-            }
-            else if (std::holds_alternative<double>(value)) {
-                return std::to_string(asDouble(value));
-            }
-            else if (std::holds_alternative<bool>(value)) {
-                return std::get<bool>(value) ? "true" : "false";
-            }
+        // Convert int or double to string
+        if (std::holds_alternative<int>(value)) {
+            return NumberConversion::toString(std::get<int>(value));
         }
-        catch (const std::bad_variant_access&) {
-            // Handle bad_variant_access exceptions by returning an empty string
+        else if (std::holds_alternative<double>(value)) {
+            return NumberConversion::toString(std::get<double>(value));
         }
-        catch (const std::length_error&) {
-            // Handle length_error exceptions by returning an empty string
+        else if (std::holds_alternative<bool>(value)) {
+            return std::get<bool>(value) ? "true" : "false";
         }
 
-        // Return empty string if value is neither int, double, nor string, or if an exception occurs
-        return emptyString;
+        // Return empty string if value is neither int, double, bool nor string
+        return std::string();
+    }
+
+    /**
+     * @brief Appends the string representation of a value to an existing string.
+     *
+     * Numbers are formatted straight into the target, so no temporary string is created and the
+     * target's capacity grows geometrically, making repeated appends amortised O(1).
+     *
+     * @param target The string to append to.
+     * @param value The value to append, converted as by asString.
+     */
+    static void appendString(std::string& target, const Value& value) {
+        if (std::holds_alternative<std::string>(value)) {
+            target += std::get<std::string>(value);
+        }
+        else if (std::holds_alternative<int>(value) || std::holds_alternative<double>(value)) {
+            char buffer[NumberConversion::maxLength];
+            char* last = std::holds_alternative<int>(value)
+                ? NumberConversion::formatInt(buffer, std::get<int>(value))
+                : NumberConversion::formatDouble(buffer, std::get<double>(value));
+            target.append(buffer, last);
+        }
+        else if (std::holds_alternative<bool>(value)) {
+            target += std::get<bool>(value) ? "true" : "false";
+        }
     }
 
     /**
      * @brief Converts the value to a boolean.
      * @param value The value to convert.
-     * @return The boolean value.
-     * @throws std::runtime_error if the value is not a boolean.
+     * @return The boolean value, or an error if the value is not a boolean.
      */
-    static bool asBool(const Value& value) {
-        if (!isBool(value)) throw std::runtime_error("Value is not a bool");
+    static Result<bool> asBool(const Value& value) {
+        if (!isBool(value)) {
+            return RuntimeError{ "Value is not a bool" };
+        }
         return std::get<bool>(value);
     }
 
     /**
-     * @brief Converts the value to a vector (non-const version).
-     * @param value The value to convert.
+     * @brief Gets the vector a value holds (non-const version).
+     * @param value The value, which must be a vector, as isVector checks.
      * @return A reference to the vector.
-     * @throws std::runtime_error if the value is not a vector.
      */
     static std::shared_ptr<TypedVector>& asVector(Value& value) {
-        if (!isVector(value)) {
-            throw std::runtime_error("Value is not a vector");
-        }
         return std::get<std::shared_ptr<TypedVector>>(value);
     }
 
     /**
-     * @brief Converts the value to a vector (const version).
-     * @param value The value to convert.
+     * @brief Gets the vector a value holds (const version).
+     * @param value The value, which must be a vector, as isVector checks.
      * @return A const reference to the vector.
-     * @throws std::runtime_error if the value is not a vector.
      */
     static const std::shared_ptr<TypedVector>& asVector(const Value& value) {
-        if (!isVector(value)) {
-            throw std::runtime_error("Value is not a vector");
-        }
         return std::get<std::shared_ptr<TypedVector>>(value);
     }
 
+    /**
+     * @brief Gets the map a value holds.
+     * @param value The value, which must be a map, as isMap checks.
+     * @return A const reference to the map.
+     */
+    static const std::shared_ptr<TypedMap>& asMap(const Value& value) {
+        return std::get<std::shared_ptr<TypedMap>>(value);
+    }
+
+    /**
+     * @brief Checks whether a value has a declared parameter or return type.
+     * @param value The value to check.
+     * @param type The declared type, such as "int" or "list:int".
+     * @return True if the value has the type; a list type also requires a matching element type.
+     */
+    static bool hasType(const Value& value, const std::string& type) {
+        if (type.compare(0, 5, "list:") == 0) {
+            return isVector(value) && std::get<std::shared_ptr<TypedVector>>(value)->getElementType() == type.substr(5);
+        }
+        return ValueHelper::type(value) == type;
+    }
+
     /**
      * @brief Gets the type of the value as a string.
      * @param value The value whose type is to be determined.
@@ -235,6 +238,7 @@ struct ValueHelper {
         if (isString(value)) return "string";
         if (isBool(value)) return "bool";
         if (isVector(value)) return "vector";
+        if (isMap(value)) return "map";
         return "null";
     }
 };
@@ -0,0 +1,936 @@
+#include "CppTranspiler.h"
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+#include "Optimizer/Utility/ASTHelper.h"
+
+namespace {
+    // Checks whether an assignment has the form `name = name + a + b ...`, which the interpreter appends in place to a string
+    bool isAppendTo(const ExprNode* node, const std::string& name) {
+        if (!dynamic_cast<const BinaryExprNode*>(node)) {
+            return false;
+        }
+        while (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+            if (binNode->getToken().type != TokenType::ARITHMETIC || binNode->getOp() != "+") {
+                return false;
+            }
+            node = binNode->getLeft().get();
+        }
+        auto varNode = dynamic_cast<const VariableNode*>(node);
+        return varNode && varNode->getName() == name;
+    }
+
+    const char* listMethodName(ListMethod method) {
+        switch (method) {
+            case ListMethod::SUM: return "ListMethod::SUM";
+            case ListMethod::MIN: return "ListMethod::MIN";
+            case ListMethod::MAX: return "ListMethod::MAX";
+            case ListMethod::SORT: return "ListMethod::SORT";
+            case ListMethod::CONTAINS: return "ListMethod::CONTAINS";
+            case ListMethod::INDEX: return "ListMethod::INDEX";
+            case ListMethod::EXTEND: return "ListMethod::EXTEND";
+            case ListMethod::REVERSE: return "ListMethod::REVERSE";
+        }
+        return "";
+    }
+
+    const char* mapMethodName(MapMethod method) {
+        switch (method) {
+            case MapMethod::GET: return "MapMethod::GET";
+            case MapMethod::SET: return "MapMethod::SET";
+            case MapMethod::REMOVE: return "MapMethod::REMOVE";
+            case MapMethod::KEYS: return "MapMethod::KEYS";
+            case MapMethod::VALUES: return "MapMethod::VALUES";
+        }
+        return "";
+    }
+}
+
+std::string CppTranspiler::transpile(const BlockNode* program) {
+    collect(program);
+
+    std::string functions;
+    for (const FunctionDefNode* definition : definitions) {
+        functions += translateFunction(definition);
+    }
+
+    function = nullptr;
+    locals.clear();
+    code.clear();
+    indent = 1;
+    lowerBlock(program);
+
+    std::ostringstream out;
+    out << "// Generated by CPulse --emit-cpp\n";
+    out << "// Build it against the cpulse_runtime library, with Classes, Classes/Enums and Classes/Structs on the include path.\n";
+    out << "#include <limits>\n#include <stdexcept>\n#include <variant>\n#include <vector>\n#include \"Transpiler/ScriptRuntime.h\"\n\n";
+    out << "namespace {\n";
+    for (const std::string& name : globals) {
+        out << "ScriptVariable " << identifier("g_", name) << ";\n";
+    }
+    for (const std::string& name : functionNames) {
+        out << "const ScriptFunction* " << identifier("f_", name) << " = nullptr;\n";
+    }
+    out << "\n";
+
+    for (size_t i = 0; i < definitions.size(); i++) {
+        out << "Value function_" << i << "(std::vector<Value>& arguments, OutputBuffer& output);\n";
+    }
+    for (size_t i = 0; i < definitions.size(); i++) {
+        const FunctionDefNode* definition = definitions[i];
+        std::string parameters;
+        for (const auto& parameter : definition->getParameters()) {
+            parameters += (parameters.empty() ? "" : ", ") + std::string("Parameter(") + quote(parameter.first) + ", " + quote(parameter.second) + ")";
+        }
+        const std::string head = "{ " + quote(definition->getName()) + ", " + quote(definition->getReturnType()) + ", { " + parameters + " }, ";
+        out << "const ScriptFunction definition_" << i << " = " << head << "function_" << i << " };\n";
+        out << "const ScriptFunction emptied_" << i << " = " << head << "ScriptRuntime::emptyBody };\n";
+        out << "bool executed_" << i << " = false;\n";
+    }
+    out << "\n" << functions;
+    out << "void program(OutputBuffer& output) {\n" << code << "}\n";
+    out << "}\n\n";
+    out << "int main() {\n    OutputBuffer output;\n    return ScriptRuntime::run(program, output);\n}\n";
+    return out.str();
+}
+
+void CppTranspiler::collect(const ExprNode* node) {
+    if (!node) {
+        return;
+    }
+
+    if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        globals.insert(varNode->getName());
+    }
+    else if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+        globals.insert(assignNode->getName());
+    }
+    else if (auto listNode = dynamic_cast<const ListInitNode*>(node)) {
+        globals.insert(listNode->getName());
+    }
+    else if (auto appendNode = dynamic_cast<const ListAppendNode*>(node)) {
+        globals.insert(appendNode->getListName());
+    }
+    else if (auto popNode = dynamic_cast<const ListPopNode*>(node)) {
+        globals.insert(popNode->getListName());
+    }
+    else if (auto lengthNode = dynamic_cast<const ListLengthNode*>(node)) {
+        globals.insert(lengthNode->getListName());
+    }
+    else if (auto indexNode = dynamic_cast<const ListIndexNode*>(node)) {
+        globals.insert(indexNode->getListName());
+    }
+    else if (auto sliceNode = dynamic_cast<const ListSliceNode*>(node)) {
+        globals.insert(sliceNode->getListName());
+    }
+    else if (auto replaceNode = dynamic_cast<const ListReplaceNode*>(node)) {
+        globals.insert(replaceNode->getListName());
+    }
+    else if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        globals.insert(methodNode->getListName());
+    }
+    else if (auto mapNode = dynamic_cast<const MapInitNode*>(node)) {
+        globals.insert(mapNode->getName());
+    }
+    else if (auto mapMethodNode = dynamic_cast<const MapMethodNode*>(node)) {
+        globals.insert(mapMethodNode->getMapName());
+    }
+    else if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        for (const auto& binding : inlinedNode->getBindings()) {
+            globals.insert(binding->getName());
+        }
+    }
+    else if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+        for (const auto& assignment : hoistedNode->getHoisted()) {
+            globals.insert(assignment->getName());
+        }
+    }
+    else if (auto callNode = dynamic_cast<const FunctionCallNode*>(node)) {
+        functionNames.insert(callNode->getName());
+    }
+    else if (auto definition = dynamic_cast<const FunctionDefNode*>(node)) {
+        definitionNumbers[definition] = definitions.size();
+        definitions.push_back(definition);
+        functionNames.insert(definition->getName());
+        // Locals are read with a fallback to the global of the same name, so parameters have one too
+        for (const auto& parameter : definition->getParameters()) {
+            globals.insert(parameter.first);
+        }
+    }
+
+    ASTHelper::forEachChild(node, [this](const ExprNode* child) {
+        collect(child);
+    });
+}
+
+bool CppTranspiler::collectLocals(const ExprNode* node, std::set<std::string>& names) {
+    if (!node || dynamic_cast<const FunctionDefNode*>(node)) {
+        return false;
+    }
+
+    bool hasReturn = dynamic_cast<const ReturnNode*>(node) != nullptr;
+    if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+        names.insert(assignNode->getName());
+    }
+    else if (auto listNode = dynamic_cast<const ListInitNode*>(node)) {
+        names.insert(listNode->getName());
+    }
+    else if (auto mapNode = dynamic_cast<const MapInitNode*>(node)) {
+        names.insert(mapNode->getName());
+    }
+    else if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        for (const auto& binding : inlinedNode->getBindings()) {
+            names.insert(binding->getName());
+        }
+    }
+    else if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+        for (const auto& assignment : hoistedNode->getHoisted()) {
+            names.insert(assignment->getName());
+        }
+    }
+
+    ASTHelper::forEachChild(node, [&names, &hasReturn](const ExprNode* child) {
+        hasReturn = collectLocals(child, names) || hasReturn;
+    });
+    return hasReturn;
+}
+
+std::string CppTranspiler::translateFunction(const FunctionDefNode* definition) {
+    function = definition;
+    locals.clear();
+    for (const auto& parameter : definition->getParameters()) {
+        locals.insert(parameter.first);
+    }
+    // Nested blocks are statements of the body, so the whole body is one subtree
+    bool hasReturn = false;
+    for (const auto& statement : definition->getBody()->getStatements()) {
+        hasReturn = collectLocals(statement.get(), locals) || hasReturn;
+    }
+
+    code.clear();
+    indent = 1;
+    for (const std::string& name : locals) {
+        line("ScriptVariable " + identifier("l_", name) + ";");
+    }
+    const auto& parameters = definition->getParameters();
+    for (size_t i = 0; i < parameters.size(); i++) {
+        line(identifier("l_", parameters[i].first) + ".assign(std::move(arguments[" + std::to_string(i) + "]));");
+    }
+    if (hasReturn) {
+        line("bool returned = false;");
+    }
+    line("Value returnValue;");
+    lowerBlock(definition->getBody().get());
+    line("return returnValue;");
+
+    const size_t number = definitionNumbers.at(definition);
+    return "// " + definition->getName() + " at line " + std::to_string(definition->getToken().line) + "\n"
+        + "Value function_" + std::to_string(number) + "(std::vector<Value>& arguments, OutputBuffer& output) {\n" + code + "}\n\n";
+}
+
+void CppTranspiler::line(const std::string& text) {
+    code.append(static_cast<size_t>(indent) * 4, ' ');
+    code += text;
+    code += '\n';
+}
+
+std::string CppTranspiler::temp(CppType type, const std::string& expression) {
+    std::string name = "t" + std::to_string(temps++);
+    line(typeName(type) + " " + name + " = " + expression + ";");
+    return name;
+}
+
+std::string CppTranspiler::typeName(CppType type) {
+    switch (type) {
+        case CppType::INT: return "int";
+        case CppType::DOUBLE: return "double";
+        case CppType::BOOL: return "bool";
+        default: return "Value";
+    }
+}
+
+std::string CppTranspiler::identifier(const std::string& prefix, const std::string& name) {
+    std::string result = prefix;
+    for (char c : name) {
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+            result += c;
+        }
+        else {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "_x%02X", static_cast<unsigned char>(c));
+            result += escaped;
+        }
+    }
+    return result;
+}
+
+std::string CppTranspiler::quote(const std::string& text) {
+    std::string result = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            case '\r': result += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20 || c == 0x7F) {
+                    // Octal escapes end after three digits, so a following digit cannot extend them
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\%03o", static_cast<unsigned char>(c));
+                    result += escaped;
+                }
+                else {
+                    result += c;
+                }
+        }
+    }
+    return result + "\"";
+}
+
+std::string CppTranspiler::tokenType(const Token& token) {
+    switch (token.type) {
+        case TokenType::ARITHMETIC: return "TokenType::ARITHMETIC";
+        case TokenType::COMPARISON: return "TokenType::COMPARISON";
+        case TokenType::LOGICAL: return "TokenType::LOGICAL";
+        default: return "";
+    }
+}
+
+std::string CppTranspiler::asValue(const Operand& operand) {
+    switch (operand.type) {
+        case CppType::NONE: return "Value(std::monostate())";
+        case CppType::VALUE: return operand.code;
+        default: return "Value(" + operand.code + ")";
+    }
+}
+
+std::string CppTranspiler::asInt(const Operand& operand) {
+    return operand.type == CppType::INT ? operand.code : "std::get<int>(" + asValue(operand) + ")";
+}
+
+std::string CppTranspiler::asNumber(const Operand& operand) {
+    switch (operand.type) {
+        case CppType::INT: return "static_cast<double>(" + operand.code + ")";
+        case CppType::DOUBLE: return operand.code;
+        default: return "ScriptRuntime::asNumber(" + asValue(operand) + ")";
+    }
+}
+
+std::string CppTranspiler::asBool(const Operand& operand) {
+    return operand.type == CppType::BOOL ? operand.code : "std::get<bool>(" + asValue(operand) + ")";
+}
+
+std::string CppTranspiler::asString(const Operand& operand) {
+    return "std::get<std::string>(" + asValue(operand) + ")";
+}
+
+std::string CppTranspiler::asCondition(const Operand& operand) {
+    return operand.type == CppType::BOOL ? operand.code : "ScriptRuntime::asBool(" + asValue(operand) + ")";
+}
+
+std::string CppTranspiler::asIndex(const Operand& operand) {
+    return operand.type == CppType::INT ? operand.code : "ScriptRuntime::asInt(" + asValue(operand) + ")";
+}
+
+bool CppTranspiler::isLocal(const std::string& name) const {
+    return function && locals.count(name);
+}
+
+std::string CppTranspiler::scopeVariable(const std::string& name) const {
+    // Assignments and declarations in a function always write its own scope
+    return identifier(function ? "l_" : "g_", name);
+}
+
+std::string CppTranspiler::readVariable(const std::string& name) const {
+    if (isLocal(name)) {
+        return "ScriptRuntime::read(" + identifier("l_", name) + ", " + identifier("g_", name) + ", " + quote(name) + ")";
+    }
+    return "ScriptRuntime::read(" + identifier("g_", name) + ", " + quote(name) + ")";
+}
+
+std::string CppTranspiler::lookupList(const std::string& name, size_t line) const {
+    std::string scope = isLocal(name) ? identifier("l_", name) + ", " : "";
+    return "ScriptRuntime::list(" + scope + identifier("g_", name) + ", " + quote(name) + ", " + std::to_string(line) + ")";
+}
+
+std::string CppTranspiler::findVariable(const std::string& name) const {
+    std::string scope = isLocal(name) ? identifier("l_", name) + ", " : "";
+    return "ScriptRuntime::find(" + scope + identifier("g_", name) + ")";
+}
+
+CppTranspiler::Operand CppTranspiler::lower(const ExprNode* node) {
+    if (!node) {
+        return { "", CppType::NONE };
+    }
+
+    // Nodes the optimiser derives from other node types are matched by their exact type first
+    const std::type_info& type = typeid(*node);
+    if (type == typeid(TypedBinaryExprNode)) {
+        return lowerTypedBinary(static_cast<const TypedBinaryExprNode*>(node));
+    }
+    if (type == typeid(VariableCompareNode)) {
+        return lowerVariableCompare(static_cast<const VariableCompareNode*>(node));
+    }
+    if (type == typeid(IncrementNode)) {
+        lowerIncrement(static_cast<const IncrementNode*>(node));
+        return { "", CppType::NONE };
+    }
+    if (type == typeid(UpdateAssignNode)) {
+        lowerUpdateAssign(static_cast<const UpdateAssignNode*>(node));
+        return { "", CppType::NONE };
+    }
+
+    if (auto strNode = dynamic_cast<const StringNode*>(node)) {
+        return { "Value(std::string(" + quote(strNode->getValue()) + "))", CppType::VALUE };
+    }
+    else if (auto doubleNode = dynamic_cast<const DoubleNode*>(node)) {
+        double value = doubleNode->getValue();
+        if (std::isnan(value)) {
+            return { "std::numeric_limits<double>::quiet_NaN()", CppType::DOUBLE };
+        }
+        if (std::isinf(value)) {
+            return { value > 0 ? "std::numeric_limits<double>::infinity()" : "(-std::numeric_limits<double>::infinity())", CppType::DOUBLE };
+        }
+        std::ostringstream out;
+        out << std::setprecision(17) << value;
+        std::string literal = out.str();
+        if (literal.find_first_of(".e") == std::string::npos) {
+            literal += ".0";
+        }
+        return { value < 0 ? "(" + literal + ")" : literal, CppType::DOUBLE };
+    }
+    else if (auto boolNode = dynamic_cast<const BooleanNode*>(node)) {
+        return { boolNode->getValue() ? "true" : "false", CppType::BOOL };
+    }
+    else if (auto intNode = dynamic_cast<const IntegerNode*>(node)) {
+        int value = intNode->getValue();
+        if (value == INT_MIN) {
+            return { "(-2147483647 - 1)", CppType::INT };
+        }
+        return { value < 0 ? "(" + std::to_string(value) + ")" : std::to_string(value), CppType::INT };
+    }
+    else if (auto varNode = dynamic_cast<const VariableNode*>(node)) {
+        // Expressions cannot assign the variables they read, so the value is read where it is stored
+        std::string name = "t" + std::to_string(temps++);
+        line("const Value& " + name + " = " + readVariable(varNode->getName()) + ";");
+        return { name, CppType::VALUE };
+    }
+    else if (dynamic_cast<const ListInitNode*>(node) || dynamic_cast<const ListAppendNode*>(node) || dynamic_cast<const ListPopNode*>(node)
+        || dynamic_cast<const ListLengthNode*>(node) || dynamic_cast<const ListIndexNode*>(node) || dynamic_cast<const ListSliceNode*>(node)
+        || dynamic_cast<const ListReplaceNode*>(node) || dynamic_cast<const ListMethodNode*>(node) || dynamic_cast<const MapInitNode*>(node)
+        || dynamic_cast<const MapMethodNode*>(node)) {
+        return lowerListOperation(node);
+    }
+    else if (auto assignNode = dynamic_cast<const AssignNode*>(node)) {
+        return lowerAssign(assignNode);
+    }
+    else if (auto binNode = dynamic_cast<const BinaryExprNode*>(node)) {
+        return lowerBinary(binNode);
+    }
+    else if (auto unNode = dynamic_cast<const UnaryExprNode*>(node)) {
+        return lowerUnary(unNode);
+    }
+    else if (auto prNode = dynamic_cast<const PrintNode*>(node)) {
+        Operand value = lower(prNode->getExpression().get());
+        line("ScriptRuntime::print(output, " + asValue(value) + ");");
+        return value;
+    }
+    else if (auto inNode = dynamic_cast<const InputNode*>(node)) {
+        // The prompt is evaluated but not printed by input itself
+        lower(inNode->getExpression().get());
+        return { temp(CppType::VALUE, "Value(ScriptRuntime::input(output))"), CppType::VALUE };
+    }
+    else if (dynamic_cast<const FlushNode*>(node)) {
+        line("ScriptRuntime::flush(output);");
+        return { "", CppType::NONE };
+    }
+    else if (auto ifNode = dynamic_cast<const IfNode*>(node)) {
+        lowerIf(ifNode);
+        return { "", CppType::NONE };
+    }
+    else if (auto whileNode = dynamic_cast<const WhileNode*>(node)) {
+        lowerWhile(whileNode);
+        return { "", CppType::NONE };
+    }
+    else if (auto blockNode = dynamic_cast<const BlockNode*>(node)) {
+        line("{");
+        indent++;
+        lowerBlock(blockNode);
+        indent--;
+        line("}");
+        return { "", CppType::NONE };
+    }
+    else if (auto castNode = dynamic_cast<const TypeCastNode*>(node)) {
+        return lowerCast(castNode);
+    }
+    else if (auto definition = dynamic_cast<const FunctionDefNode*>(node)) {
+        const std::string number = std::to_string(definitionNumbers.at(definition));
+        line("ScriptRuntime::define(" + identifier("f_", definition->getName()) + ", definition_" + number + ", emptied_" + number
+            + ", executed_" + number + ");");
+        return { "", CppType::NONE };
+    }
+    else if (auto callNode = dynamic_cast<const FunctionCallNode*>(node)) {
+        return lowerCall(callNode);
+    }
+    else if (auto returnNode = dynamic_cast<const ReturnNode*>(node)) {
+        lowerReturn(returnNode);
+        return { "", CppType::NONE };
+    }
+    else if (auto inlinedNode = dynamic_cast<const InlinedCallNode*>(node)) {
+        return lowerInlinedCall(inlinedNode);
+    }
+    else if (auto hoistedNode = dynamic_cast<const HoistedWhileNode*>(node)) {
+        lowerHoistedWhile(hoistedNode);
+        return { "", CppType::NONE };
+    }
+
+    throw std::runtime_error("Emit Error: Unsupported node type at line " + std::to_string(node->getToken().line));
+}
+
+void CppTranspiler::lowerBlock(const BlockNode* block) {
+    if (!block) {
+        return;
+    }
+    for (const auto& statement : block->getStatements()) {
+        lower(statement.get());
+    }
+}
+
+CppTranspiler::Operand CppTranspiler::lowerTypedBinary(const TypedBinaryExprNode* typedNode) {
+    Operand left = lower(typedNode->getLeft().get());
+    Operand right = lower(typedNode->getRight().get());
+    const std::string line = std::to_string(typedNode->getToken().line);
+
+    // Int arithmetic is computed in double like the kernels, so results out of the int range convert the same way
+    auto intArithmetic = [&](const char* op) {
+        return Operand{ temp(CppType::INT, "static_cast<int>(static_cast<double>(" + asInt(left) + ") " + op + " " + asInt(right) + ")"), CppType::INT };
+    };
+    auto numberArithmetic = [&](const char* op) {
+        return Operand{ temp(CppType::VALUE, "ArithmeticOperations::toValue(" + asNumber(left) + " " + op + " " + asNumber(right) + ")"), CppType::VALUE };
+    };
+    auto compare = [&](const std::string& l, const std::string& r) {
+        return Operand{ temp(CppType::BOOL, l + " " + typedNode->getOp() + " " + r), CppType::BOOL };
+    };
+
+    switch (typedNode->getTypedOp()) {
+        case TypedBinaryOp::INT_ADD: return intArithmetic("+");
+        case TypedBinaryOp::INT_SUB: return intArithmetic("-");
+        case TypedBinaryOp::INT_MUL: return intArithmetic("*");
+        case TypedBinaryOp::INT_DIV:
+            return { temp(CppType::VALUE, "ScriptRuntime::intDivide(" + asInt(left) + ", " + asInt(right) + ", " + line + ")"), CppType::VALUE };
+        case TypedBinaryOp::INT_MOD:
+            return { temp(CppType::INT, "ScriptRuntime::intModulo(" + asInt(left) + ", " + asInt(right) + ", " + line + ")"), CppType::INT };
+        case TypedBinaryOp::DOUBLE_ADD: return numberArithmetic("+");
+        case TypedBinaryOp::DOUBLE_SUB: return numberArithmetic("-");
+        case TypedBinaryOp::DOUBLE_MUL: return numberArithmetic("*");
+        case TypedBinaryOp::DOUBLE_DIV:
+            return { temp(CppType::VALUE, "ScriptRuntime::numberDivide(" + asNumber(left) + ", " + asNumber(right) + ", " + line + ")"), CppType::VALUE };
+        case TypedBinaryOp::DOUBLE_MOD:
+            return { temp(CppType::VALUE, "ScriptRuntime::numberModulo(" + asNumber(left) + ", " + asNumber(right) + ", " + line + ")"), CppType::VALUE };
+        case TypedBinaryOp::INT_EQUAL:
+        case TypedBinaryOp::INT_NOT_EQUAL:
+        case TypedBinaryOp::INT_LESS:
+        case TypedBinaryOp::INT_LESS_EQUAL:
+        case TypedBinaryOp::INT_GREATER:
+        case TypedBinaryOp::INT_GREATER_EQUAL:
+            return compare(asInt(left), asInt(right));
+        case TypedBinaryOp::DOUBLE_EQUAL:
+        case TypedBinaryOp::DOUBLE_NOT_EQUAL:
+        case TypedBinaryOp::DOUBLE_LESS:
+        case TypedBinaryOp::DOUBLE_LESS_EQUAL:
+        case TypedBinaryOp::DOUBLE_GREATER:
+        case TypedBinaryOp::DOUBLE_GREATER_EQUAL:
+            return compare(asNumber(left), asNumber(right));
+        case TypedBinaryOp::STRING_EQUAL:
+        case TypedBinaryOp::STRING_NOT_EQUAL:
+            return compare(asString(left), asString(right));
+        case TypedBinaryOp::BOOL_EQUAL:
+        case TypedBinaryOp::BOOL_NOT_EQUAL:
+            return compare(asBool(left), asBool(right));
+        case TypedBinaryOp::BOOL_AND:
+            return { temp(CppType::BOOL, asBool(left) + " && " + asBool(right)), CppType::BOOL };
+        case TypedBinaryOp::BOOL_OR:
+            return { temp(CppType::BOOL, asBool(left) + " || " + asBool(right)), CppType::BOOL };
+        case TypedBinaryOp::STRING_CONCAT:
+            break;
+    }
+    return { temp(CppType::VALUE, "ScriptRuntime::binary(" + tokenType(typedNode->getToken()) + ", " + quote(typedNode->getOp()) + ", " + line + ", "
+        + asValue(left) + ", " + asValue(right) + ")"), CppType::VALUE };
+}
+
+CppTranspiler::Operand CppTranspiler::lowerBinary(const BinaryExprNode* binNode) {
+    Operand left = lower(binNode->getLeft().get());
+    Operand right = lower(binNode->getRight().get());
+    const Token& token = binNode->getToken();
+    const std::string line = std::to_string(token.line);
+    const std::string type = tokenType(token);
+    if (type.empty()) {
+        this->line("throw std::runtime_error(" + quote("Arithmetic Operation Error: Type mismatch or unsupported operation " + binNode->getOp()
+            + " at line " + line) + ");");
+        return { "", CppType::NONE };
+    }
+
+    const std::string call = "ScriptRuntime::binary(" + type + ", " + quote(binNode->getOp()) + ", " + line + ", " + asValue(left) + ", " + asValue(right) + ")";
+    // Comparisons and logical operations produce a bool whenever they do not fail
+    if (token.type == TokenType::ARITHMETIC) {
+        return { temp(CppType::VALUE, call), CppType::VALUE };
+    }
+    return { temp(CppType::BOOL, "std::get<bool>(" + call + ")"), CppType::BOOL };
+}
+
+CppTranspiler::Operand CppTranspiler::lowerVariableCompare(const VariableCompareNode* compareNode) {
+    const std::string type = tokenType(compareNode->getToken());
+    if (type.empty()) {
+        return lowerBinary(compareNode);
+    }
+
+    Operand left = lower(compareNode->getLeft().get());
+    Operand right = lower(compareNode->getRight().get());
+    auto isInt = [](const Operand& operand) {
+        return operand.type == CppType::INT ? std::string("true") : "std::holds_alternative<int>(" + asValue(operand) + ")";
+    };
+    std::string guard = isInt(left);
+    if (right.type != CppType::INT) {
+        guard += " && " + isInt(right);
+    }
+    const std::string line = std::to_string(compareNode->getToken().line);
+    const std::string fallback = "std::get<bool>(ScriptRuntime::binary(" + type + ", " + quote(compareNode->getOp()) + ", " + line + ", "
+        + asValue(left) + ", " + asValue(right) + "))";
+    return { temp(CppType::BOOL, guard + " ? " + asInt(left) + " " + compareNode->getOp() + " " + asInt(right) + " : " + fallback), CppType::BOOL };
+}
+
+CppTranspiler::Operand CppTranspiler::lowerUnary(const UnaryExprNode* unNode) {
+    Operand operand = lower(unNode->getOperand().get());
+    const std::string& op = unNode->getOp();
+    if (op == "-" && operand.type == CppType::INT) {
+        return { temp(CppType::INT, "-" + operand.code), CppType::INT };
+    }
+    if (op == "-" && operand.type == CppType::DOUBLE) {
+        return { temp(CppType::DOUBLE, "-" + operand.code), CppType::DOUBLE };
+    }
+    if (op == "!" && operand.type == CppType::BOOL) {
+        return { temp(CppType::BOOL, "!" + operand.code), CppType::BOOL };
+    }
+    return { temp(CppType::VALUE, "ScriptRuntime::unary(" + quote(op) + ", " + std::to_string(unNode->getToken().line) + ", " + asValue(operand) + ")"),
+        CppType::VALUE };
+}
+
+CppTranspiler::Operand CppTranspiler::lowerAssign(const AssignNode* assignNode) {
+    const std::string& name = assignNode->getName();
+    const std::string target = scopeVariable(name);
+    const ExprNode* value = assignNode->getValue().get();
+
+    if (!isAppendTo(value, name)) {
+        Operand result = lower(value);
+        line(target + ".assign(" + asValue(result) + ");");
+        return result;
+    }
+
+    // A string variable of the assignment's own scope is appended to in place, with every operand evaluated first
+    line("if (" + target + ".defined && ValueHelper::isString(" + target + ".value)) {");
+    indent++;
+    std::vector<const BinaryExprNode*> operations;
+    for (auto binNode = dynamic_cast<const BinaryExprNode*>(value); binNode; binNode = dynamic_cast<const BinaryExprNode*>(binNode->getLeft().get())) {
+        operations.push_back(binNode);
+    }
+    std::vector<std::string> operands;
+    for (auto it = operations.rbegin(); it != operations.rend(); ++it) {
+        // The operand is copied, as appending may change a variable it reads
+        operands.push_back(temp(CppType::VALUE, asValue(lower((*it)->getRight().get()))));
+        line("ScriptRuntime::checkAppend(" + target + ".value, " + operands.back() + ", " + std::to_string((*it)->getToken().line) + ");");
+    }
+    const std::string text = "t" + std::to_string(temps++);
+    line("std::string& " + text + " = std::get<std::string>(" + target + ".value);");
+    for (const std::string& operand : operands) {
+        line("ValueHelper::appendString(" + text + ", " + operand + ");");
+    }
+    indent--;
+    line("}");
+    line("else {");
+    indent++;
+    Operand result = lower(value);
+    line(target + ".assign(" + asValue(result) + ");");
+    indent--;
+    line("}");
+    return { "", CppType::NONE };
+}
+
+
+void CppTranspiler::lowerIncrement(const IncrementNode* incrementNode) {
+    const std::string target = scopeVariable(incrementNode->getName());
+    const int delta = incrementNode->getDelta();
+    line("if (" + target + ".defined && std::holds_alternative<int>(" + target + ".value)) {");
+    indent++;
+    const std::string value = "t" + std::to_string(temps++);
+    line("int& " + value + " = std::get<int>(" + target + ".value);");
+    line(value + " = static_cast<int>(static_cast<double>(" + value + ") + " + (delta < 0 ? "(" + std::to_string(delta) + ")" : std::to_string(delta)) + ");");
+    indent--;
+    line("}");
+    line("else {");
+    indent++;
+    lowerAssign(incrementNode);
+    indent--;
+    line("}");
+}
+
+void CppTranspiler::lowerUpdateAssign(const UpdateAssignNode* updateNode) {
+    const std::string target = scopeVariable(updateNode->getName());
+    const BinaryExprNode* operation = updateNode->getOperation();
+    const std::string& op = operation->getOp();
+    const std::string type = tokenType(operation->getToken());
+
+    line("if (" + target + ".defined) {");
+    indent++;
+    Operand right = lower(operation->getRight().get());
+    const std::string generic = target + ".value = ScriptRuntime::binary(" + type + ", " + quote(op) + ", " + std::to_string(operation->getToken().line)
+        + ", " + target + ".value, " + asValue(right) + ");";
+    if (op == "+" || op == "-" || op == "*") {
+        std::string guard = "std::holds_alternative<int>(" + target + ".value)";
+        if (right.type != CppType::INT) {
+            guard += " && std::holds_alternative<int>(" + asValue(right) + ")";
+        }
+        line("if (" + guard + ") {");
+        indent++;
+        const std::string value = "t" + std::to_string(temps++);
+        line("int& " + value + " = std::get<int>(" + target + ".value);");
+        line(value + " = static_cast<int>(" + value + " " + op + " static_cast<double>(" + asInt(right) + "));");
+        indent--;
+        line("}");
+        line("else {");
+        indent++;
+        line(generic);
+        indent--;
+        line("}");
+    }
+    else {
+        line(generic);
+    }
+    indent--;
+    line("}");
+    line("else {");
+    indent++;
+    lowerAssign(updateNode);
+    indent--;
+    line("}");
+}
+
+void CppTranspiler::lowerIf(const IfNode* ifNode) {
+    Operand condition = lower(ifNode->getCondition().get());
+    line("if (" + asCondition(condition) + ") {");
+    indent++;
+    lowerBlock(ifNode->getThenBlock().get());
+    indent--;
+    line("}");
+    if (ifNode->getElseBlock()) {
+        line("else {");
+        indent++;
+        lowerBlock(ifNode->getElseBlock().get());
+        indent--;
+        line("}");
+    }
+}
+
+void CppTranspiler::lowerWhile(const WhileNode* whileNode) {
+    const ExprNode* condition = whileNode->getCondition().get();
+    auto exitUnless = [&]() {
+        line("if (!" + asCondition(lower(condition)) + ") {");
+        line("    break;");
+        line("}");
+    };
+
+    // The interpreter tests the condition after every statement of the body as well, leaving the
+    // body when it fails, and once more after the body
+    line("while (true) {");
+    indent++;
+    exitUnless();
+    line("do {");
+    indent++;
+    for (const auto& statement : whileNode->getBlock()->getStatements()) {
+        lower(statement.get());
+        Operand discarded = lower(condition);
+        if (discarded.type != CppType::BOOL) {
+            line("static_cast<void>(" + asCondition(discarded) + ");");
+        }
+        exitUnless();
+    }
+    indent--;
+    line("} while (false);");
+    exitUnless();
+    indent--;
+    line("}");
+}
+
+void CppTranspiler::lowerHoistedWhile(const HoistedWhileNode* hoistedNode) {
+    const std::string hoisted = "hoisted" + std::to_string(temps++);
+    line("bool " + hoisted + " = true;");
+    line("try {");
+    indent++;
+    for (const auto& assignment : hoistedNode->getHoisted()) {
+        lower(assignment.get());
+    }
+    indent--;
+    line("}");
+    line("catch (const std::runtime_error&) {");
+    line("    " + hoisted + " = false;");
+    line("}");
+    line("if (" + hoisted + ") {");
+    indent++;
+    lower(hoistedNode->getLoop().get());
+    indent--;
+    line("}");
+    line("else {");
+    indent++;
+    lower(hoistedNode->getFallback().get());
+    indent--;
+    line("}");
+}
+
+CppTranspiler::Operand CppTranspiler::lowerCall(const FunctionCallNode* callNode) {
+    const auto& args = callNode->getArgs();
+    const std::string number = std::to_string(temps++);
+    const std::string line = std::to_string(callNode->getToken().line);
+    this->line("const ScriptFunction& c" + number + " = ScriptRuntime::function(" + identifier("f_", callNode->getName()) + ", "
+        + quote(callNode->getName()) + ", " + std::to_string(args.size()) + ");");
+    this->line("std::vector<Value> a" + number + ";");
+    this->line("a" + number + ".reserve(" + std::to_string(args.size()) + ");");
+    for (size_t i = 0; i < args.size(); i++) {
+        Operand argument = lower(args[i].get());
+        this->line("a" + number + ".push_back(ScriptRuntime::argument(c" + number + ", " + std::to_string(i) + ", " + asValue(argument) + ", " + line + "));");
+    }
+    return { temp(CppType::VALUE, "c" + number + ".body(a" + number + ", output)"), CppType::VALUE };
+}
+
+void CppTranspiler::lowerReturn(const ReturnNode* returnNode) {
+    const std::string lineNumber = std::to_string(returnNode->getToken().line);
+    if (!returnNode->getValue()) {
+        line("throw std::runtime_error(" + quote("Runtime Error: Return statement missing value at line " + lineNumber) + ");");
+        return;
+    }
+    if (!function) {
+        line("throw std::runtime_error(" + quote("Runtime Error: Return statement outside of function at line " + lineNumber) + ");");
+        return;
+    }
+
+    // Like the interpreter, the first return that runs sets the value and the rest of the body still runs
+    line("if (!returned) {");
+    indent++;
+    line("returned = true;");
+    if (function->getReturnType() == "void") {
+        line("throw std::runtime_error(" + quote("Runtime Error: Return statement with value in void function at line " + lineNumber) + ");");
+    }
+    else {
+        Operand value = lower(returnNode->getValue().get());
+        line("ScriptRuntime::checkReturn(" + asValue(value) + ", " + quote(function->getReturnType()) + ", " + lineNumber + ");");
+        line("returnValue = " + asValue(value) + ";");
+    }
+    indent--;
+    line("}");
+}
+
+CppTranspiler::Operand CppTranspiler::lowerInlinedCall(const InlinedCallNode* inlinedNode) {
+    for (const auto& binding : inlinedNode->getBindings()) {
+        lowerAssign(binding.get());
+    }
+    Operand result = lower(inlinedNode->getBody().get());
+    if (inlinedNode->needsReturnTypeCheck()) {
+        line("ScriptRuntime::checkReturn(" + asValue(result) + ", " + quote(inlinedNode->getReturnType()) + ", "
+            + std::to_string(inlinedNode->getReturnToken().line) + ");");
+    }
+    return result;
+}
+
+CppTranspiler::Operand CppTranspiler::lowerListOperation(const ExprNode* node) {
+    const std::string line = std::to_string(node->getToken().line);
+    const size_t lineNumber = node->getToken().line;
+
+    if (auto listNode = dynamic_cast<const ListInitNode*>(node)) {
+        this->line("ScriptRuntime::initList(" + scopeVariable(listNode->getName()) + ", " + quote(listNode->getName()) + ", "
+            + quote(listNode->getElementType()) + ", " + line + ");");
+        return { "", CppType::NONE };
+    }
+    if (auto mapNode = dynamic_cast<const MapInitNode*>(node)) {
+        this->line("ScriptRuntime::initMap(" + scopeVariable(mapNode->getName()) + ", " + quote(mapNode->getName()) + ", "
+            + quote(mapNode->getKeyType()) + ", " + quote(mapNode->getValueType()) + ", " + line + ");");
+        return { "", CppType::NONE };
+    }
+    if (typeid(*node) == typeid(ListAppendInPlaceNode)) {
+        auto appendNode = static_cast<const ListAppendInPlaceNode*>(node);
+        Operand value = lower(appendNode->getValue().get());
+        this->line("ScriptRuntime::appendInPlace(" + findVariable(appendNode->getListName()) + ", " + quote(appendNode->getListName()) + ", "
+            + asValue(value) + ", " + line + ");");
+        return { "", CppType::NONE };
+    }
+
+    // The operands are evaluated before the list is looked up
+    auto lookup = [&](const std::string& name) {
+        std::string list = "t" + std::to_string(temps++);
+        this->line("const Value& " + list + " = " + lookupList(name, lineNumber) + ";");
+        return list;
+    };
+    auto index = [&](const ExprNode* indexNode) {
+        return temp(CppType::INT, asIndex(lower(indexNode)));
+    };
+
+    if (auto appendNode = dynamic_cast<const ListAppendNode*>(node)) {
+        Operand value = lower(appendNode->getValue().get());
+        const std::string list = lookup(appendNode->getListName());
+        this->line("ScriptRuntime::append(" + list + ", " + quote(appendNode->getListName()) + ", " + asValue(value) + ", " + line + ");");
+        return { "", CppType::NONE };
+    }
+    if (auto popNode = dynamic_cast<const ListPopNode*>(node)) {
+        const std::string position = index(popNode->getIndex().get());
+        const std::string list = lookup(popNode->getListName());
+        return { temp(CppType::VALUE, "ScriptRuntime::pop(" + list + ", " + quote(popNode->getListName()) + ", " + position + ", " + line + ")"), CppType::VALUE };
+    }
+    if (auto lengthNode = dynamic_cast<const ListLengthNode*>(node)) {
+        const std::string list = lookup(lengthNode->getListName());
+        return { temp(CppType::INT, "ScriptRuntime::length(" + list + ", " + quote(lengthNode->getListName()) + ", " + line + ")"), CppType::INT };
+    }
+    if (auto indexNode = dynamic_cast<const ListIndexNode*>(node)) {
+        const std::string position = index(indexNode->getIndex().get());
+        const std::string list = lookup(indexNode->getListName());
+        return { temp(CppType::VALUE, "ScriptRuntime::index(" + list + ", " + quote(indexNode->getListName()) + ", " + position + ", " + line + ")"),
+            CppType::VALUE };
+    }
+    if (auto sliceNode = dynamic_cast<const ListSliceNode*>(node)) {
+        const std::string begin = sliceNode->getBegin() ? index(sliceNode->getBegin().get()) : "0";
+        const std::string end = sliceNode->getEnd() ? index(sliceNode->getEnd().get()) : "0";
+        const std::string list = lookup(sliceNode->getListName());
+        return { temp(CppType::VALUE, "ScriptRuntime::slice(" + list + ", " + quote(sliceNode->getListName()) + ", " + begin + ", " + end + ", "
+            + (sliceNode->getEnd() ? "true" : "false") + ", " + line + ")"), CppType::VALUE };
+    }
+    if (auto replaceNode = dynamic_cast<const ListReplaceNode*>(node)) {
+        Operand value = lower(replaceNode->getValue().get());
+        const std::string position = index(replaceNode->getIndex().get());
+        const std::string list = lookup(replaceNode->getListName());
+        this->line("ScriptRuntime::replace(" + list + ", " + quote(replaceNode->getListName()) + ", " + position + ", " + asValue(value) + ", " + line + ");");
+        return { "", CppType::NONE };
+    }
+    if (auto methodNode = dynamic_cast<const ListMethodNode*>(node)) {
+        Operand argument = lower(methodNode->getArgument().get());
+        const std::string list = lookup(methodNode->getListName());
+        return { temp(CppType::VALUE, "ScriptRuntime::listMethod(" + list + ", " + quote(methodNode->getListName()) + ", "
+            + listMethodName(methodNode->getMethod()) + ", " + asValue(argument) + ", " + line + ")"), CppType::VALUE };
+    }
+    auto mapMethodNode = static_cast<const MapMethodNode*>(node);
+    Operand key = lower(mapMethodNode->getKey().get());
+    Operand value = lower(mapMethodNode->getValue().get());
+    const std::string map = lookup(mapMethodNode->getMapName());
+    return { temp(CppType::VALUE, "ScriptRuntime::mapMethod(" + map + ", " + quote(mapMethodNode->getMapName()) + ", "
+        + mapMethodName(mapMethodNode->getMethod()) + ", " + asValue(key) + ", " + asValue(value) + ", " + line + ")"), CppType::VALUE };
+}
+
+CppTranspiler::Operand CppTranspiler::lowerCast(const TypeCastNode* castNode) {
+    Operand value = lower(castNode->getValue().get());
+    if (castNode->getType() == "double" && (value.type == CppType::INT || value.type == CppType::DOUBLE)) {
+        return { temp(CppType::DOUBLE, asNumber(value)), CppType::DOUBLE };
+    }
+    return { temp(CppType::VALUE, "ScriptRuntime::cast(" + quote(castNode->getType()) + ", " + asValue(value) + ", "
+        + std::to_string(castNode->getToken().line) + ")"), CppType::VALUE };
+}
@@ -0,0 +1,148 @@
+#ifndef CPPTRANSPILER_H
+#define CPPTRANSPILER_H
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AST/AST.h"
+
+/**
+ * @class CppTranspiler
+ * @brief Translates an optimised program to a C++ translation unit that runs it ahead of time.
+ *
+ * The generated code links against the interpreter's Value, TypedVector and TypedMap runtime and
+ * calls ScriptRuntime for every operation it does not compute natively, so the compiled program
+ * writes the same output and fails with the same errors as the interpreter. Operations the type
+ * inference pass proved to work on ints, doubles or bools are computed on native C++ values.
+ *
+ * Variables stay Values, as the interpreter's scopes let any variable change its type, and each
+ * one remembers whether it is defined so reads of undefined variables fail like the interpreter.
+ * Every expression is evaluated into its own temporary, so operands are evaluated in the
+ * interpreter's order.
+ */
+class CppTranspiler {
+public:
+    /**
+     * @brief Translates a program.
+     * @param program The optimised program.
+     * @return The C++ source.
+     * @throws std::runtime_error If the program contains a node that cannot be translated.
+     */
+    std::string transpile(const BlockNode* program);
+
+private:
+    /**
+     * @enum CppType
+     * @brief The C++ type an expression is evaluated to.
+     */
+    enum class CppType {
+        NONE,   ///< A statement without a value, which the interpreter evaluates to null.
+        VALUE,  ///< A Value of a type not known statically.
+        INT,    ///< A native int.
+        DOUBLE, ///< A native double.
+        BOOL    ///< A native bool.
+    };
+
+    /**
+     * @struct Operand
+     * @brief An evaluated expression: a temporary or a literal, and its type.
+     */
+    struct Operand {
+        std::string code; ///< The C++ expression reading the value, without side effects.
+        CppType type; ///< The type of the expression.
+    };
+
+    std::vector<const FunctionDefNode*> definitions; ///< Every function definition of the program, by number.
+    std::unordered_map<const FunctionDefNode*, size_t> definitionNumbers; ///< The number of each definition.
+    std::set<std::string> globals; ///< Every variable name of the program, which all have a global.
+    std::set<std::string> functionNames; ///< Every name a function is defined or called under.
+
+    const FunctionDefNode* function = nullptr; ///< The function being translated, or null for the program body.
+    std::set<std::string> locals; ///< The names the function being translated can define in its scope.
+    std::string code; ///< The code of the function being translated.
+    int indent = 0; ///< The indentation level of the next line.
+    size_t temps = 0; ///< Number of temporaries created so far.
+
+    /**
+     * @brief Collects the definitions, variable names and function names of a subtree.
+     * @param node The subtree.
+     */
+    void collect(const ExprNode* node);
+
+    /**
+     * @brief Collects the names a function body can define in its own scope.
+     * @param node The subtree of the body, not including nested definitions.
+     * @param names Receives the names.
+     * @return True if the subtree contains a return statement.
+     */
+    static bool collectLocals(const ExprNode* node, std::set<std::string>& names);
+
+    /**
+     * @brief Translates a function definition to a C++ function.
+     * @param definition The definition.
+     * @return The function.
+     */
+    std::string translateFunction(const FunctionDefNode* definition);
+
+    void line(const std::string& text);
+    std::string temp(CppType type, const std::string& expression);
+
+    static std::string typeName(CppType type);
+    static std::string identifier(const std::string& prefix, const std::string& name);
+    static std::string quote(const std::string& text);
+    static std::string tokenType(const Token& token);
+
+    /**
+     * @name Operand conversions
+     * The C++ expressions reading an operand as a Value, as the type a typed operation proved it
+     * has, as a condition or as a list index.
+     * @{
+     */
+    static std::string asValue(const Operand& operand);
+    static std::string asInt(const Operand& operand);
+    static std::string asNumber(const Operand& operand);
+    static std::string asBool(const Operand& operand);
+    static std::string asString(const Operand& operand);
+    static std::string asCondition(const Operand& operand);
+    static std::string asIndex(const Operand& operand);
+    /** @} */
+
+    /**
+     * @name Name resolution
+     * The C++ expressions accessing a variable from the code being translated.
+     * @{
+     */
+    bool isLocal(const std::string& name) const;
+    std::string scopeVariable(const std::string& name) const;
+    std::string readVariable(const std::string& name) const;
+    std::string lookupList(const std::string& name, size_t line) const;
+    std::string findVariable(const std::string& name) const;
+    /** @} */
+
+    /**
+     * @brief Translates an expression or statement, emitting the code that evaluates it.
+     * @param node The node, or null for an absent expression.
+     * @return The operand holding its value.
+     */
+    Operand lower(const ExprNode* node);
+
+    void lowerBlock(const BlockNode* block);
+    Operand lowerTypedBinary(const TypedBinaryExprNode* typedNode);
+    Operand lowerBinary(const BinaryExprNode* binNode);
+    Operand lowerVariableCompare(const VariableCompareNode* compareNode);
+    Operand lowerUnary(const UnaryExprNode* unNode);
+    Operand lowerAssign(const AssignNode* assignNode);
+    void lowerIncrement(const IncrementNode* incrementNode);
+    void lowerUpdateAssign(const UpdateAssignNode* updateNode);
+    void lowerIf(const IfNode* ifNode);
+    void lowerWhile(const WhileNode* whileNode);
+    void lowerHoistedWhile(const HoistedWhileNode* hoistedNode);
+    Operand lowerCall(const FunctionCallNode* callNode);
+    void lowerReturn(const ReturnNode* returnNode);
+    Operand lowerInlinedCall(const InlinedCallNode* inlinedNode);
+    Operand lowerListOperation(const ExprNode* node);
+    Operand lowerCast(const TypeCastNode* castNode);
+};
+
+#endif // CPPTRANSPILER_H
@@ -0,0 +1,401 @@
+#include "ScriptRuntime.h"
+#include <iostream>
+#include <stdexcept>
+#include "CodeGenerator/Operation/OperationDispatcher/OperationDispatcher.h"
+#include "CodeGenerator/Operation/UnaryOperations/UnaryOperations.h"
+#include "CodeGenerator/Operation/StringOperations/StringOperations.h"
+#include "CodeGenerator/Utility/PrintOperations.h"
+#include "TypedVector/TypedVector.h"
+#include "TypedVector/ListKernels.h"
+#include "TypedMap/TypedMap.h"
+
+namespace {
+    std::string at(size_t line) {
+        return " at line " + std::to_string(line);
+    }
+
+    std::runtime_error zeroDivisorError(const char* operation, size_t line) {
+        return std::runtime_error(std::string("Arithmetic Operation Error: ") + operation + " by zero" + at(line));
+    }
+
+    // Gets the value of a result of the interpreter's runtime, throwing its error
+    template <typename T>
+    T unwrap(Result<T> result) {
+        if (!result.ok()) {
+            throw std::runtime_error(result.getError().message);
+        }
+        return std::move(*result);
+    }
+}
+
+int ScriptRuntime::run(void (*program)(OutputBuffer& output), OutputBuffer& output) {
+    try {
+        program(output);
+    }
+    catch (const std::runtime_error& e) {
+        // Output produced before an error is written ahead of the message
+        output.flush();
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    output.flush();
+    return 0;
+}
+
+const Value& ScriptRuntime::read(const ScriptVariable& global, const char* name) {
+    if (!global.defined) {
+        throw std::runtime_error("Variable Error: Undefined variable " + std::string(name));
+    }
+    return global.value;
+}
+
+const Value& ScriptRuntime::read(const ScriptVariable& local, const ScriptVariable& global, const char* name) {
+    return local.defined ? local.value : read(global, name);
+}
+
+const Value& ScriptRuntime::list(const ScriptVariable& global, const char* name, size_t line) {
+    if (!global.defined) {
+        throw std::runtime_error("List Error: Undefined list " + std::string(name) + at(line));
+    }
+    return global.value;
+}
+
+const Value& ScriptRuntime::list(const ScriptVariable& local, const ScriptVariable& global, const char* name, size_t line) {
+    return local.defined ? local.value : list(global, name, line);
+}
+
+ScriptVariable* ScriptRuntime::find(ScriptVariable& local, ScriptVariable& global) {
+    return local.defined ? &local : find(global);
+}
+
+Value ScriptRuntime::binary(TokenType type, const char* op, size_t line, const Value& left, const Value& right) {
+    return unwrap(OperationDispatcher::dispatchOperation(Token(type, op, line), op, left, right));
+}
+
+Value ScriptRuntime::unary(const char* op, size_t line, const Value& operand) {
+    return unwrap(UnaryOperations::performUnaryOperation(Token(TokenType::ARITHMETIC, op, line), op, operand));
+}
+
+bool ScriptRuntime::asBool(const Value& value) {
+    return unwrap(ValueHelper::asBool(value));
+}
+
+int ScriptRuntime::asInt(const Value& value) {
+    return unwrap(ValueHelper::asInt(value));
+}
+
+Value ScriptRuntime::intDivide(int left, int right, size_t line) {
+    if (right == 0) {
+        throw zeroDivisorError("Division", line);
+    }
+    return ArithmeticOperations::toValue(static_cast<double>(left) / right);
+}
+
+int ScriptRuntime::intModulo(int left, int right, size_t line) {
+    if (right == 0) {
+        throw zeroDivisorError("Modulo", line);
+    }
+    // INT_MIN % -1 overflows, while the remainder computed in double is 0
+    return right == -1 ? 0 : left % right;
+}
+
+Value ScriptRuntime::numberDivide(double left, double right, size_t line) {
+    if (right == 0) {
+        throw zeroDivisorError("Division", line);
+    }
+    return ArithmeticOperations::toValue(left / right);
+}
+
+Value ScriptRuntime::numberModulo(double left, double right, size_t line) {
+    if (right == 0) {
+        throw zeroDivisorError("Modulo", line);
+    }
+    return ArithmeticOperations::toValue(std::fmod(left, right));
+}
+
+void ScriptRuntime::checkAppend(const Value& target, const Value& operand, size_t line) {
+    if (!StringOperations::canAppend(operand)) {
+        binary(TokenType::ARITHMETIC, "+", line, target, operand);
+    }
+}
+
+void ScriptRuntime::print(OutputBuffer& output, const Value& value) {
+    PrintOperations::printValue(value, output);
+}
+
+std::string ScriptRuntime::input(OutputBuffer& output) {
+    // Make sure the prompt is visible before waiting for the user
+    output.flush();
+    std::string input;
+    std::getline(std::cin, input);
+    return input;
+}
+
+void ScriptRuntime::flush(OutputBuffer& output) {
+    output.flush();
+}
+
+Value ScriptRuntime::cast(const char* type, const Value& value, size_t line) {
+    const std::string target = type;
+    Result<Value> result = std::monostate();
+    if (target == "int" && ValueHelper::isString(value)) {
+        result = ValueHelper::asInt(value);
+    }
+    else if (target == "double") {
+        result = ValueHelper::asDouble(value);
+    }
+    else if (target == "bool") {
+        result = ValueHelper::asBool(value);
+    }
+    else if (target == "string") {
+        result = ValueHelper::asString(value);
+    }
+    else {
+        // Only strings are converted to int, like in the interpreter
+        throw std::runtime_error("Type Cast Error: Cannot cast " + ValueHelper::type(value) + " to " + target + at(line));
+    }
+    if (!result.ok()) {
+        throw std::runtime_error("Type Cast Error: " + result.getError().message + at(line));
+    }
+    return std::move(*result);
+}
+
+void ScriptRuntime::initList(ScriptVariable& scope, const char* name, const char* type, size_t line) {
+    const std::string elementType = type;
+    if (elementType != "int" && elementType != "double" && elementType != "bool" && elementType != "string") {
+        throw std::runtime_error("List Init Error: Invalid list type " + elementType + at(line));
+    }
+    if (scope.defined) {
+        throw std::runtime_error("List Init Error: List " + std::string(name) + " already exists" + at(line));
+    }
+    scope.assign(std::make_shared<TypedVector>(elementType));
+}
+
+void ScriptRuntime::initMap(ScriptVariable& scope, const char* name, const char* keyType, const char* valueType, size_t line) {
+    if (!TypedMap::isKeyType(keyType)) {
+        throw std::runtime_error("Map Init Error: Invalid key type " + std::string(keyType) + at(line));
+    }
+    if (!TypedMap::isValueType(valueType)) {
+        throw std::runtime_error("Map Init Error: Invalid value type " + std::string(valueType) + at(line));
+    }
+    if (scope.defined) {
+        throw std::runtime_error("Map Init Error: Map " + std::string(name) + " already exists" + at(line));
+    }
+    scope.assign(std::make_shared<TypedMap>(keyType, valueType));
+}
+
+void ScriptRuntime::append(const Value& list, const char* name, const Value& value, size_t line) {
+    if (!ValueHelper::isVector(list)) {
+        throw std::runtime_error("List Append Error: Variable " + std::string(name) + " is not a list" + at(line));
+    }
+    TypedVector& vec = *ValueHelper::asVector(list);
+    if (vec.getElementType() != ValueHelper::type(value)) {
+        throw std::runtime_error("List Append Error: Type mismatch in list " + std::string(name) + at(line));
+    }
+    vec.push_back(value);
+}
+
+void ScriptRuntime::appendInPlace(ScriptVariable* list, const char* name, Value value, size_t line) {
+    if (!list) {
+        throw std::runtime_error("List Error: Undefined list " + std::string(name) + at(line));
+    }
+    if (!ValueHelper::isVector(list->value)) {
+        throw std::runtime_error("List Append Error: Variable " + std::string(name) + " is not a list" + at(line));
+    }
+    TypedVector& vec = *std::get<std::shared_ptr<TypedVector>>(list->value);
+    if (!vec.accepts(value)) {
+        throw std::runtime_error("List Append Error: Type mismatch in list " + std::string(name) + at(line));
+    }
+    vec.push_back(std::move(value));
+}
+
+Value ScriptRuntime::pop(const Value& list, const char* name, int index, size_t line) {
+    if (!ValueHelper::isVector(list)) {
+        throw std::runtime_error("List Pop Error: Variable " + std::string(name) + " is not a list" + at(line));
+    }
+    TypedVector& vec = *ValueHelper::asVector(list);
+    if (index < 0 || static_cast<size_t>(index) >= vec.size()) {
+        throw std::runtime_error("List Pop Error: Index out of bounds for list " + std::string(name) + at(line));
+    }
+    return vec.pop(index);
+}
+
+int ScriptRuntime::length(const Value& list, const char* name, size_t line) {
+    if (ValueHelper::isVector(list)) {
+        return static_cast<int>(ValueHelper::asVector(list)->size());
+    }
+    if (ValueHelper::isMap(list)) {
+        return static_cast<int>(ValueHelper::asMap(list)->size());
+    }
+    throw std::runtime_error("List Length Error: Variable " + std::string(name) + " is not a list" + at(line));
+}
+
+Value ScriptRuntime::index(const Value& list, const char* name, int index, size_t line) {
+    if (!ValueHelper::isVector(list)) {
+        throw std::runtime_error("List Index Error: Variable " + std::string(name) + " is not a list" + at(line));
+    }
+    const TypedVector& vec = *ValueHelper::asVector(list);
+    if (index < 0 || static_cast<size_t>(index) >= vec.size()) {
+        throw std::runtime_error("List Index Error: Index out of bounds for list " + std::string(name) + at(line));
+    }
+    return vec[index];
+}
+
+Value ScriptRuntime::slice(const Value& list, const char* name, int begin, int end, bool hasEnd, size_t line) {
+    if (!ValueHelper::isVector(list)) {
+        throw std::runtime_error("List Slice Error: Variable " + std::string(name) + " is not a list" + at(line));
+    }
+    const TypedVector& vec = *ValueHelper::asVector(list);
+    int length = static_cast<int>(vec.size());
+    if (!hasEnd) {
+        end = length;
+    }
+    if (begin < 0 || end < begin || end > length) {
+        throw std::runtime_error("List Slice Error: Invalid range " + std::to_string(begin) + ":" + std::to_string(end) +
+            " for list " + name + " of length " + std::to_string(length) + at(line));
+    }
+    return vec.slice(begin, end);
+}
+
+void ScriptRuntime::replace(const Value& list, const char* name, int index, const Value& value, size_t line) {
+    if (!ValueHelper::isVector(list)) {
+        throw std::runtime_error("List Replace Error: Variable " + std::string(name) + " is not a list" + at(line));
+    }
+    TypedVector& vec = *ValueHelper::asVector(list);
+    if (index < 0 || static_cast<size_t>(index) >= vec.size()) {
+        throw std::runtime_error("List Replace Error: Index out of bounds for list " + std::string(name) + at(line));
+    }
+    if (vec.getElementType() != ValueHelper::type(value)) {
+        throw std::runtime_error("List Replace Error: Type mismatch in list " + std::string(name) + at(line));
+    }
+    vec.replace(index, value);
+}
+
+Value ScriptRuntime::listMethod(const Value& list, const char* name, ListMethod method, const Value& argument, size_t line) {
+    const std::string methodName = listMethodToString(method);
+    if (method == ListMethod::CONTAINS && ValueHelper::isMap(list)) {
+        const TypedMap& map = *ValueHelper::asMap(list);
+        if (ValueHelper::type(argument) != map.getKeyType()) {
+            throw std::runtime_error("Map Method Error: Key type mismatch in contains on map " + std::string(name) + at(line));
+        }
+        return map.find(argument) != nullptr;
+    }
+    if (!ValueHelper::isVector(list)) {
+        throw std::runtime_error("List Method Error: Variable " + std::string(name) + " is not a list" + at(line));
+    }
+    TypedVector& vec = *ValueHelper::asVector(list);
+    const std::string type = vec.getElementType();
+
+    switch (method) {
+        case ListMethod::SUM:
+            if (type != "int" && type != "double") {
+                throw std::runtime_error("List Method Error: Cannot sum list " + std::string(name) + " of type " + type + at(line));
+            }
+            return ListKernels::sum(vec);
+        case ListMethod::MIN:
+        case ListMethod::MAX:
+            if (vec.size() == 0) {
+                throw std::runtime_error("List Method Error: Cannot take the " + methodName + " of empty list " + name + at(line));
+            }
+            return method == ListMethod::MIN ? ListKernels::min(vec) : ListKernels::max(vec);
+        case ListMethod::SORT:
+            ListKernels::sort(vec);
+            return std::monostate();
+        case ListMethod::CONTAINS:
+        case ListMethod::INDEX: {
+            if (ValueHelper::type(argument) != type) {
+                throw std::runtime_error("List Method Error: Type mismatch in " + methodName + " on list " + name + at(line));
+            }
+            int index = ListKernels::indexOf(vec, argument);
+            return method == ListMethod::CONTAINS ? Value(index >= 0) : Value(index);
+        }
+        case ListMethod::EXTEND: {
+            if (!ValueHelper::isVector(argument)) {
+                throw std::runtime_error("List Method Error: Argument of extend on list " + std::string(name) + " is not a list" + at(line));
+            }
+            const TypedVector& other = *ValueHelper::asVector(argument);
+            if (other.getElementType() != type) {
+                throw std::runtime_error("List Method Error: Type mismatch in extend on list " + std::string(name) + at(line));
+            }
+            vec.extend(other);
+            return std::monostate();
+        }
+        case ListMethod::REVERSE:
+            ListKernels::reverse(vec);
+            return std::monostate();
+    }
+    throw std::runtime_error("List Method Error: Unsupported method " + methodName + at(line));
+}
+
+Value ScriptRuntime::mapMethod(const Value& map, const char* name, MapMethod method, const Value& key, const Value& value, size_t line) {
+    const std::string methodName = mapMethodToString(method);
+    if (!ValueHelper::isMap(map)) {
+        throw std::runtime_error("Map Method Error: Variable " + std::string(name) + " is not a map" + at(line));
+    }
+    TypedMap& typedMap = *ValueHelper::asMap(map);
+    if (mapMethodArgumentCount(method) > 0 && ValueHelper::type(key) != typedMap.getKeyType()) {
+        throw std::runtime_error("Map Method Error: Key type mismatch in " + methodName + " on map " + name + at(line));
+    }
+
+    switch (method) {
+        case MapMethod::GET: {
+            const Value* found = typedMap.find(key);
+            if (!found) {
+                throw std::runtime_error("Map Error: Key " + ValueHelper::asString(key) + " not found in map " + name + at(line));
+            }
+            return *found;
+        }
+        case MapMethod::SET:
+            if (ValueHelper::type(value) != typedMap.getValueType()) {
+                throw std::runtime_error("Map Method Error: Value type mismatch in set on map " + std::string(name) + at(line));
+            }
+            typedMap.set(key, value);
+            return std::monostate();
+        case MapMethod::REMOVE:
+            return typedMap.remove(key);
+        case MapMethod::KEYS:
+            return typedMap.keys();
+        case MapMethod::VALUES:
+            return typedMap.values();
+    }
+    throw std::runtime_error("Map Method Error: Unsupported method " + methodName + at(line));
+}
+
+void ScriptRuntime::define(const ScriptFunction*& slot, const ScriptFunction& function, const ScriptFunction& emptied, bool& executed) {
+    slot = executed ? &emptied : &function;
+    executed = true;
+}
+
+Value ScriptRuntime::emptyBody(std::vector<Value>&, OutputBuffer&) {
+    return Value();
+}
+
+const ScriptFunction& ScriptRuntime::function(const ScriptFunction* function, const char* name, size_t argumentCount) {
+    if (!function) {
+        throw std::runtime_error("Runtime Error: Undefined function " + std::string(name));
+    }
+    if (function->parameters.size() != argumentCount) {
+        throw std::runtime_error("Runtime Error: Argument count mismatch in function call " + std::string(name));
+    }
+    return *function;
+}
+
+Value ScriptRuntime::argument(const ScriptFunction& function, size_t index, Value value, size_t line) {
+    const Parameter& parameter = function.parameters[index];
+    if (parameter.type.compare(0, 5, "list:") != 0) {
+        return value;
+    }
+    if (!ValueHelper::hasType(value, parameter.type)) {
+        throw std::runtime_error("Type Error: Argument " + parameter.name + " of function " + function.name +
+            " must be a " + parameter.type + at(line));
+    }
+    // Lists are passed by value: the parameter shares the caller's elements until either side changes them
+    const auto& list = std::get<std::shared_ptr<TypedVector>>(value);
+    return list->slice(0, list->size());
+}
+
+void ScriptRuntime::checkReturn(const Value& value, const char* type, size_t line) {
+    if (!ValueHelper::hasType(value, type)) {
+        throw std::runtime_error("Type Error: Return type mismatch in function" + at(line));
+    }
+}
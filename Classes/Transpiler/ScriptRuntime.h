@@ -0,0 +1,302 @@
+#ifndef SCRIPTRUNTIME_H
+#define SCRIPTRUNTIME_H
+
+#include <string>
+#include <vector>
+#include "Value/Value.h"
+#include "Value/ValueHelper.h"
+#include "Function/Parameter.h"
+#include "TokenType.h"
+#include "ListMethod.h"
+#include "MapMethod.h"
+#include "CodeGenerator/Operation/ArithmeticOperations/ArithmeticOperations.h"
+#include "CodeGenerator/Utility/OutputBuffer.h"
+
+/**
+ * @struct ScriptVariable
+ * @brief A variable of a transpiled program, which like an entry of the interpreter's scopes may not be defined yet.
+ */
+struct ScriptVariable {
+    Value value; ///< The value, meaningful once the variable is defined.
+    bool defined = false; ///< Whether the variable has been assigned in its scope.
+
+    /**
+     * @brief Assigns a value, defining the variable.
+     * @param newValue The value.
+     */
+    void assign(Value newValue) {
+        value = std::move(newValue);
+        defined = true;
+    }
+};
+
+/**
+ * @struct ScriptFunction
+ * @brief A function definition of a transpiled program.
+ */
+struct ScriptFunction {
+    const char* name; ///< The name of the function.
+    const char* returnType; ///< The declared return type.
+    std::vector<Parameter> parameters; ///< The parameters of the function.
+    Value (*body)(std::vector<Value>& arguments, OutputBuffer& output); ///< The compiled body, taking the checked arguments and the program's output and returning the return value.
+};
+
+/**
+ * @class ScriptRuntime
+ * @brief The support library of C++ programs generated by CppTranspiler.
+ *
+ * Generated code calls these functions for every operation that is not computed natively, so
+ * transpiled programs behave like the interpreter and fail with the same error messages. The
+ * runtime keeps no state of its own: the output buffer belongs to the generated main function
+ * and is passed to the program, which hands it to every function it calls.
+ */
+class ScriptRuntime {
+public:
+    /**
+     * @brief Runs a transpiled program, reporting an error like the interpreter's driver.
+     * @param program The body of the program.
+     * @param output The buffer the program writes to, flushed before an error is reported.
+     * @return The exit status of the program: 0, or 1 if it failed.
+     */
+    static int run(void (*program)(OutputBuffer& output), OutputBuffer& output);
+
+    /**
+     * @brief Reads a variable from the program body.
+     * @param global The global variable.
+     * @param name The name of the variable.
+     * @return The value.
+     * @throws std::runtime_error If the variable is not defined.
+     */
+    static const Value& read(const ScriptVariable& global, const char* name);
+
+    /**
+     * @brief Reads a variable from a function, looking in its scope and then in the globals.
+     * @param local The variable of the function's scope.
+     * @param global The global variable of the same name.
+     * @param name The name of the variable.
+     * @return The value.
+     * @throws std::runtime_error If the variable is defined in neither scope.
+     */
+    static const Value& read(const ScriptVariable& local, const ScriptVariable& global, const char* name);
+
+    /**
+     * @brief Looks up the list or map an operation of the program body works on.
+     * @param global The global variable.
+     * @param name The name of the list.
+     * @param line The line of the operation.
+     * @return The value of the variable.
+     * @throws std::runtime_error If the variable is not defined.
+     */
+    static const Value& list(const ScriptVariable& global, const char* name, size_t line);
+
+    /**
+     * @brief Looks up the list or map an operation of a function works on, in its scope and then in the globals.
+     * @param local The variable of the function's scope.
+     * @param global The global variable of the same name.
+     * @param name The name of the list.
+     * @param line The line of the operation.
+     * @return The value of the variable.
+     * @throws std::runtime_error If the variable is defined in neither scope.
+     */
+    static const Value& list(const ScriptVariable& local, const ScriptVariable& global, const char* name, size_t line);
+
+    /**
+     * @brief Finds the variable a name refers to from a function, without failing.
+     * @param local The variable of the function's scope.
+     * @param global The global variable of the same name.
+     * @return The local variable if it is defined, else the global one if it is defined, else null.
+     */
+    static ScriptVariable* find(ScriptVariable& local, ScriptVariable& global);
+
+    /**
+     * @brief Finds the variable a name refers to from the program body, without failing.
+     * @param global The global variable.
+     * @return The variable if it is defined, else null.
+     */
+    static ScriptVariable* find(ScriptVariable& global) {
+        return global.defined ? &global : nullptr;
+    }
+
+    /**
+     * @brief Performs a binary operation whose operand types are not known.
+     * @param type The token type of the operator.
+     * @param op The operator.
+     * @param line The line of the operation.
+     * @param left The left operand.
+     * @param right The right operand.
+     * @return The result.
+     */
+    static Value binary(TokenType type, const char* op, size_t line, const Value& left, const Value& right);
+
+    /**
+     * @brief Performs a unary operation whose operand type is not known.
+     * @param op The operator.
+     * @param line The line of the operation.
+     * @param operand The operand.
+     * @return The result.
+     */
+    static Value unary(const char* op, size_t line, const Value& operand);
+
+    /**
+     * @brief Gets a value proven to be a number as a double.
+     * @param value An int or a double.
+     * @return The number.
+     */
+    static double asNumber(const Value& value) {
+        return std::holds_alternative<int>(value) ? std::get<int>(value) : std::get<double>(value);
+    }
+
+    /**
+     * @name Checked conversions
+     * Conditions and list indices of types not known, converted like the interpreter converts them.
+     * @throws std::runtime_error If the value cannot be converted, with the conversion's message.
+     * @{
+     */
+    static bool asBool(const Value& value);
+    static int asInt(const Value& value);
+    /** @} */
+
+    /**
+     * @name Checked arithmetic
+     * Divisions and remainders of operands proven to be ints or numbers, failing on a zero divisor
+     * with the message of the typed kernels.
+     * @{
+     */
+    static Value intDivide(int left, int right, size_t line);
+    static int intModulo(int left, int right, size_t line);
+    static Value numberDivide(double left, double right, size_t line);
+    static Value numberModulo(double left, double right, size_t line);
+    /** @} */
+
+    /**
+     * @brief Checks an operand appended to a string variable in place, reporting the error the concatenation would.
+     * @param target The string.
+     * @param operand The operand.
+     * @param line The line of the operator.
+     */
+    static void checkAppend(const Value& target, const Value& operand, size_t line);
+
+    /**
+     * @name Input and output
+     * The print, input and flush builtins. Input flushes pending output before it reads a line.
+     * @{
+     */
+    static void print(OutputBuffer& output, const Value& value);
+    static std::string input(OutputBuffer& output);
+    static void flush(OutputBuffer& output);
+    /** @} */
+
+    /**
+     * @brief Converts a value like a type cast.
+     * @param type The type to convert to.
+     * @param value The value.
+     * @param line The line of the cast.
+     * @return The converted value.
+     */
+    static Value cast(const char* type, const Value& value, size_t line);
+
+    /**
+     * @brief Creates a list in a scope.
+     * @param scope The variable of the scope the list is created in.
+     * @param name The name of the list.
+     * @param type The element type.
+     * @param line The line of the declaration.
+     */
+    static void initList(ScriptVariable& scope, const char* name, const char* type, size_t line);
+
+    /**
+     * @brief Creates a map in a scope.
+     * @param scope The variable of the scope the map is created in.
+     * @param name The name of the map.
+     * @param keyType The key type.
+     * @param valueType The value type.
+     * @param line The line of the declaration.
+     */
+    static void initMap(ScriptVariable& scope, const char* name, const char* keyType, const char* valueType, size_t line);
+
+    /**
+     * @name List and map operations
+     * Operations on the value of a looked up variable, after their operands are evaluated.
+     * @{
+     */
+    static void append(const Value& list, const char* name, const Value& value, size_t line);
+
+    /**
+     * @brief Appends to a list found without the lookup error of the other list operations.
+     * @param list The variable holding the list, or null if it is not defined.
+     * @param name The name of the list.
+     * @param value The appended value.
+     * @param line The line of the append.
+     */
+    static void appendInPlace(ScriptVariable* list, const char* name, Value value, size_t line);
+
+    static Value pop(const Value& list, const char* name, int index, size_t line);
+    static int length(const Value& list, const char* name, size_t line);
+    static Value index(const Value& list, const char* name, int index, size_t line);
+
+    /**
+     * @brief Copies a range of a list.
+     * @param list The list.
+     * @param name The name of the list.
+     * @param begin The first index.
+     * @param end The index after the last, if hasEnd is set.
+     * @param hasEnd Whether an end was given, or the range runs to the end of the list.
+     * @param line The line of the slice.
+     * @return The new list.
+     */
+    static Value slice(const Value& list, const char* name, int begin, int end, bool hasEnd, size_t line);
+
+    static void replace(const Value& list, const char* name, int index, const Value& value, size_t line);
+    static Value listMethod(const Value& list, const char* name, ListMethod method, const Value& argument, size_t line);
+    static Value mapMethod(const Value& map, const char* name, MapMethod method, const Value& key, const Value& value, size_t line);
+    /** @} */
+
+    /**
+     * @brief Executes a function definition.
+     *
+     * Like the interpreter, which moves the body out of the definition the first time it runs,
+     * a definition executed again defines the function with an empty body.
+     *
+     * @param slot The function currently defined under the name.
+     * @param function The definition.
+     * @param emptied The definition with an empty body.
+     * @param executed Whether the definition has run before, set by the call.
+     */
+    static void define(const ScriptFunction*& slot, const ScriptFunction& function, const ScriptFunction& emptied, bool& executed);
+
+    /**
+     * @brief The body of a function whose definition was executed again.
+     * @return The value a function that never returns produces.
+     */
+    static Value emptyBody(std::vector<Value>&, OutputBuffer&);
+
+    /**
+     * @brief Resolves a call.
+     * @param function The function defined under the name, or null.
+     * @param name The name of the called function.
+     * @param argumentCount The number of arguments of the call.
+     * @return The function.
+     * @throws std::runtime_error If the function is not defined or takes a different number of arguments.
+     */
+    static const ScriptFunction& function(const ScriptFunction* function, const char* name, size_t argumentCount);
+
+    /**
+     * @brief Passes an argument to a parameter, checking and copying lists.
+     * @param function The called function.
+     * @param index The index of the parameter.
+     * @param value The evaluated argument.
+     * @param line The line of the call.
+     * @return The value the parameter is bound to.
+     */
+    static Value argument(const ScriptFunction& function, size_t index, Value value, size_t line);
+
+    /**
+     * @brief Checks a returned value against the declared return type.
+     * @param value The value.
+     * @param type The declared type.
+     * @param line The line of the return statement.
+     */
+    static void checkReturn(const Value& value, const char* type, size_t line);
+};
+
+#endif // SCRIPTRUNTIME_H
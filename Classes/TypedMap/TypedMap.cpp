@@ -0,0 +1,171 @@
+#include "TypedMap/TypedMap.h"
+#include "TypedVector/TypedVector.h"
+#include "Value/Value.h"
+#include <cstring>
+
+namespace {
+    const uint64_t hashMultiplier = 0x9E3779B97F4A7C15ULL;
+
+    // Spreads every input bit over the whole word, so the low bits can index the table
+    uint64_t finalize(uint64_t x) {
+        x ^= x >> 32;
+        x *= 0xD6E8FEB86659FD93ULL;
+        x ^= x >> 32;
+        x *= 0xD6E8FEB86659FD93ULL;
+        x ^= x >> 32;
+        return x;
+    }
+
+    // Hashes a string eight bytes at a time with a multiply and shift per word
+    uint64_t hashBytes(const char* data, size_t length) {
+        uint64_t h = length * hashMultiplier;
+        while (length >= 8) {
+            uint64_t word;
+            std::memcpy(&word, data, 8);
+            h = (h ^ word) * hashMultiplier;
+            h ^= h >> 29;
+            data += 8;
+            length -= 8;
+        }
+        if (length > 0) {
+            uint64_t word = 0;
+            std::memcpy(&word, data, length);
+            h = (h ^ word) * hashMultiplier;
+            h ^= h >> 29;
+        }
+        return finalize(h);
+    }
+}
+
+bool TypedMap::isKeyType(const std::string& type) {
+    return type == "int" || type == "string" || type == "bool";
+}
+
+bool TypedMap::isValueType(const std::string& type) {
+    return type == "int" || type == "double" || type == "string" || type == "bool";
+}
+
+uint32_t TypedMap::hash(const Value& key) {
+    if (std::holds_alternative<std::string>(key)) {
+        const std::string& text = std::get<std::string>(key);
+        return static_cast<uint32_t>(hashBytes(text.data(), text.size()));
+    }
+    if (std::holds_alternative<int>(key)) {
+        return static_cast<uint32_t>(finalize(static_cast<uint32_t>(std::get<int>(key))));
+    }
+    return static_cast<uint32_t>(finalize(std::get<bool>(key) ? 1 : 0));
+}
+
+size_t TypedMap::findSlot(const Value& key, uint32_t keyHash) const {
+    if (slots.empty()) {
+        return 0;
+    }
+    // The table is at most half full, so the probe always reaches an empty slot
+    size_t mask = slots.size() - 1;
+    for (size_t i = keyHash & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.entry == emptySlot) {
+            return slots.size();
+        }
+        if (slot.hash == keyHash && entries[slot.entry].key == key) {
+            return i;
+        }
+    }
+}
+
+const Value* TypedMap::find(const Value& key) const {
+    size_t slot = findSlot(key, hash(key));
+    return slot < slots.size() ? &entries[slots[slot].entry].value : nullptr;
+}
+
+void TypedMap::insertSlot(uint32_t keyHash, uint32_t entry) {
+    size_t mask = slots.size() - 1;
+    size_t i = keyHash & mask;
+    while (slots[i].entry != emptySlot) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = { keyHash, entry };
+}
+
+void TypedMap::set(const Value& key, const Value& value) {
+    uint32_t keyHash = hash(key);
+    size_t slot = findSlot(key, keyHash);
+    if (slot < slots.size()) {
+        entries[slots[slot].entry].value = value;
+        return;
+    }
+
+    // Keep the table at most half full; removed entries are dropped whenever the table is rebuilt
+    if ((entries.size() + 1) * 2 > slots.size()) {
+        size_t slotCount = slots.empty() ? 16 : slots.size();
+        while ((live + 1) * 2 > slotCount) {
+            slotCount *= 2;
+        }
+        rehash(slotCount);
+    }
+    entries.push_back({ key, value, keyHash, true });
+    insertSlot(keyHash, static_cast<uint32_t>(entries.size() - 1));
+    live++;
+}
+
+bool TypedMap::remove(const Value& key) {
+    size_t slot = findSlot(key, hash(key));
+    if (slot == slots.size()) {
+        return false;
+    }
+
+    Entry& entry = entries[slots[slot].entry];
+    entry.live = false;
+    entry.key = Value();
+    entry.value = Value();
+    live--;
+
+    // Shift later slots of the probe run back into the gap, so lookups never need tombstones
+    size_t mask = slots.size() - 1;
+    size_t gap = slot;
+    for (size_t i = (gap + 1) & mask; slots[i].entry != emptySlot; i = (i + 1) & mask) {
+        size_t home = slots[i].hash & mask;
+        // Move the slot unless its home lies cyclically after the gap, up to and including i
+        if (((i - home) & mask) >= ((i - gap) & mask)) {
+            slots[gap] = slots[i];
+            gap = i;
+        }
+    }
+    slots[gap] = { 0, emptySlot };
+
+    // Compact the entries once most of them are removed
+    if (entries.size() > 16 && entries.size() - live > live) {
+        rehash(slots.size());
+    }
+    return true;
+}
+
+void TypedMap::rehash(size_t slotCount) {
+    size_t kept = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].live) {
+            if (kept != i) {
+                entries[kept] = std::move(entries[i]);
+            }
+            kept++;
+        }
+    }
+    entries.resize(kept);
+
+    slots.assign(slotCount, { 0, emptySlot });
+    for (size_t i = 0; i < entries.size(); i++) {
+        insertSlot(entries[i].hash, static_cast<uint32_t>(i));
+    }
+}
+
+std::shared_ptr<TypedVector> TypedMap::keys() const {
+    auto list = std::make_shared<TypedVector>(keyType);
+    forEach([&list](const Value& key, const Value&) { list->push_back(key); });
+    return list;
+}
+
+std::shared_ptr<TypedVector> TypedMap::values() const {
+    auto list = std::make_shared<TypedVector>(valueType);
+    forEach([&list](const Value&, const Value& value) { list->push_back(value); });
+    return list;
+}
@@ -0,0 +1,175 @@
+#ifndef TYPEDMAP_H
+#define TYPEDMAP_H
+
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Value/Value.h"
+
+class TypedVector; // Forward declaration
+
+/**
+ * @class TypedMap
+ * @brief A hash map from keys of one type to values of another, such as `map:string:int()`.
+ *
+ * Entries are stored in insertion order in a dense array, and an open-addressing table of
+ * small slots with linear probing indexes them. A slot holds the entry index and 32 bits of
+ * the key's hash, so most probes compare the hash without touching the entry, and a lookup
+ * usually reads a single cache line of the table. The table is at most half full, and
+ * removal shifts later slots of the probe run back instead of leaving tombstones.
+ *
+ * Iteration visits the entries in the order their keys were first inserted.
+ */
+class TypedMap {
+public:
+    /**
+     * @brief Constructor that initializes the TypedMap with its key and value types.
+     * @param keyType The type of the keys, one of int, string or bool.
+     * @param valueType The type of the values, one of int, double, string or bool.
+     */
+    TypedMap(const std::string& keyType, const std::string& valueType) : keyType(keyType), valueType(valueType) {}
+
+    /**
+     * @brief Finds the value stored for a key.
+     * @param key The key to look up, which must have the key type.
+     * @return A pointer to the value, or nullptr if the map does not contain the key.
+     */
+    const Value* find(const Value& key) const;
+
+    /**
+     * @brief Stores a value for a key, replacing the value if the map already contains the key.
+     * @param key The key, which must have the key type of the map.
+     * @param value The value to store, which must have the value type of the map.
+     */
+    void set(const Value& key, const Value& value);
+
+    /**
+     * @brief Removes a key and its value.
+     * @param key The key to remove.
+     * @return True if the map contained the key, false otherwise.
+     */
+    bool remove(const Value& key);
+
+    /**
+     * @brief Gets the number of keys in the map.
+     * @return The number of keys.
+     */
+    size_t size() const {
+        return live;
+    }
+
+    /**
+     * @brief Creates a list of the keys in insertion order.
+     * @return A new list with the key type as its element type.
+     */
+    std::shared_ptr<TypedVector> keys() const;
+
+    /**
+     * @brief Creates a list of the values in the insertion order of their keys.
+     * @return A new list with the value type as its element type.
+     */
+    std::shared_ptr<TypedVector> values() const;
+
+    /**
+     * @brief Calls a function for every key and value in insertion order.
+     * @param visit The function, called with the key and value of each entry.
+     */
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const Entry& entry : entries) {
+            if (entry.live) {
+                visit(entry.key, entry.value);
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the key type of the map.
+     * @return A string representing the key type.
+     */
+    const std::string& getKeyType() const {
+        return keyType;
+    }
+
+    /**
+     * @brief Gets the value type of the map.
+     * @return A string representing the value type.
+     */
+    const std::string& getValueType() const {
+        return valueType;
+    }
+
+    /**
+     * @brief Checks whether a type can be used for the keys of a map.
+     * @param type The type name.
+     * @return True for int, string and bool. Doubles are not hashable keys.
+     */
+    static bool isKeyType(const std::string& type);
+
+    /**
+     * @brief Checks whether a type can be used for the values of a map.
+     * @param type The type name.
+     * @return True for int, double, string and bool.
+     */
+    static bool isValueType(const std::string& type);
+
+private:
+    /**
+     * @struct Entry
+     * @brief A key and value in insertion order; removed entries stay until the array is compacted.
+     */
+    struct Entry {
+        Value key;
+        Value value;
+        uint32_t hash;
+        bool live;
+    };
+
+    /**
+     * @struct Slot
+     * @brief A table slot holding the index of an entry and the low 32 bits of its key's hash.
+     */
+    struct Slot {
+        uint32_t hash;
+        uint32_t entry;
+    };
+
+    static constexpr uint32_t emptySlot = 0xFFFFFFFFu; ///< The entry index of an unused slot.
+
+    std::string keyType; ///< The type of the keys.
+    std::string valueType; ///< The type of the values.
+    std::vector<Entry> entries; ///< The entries in insertion order.
+    std::vector<Slot> slots; ///< The open-addressing table; its size is zero or a power of two.
+    size_t live = 0; ///< The number of entries that have not been removed.
+
+    /**
+     * @brief Hashes a key.
+     * @param key An int, string or bool key.
+     * @return The hash of the key.
+     */
+    static uint32_t hash(const Value& key);
+
+    /**
+     * @brief Finds the slot of a key.
+     * @param key The key to look up.
+     * @param keyHash The hash of the key.
+     * @return The index of the slot, or slots.size() if the map does not contain the key.
+     */
+    size_t findSlot(const Value& key, uint32_t keyHash) const;
+
+    /**
+     * @brief Stores an entry index in the first free slot of its probe run.
+     * @param keyHash The hash of the entry's key.
+     * @param entry The index of the entry.
+     */
+    void insertSlot(uint32_t keyHash, uint32_t entry);
+
+    /**
+     * @brief Drops removed entries and rebuilds the table with the given number of slots.
+     * @param slotCount The new table size, a power of two greater than twice the number of live entries.
+     */
+    void rehash(size_t slotCount);
+};
+
+#endif // TYPEDMAP_H
@@ -0,0 +1,293 @@
+#include "ListKernels.h"
+#include "Concurrency/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    ListKernels::Options options;
+    std::once_flag poolCreated;
+    std::unique_ptr<ThreadPool> pool;
+
+    // Returns the shared pool if a list of the given size should be processed in parallel
+    ThreadPool* parallelPool(size_t count) {
+        if (count < options.parallelThreshold) {
+            return nullptr;
+        }
+        std::call_once(poolCreated, [] {
+            size_t threads = options.threads == 0 ? ThreadPool::defaultThreadCount() : options.threads;
+            // The calling thread works alongside the pool's workers
+            if (threads > 1) {
+                pool = std::make_unique<ThreadPool>(threads - 1);
+            }
+        });
+        return pool.get();
+    }
+
+    // Runs the body for every block of the list, in parallel when a pool is given
+    template <typename Body>
+    void forEachBlock(ThreadPool* pool, size_t count, size_t blockSize, Body body) {
+        size_t blocks = (count + blockSize - 1) / blockSize;
+        auto run = [&](size_t block) {
+            body(block, block * blockSize, std::min(count, (block + 1) * blockSize));
+        };
+        if (pool) {
+            pool->forEach(blocks, run);
+        }
+        else {
+            for (size_t block = 0; block < blocks; block++) {
+                run(block);
+            }
+        }
+    }
+
+    // Searches split the list into a few blocks per thread so uneven blocks balance out
+    size_t searchBlockSize(ThreadPool* pool, size_t count) {
+        return pool ? std::max<size_t>(4096, count / ((pool->size() + 1) * 4) + 1) : std::max<size_t>(count, 1);
+    }
+
+    // Reads an element whose type is known from the list's element type
+    template <typename T>
+    const T& element(const Value& value) {
+        return *std::get_if<T>(&value);
+    }
+
+    // A total order on doubles: NaN after every number and -0.0 before 0.0, so any sort gives the same result
+    bool lessDouble(double a, double b) {
+        if (std::isnan(a) || std::isnan(b)) {
+            return !std::isnan(a) && std::isnan(b);
+        }
+        return a < b || (a == b && std::signbit(a) && !std::signbit(b));
+    }
+
+    // Orders elements for min and max, using the total order for doubles so blocks agree on NaN
+    template <typename T>
+    bool lessElement(const T& a, const T& b) {
+        return a < b;
+    }
+
+    bool lessElement(double a, double b) {
+        return lessDouble(a, b);
+    }
+
+    template <typename T, typename Total>
+    Value sumBlocks(ThreadPool* pool, const Value* values, size_t count) {
+        std::vector<Total> partials((count + ListKernels::sumBlockSize - 1) / ListKernels::sumBlockSize);
+        forEachBlock(pool, count, ListKernels::sumBlockSize, [&](size_t block, size_t begin, size_t end) {
+            Total total = 0;
+            for (size_t i = begin; i < end; i++) {
+                total += static_cast<Total>(element<T>(values[i]));
+            }
+            partials[block] = total;
+        });
+
+        Total total = 0;
+        for (Total partial : partials) {
+            total += partial;
+        }
+        return static_cast<T>(total);
+    }
+
+    // Sums an int list like a loop of + does, which adds in double and converts back to int each time.
+    // While no running sum leaves the int range that is the exact total, so blocks record the range
+    // of their running sums, and a list whose sum overflows is added again one element at a time.
+    Value sumInts(ThreadPool* pool, const Value* values, size_t count) {
+        struct BlockSum {
+            long long total = 0;
+            long long lowest = 0;
+            long long highest = 0;
+        };
+        std::vector<BlockSum> partials((count + ListKernels::sumBlockSize - 1) / ListKernels::sumBlockSize);
+        forEachBlock(pool, count, ListKernels::sumBlockSize, [&](size_t block, size_t begin, size_t end) {
+            BlockSum sum;
+            for (size_t i = begin; i < end; i++) {
+                sum.total += element<int>(values[i]);
+                sum.lowest = std::min(sum.lowest, sum.total);
+                sum.highest = std::max(sum.highest, sum.total);
+            }
+            partials[block] = sum;
+        });
+
+        long long total = 0;
+        for (const BlockSum& partial : partials) {
+            if (total + partial.lowest < INT_MIN || total + partial.highest > INT_MAX) {
+                int result = 0;
+                for (size_t i = 0; i < count; i++) {
+                    // The same conversion as ArithmeticOperations::intAdd
+                    result = static_cast<int>(static_cast<double>(result) + element<int>(values[i]));
+                }
+                return result;
+            }
+            total += partial.total;
+        }
+        return static_cast<int>(total);
+    }
+
+    // Returns the index of the first element that is preferred over all others by `better`
+    template <typename T, typename Better>
+    size_t findExtreme(ThreadPool* pool, const Value* values, size_t count, Better better) {
+        size_t blockSize = searchBlockSize(pool, count);
+        std::vector<size_t> bests((count + blockSize - 1) / blockSize);
+        forEachBlock(pool, count, blockSize, [&](size_t block, size_t begin, size_t end) {
+            size_t best = begin;
+            for (size_t i = begin + 1; i < end; i++) {
+                if (better(element<T>(values[i]), element<T>(values[best]))) {
+                    best = i;
+                }
+            }
+            bests[block] = best;
+        });
+
+        // Blocks are combined in list order, so ties resolve to the first element as in a serial scan
+        size_t best = bests[0];
+        for (size_t candidate : bests) {
+            if (better(element<T>(values[candidate]), element<T>(values[best]))) {
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    template <typename Better>
+    size_t findExtreme(const std::string& type, const Value* values, size_t count, Better better) {
+        ThreadPool* pool = parallelPool(count);
+        if (type == "int") return findExtreme<int>(pool, values, count, better);
+        if (type == "double") return findExtreme<double>(pool, values, count, better);
+        if (type == "bool") return findExtreme<bool>(pool, values, count, better);
+        return findExtreme<std::string>(pool, values, count, better);
+    }
+
+    // Sorts runs in parallel, then merges neighbouring runs in rounds until one is left
+    template <typename T, typename Less>
+    void sortRange(ThreadPool* pool, T* first, size_t count, Less less) {
+        if (!pool) {
+            std::sort(first, first + count, less);
+            return;
+        }
+
+        size_t runs = 1;
+        while (runs < (pool->size() + 1) * 2) {
+            runs *= 2;
+        }
+        auto bound = [count, runs](size_t run) { return count * run / runs; };
+        pool->forEach(runs, [&](size_t run) {
+            std::sort(first + bound(run), first + bound(run + 1), less);
+        });
+        for (size_t width = 1; width < runs; width *= 2) {
+            pool->forEach(runs / (width * 2), [&](size_t pair) {
+                size_t begin = pair * width * 2;
+                std::inplace_merge(first + bound(begin), first + bound(begin + width), first + bound(begin + width * 2), less);
+            });
+        }
+    }
+
+    // Unpacks the elements into a plain array, sorts it and writes it back
+    template <typename T, typename Less>
+    void sortScalars(ThreadPool* pool, Value* values, size_t count, Less less) {
+        std::vector<T> scalars(count);
+        for (size_t i = 0; i < count; i++) {
+            scalars[i] = element<T>(values[i]);
+        }
+        sortRange(pool, scalars.data(), count, less);
+        for (size_t i = 0; i < count; i++) {
+            values[i] = scalars[i];
+        }
+    }
+
+    template <typename T>
+    int find(const Value* values, size_t count, const T& target) {
+        ThreadPool* pool = parallelPool(count);
+        if (!pool) {
+            for (size_t i = 0; i < count; i++) {
+                if (element<T>(values[i]) == target) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        // Blocks after an earlier match are skipped, and the smallest matching index wins
+        std::atomic<size_t> found{ count };
+        forEachBlock(pool, count, searchBlockSize(pool, count), [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end && i < found.load(std::memory_order_relaxed); i++) {
+                if (element<T>(values[i]) == target) {
+                    size_t current = found.load();
+                    while (i < current && !found.compare_exchange_weak(current, i)) {}
+                    return;
+                }
+            }
+        });
+        return found == count ? -1 : static_cast<int>(found.load());
+    }
+}
+
+void ListKernels::setOptions(const Options& newOptions) {
+    options = newOptions;
+}
+
+ListKernels::Options ListKernels::getOptions() {
+    return options;
+}
+
+Value ListKernels::sum(TypedVector& list) {
+    const Value* values = list.data();
+    size_t count = list.size();
+    ThreadPool* pool = parallelPool(count);
+    if (list.getElementType() == "double") {
+        return sumBlocks<double, double>(pool, values, count);
+    }
+    return sumInts(pool, values, count);
+}
+
+Value ListKernels::min(TypedVector& list) {
+    const Value* values = list.data();
+    return values[findExtreme(list.getElementType(), values, list.size(), [](const auto& a, const auto& b) { return lessElement(a, b); })];
+}
+
+Value ListKernels::max(TypedVector& list) {
+    const Value* values = list.data();
+    return values[findExtreme(list.getElementType(), values, list.size(), [](const auto& a, const auto& b) { return lessElement(b, a); })];
+}
+
+void ListKernels::sort(TypedVector& list) {
+    Value* values = list.mutableData();
+    size_t count = list.size();
+    ThreadPool* pool = parallelPool(count);
+    const std::string type = list.getElementType();
+    if (type == "int") {
+        sortScalars<int>(pool, values, count, std::less<int>());
+    }
+    else if (type == "double") {
+        sortScalars<double>(pool, values, count, lessDouble);
+    }
+    else if (type == "bool") {
+        // Booleans only need counting
+        size_t falses = static_cast<size_t>(std::count_if(values, values + count, [](const Value& value) { return !element<bool>(value); }));
+        std::fill(values, values + falses, Value(false));
+        std::fill(values + falses, values + count, Value(true));
+    }
+    else {
+        // Strings are moved rather than copied while sorting
+        sortRange(pool, values, count, [](const Value& a, const Value& b) {
+            return element<std::string>(a) < element<std::string>(b);
+        });
+    }
+}
+
+int ListKernels::indexOf(TypedVector& list, const Value& value) {
+    const Value* values = list.data();
+    size_t count = list.size();
+    if (std::holds_alternative<int>(value)) return find(values, count, std::get<int>(value));
+    if (std::holds_alternative<double>(value)) return find(values, count, std::get<double>(value));
+    if (std::holds_alternative<bool>(value)) return find(values, count, std::get<bool>(value));
+    return find(values, count, std::get<std::string>(value));
+}
+
+void ListKernels::reverse(TypedVector& list) {
+    Value* values = list.mutableData();
+    std::reverse(values, values + list.size());
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "TypedVector/TypedVector.h"
+
+/**
+ * @class ListKernels
+ * @brief Implements the built-in whole-list methods as native loops over a list's elements.
+ *
+ * Each kernel makes the list contiguous once and then runs a loop specialised for the list's
+ * element type, so int, double, bool and string lists avoid per-element type dispatch. Callers
+ * check element types and emptiness beforehand and report errors with the script location.
+ *
+ * Lists with at least Options::parallelThreshold elements are processed by a thread pool shared
+ * by all interpreters. Results are identical to the serial path for any thread count: sums add
+ * fixed-size blocks in order, searches combine per-block results in list order, and min, max and
+ * sort compare doubles with a total order.
+ */
+class ListKernels {
+public:
+    /**
+     * @struct Options
+     * @brief Holds the settings of the parallel kernels.
+     */
+    struct Options {
+        size_t threads = 0; ///< Threads used by a parallel kernel, including the caller; 0 uses every hardware thread and 1 disables parallelism.
+        size_t parallelThreshold = 100000; ///< Minimum number of elements for a kernel to run in parallel.
+    };
+
+    /**
+     * @brief Sets the parallel kernel settings.
+     *
+     * The thread count takes effect when the shared pool is created, which happens the first
+     * time a kernel runs in parallel, so it must be set before any script runs.
+     *
+     * @param options The settings.
+     */
+    static void setOptions(const Options& options);
+
+    /**
+     * @brief Gets the parallel kernel settings.
+     * @return The settings.
+     */
+    static Options getOptions();
+
+    /**
+     * @brief Sums an int or double list.
+     *
+     * Int sums follow the overflow rule of +, which adds in double and converts the result back
+     * to int: a sum that leaves the int range at any point gives the result of a left-to-right
+     * loop of +, and any other sum is exact. Double lists are summed in blocks of sumBlockSize
+     * elements from first to last, and the block sums are then added in order, so lists up to one
+     * block give exactly the result of a left-to-right loop.
+     *
+     * @param list The list to sum, which must hold ints or doubles.
+     * @return The sum, of the list's element type; 0 for an empty list.
+     */
+    static Value sum(TypedVector& list);
+
+    static const size_t sumBlockSize = 16384; ///< Number of elements summed before a block sum is added to the total.
+
+    /**
+     * @brief Finds the smallest element of a list.
+     *
+     * Doubles are compared in the order sort uses, so NaN is only the minimum of a list holding
+     * nothing else, and -0.0 is smaller than 0.0.
+     *
+     * @param list The list to search, which must not be empty.
+     * @return The first smallest element.
+     */
+    static Value min(TypedVector& list);
+
+    /**
+     * @brief Finds the largest element of a list.
+     *
+     * Doubles are compared in the order sort uses, so any NaN is the maximum.
+     *
+     * @param list The list to search, which must not be empty.
+     * @return The first largest element.
+     */
+    static Value max(TypedVector& list);
+
+    /**
+     * @brief Sorts a list in ascending order in place. NaN values are placed last and -0.0 before 0.0.
+     * @param list The list to sort.
+     */
+    static void sort(TypedVector& list);
+
+    /**
+     * @brief Finds the first element equal to a value.
+     * @param list The list to search.
+     * @param value The value to find, which must have the list's element type.
+     * @return The index of the first equal element, or -1 if there is none.
+     */
+    static int indexOf(TypedVector& list, const Value& value);
+
+    /**
+     * @brief Reverses a list in place.
+     * @param list The list to reverse.
+     */
+    static void reverse(TypedVector& list);
+};
@@ -1,48 +1,136 @@
 #include "TypedVector/TypedVector.h"
 #include "Value/Value.h"
-#include <stdexcept>
+#include <algorithm>
+
+namespace {
+    // Returns the smallest power of two that holds the given number of elements
+    size_t capacityFor(size_t minimum) {
+        size_t capacity = 8;
+        while (capacity < minimum) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+}
+
+bool TypedVector::accepts(const Value& value) const {
+    switch (value.index()) {
+        case 0: return elementType == "double";
+        case 1: return elementType == "int";
+        case 2: return elementType == "bool";
+        case 3: return elementType == "string";
+        default: return false;
+    }
+}
 
 void TypedVector::push_back(const Value& value) {
-    std::string valueType = value.index() == 0 ? "double" :
-        value.index() == 1 ? "int" :
-        value.index() == 2 ? "bool" :
-        value.index() == 3 ? "string" :
-        "unknown";
+    push_back(Value(value));
+}
 
-    if (valueType != elementType) {
-        throw std::runtime_error("Type Error: Attempt to add wrong type to the list.");
+void TypedVector::push_back(Value&& value) {
+    detach();
+    if (count == capacity()) {
+        grow(count + 1);
     }
-    values.push_back(value);
+    slot(count) = std::move(value);
+    count++;
 }
 
-void TypedVector::pop(int index) {
-    if (index < 0 || index >= values.size()) {
-        throw std::runtime_error("Index Error: Index out of bounds.");
+Value TypedVector::pop(int index) {
+    detach();
+    Value value = std::move(slot(index));
+
+    // Close the gap from whichever end is nearer, so popping either end moves nothing
+    size_t position = index;
+    if (position < count / 2) {
+        for (size_t i = position; i > 0; i--) {
+            slot(i) = std::move(slot(i - 1));
+        }
+        slot(0) = Value();
+        head = (head + 1) & (buffer->size() - 1);
     }
-    values.erase(values.begin() + index);
+    else {
+        for (size_t i = position; i + 1 < count; i++) {
+            slot(i) = std::move(slot(i + 1));
+        }
+        slot(count - 1) = Value();
+    }
+    count--;
+    return value;
 }
 
 Value& TypedVector::at(int index) {
-    if (index < 0 || index >= values.size()) {
-        throw std::runtime_error("Index Error: Index out of bounds.");
-    }
-    return values.at(index);
+    // The reference may be written through
+    detach();
+    return slot(index);
 }
 
 void TypedVector::replace(int index, const Value& value) {
-    if (index < 0 || index >= values.size()) {
-		throw std::runtime_error("Index Error: Index out of bounds.");
-	}
-
-	std::string valueType = value.index() == 0 ? "double" :
-		value.index() == 1 ? "int" :
-		value.index() == 2 ? "bool" :
-		value.index() == 3 ? "string" :
-		"unknown";
-
-    if (valueType != elementType) {
-		throw std::runtime_error("Type Error: Attempt to add wrong type to the list.");
-	}
-
-	values.at(index) = value;
-}
\ No newline at end of file
+    detach();
+    slot(index) = value;
+}
+
+void TypedVector::extend(const TypedVector& other) {
+    // Read the size first, so extending a vector with itself appends each element once.
+    // A slice of this vector keeps the old buffer when this one detaches, so it stays readable.
+    size_t added = other.count;
+    detach();
+    if (count + added > capacity()) {
+        grow(count + added);
+    }
+    for (size_t i = 0; i < added; i++) {
+        slot(count + i) = other[i];
+    }
+    count += added;
+}
+
+std::shared_ptr<TypedVector> TypedVector::slice(size_t begin, size_t end) const {
+    auto result = std::make_shared<TypedVector>(elementType);
+    if (begin < end) {
+        result->buffer = buffer;
+        result->head = (head + begin) & (buffer->size() - 1);
+        result->count = end - begin;
+    }
+    return result;
+}
+
+const Value* TypedVector::data() {
+    if (!buffer) {
+        return nullptr;
+    }
+    if (head + count > buffer->size()) {
+        if (isShared()) {
+            reallocate(buffer->size());
+        }
+        else {
+            std::rotate(buffer->begin(), buffer->begin() + head, buffer->end());
+            head = 0;
+        }
+    }
+    return buffer->data() + head;
+}
+
+Value* TypedVector::mutableData() {
+    detach();
+    return const_cast<Value*>(data());
+}
+
+void TypedVector::detach() {
+    if (isShared()) {
+        reallocate(capacityFor(count));
+    }
+}
+
+void TypedVector::grow(size_t minimum) {
+    reallocate(capacityFor(std::max(minimum, capacity() * 2)));
+}
+
+void TypedVector::reallocate(size_t capacity) {
+    auto grown = std::make_shared<std::vector<Value>>(capacity);
+    bool shared = isShared();
+    for (size_t i = 0; i < count; i++) {
+        (*grown)[i] = shared ? slot(i) : std::move(slot(i));
+    }
+    buffer = std::move(grown);
+    head = 0;
+}
@@ -9,6 +9,14 @@
 /**
  * @class TypedVector
  * @brief A class that represents a typed vector, ensuring all elements are of the specified type.
+ *
+ * Elements are stored in a ring buffer whose capacity is a power of two, so indexing and
+ * removing the first or last element are O(1). Removing any other element shifts the shorter
+ * side of the list.
+ *
+ * A vector is a window onto its buffer, and slices share the buffer of the vector they were
+ * taken from. The buffer is copy-on-write: a vector copies its elements into a buffer of its
+ * own before it is modified while another vector still shares its buffer.
  */
 class TypedVector {
 public:
@@ -20,40 +28,102 @@ public:
 
     /**
      * @brief Adds a value to the end of the vector.
-     * @param value The value to add.
-     * @throws std::runtime_error if the value type does not match the element type of the vector.
+     * @param value The value to add, which must have the element type of the vector, as accepts checks.
      */
     void push_back(const Value& value);
 
     /**
-     * @brief Removes the element at the specified index.
-     * @param index The index of the element to remove.
-     * @throws std::runtime_error if the index is out of bounds.
+     * @brief Moves a value to the end of the vector.
+     * @param value The value to add, which must have the element type of the vector, as accepts checks.
+     * It is left in a valid but unspecified state.
      */
-    void pop(int index);
+    void push_back(Value&& value);
+
+    /**
+     * @brief Removes the element at the specified index and moves it out.
+     * @param index The index of the element to remove, which must be within bounds.
+     * @return The removed element.
+     */
+    Value pop(int index);
 
     /**
      * @brief Returns a reference to the element at the specified index.
-     * @param index The index of the element to access.
+     * @param index The index of the element to access, which must be within bounds.
      * @return A reference to the value at the specified index.
-     * @throws std::runtime_error if the index is out of bounds.
      */
     Value& at(int index);
 
     /**
      * @brief Replaces the element at the specified index with a new value.
-     * @param index The index of the element to replace.
-     * @param value The new value to set at the specified index.
-     * @throws std::runtime_error if the index is out of bounds or the value type does not match the element type of the vector.
+     * @param index The index of the element to replace, which must be within bounds.
+     * @param value The new value to set at the specified index, which must have the element type of the vector.
      */
     void replace(int index, const Value& value);
 
     /**
-     * @brief Gets a constant reference to the underlying values vector.
-     * @return A constant reference to the vector of values.
+     * @brief Appends every element of another vector of the same element type.
+     * @param other The vector to append, which must have the same element type and may be this vector.
+     */
+    void extend(const TypedVector& other);
+
+    /**
+     * @brief Creates a vector of a range of elements that shares this vector's buffer.
+     * @param begin The index of the first element of the slice.
+     * @param end The index after the last element of the slice, at least begin and at most size().
+     * @return The slice, created in O(1) without copying elements.
+     */
+    std::shared_ptr<TypedVector> slice(size_t begin, size_t end) const;
+
+    /**
+     * @brief Makes the elements contiguous in list order and returns them for reading.
+     *
+     * This is O(n) if earlier pops from the front left the elements wrapped around the
+     * buffer, and free otherwise. A shared buffer is only read, never reordered.
+     *
+     * @return A pointer to the first of size() contiguous elements.
+     */
+    const Value* data();
+
+    /**
+     * @brief Makes the elements contiguous in list order and returns them for modification.
+     *
+     * Unlike data(), this first copies the elements if the buffer is shared.
+     *
+     * @return A pointer to the first of size() contiguous elements.
+     */
+    Value* mutableData();
+
+    /**
+     * @brief Returns a constant reference to the element at the specified index without bounds checking.
+     * @param index The index of the element to access, which must be less than size().
+     * @return A constant reference to the value at the specified index.
+     */
+    const Value& operator[](size_t index) const {
+        return (*buffer)[(head + index) & (buffer->size() - 1)];
+    }
+
+    /**
+     * @brief Gets the number of elements in the vector.
+     * @return The number of elements.
+     */
+    size_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief Gets the number of elements the vector can hold before it has to reallocate.
+     * @return The capacity of the underlying storage.
+     */
+    size_t capacity() const {
+        return buffer ? buffer->size() : 0;
+    }
+
+    /**
+     * @brief Checks whether another vector shares this vector's buffer.
+     * @return True if the next modification has to copy the elements first.
      */
-    const std::vector<Value>& getValues() const {
-        return values;
+    bool isShared() const {
+        return buffer && buffer.use_count() > 1;
     }
 
     /**
@@ -64,9 +134,44 @@ public:
         return elementType;
     }
 
+    /**
+     * @brief Checks whether a value has the element type of the vector.
+     * @param value The value to check.
+     * @return True if the value can be added to the vector.
+     */
+    bool accepts(const Value& value) const;
+
 private:
     std::string elementType; ///< The type of elements that this vector holds.
-    std::vector<Value> values; ///< The underlying vector of values.
+    std::shared_ptr<std::vector<Value>> buffer; ///< The ring buffer holding the elements; its size is a power of two.
+    size_t head = 0; ///< The buffer position of the first element.
+    size_t count = 0; ///< The number of elements.
+
+    /**
+     * @brief Gets the element at the specified index without bounds checking.
+     * @param index The index of the element to access, which must be less than size().
+     * @return A reference to the value at the specified index.
+     */
+    Value& slot(size_t index) {
+        return (*buffer)[(head + index) & (buffer->size() - 1)];
+    }
+
+    /**
+     * @brief Copies the elements into a buffer of this vector's own if the buffer is shared.
+     */
+    void detach();
+
+    /**
+     * @brief Grows the buffer so it holds at least the given number of elements.
+     * @param minimum The number of elements the buffer must hold, which must exceed its capacity.
+     */
+    void grow(size_t minimum);
+
+    /**
+     * @brief Moves the elements in order to the start of a new buffer, copying them if the old buffer is shared.
+     * @param capacity The size of the new buffer, a power of two of at least size().
+     */
+    void reallocate(size_t capacity);
 };
 
 #endif // TYPEDVECTOR_H
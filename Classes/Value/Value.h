@@ -7,6 +7,7 @@
 #include <memory>
 
 class TypedVector; // Forward declaration
+class TypedMap; // Forward declaration
 
 /**
  * @typedef Value
@@ -19,7 +20,8 @@ class TypedVector; // Forward declaration
  * - std::string: Represents a string.
  * - std::monostate: Represents a "none" or "null" type.
  * - std::shared_ptr<TypedVector>: Represents a pointer to a TypedVector object.
+ * - std::shared_ptr<TypedMap>: Represents a pointer to a TypedMap object.
  */
-using Value = std::variant<double, int, bool, std::string, std::monostate, std::shared_ptr<TypedVector>>;
+using Value = std::variant<double, int, bool, std::string, std::monostate, std::shared_ptr<TypedVector>, std::shared_ptr<TypedMap>>;
 
 #endif // VALUE_H
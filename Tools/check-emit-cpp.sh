@@ -0,0 +1,83 @@
+#!/usr/bin/env bash
+# Checks that the C++ programs written by --emit-cpp print the same output as the interpreter.
+#
+# Usage: Tools/check-emit-cpp.sh BUILD_DIR [SCRIPT_DIR...]
+#
+# BUILD_DIR holds CPulse, cpulse_bench and libcpulse_runtime.a. Every script of the given
+# directories is run by the interpreter, translated, compiled against the runtime library and run
+# again, and the two outputs are compared. Without SCRIPT_DIR the sample scripts in
+# out/build/Debug/Files and the macro benchmark corpus of cpulse_bench are checked. Scripts that
+# read input or that the interpreter rejects before running are skipped. Set CXX and CXXFLAGS to
+# choose the compiler and add flags.
+
+set -u
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 BUILD_DIR [SCRIPT_DIR...]" >&2
+    exit 2
+fi
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+build=$(cd "$1" && pwd) || exit 2
+shift
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+directories=("$@")
+if [ ${#directories[@]} -eq 0 ]; then
+    directories=("$root/out/build/Debug/Files")
+    if [ -x "$build/cpulse_bench" ]; then
+        "$build/cpulse_bench" --write-corpus "$work/corpus" > /dev/null
+        directories+=("$work/corpus")
+    fi
+fi
+
+matched=0
+failed=0
+skipped=0
+for directory in "${directories[@]}"; do
+    for script in "$directory"/*.txt; do
+        [ -f "$script" ] || continue
+        name=$(basename "$script" .txt)
+        if grep -q 'input(' "$script"; then
+            echo "SKIP $name: reads input"
+            skipped=$((skipped + 1))
+            continue
+        fi
+
+        # CPulse runs every file in Files/, so each script gets a directory of its own
+        case=$(mktemp -d "$work/case.XXXXXX")
+        mkdir "$case/Files"
+        cp "$script" "$case/Files/"
+        (cd "$case" && "$build/CPulse" --emit-cpp < /dev/null > emit.log 2>&1)
+        if [ ! -f "$case/Files/$name.cpp" ]; then
+            echo "SKIP $name: not translated"
+            skipped=$((skipped + 1))
+            continue
+        fi
+
+        # The driver frames each file's output with a header and a rule, which the program does not print
+        (cd "$case" && "$build/CPulse" < /dev/null 2>&1) | grep -v '^Processing \|^-----' > "$case/expected"
+
+        if ! ${CXX:-c++} -std=c++20 -O1 ${CXXFLAGS:-} -I "$root/Classes" -I "$root/Classes/Enums" -I "$root/Classes/Structs" \
+            "$case/Files/$name.cpp" -L "$build" -lcpulse_runtime -pthread -o "$case/program" 2> "$case/compile.log"; then
+            echo "FAIL $name: does not compile"
+            head -n 20 "$case/compile.log"
+            failed=$((failed + 1))
+            continue
+        fi
+        "$case/program" < /dev/null > "$case/actual" 2>&1
+
+        if diff -u "$case/expected" "$case/actual" > "$case/diff"; then
+            echo "OK   $name"
+            matched=$((matched + 1))
+        else
+            echo "FAIL $name: output differs"
+            head -n 20 "$case/diff"
+            failed=$((failed + 1))
+        fi
+    done
+done
+
+echo "$matched matched, $failed failed, $skipped skipped"
+[ $failed -eq 0 ]
@@ -0,0 +1,172 @@
+#!/usr/bin/env bash
+# Checks that native code compiled by the JIT prints the same output as the interpreter.
+#
+# Usage: Tools/check-jit.sh BUILD_DIR [SCRIPT_DIR...]
+#
+# BUILD_DIR holds CPulse and cpulse_bench. Every script is run with the default thresholds, with
+# --jit-threshold 1 --jit-loop-threshold 0 so everything the JIT accepts runs natively from the
+# start, and with --no-jit, and the outputs are compared. Without SCRIPT_DIR the sample scripts in
+# out/build/Debug/Files, a few generated scripts that deoptimise, replace loops on the stack and
+# fail inside compiled code, and the macro benchmark corpus of cpulse_bench are checked. Scripts
+# that read input are skipped.
+
+set -u
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 BUILD_DIR [SCRIPT_DIR...]" >&2
+    exit 2
+fi
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+build=$(cd "$1" && pwd) || exit 2
+shift
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+directories=("$@")
+if [ ${#directories[@]} -eq 0 ]; then
+    mkdir "$work/generated"
+    # A double function that is later called with whole doubles, which its code cannot take
+    cat > "$work/generated/deoptimise.txt" << 'EOF'
+func:double half(v:double) {
+    w = v * 0.5
+    return w + 0.25
+}
+n = 0
+total = 0.5
+while (n < 60) {
+    if (n < 30) {
+        total = total + half(2.5)
+    }
+    else {
+        total = total + half(4.0)
+    }
+    n = n + 1
+}
+print(total)
+EOF
+    # Hot loops that are replaced on the stack, nested, and that overflow an int
+    cat > "$work/generated/loops.txt" << 'EOF'
+i = 0
+s = 0
+while (i < 100000) {
+    s = s + i
+    i = i + 1
+}
+print(s)
+print(i)
+j = 0
+t = 0
+while (j < 50) {
+    k = 0
+    while (k < 10) {
+        t = t + k * j
+        k = k + 1
+    }
+    j = j + 1
+}
+print(t)
+m = 2147483000
+c = 0
+while (c < 1000) {
+    m = m + 1
+    c = c + 1
+}
+print(m)
+EOF
+    # Recursive int functions and double arithmetic with comparisons and logic
+    cat > "$work/generated/functions.txt" << 'EOF'
+func:int fib(n:int) {
+    r = n
+    if (n > 1) {
+        r = fib(n - 1) + fib(n - 2)
+    }
+    return r
+}
+func:double mix(a:double, b:int) {
+    r = a / 3.0 + b % 7 + 0.01
+    if (((r > 10.0) and (b != 3)) or !(a < 0.0)) {
+        r = r - 1.5
+    }
+    return r
+}
+print(fib(22))
+x = 0
+acc = 0.0
+while (x < 500) {
+    acc = acc + mix(x * 1.25 + 0.1, x)
+    x = x + 1
+}
+print(acc)
+EOF
+    # Errors raised by compiled code must stop the program where the interpreter does
+    cat > "$work/generated/divide_by_zero.txt" << 'EOF'
+x = 0
+while (x < 300) {
+    x = x + 1
+    if (x == 250) {
+        y = 10 / 0
+    }
+}
+print(x)
+EOF
+    cat > "$work/generated/type_change.txt" << 'EOF'
+z = 0
+w = 0
+while (w < 150) {
+    z = z + w * 1.5
+    w = w + 1
+    if (w == 120) {
+        z = "str"
+    }
+}
+print(z)
+EOF
+    directories=("$root/out/build/Debug/Files" "$work/generated")
+    if [ -x "$build/cpulse_bench" ]; then
+        "$build/cpulse_bench" --write-corpus "$work/corpus" > /dev/null
+        directories+=("$work/corpus")
+    fi
+fi
+
+matched=0
+failed=0
+skipped=0
+for directory in "${directories[@]}"; do
+    for script in "$directory"/*.txt; do
+        [ -f "$script" ] || continue
+        name=$(basename "$script" .txt)
+        if grep -q 'input(' "$script"; then
+            echo "SKIP $name: reads input"
+            skipped=$((skipped + 1))
+            continue
+        fi
+
+        # CPulse runs every file in Files/, so each script gets a directory of its own
+        case=$(mktemp -d "$work/case.XXXXXX")
+        mkdir "$case/Files"
+        cp "$script" "$case/Files/"
+        (cd "$case" && "$build/CPulse" --no-jit < /dev/null > interpreted 2>&1)
+        (cd "$case" && "$build/CPulse" < /dev/null > default 2>&1)
+        (cd "$case" && "$build/CPulse" --jit-threshold 1 --jit-loop-threshold 0 < /dev/null > eager 2>&1)
+
+        result="OK  "
+        for mode in default eager; do
+            if ! diff -u "$case/interpreted" "$case/$mode" > "$case/$mode.diff"; then
+                [ "$result" = "OK  " ] && echo "FAIL $name"
+                echo "  $mode output differs from --no-jit"
+                head -n 20 "$case/$mode.diff"
+                result="FAIL"
+            fi
+        done
+        if [ "$result" = "OK  " ]; then
+            echo "OK   $name"
+            matched=$((matched + 1))
+        else
+            failed=$((failed + 1))
+        fi
+    done
+done
+
+echo "$matched matched, $failed failed, $skipped skipped"
+[ $failed -eq 0 ]
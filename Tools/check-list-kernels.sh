@@ -0,0 +1,123 @@
+#!/usr/bin/env bash
+# Checks that the parallel list kernels give the same results as the serial ones.
+#
+# Usage: Tools/check-list-kernels.sh BUILD_DIR [SCRIPT_DIR...]
+#
+# BUILD_DIR holds CPulse and cpulse_bench. Every script is run once with --kernel-threads 1 and
+# once with four threads and a parallel threshold low enough that every list method splits its
+# list into blocks, and the two outputs are compared. Without SCRIPT_DIR the check runs a few
+# generated scripts, which put NaN, -0.0 and ties at block boundaries, and the macro benchmark
+# corpus of cpulse_bench. Scripts that read input are skipped.
+
+set -u
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 BUILD_DIR [SCRIPT_DIR...]" >&2
+    exit 2
+fi
+
+build=$(cd "$1" && pwd) || exit 2
+shift
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# Appends `count` copies of `value` to the list `name`
+fill() {
+    printf 'i = 0\nwhile (i < %s) {\n    %s.append(%s)\n    i = i + 1\n}\n' "$2" "$1" "$3"
+}
+
+# Prints the results of every list method on the list `name`, sorting it last
+report() {
+    printf 'print(%s.min())\nprint(%s.max())\nprint(%s.contains(%s))\nprint(%s.index(%s))\n' "$1" "$1" "$1" "$2" "$1" "$2"
+    if [ "$3" = "number" ]; then
+        printf 'print(%s.sum())\n' "$1"
+    fi
+    printf '%s.sort()\nprint(%s[0])\nprint(%s[%s.length() - 1])\n' "$1" "$1" "$1" "$1"
+}
+
+directories=("$@")
+if [ ${#directories[@]} -eq 0 ]; then
+    # Parallel searches use blocks of 4096 elements, so these lists start blocks with NaN and -0.0
+    mkdir "$work/generated"
+    {
+        echo 'l = list:double()'
+        fill l 20480 5.5
+        echo 'l.append(double("nan"))'
+        echo 'l.append(0.5)'
+        fill l 20000 7.5
+        report l 0.5 number
+    } > "$work/generated/nan_inside.txt"
+    {
+        echo 'l = list:double()'
+        echo 'l.append(double("nan"))'
+        fill l 12287 2.5
+        echo 'l.append(0.0)'
+        echo 'l.append(-0.0)'
+        fill l 8190 1.5
+        echo 'l.append(-0.0)'
+        fill l 4096 'double("nan")'
+        report l -0.0 number
+    } > "$work/generated/nan_first.txt"
+    {
+        echo 'l = list:int()'
+        fill l 30000 'i % 977 - 400'
+        report l 576 number
+    } > "$work/generated/ints.txt"
+    {
+        # A sum that overflows follows +, so it is compared with a loop too
+        echo 'l = list:int()'
+        fill l 40000 100000
+        fill l 40000 -100000
+        echo 'total = 0'
+        echo 'i = 0'
+        printf 'while (i < l.length()) {\n    total = total + l[i]\n    i = i + 1\n}\n'
+        echo 'print(total)'
+        report l 100000 number
+    } > "$work/generated/int_overflow.txt"
+    {
+        echo 'l = list:string()'
+        fill l 20000 '"b"'
+        echo 'l.append("a")'
+        fill l 20000 '"c"'
+        report l '"c"' text
+    } > "$work/generated/strings.txt"
+    directories=("$work/generated")
+    if [ -x "$build/cpulse_bench" ]; then
+        "$build/cpulse_bench" --write-corpus "$work/corpus" > /dev/null
+        directories+=("$work/corpus")
+    fi
+fi
+
+matched=0
+failed=0
+skipped=0
+for directory in "${directories[@]}"; do
+    for script in "$directory"/*.txt; do
+        [ -f "$script" ] || continue
+        name=$(basename "$script" .txt)
+        if grep -q 'input(' "$script"; then
+            echo "SKIP $name: reads input"
+            skipped=$((skipped + 1))
+            continue
+        fi
+
+        # CPulse runs every file in Files/, so each script gets a directory of its own
+        case=$(mktemp -d "$work/case.XXXXXX")
+        mkdir "$case/Files"
+        cp "$script" "$case/Files/"
+        (cd "$case" && "$build/CPulse" --kernel-threads 1 < /dev/null > serial 2>&1)
+        (cd "$case" && "$build/CPulse" --kernel-threads 4 --parallel-threshold 10 < /dev/null > parallel 2>&1)
+
+        if diff -u "$case/serial" "$case/parallel" > "$case/diff"; then
+            echo "OK   $name"
+            matched=$((matched + 1))
+        else
+            echo "FAIL $name: parallel output differs"
+            head -n 20 "$case/diff"
+            failed=$((failed + 1))
+        fi
+    done
+done
+
+echo "$matched matched, $failed failed, $skipped skipped"
+[ $failed -eq 0 ]